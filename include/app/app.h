@@ -3,6 +3,9 @@
 
 #include "ui/input_handler.h"
 #include "logging/logger.h"
+#include "core/flight_replay.h"
+#include "core/job_system.h"
+#include "core/physics_thread.h"
 #include "core/simulation.h"
 #include "rendering/shader.h"
 #include "app/map.h"
@@ -13,14 +16,19 @@
 
 class App {
 public:
-    App(const std::string& title, int width, int height, Config& config, std::shared_ptr<ILogger> logger, Camera& camera);
+    // A non-empty replayPath plays that telemetry recording back instead of running the physics
+    App(const std::string& title, int width, int height, Config& config, std::shared_ptr<ILogger> logger, Camera& camera,
+        const std::string& replayPath = "");
     ~App();
     void run();
 
 private:
     GLFWwindow* window;
     Config& config;
+    std::unique_ptr<JobSystem> jobs;          // Shared worker pool; outlives the simulation's users
     Simulation simulation;
+    std::unique_ptr<PhysicsThread> physics;   // Declared after simulation: stops before it is destroyed
+    std::unique_ptr<FlightReplay> replay;     // Set when replaying; the physics then never runs
     Shader shader;
     std::unique_ptr<InputHandler> inputHandler;
     std::unique_ptr<UI> ui;
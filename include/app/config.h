@@ -10,6 +10,7 @@
 #include <string>
 #include <vector>
 #include <unordered_map>
+#include <utility>
 
 using json = nlohmann::json;
 
@@ -19,6 +20,30 @@ public:
     using std::runtime_error::runtime_error;
 };
 
+// Tabulated atmosphere profile for a body, sampled by altitude above its surface.
+// Resampled onto a uniform lookup grid by AtmosphereTable::fromProfile.
+struct AtmosphereProfile {
+    std::vector<double> altitudes;      // meters, strictly increasing; the last one is the ceiling
+    std::vector<double> densities;      // kg/m^3
+    std::vector<double> temperatures;   // K (for the speed of sound)
+    double gas_constant = 287.05;       // Specific gas constant J/(kg K)
+    double gamma = 1.4;                 // Heat capacity ratio
+
+    bool empty() const { return altitudes.empty(); }
+};
+
+// One stage of the rocket stack, burned bottom to top. Vacuum thrust is
+// tabulated against the stage's firing time and specific impulse against
+// ambient pressure; a single point is a constant. Without a thrust curve the
+// stage delivers whatever the flight plan commands.
+struct RocketStageConfig {
+    std::string name;
+    double dry_mass = 0.0;                                  // kg, jettisoned at staging
+    double propellant_mass = 0.0;                           // kg
+    std::vector<std::pair<double, double>> thrust_curve;    // (firing time s, vacuum thrust N)
+    std::vector<std::pair<double, double>> isp_curve;       // (ambient pressure Pa, Isp s)
+};
+
 // Configuration for a single planet (orbit, mass, radius, rendering)
 struct PlanetConfig {
     std::string name;
@@ -29,6 +54,8 @@ struct PlanetConfig {
     float orbital_inclination;  // radians (relative to ecliptic)
     glm::vec4 orbit_color;      // RGBA for orbit line rendering
     float view_multiplier;      // Camera distance multiplier for focus mode
+    AtmosphereProfile atmosphere = {};  // Empty: no drag near this planet
+    std::string parent = "sun";         // Body this planet orbits (body hierarchy)
 };
 
 class Config {
@@ -47,6 +74,9 @@ public:
     glm::dvec3 rocket_initial_velocity = {0.0, 0.0, 0.0};
     float rocket_rotation_speed = 90.0f;
     float rocket_direction_cooldown = 0.01f;
+    // Empty: a single stage from fuel_mass, thrust and exhaust_velocity.
+    // Otherwise mass is the liftoff mass and fuel_mass is ignored.
+    std::vector<RocketStageConfig> rocket_stages;
     std::string flight_plan_path = "etc/flight_plan.json";
 
     // Physics parameters
@@ -75,10 +105,20 @@ public:
     double physics_earth_radius = 6371000.0;
     double physics_gravity_constant = 6.674e-11;
     double physics_earth_mass = 5.972e24;
-    double physics_air_density = 1.225;
-    double physics_scale_height = 8000.0;
     double physics_drag_coefficient = 0.1;
     double physics_cross_section_area = 0.5;
+    double physics_earth_j2 = 0.0;               // Oblateness term, 0 disables it (Earth: 1.08263e-3)
+    // Rocket gravity: bodies whose GM/r^2 is below this fraction of the strongest
+    // are folded into a frozen far-field term (0 disables culling)
+    double physics_perturber_tolerance = 1e-7;
+    double physics_perturber_refresh_interval = 60.0;  // seconds between reclassifications
+    // Earth uses the US Standard Atmosphere 1976 table; other planets may provide
+    // an atmosphere profile in physics.planets.<name>.atmosphere
+    double physics_atmosphere_resolution = 100.0;      // Lookup grid spacing (m)
+    double physics_atmosphere_ceiling = 100000.0;      // Earth drag ceiling (m)
+    // Drag coefficient versus Mach number as (mach, cd) pairs.
+    // Empty: constant physics_drag_coefficient.
+    std::vector<std::pair<double, double>> physics_drag_mach_table;
     // Moon parameters
     double physics_moon_radius = 1737100.0;
     double physics_moon_mass = 7.34767309e22;
@@ -96,15 +136,59 @@ public:
     float simulation_prediction_duration = 30.0f;
     float simulation_prediction_step = 0.1f;
     float simulation_rendering_scale = 0.001f;
+    double simulation_event_tolerance = 1e-6;            // Event time tolerance (s)
+    bool simulation_block_timesteps = true;              // Multi-rate block timesteps for bodies
+    double simulation_block_max_step = 345600.0;         // Coarsest body step / block length (s)
+    double simulation_block_eta = 0.005;                 // Step as a fraction of the dynamical timescale
+    int simulation_block_max_level = 16;                 // Finest level: max_step / 2^level
+    // Coasting rocket: integrate only the deviation from a Kepler conic around
+    // the dominant body (Encke); burns always use full (Cowell) integration
+    bool simulation_encke = true;
+    double simulation_encke_rectify_ratio = 1e-3;        // Rectify once |deviation| / |r| exceeds this
+    float simulation_encke_step_scale = 4.0f;            // Prediction step multiplier while coasting
+    // Coasting rocket on a highly eccentric orbit or in a close approach (a step
+    // covering more than ks_step_fraction of the distance): KS-regularized steps
+    bool simulation_ks = true;
+    double simulation_ks_eccentricity = 0.9;
+    double simulation_ks_step_fraction = 0.05;
+    double simulation_ks_anomaly_step = 0.0314;          // Eccentric anomaly per KS step (rad)
+    // Burns integrate mass with the state, so prediction can take longer steps under thrust
+    float simulation_burn_step_scale = 2.0f;
+    // Linearized covariance along the prediction: the state transition matrix
+    // is integrated with the trajectory and maps these 1-sigma initial errors
+    bool simulation_covariance = false;
+    double simulation_covariance_position_sigma = 100.0;   // m
+    double simulation_covariance_velocity_sigma = 0.1;     // m/s
+    size_t simulation_covariance_ellipsoids = 8;           // Error ellipsoids drawn along the prediction
+    // Closest approaches to the bodies along the prediction, searched
+    // incrementally within this much wall-clock time per frame
+    bool simulation_encounters = true;
+    double simulation_encounter_budget_ms = 0.5;
+    // Physics on its own thread at this rate; rendering reads published snapshots
+    bool simulation_physics_thread = true;
+    double simulation_physics_rate = 240.0;              // Steps per second
+    unsigned simulation_job_threads = 0;                 // Job system threads, including the waiting one; 0: all cores
     
     // Trajectory colors (RGBA)
     glm::vec4 trajectory_rocket_color = {1.0f, 0.0f, 0.0f, 1.0f};      // Red
     glm::vec4 trajectory_prediction_color = {0.0f, 1.0f, 0.0f, 0.7f};  // Green with transparency
+    glm::vec4 trajectory_covariance_color = {1.0f, 0.6f, 0.0f, 0.8f};  // Orange; 3-sigma at half alpha
     glm::vec4 trajectory_moon_color = {0.5f, 0.5f, 0.5f, 0.8f};        // Gray
     glm::vec4 trajectory_earth_color = {0.0f, 0.5f, 1.0f, 0.8f};       // Light blue
 
     // Logger settings
     int logger_level = 3; // 0: DEBUG, 1: INFO, 2: WARN, 3: ERROR
+    bool logger_async = true;             // Write logs from a background thread
+    bool logger_block_when_full = false;  // Async queue full: wait for room instead of dropping
+
+    // Telemetry recording (see FlightRecorder)
+    bool telemetry_enabled = false;
+    std::string telemetry_path = "logs/telemetry.rst";
+    double telemetry_interval = 0.1;      // Simulated seconds between rows; 0: every physics step
+    bool telemetry_compress = true;       // Delta and run-length pack each chunk
+
+    // Checkpoints (F5 saves, F9 restores)
+    std::string checkpoint_path = "saves/quicksave.rsc";
 
     // Camera settings
     float camera_pitch = 45.0f;
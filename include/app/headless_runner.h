@@ -0,0 +1,60 @@
+#ifndef HEADLESS_RUNNER_H
+#define HEADLESS_RUNNER_H
+
+#include "app/config.h"
+#include "core/simulation_core.h"
+#include "logging/logger.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+struct HeadlessOptions {
+    double duration = 600.0;          // Simulated seconds to run
+    double step = 0.05;               // Simulated seconds per physics step
+    std::string telemetryPath;        // Binary telemetry (see FlightRecorder); empty records none
+    double telemetryInterval = 1.0;   // Simulated seconds between telemetry rows
+    bool launch = true;               // Launch the rocket before the first step (unless restored in flight)
+    std::string restorePath;          // Checkpoint to start from; the duration runs on from its time
+    std::string checkpointPath;       // Checkpoint to save at the end of the run
+};
+
+struct HeadlessResult {
+    uint64_t steps = 0;
+    double simulatedTime = 0.0;       // s
+    double wallTime = 0.0;            // s
+    uint64_t telemetryRows = 0;
+    bool crashed = false;
+};
+
+/**
+ * Runs a SimulationCore without a window, as fast as the CPU allows, for
+ * batch studies. Every step is a fixed simulated interval at time scale 1,
+ * so a run is reproducible. Telemetry goes through the core's
+ * FlightRecorder, started after any checkpoint restore so the file covers
+ * exactly this run; the configuration's own telemetry setting is ignored.
+ */
+class HeadlessRunner {
+public:
+    HeadlessRunner(const Config& config, std::shared_ptr<ILogger> logger, const HeadlessOptions& options);
+
+    // Worker pool for the simulation's frame graph; nullptr runs it on the calling thread
+    void setJobSystem(JobSystem* jobs) { core_.setJobSystem(jobs); }
+
+    /**
+     * Initialize the simulation and run it for options.duration. The
+     * telemetry file is complete when this returns.
+     * @throws CheckpointError if the checkpoint to restore or save fails
+     * @throws TelemetryError if the telemetry file cannot be created
+     */
+    HeadlessResult run();
+
+    SimulationCore& getCore() { return core_; }
+
+private:
+    SimulationCore core_;
+    HeadlessOptions options_;
+    std::shared_ptr<ILogger> logger_;
+};
+
+#endif // HEADLESS_RUNNER_H
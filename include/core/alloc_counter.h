@@ -0,0 +1,19 @@
+#ifndef ALLOC_COUNTER_H
+#define ALLOC_COUNTER_H
+
+#include <cstdint>
+
+/**
+ * Process-wide heap allocation counts, for finding allocations on the
+ * physics frame. Counting replaces the global operator new and is compiled
+ * in only with ROCKETSIM_COUNT_ALLOCATIONS (on in Debug builds and the
+ * tests); otherwise enabled() is false and the counts stay at zero.
+ */
+class AllocationCounter {
+public:
+    static bool enabled();
+    static uint64_t count();    // operator new calls so far, every thread
+    static uint64_t bytes();    // Bytes they asked for
+};
+
+#endif // ALLOC_COUNTER_H
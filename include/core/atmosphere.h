@@ -0,0 +1,150 @@
+#ifndef ATMOSPHERE_H
+#define ATMOSPHERE_H
+
+#include "app/config.h"
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+/**
+ * Table-driven atmosphere and drag coefficient models.
+ *
+ * Both tables are resampled once onto a uniform grid, so a lookup is an
+ * index computation plus one linear interpolation: no search and no
+ * transcendental functions per force evaluation. Values are stored as
+ * plain arrays (structure of arrays) so the batch versions compile to
+ * straight-line loops the compiler can auto-vectorize. The single lookups
+ * are templates on the scalar, so dual numbers (core/dual.h) pass through
+ * with the slope of the cell they land in.
+ */
+
+/**
+ * Density, speed of sound and pressure versus altitude above a body's surface.
+ *
+ * The grid is fine enough (default 100 m) that linear interpolation of
+ * density is within ~1e-4 of log-linear interpolation for scale heights
+ * down to ~5 km, while keeping the table a few kilobytes in size.
+ */
+class AtmosphereTable {
+public:
+    AtmosphereTable() = default;
+
+    /**
+     * U.S. Standard Atmosphere 1976 (seven layers up to 86 km geometric
+     * altitude). Above 86 km the last layer's lapse rate is continued up
+     * to the ceiling, which is adequate for drag at those densities.
+     *
+     * @param resolution Grid spacing (m)
+     * @param ceiling Altitude above which density is zero (m)
+     */
+    static AtmosphereTable us76(double resolution = 100.0, double ceiling = 100000.0);
+
+    /**
+     * Build from sparse sample points (e.g. a Mars or Venus profile from
+     * config). Density is interpolated log-linearly between samples while
+     * resampling; the top sample altitude becomes the ceiling.
+     * Throws ConfigError if the profile is malformed.
+     */
+    static AtmosphereTable fromProfile(const AtmosphereProfile& profile, double resolution = 100.0);
+
+    bool empty() const { return density_.empty(); }
+    double ceiling() const { return ceiling_; }
+    double resolution() const { return step_; }
+
+    /**
+     * Density (kg/m^3) at an altitude (m). Zero above the ceiling;
+     * below the surface the surface value is returned.
+     */
+    template <typename Scalar>
+    Scalar density(const Scalar& altitude) const {
+        if (altitude >= ceiling_ || density_.empty()) return 0.0;
+        size_t k;
+        Scalar f = locate(altitude, k);
+        return density_[k] + f * (density_[k + 1] - density_[k]);
+    }
+
+    /**
+     * Speed of sound (m/s) at an altitude (m), clamped to the table range.
+     */
+    template <typename Scalar>
+    Scalar speedOfSound(const Scalar& altitude) const {
+        if (soundSpeed_.empty()) return 0.0;
+        size_t k;
+        Scalar f = locate(altitude, k);
+        return soundSpeed_[k] + f * (soundSpeed_[k + 1] - soundSpeed_[k]);
+    }
+
+    /**
+     * Static pressure (Pa) at an altitude (m), for engine back-pressure.
+     * Zero above the ceiling, like density.
+     */
+    template <typename Scalar>
+    Scalar pressure(const Scalar& altitude) const {
+        if (altitude >= ceiling_ || pressure_.empty()) return 0.0;
+        size_t k;
+        Scalar f = locate(altitude, k);
+        return pressure_[k] + f * (pressure_[k + 1] - pressure_[k]);
+    }
+
+    /**
+     * Batch lookup for many altitudes at once (e.g. several vehicles or
+     * prediction samples). Same semantics as density()/speedOfSound().
+     */
+    void sample(const double* altitudes, double* density, double* soundSpeed, size_t count) const;
+
+private:
+    std::vector<double> density_;
+    std::vector<double> soundSpeed_;
+    std::vector<double> pressure_;
+    double step_ = 100.0;
+    double invStep_ = 0.01;
+    double ceiling_ = 0.0;
+
+    // Grid cell k and fraction within it for an altitude, clamped to the table
+    template <typename Scalar>
+    Scalar locate(const Scalar& altitude, size_t& k) const {
+        Scalar x = altitude * invStep_;
+        double last = static_cast<double>(density_.size() - 1);
+        x = x < 0.0 ? Scalar(0.0) : (x > last ? Scalar(last) : x);
+        k = static_cast<size_t>(static_cast<double>(x));
+        if (k >= density_.size() - 1) k = density_.size() - 2;
+        return x - static_cast<double>(k);
+    }
+};
+
+/**
+ * Drag coefficient versus Mach number.
+ * A table with a single point is a constant Cd.
+ */
+class DragTable {
+public:
+    DragTable() = default;
+
+    static DragTable constant(double cd);
+
+    /**
+     * Build from (Mach, Cd) pairs sorted by Mach. Beyond the last point
+     * the last Cd is held. Throws ConfigError if the points are malformed.
+     */
+    static DragTable fromPoints(const std::vector<std::pair<double, double>>& points, double resolution = 0.05);
+
+    template <typename Scalar>
+    Scalar at(const Scalar& mach) const {
+        Scalar x = mach * invStep_;
+        double last = static_cast<double>(cd_.size() - 1);
+        x = x < 0.0 ? Scalar(0.0) : (x > last ? Scalar(last) : x);
+        size_t k = static_cast<size_t>(static_cast<double>(x));
+        if (k >= cd_.size() - 1) k = cd_.size() - 2;
+        Scalar f = x - static_cast<double>(k);
+        return cd_[k] + f * (cd_[k + 1] - cd_[k]);
+    }
+
+    void sample(const double* mach, double* cd, size_t count) const;
+
+private:
+    std::vector<double> cd_ = {0.0, 0.0};
+    double invStep_ = 1.0;
+};
+
+#endif // ATMOSPHERE_H
@@ -2,12 +2,18 @@
 #define BODY_H
 
 #include "app/config.h"
-#include "rendering/body_renderer.h"
+#include "logging/logger.h"
 
 #include <glm/glm.hpp>
+#include <memory>
 #include <string>
+#include <unordered_map>
 
 
+/**
+ * Physics state of a body. Rendering lives in BodyRenderer, owned by the
+ * windowed Simulation, so the physics core builds without OpenGL.
+ */
 class Body {
 public:
     // Physics state (public for direct access in physics integrator)
@@ -16,9 +22,6 @@ public:
     glm::dvec3 position;
     glm::dvec3 velocity;
 
-    // Rendering component (owns sphere mesh + orbit trajectory)
-    BodyRenderer renderer;
-
 public:
     Body();
     Body(const Config& config, std::shared_ptr<ILogger> logger);
@@ -28,13 +31,6 @@ public:
 
     Body& operator=(const Body& other);
 
-    // Update trajectory with current position (delegates to renderer)
-    virtual void update(float deltaTime);
-
-    // Render orbit trajectory (delegates to renderer)
-    virtual void render(const Shader& shader) const;
-    virtual void render(const Shader& shader, const glm::vec3& orbitCenter) const;
-
     // Getters
     std::string getName() const { return name; }
     double getMass() const { return mass; }
@@ -45,9 +41,6 @@ public:
     void setPosition(const glm::dvec3& position) { this->position = position; }
     void setVelocity(const glm::dvec3& velocity) { this->velocity = velocity; }
 
-    // Convenience: delegate to renderer (backward compatibility)
-    void setTrajectory(std::unique_ptr<Trajectory> trajectory) { renderer.setTrajectory(std::move(trajectory)); }
-
 protected:
     const Config& config_;
     std::shared_ptr<ILogger> logger_;
@@ -0,0 +1,91 @@
+#ifndef BODY_TREE_H
+#define BODY_TREE_H
+
+#include "core/body.h"
+
+#include <glm/glm.hpp>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Node of the body hierarchy. State is stored relative to the parent
+ * (Sun -> planet -> moon), so the Moon's offset from Earth is ~4e8 m
+ * rather than the difference of two ~1.5e11 m heliocentric vectors.
+ */
+struct BodyNode {
+    Body* body = nullptr;
+    int parent = -1;                   // Index of the parent node, -1 for the root
+    std::vector<int> children;
+    int depth = 0;
+    glm::dvec3 localPosition{0.0};     // Relative to the parent (world for the root)
+    glm::dvec3 localVelocity{0.0};
+    double soiRadius = 0.0;            // Cached sphere of influence (infinite for the root)
+};
+
+/**
+ * Hierarchy of celestial bodies with parent-relative state.
+ *
+ * Nodes are stored parents first (by depth, then name), so a parent's
+ * index is always lower than its children's and world state can be
+ * rebuilt in a single forward pass. Parent lookup, SOI radii and world
+ * positions are index based; names are only resolved once, through
+ * indexOf().
+ *
+ * Body::position / velocity stay the heliocentric world state that the
+ * rest of the code reads; updateWorld() writes them from the local state
+ * and syncFromWorld() goes the other way after external changes.
+ */
+class BodyTree {
+public:
+    static constexpr int kNone = -1;
+
+    BodyTree() = default;
+
+    /**
+     * Build the hierarchy.
+     *
+     * @param bodies All bodies; exactly one must have no parent entry
+     * @param parents Body name -> parent name
+     * @throws std::invalid_argument on unknown parents, cycles or several roots
+     */
+    void build(BODY_MAP& bodies, const std::unordered_map<std::string, std::string>& parents);
+
+    bool empty() const { return nodes_.empty(); }
+    size_t size() const { return nodes_.size(); }
+    int root() const { return nodes_.empty() ? kNone : 0; }
+
+    int indexOf(const std::string& name) const;
+    const BodyNode& node(int index) const { return nodes_[index]; }
+    Body& body(int index) const { return *nodes_[index].body; }
+    // kNone for the root and for kNone itself, so parentOf(indexOf(name)) is safe
+    int parentOf(int index) const { return index == kNone ? kNone : nodes_[index].parent; }
+    double soiRadius(int index) const { return nodes_[index].soiRadius; }
+
+    glm::dvec3 worldPosition(int index) const;
+    glm::dvec3 worldVelocity(int index) const;
+
+    void setLocalState(int index, const glm::dvec3& position, const glm::dvec3& velocity) {
+        nodes_[index].localPosition = position;
+        nodes_[index].localVelocity = velocity;
+    }
+
+    // Write world state into the bodies from the local state
+    void updateWorld();
+    // Recompute local state from the bodies' world state
+    void syncFromWorld();
+    // Recompute SOI radii: a * (m / M)^(2/5) with a the distance to the parent
+    void refreshSoi();
+
+    /**
+     * Innermost body whose SOI contains a world position, found by
+     * descending from the root.
+     */
+    int dominantBody(const glm::dvec3& worldPosition) const;
+
+private:
+    std::vector<BodyNode> nodes_;
+    std::unordered_map<std::string, int> index_;
+};
+
+#endif // BODY_TREE_H
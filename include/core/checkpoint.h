@@ -0,0 +1,149 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include "logging/logger.h"
+
+#include <glm/glm.hpp>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/**
+ * Saved simulation state, enough to resume a run where it was taken.
+ *
+ * A file is a header (magic, u32 version, u32 flags, u64 payload size)
+ * and a payload of sections in a fixed order: clock, bodies, rocket, then
+ * the optional view (camera and trails). Values are little-endian and
+ * stored as they are in memory, so restoring is a walk over the mapped
+ * file with a copy per field and one per trail. A file of another version
+ * is refused rather than guessed at.
+ */
+
+class CheckpointError : public std::runtime_error {
+public:
+    explicit CheckpointError(const std::string& message) : std::runtime_error(message) {}
+};
+
+struct BodyCheckpoint {
+    std::string name;
+    double mass = 0.0;
+    glm::dvec3 position{0.0};
+    glm::dvec3 velocity{0.0};
+};
+
+struct RocketCheckpoint {
+    glm::dvec3 position{0.0};
+    glm::dvec3 velocity{0.0};
+    glm::dvec3 thrustDirection{0.0, 1.0, 0.0};  // Local frame, as the rocket keeps it
+    glm::dvec3 earthPosition{0.0};
+    double mass = 0.0;
+    double fuelMass = 0.0;                      // Propellant left in the active stage
+    double thrust = 0.0;
+    double stageBurnTime = 0.0;                 // Firing time of the active stage (s)
+    double perturberClock = 0.0;
+    float time = 0.0f;                          // Mission time (s)
+    uint32_t stage = 0;                         // Active stage, bottom first
+    bool launched = false;
+    bool crashed = false;
+};
+
+struct CameraCheckpoint {
+    uint32_t mode = 0;                          // Camera::Mode
+    glm::vec3 position{0.0f};
+    glm::vec3 target{0.0f};
+    glm::vec3 fixedTarget{0.0f};
+    float pitch = 0.0f;
+    float yaw = 0.0f;
+    float distance = 0.0f;
+    std::string focusBodyName;
+};
+
+// A trail's ring buffer, oldest point first, and the time since its last sample
+struct TrailCheckpoint {
+    std::string name;                           // Body name, or "rocket" for the flown path
+    float sampleTimer = 0.0f;
+    std::vector<glm::vec3> points;
+};
+
+// Render-thread state, saved by the windowed simulation only
+struct CheckpointView {
+    CameraCheckpoint camera;
+    std::vector<TrailCheckpoint> trails;
+};
+
+struct Checkpoint {
+    double time = 0.0;                          // Simulated seconds since the start
+    float timeScale = 1.0f;
+    std::vector<BodyCheckpoint> bodies;         // Body tree order
+    RocketCheckpoint rocket;
+    std::optional<CheckpointView> view;
+};
+
+namespace checkpoint {
+
+constexpr uint32_t kVersion = 1;
+
+void encode(const Checkpoint& state, std::vector<uint8_t>& out);
+// @throws CheckpointError if the data is not a whole checkpoint of this version
+Checkpoint decode(const uint8_t* data, size_t size);
+
+}  // namespace checkpoint
+
+/**
+ * Write a checkpoint, replacing `path` only once the new file is complete:
+ * it is written beside it and renamed over it, so a crash mid-write leaves
+ * the previous checkpoint intact. Missing directories are created.
+ * @throws CheckpointError if the file cannot be written
+ */
+void writeCheckpoint(const std::string& path, const Checkpoint& state);
+
+/**
+ * Read a checkpoint by mapping the file and decoding straight from it.
+ * @throws CheckpointError if the file is missing, cut short or not a checkpoint
+ */
+Checkpoint readCheckpoint(const std::string& path);
+
+/**
+ * Writes checkpoints from a background thread, so a save costs the caller
+ * a copy of the state; coding and disk I/O happen off the physics thread.
+ * The thread starts with the first save. Outcomes are logged.
+ */
+class CheckpointWriter {
+public:
+    explicit CheckpointWriter(std::shared_ptr<ILogger> logger);
+    ~CheckpointWriter();   // Finishes the queued saves
+
+    CheckpointWriter(const CheckpointWriter&) = delete;
+    CheckpointWriter& operator=(const CheckpointWriter&) = delete;
+
+    void save(const std::string& path, Checkpoint state);
+    // Wait until every queued save is on disk (or has failed)
+    void flush();
+
+    uint64_t saved() const;
+    uint64_t failed() const;
+
+private:
+    std::shared_ptr<ILogger> logger_;
+    std::deque<std::pair<std::string, Checkpoint>> queue_;
+    bool busy_ = false;         // The worker holds a save taken off the queue
+    bool stop_ = false;
+    uint64_t saved_ = 0;
+    uint64_t failed_ = 0;
+    mutable std::mutex mutex_;
+    std::condition_variable ready_;   // Worker: a save queued, or stop
+    std::condition_variable idle_;    // flush(): the queue ran dry
+    std::thread worker_;
+
+    void run();
+};
+
+#endif // CHECKPOINT_H
@@ -0,0 +1,153 @@
+#ifndef COVARIANCE_H
+#define COVARIANCE_H
+
+#include "core/force_model.h"
+
+#include <glm/glm.hpp>
+#include <array>
+#include <vector>
+
+/**
+ * Linearized uncertainty propagation.
+ *
+ * Instead of flying many perturbed trajectories, the state transition
+ * matrix Phi = d x(t) / d x(t0) is integrated with the nominal state
+ * (the variational equations Phi' = A Phi, A = [[0, I], [da/dr, da/dv]])
+ * and an initial covariance is mapped as P(t) = Phi P0 Phi^T. The
+ * acceleration Jacobian is taken by forward differences, six extra force
+ * evaluations per RK4 stage: about 7x the cost of the bare trajectory.
+ *
+ * State vectors are ordered (x, y, z, vx, vy, vz); matrices are row-major.
+ */
+
+using Matrix6 = std::array<std::array<double, 6>, 6>;
+
+Matrix6 identityMatrix6();
+Matrix6 multiply(const Matrix6& a, const Matrix6& b);
+
+// Phi P Phi^T
+Matrix6 propagateCovariance(const Matrix6& phi, const Matrix6& covariance);
+
+// Uncorrelated position and velocity errors (1-sigma, m and m/s)
+Matrix6 diagonalCovariance(double positionSigma, double velocitySigma);
+
+/**
+ * Position uncertainty at one point: the principal semi-axes of the
+ * 1-sigma ellipsoid of the 3x3 position covariance, largest first.
+ */
+struct ErrorEllipsoid {
+    glm::dvec3 center = glm::dvec3(0.0);
+    std::array<glm::dvec3, 3> axes{};
+
+    static ErrorEllipsoid fromCovariance(const glm::dvec3& center, const Matrix6& covariance);
+
+    /**
+     * Points on the ellipsoid scaled by sigma, tracing its three principal
+     * sections as one closed line: the largest section, the second, a
+     * quarter of the largest to reach the third, the third and back.
+     */
+    std::vector<glm::dvec3> outline(double sigma, int segments = 32) const;
+};
+
+/**
+ * Acceleration partials with respect to position and velocity,
+ * columns indexed by the perturbed component.
+ */
+struct AccelerationJacobian {
+    std::array<glm::dvec3, 3> position;   // d a / d r_j
+    std::array<glm::dvec3, 3> velocity;   // d a / d v_j
+};
+
+/**
+ * Acceleration at (r, v) and its Jacobian by forward differences. Steps
+ * of 1 m and 1 mm/s sit well above round-off for heliocentric positions
+ * and well below the scale on which gravity or drag change.
+ */
+template <typename Accel>
+inline glm::dvec3 accelerationJacobian(const Accel& accel, const glm::dvec3& r, const glm::dvec3& v,
+                                       double mass, AccelerationJacobian& jacobian) {
+    constexpr double kPositionStep = 1.0;
+    constexpr double kVelocityStep = 1e-3;
+
+    glm::dvec3 a = accel(r, v, mass);
+    for (int j = 0; j < 3; ++j) {
+        glm::dvec3 dr(0.0);
+        dr[j] = kPositionStep;
+        jacobian.position[j] = (accel(r + dr, v, mass) - a) / kPositionStep;
+
+        glm::dvec3 dv(0.0);
+        dv[j] = kVelocityStep;
+        jacobian.velocity[j] = (accel(r, v + dv, mass) - a) / kVelocityStep;
+    }
+    return a;
+}
+
+namespace detail {
+
+// A M for the variational equations: the velocity rows move up, the
+// acceleration rows are the Jacobian applied to M
+inline Matrix6 variationalRate(const AccelerationJacobian& jacobian, const Matrix6& m) {
+    Matrix6 out{};
+    for (int c = 0; c < 6; ++c) {
+        glm::dvec3 a(0.0);
+        for (int j = 0; j < 3; ++j) {
+            a += jacobian.position[j] * m[j][c] + jacobian.velocity[j] * m[3 + j][c];
+        }
+        for (int i = 0; i < 3; ++i) {
+            out[i][c] = m[3 + i][c];
+            out[3 + i][c] = a[i];
+        }
+    }
+    return out;
+}
+
+inline Matrix6 addScaled(const Matrix6& m, const Matrix6& k, double h) {
+    Matrix6 out = m;
+    for (int i = 0; i < 6; ++i) {
+        for (int c = 0; c < 6; ++c) {
+            out[i][c] += h * k[i][c];
+        }
+    }
+    return out;
+}
+
+}  // namespace detail
+
+/**
+ * rk4Step with the state transition matrix carried along: phi is advanced
+ * over the step through the same stages. The state result equals rk4Step's.
+ */
+template <typename Accel>
+inline PhaseState rk4StmStep(const Accel& accel, const PhaseState& s, double mass, double h, Matrix6& phi) {
+    const double half = 0.5 * h;
+    AccelerationJacobian jacobian;
+
+    glm::dvec3 a1 = accelerationJacobian(accel, s.position, s.velocity, mass, jacobian);
+    glm::dvec3 v1 = s.velocity;
+    Matrix6 k1 = detail::variationalRate(jacobian, phi);
+
+    glm::dvec3 v2 = s.velocity + a1 * half;
+    glm::dvec3 a2 = accelerationJacobian(accel, s.position + v1 * half, v2, mass, jacobian);
+    Matrix6 k2 = detail::variationalRate(jacobian, detail::addScaled(phi, k1, half));
+
+    glm::dvec3 v3 = s.velocity + a2 * half;
+    glm::dvec3 a3 = accelerationJacobian(accel, s.position + v2 * half, v3, mass, jacobian);
+    Matrix6 k3 = detail::variationalRate(jacobian, detail::addScaled(phi, k2, half));
+
+    glm::dvec3 v4 = s.velocity + a3 * h;
+    glm::dvec3 a4 = accelerationJacobian(accel, s.position + v3 * h, v4, mass, jacobian);
+    Matrix6 k4 = detail::variationalRate(jacobian, detail::addScaled(phi, k3, h));
+
+    for (int i = 0; i < 6; ++i) {
+        for (int c = 0; c < 6; ++c) {
+            phi[i][c] += (k1[i][c] + 2.0 * k2[i][c] + 2.0 * k3[i][c] + k4[i][c]) * (h / 6.0);
+        }
+    }
+
+    PhaseState out;
+    out.position = s.position + (v1 + 2.0 * v2 + 2.0 * v3 + v4) * (h / 6.0);
+    out.velocity = s.velocity + (a1 + 2.0 * a2 + 2.0 * a3 + a4) * (h / 6.0);
+    return out;
+}
+
+#endif // COVARIANCE_H
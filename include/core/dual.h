@@ -0,0 +1,188 @@
+#ifndef DUAL_H
+#define DUAL_H
+
+#include <glm/glm.hpp>
+#include <array>
+#include <cmath>
+
+/**
+ * Forward-mode automatic differentiation.
+ *
+ * Dual<N> carries a value and its gradient with respect to N seeded
+ * parameters; every operation applies the chain rule to the gradient.
+ * Running the force model and RK integrators (force_model.h) on DualVec3
+ * instead of glm::dvec3 yields the exact sensitivities of the final state
+ * to the seeded inputs (initial state, thrust, step length, ...) in a
+ * single propagation, at roughly N + 1 times the arithmetic.
+ *
+ * Comparisons look at the value only, so branches (atmosphere ceiling,
+ * minimum distances) follow the nominal trajectory, and so does the
+ * explicit conversion to double that picks a table cell or a curve
+ * segment; the interpolation within it is differentiated.
+ */
+template <int N>
+struct Dual {
+    double value = 0.0;
+    std::array<double, N> grad{};
+
+    Dual() = default;
+    Dual(double v) : value(v) {}   // A constant: zero gradient
+    explicit operator double() const { return value; }
+
+    // The input parameter `index`, with unit derivative
+    static Dual variable(double v, int index) {
+        Dual d(v);
+        d.grad[index] = 1.0;
+        return d;
+    }
+
+    Dual& operator+=(const Dual& o) {
+        value += o.value;
+        for (int i = 0; i < N; ++i) grad[i] += o.grad[i];
+        return *this;
+    }
+    Dual& operator-=(const Dual& o) {
+        value -= o.value;
+        for (int i = 0; i < N; ++i) grad[i] -= o.grad[i];
+        return *this;
+    }
+    Dual& operator*=(const Dual& o) {
+        for (int i = 0; i < N; ++i) grad[i] = grad[i] * o.value + value * o.grad[i];
+        value *= o.value;
+        return *this;
+    }
+    Dual& operator/=(const Dual& o) {
+        double inv = 1.0 / o.value;
+        for (int i = 0; i < N; ++i) grad[i] = (grad[i] - value * inv * o.grad[i]) * inv;
+        value *= inv;
+        return *this;
+    }
+    Dual& operator+=(double s) { value += s; return *this; }
+    Dual& operator-=(double s) { value -= s; return *this; }
+    Dual& operator*=(double s) {
+        value *= s;
+        for (double& g : grad) g *= s;
+        return *this;
+    }
+    Dual& operator/=(double s) { return *this *= 1.0 / s; }
+};
+
+template <int N> inline Dual<N> operator-(Dual<N> a) { return a *= -1.0; }
+
+template <int N> inline Dual<N> operator+(Dual<N> a, const Dual<N>& b) { return a += b; }
+template <int N> inline Dual<N> operator-(Dual<N> a, const Dual<N>& b) { return a -= b; }
+template <int N> inline Dual<N> operator*(Dual<N> a, const Dual<N>& b) { return a *= b; }
+template <int N> inline Dual<N> operator/(Dual<N> a, const Dual<N>& b) { return a /= b; }
+
+template <int N> inline Dual<N> operator+(Dual<N> a, double s) { return a += s; }
+template <int N> inline Dual<N> operator-(Dual<N> a, double s) { return a -= s; }
+template <int N> inline Dual<N> operator*(Dual<N> a, double s) { return a *= s; }
+template <int N> inline Dual<N> operator/(Dual<N> a, double s) { return a /= s; }
+template <int N> inline Dual<N> operator+(double s, Dual<N> a) { return a += s; }
+template <int N> inline Dual<N> operator-(double s, const Dual<N>& a) { return -a + s; }
+template <int N> inline Dual<N> operator*(double s, Dual<N> a) { return a *= s; }
+template <int N> inline Dual<N> operator/(double s, const Dual<N>& a) { return Dual<N>(s) /= a; }
+
+template <int N> inline bool operator<(const Dual<N>& a, const Dual<N>& b) { return a.value < b.value; }
+template <int N> inline bool operator>(const Dual<N>& a, const Dual<N>& b) { return a.value > b.value; }
+template <int N> inline bool operator<=(const Dual<N>& a, const Dual<N>& b) { return a.value <= b.value; }
+template <int N> inline bool operator>=(const Dual<N>& a, const Dual<N>& b) { return a.value >= b.value; }
+template <int N> inline bool operator<(const Dual<N>& a, double s) { return a.value < s; }
+template <int N> inline bool operator>(const Dual<N>& a, double s) { return a.value > s; }
+template <int N> inline bool operator<=(const Dual<N>& a, double s) { return a.value <= s; }
+template <int N> inline bool operator>=(const Dual<N>& a, double s) { return a.value >= s; }
+template <int N> inline bool operator<(double s, const Dual<N>& a) { return s < a.value; }
+template <int N> inline bool operator>(double s, const Dual<N>& a) { return s > a.value; }
+
+// f(a) with derivative df at a.value
+template <int N>
+inline Dual<N> chain(const Dual<N>& a, double f, double df) {
+    Dual<N> out(f);
+    for (int i = 0; i < N; ++i) out.grad[i] = df * a.grad[i];
+    return out;
+}
+
+template <int N> inline Dual<N> sqrt(const Dual<N>& a) {
+    double s = std::sqrt(a.value);
+    return chain(a, s, s > 0.0 ? 0.5 / s : 0.0);
+}
+template <int N> inline Dual<N> exp(const Dual<N>& a) {
+    double e = std::exp(a.value);
+    return chain(a, e, e);
+}
+template <int N> inline Dual<N> log(const Dual<N>& a) { return chain(a, std::log(a.value), 1.0 / a.value); }
+template <int N> inline Dual<N> sin(const Dual<N>& a) { return chain(a, std::sin(a.value), std::cos(a.value)); }
+template <int N> inline Dual<N> cos(const Dual<N>& a) { return chain(a, std::cos(a.value), -std::sin(a.value)); }
+template <int N> inline Dual<N> abs(const Dual<N>& a) { return a.value < 0.0 ? -a : a; }
+template <int N> inline Dual<N> pow(const Dual<N>& a, double p) {
+    double f = std::pow(a.value, p);
+    return chain(a, f, p * std::pow(a.value, p - 1.0));
+}
+
+/**
+ * Three dual components, standing in for glm::dvec3. Arithmetic mixes
+ * freely with glm::dvec3 (constants such as body positions).
+ */
+template <int N>
+struct DualVec3 {
+    using value_type = Dual<N>;
+    Dual<N> x, y, z;
+
+    DualVec3() = default;
+    explicit DualVec3(const Dual<N>& s) : x(s), y(s), z(s) {}
+    DualVec3(const Dual<N>& x_, const Dual<N>& y_, const Dual<N>& z_) : x(x_), y(y_), z(z_) {}
+    explicit DualVec3(const glm::dvec3& v) : x(v.x), y(v.y), z(v.z) {}
+
+    // Components as parameters first, first + 1, first + 2
+    static DualVec3 variable(const glm::dvec3& v, int first) {
+        return DualVec3(Dual<N>::variable(v.x, first), Dual<N>::variable(v.y, first + 1),
+                        Dual<N>::variable(v.z, first + 2));
+    }
+
+    glm::dvec3 value() const { return glm::dvec3(x.value, y.value, z.value); }
+    // d component / d parameter i
+    glm::dvec3 derivative(int i) const { return glm::dvec3(x.grad[i], y.grad[i], z.grad[i]); }
+
+    Dual<N>& operator[](int i) { return i == 0 ? x : (i == 1 ? y : z); }
+    const Dual<N>& operator[](int i) const { return i == 0 ? x : (i == 1 ? y : z); }
+
+    DualVec3& operator+=(const DualVec3& o) { x += o.x; y += o.y; z += o.z; return *this; }
+    DualVec3& operator-=(const DualVec3& o) { x -= o.x; y -= o.y; z -= o.z; return *this; }
+    DualVec3& operator+=(const glm::dvec3& o) { x += o.x; y += o.y; z += o.z; return *this; }
+    DualVec3& operator-=(const glm::dvec3& o) { x -= o.x; y -= o.y; z -= o.z; return *this; }
+    DualVec3& operator*=(const Dual<N>& s) { x *= s; y *= s; z *= s; return *this; }
+    DualVec3& operator*=(double s) { x *= s; y *= s; z *= s; return *this; }
+};
+
+template <int N> inline DualVec3<N> operator-(DualVec3<N> a) { return a *= -1.0; }
+
+template <int N> inline DualVec3<N> operator+(DualVec3<N> a, const DualVec3<N>& b) { return a += b; }
+template <int N> inline DualVec3<N> operator-(DualVec3<N> a, const DualVec3<N>& b) { return a -= b; }
+template <int N> inline DualVec3<N> operator+(DualVec3<N> a, const glm::dvec3& b) { return a += b; }
+template <int N> inline DualVec3<N> operator-(DualVec3<N> a, const glm::dvec3& b) { return a -= b; }
+template <int N> inline DualVec3<N> operator+(const glm::dvec3& a, DualVec3<N> b) { return b += a; }
+template <int N> inline DualVec3<N> operator-(const glm::dvec3& a, const DualVec3<N>& b) { return -b + a; }
+
+template <int N> inline DualVec3<N> operator*(DualVec3<N> a, const Dual<N>& s) { return a *= s; }
+template <int N> inline DualVec3<N> operator*(const Dual<N>& s, DualVec3<N> a) { return a *= s; }
+template <int N> inline DualVec3<N> operator*(DualVec3<N> a, double s) { return a *= s; }
+template <int N> inline DualVec3<N> operator*(double s, DualVec3<N> a) { return a *= s; }
+template <int N> inline DualVec3<N> operator*(const glm::dvec3& a, const Dual<N>& s) { return DualVec3<N>(a.x * s, a.y * s, a.z * s); }
+template <int N> inline DualVec3<N> operator*(const Dual<N>& s, const glm::dvec3& a) { return a * s; }
+template <int N> inline DualVec3<N> operator/(DualVec3<N> a, const Dual<N>& s) { return a *= (1.0 / s); }
+template <int N> inline DualVec3<N> operator/(DualVec3<N> a, double s) { return a *= (1.0 / s); }
+template <int N> inline DualVec3<N> operator/(const glm::dvec3& a, const Dual<N>& s) { return a * (1.0 / s); }
+
+template <int N> inline Dual<N> dot(const DualVec3<N>& a, const DualVec3<N>& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+template <int N> inline Dual<N> dot(const DualVec3<N>& a, const glm::dvec3& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+template <int N> inline Dual<N> dot(const glm::dvec3& a, const DualVec3<N>& b) { return dot(b, a); }
+template <int N> inline DualVec3<N> cross(const DualVec3<N>& a, const DualVec3<N>& b) {
+    return DualVec3<N>(a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x);
+}
+template <int N> inline DualVec3<N> cross(const glm::dvec3& a, const DualVec3<N>& b) {
+    return DualVec3<N>(a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x);
+}
+template <int N> inline Dual<N> length(const DualVec3<N>& a) { return sqrt(dot(a, a)); }
+template <int N> inline DualVec3<N> normalize(const DualVec3<N>& a) { return a / length(a); }
+
+#endif // DUAL_H
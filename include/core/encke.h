@@ -0,0 +1,126 @@
+#ifndef ENCKE_H
+#define ENCKE_H
+
+#include "core/force_model.h"
+
+#include <glm/glm.hpp>
+#include <cmath>
+
+/**
+ * Two-body (Kepler) propagation of a state relative to a central body,
+ * using universal variables so ellipses, parabolas and hyperbolas share
+ * one code path.
+ *
+ * @param s Position and velocity relative to the central body
+ * @param mu G * M of the central body (m^3/s^2)
+ * @param dt Time to propagate (s), may be negative
+ */
+PhaseState keplerPropagate(const PhaseState& s, double mu, double dt);
+
+/**
+ * Encke's method: integrate only the deviation from a reference conic.
+ *
+ * Near one dominant body the Kepler term is orders of magnitude larger
+ * than everything else. Cowell integration spends its accuracy on that
+ * term; here the reference conic (osculating at the last rectification)
+ * is propagated exactly with keplerPropagate() and RK4 only sees the
+ * deviation delta = r - rho, which grows slowly:
+ *
+ *   delta'' = -(mu / rho^3) (f(q) r + delta) + a_p(r, v)
+ *
+ * with Battin's f(q) to avoid the cancellation in 1 - rho^3/r^3. Once
+ * |delta| exceeds rectifyRatio * |rho| the current state becomes the new
+ * reference conic.
+ *
+ * State is relative to the central body; the perturbation a_p must not
+ * contain the central body's point-mass term.
+ */
+class EnckePropagator {
+public:
+    EnckePropagator() = default;
+    EnckePropagator(double mu, double rectifyRatio) : mu_(mu), rectifyRatio_(rectifyRatio) {}
+
+    /**
+     * Start a new reference conic at the given relative state.
+     */
+    void rectify(const PhaseState& s) {
+        reference_ = s;
+        sinceEpoch_ = 0.0;
+        delta_ = PhaseState{glm::dvec3(0.0), glm::dvec3(0.0)};
+        ++rectifications_;
+    }
+
+    /**
+     * Advance by h seconds. The perturbation is called as
+     * perturbation(relativePosition, relativeVelocity, mass).
+     */
+    template <typename Perturbation>
+    void step(const Perturbation& perturbation, double mass, double h);
+
+    // Relative state: reference conic plus deviation
+    PhaseState state() const {
+        PhaseState rho = keplerPropagate(reference_, mu_, sinceEpoch_);
+        return PhaseState{rho.position + delta_.position, rho.velocity + delta_.velocity};
+    }
+
+    const PhaseState& deviation() const { return delta_; }
+    double mu() const { return mu_; }
+    int rectifications() const { return rectifications_; }
+
+private:
+    double mu_ = 0.0;
+    double rectifyRatio_ = 1e-3;
+
+    PhaseState reference_{glm::dvec3(0.0), glm::dvec3(0.0)};  // Conic state at its epoch
+    double sinceEpoch_ = 0.0;                                   // Time since the last rectification (s)
+    PhaseState delta_{glm::dvec3(0.0), glm::dvec3(0.0)};
+    int rectifications_ = 0;
+
+    // Deviation acceleration for the conic state rho and the true state r = rho + delta
+    glm::dvec3 deviationAcceleration(const glm::dvec3& rho, const glm::dvec3& delta) const {
+        glm::dvec3 r = rho + delta;
+        double q = glm::dot(delta, delta - 2.0 * r) / glm::dot(r, r);
+        double onePlusQ15 = std::pow(1.0 + q, 1.5);
+        double fq = q * (3.0 + 3.0 * q + q * q) / (1.0 + onePlusQ15);
+        double rhoLen = glm::length(rho);
+        return -(mu_ / (rhoLen * rhoLen * rhoLen)) * (fq * r + delta);
+    }
+};
+
+template <typename Perturbation>
+void EnckePropagator::step(const Perturbation& perturbation, double mass, double h) {
+    const double half = 0.5 * h;
+
+    // The conic at the three RK4 sample times
+    PhaseState rho0 = keplerPropagate(reference_, mu_, sinceEpoch_);
+    PhaseState rhoHalf = keplerPropagate(reference_, mu_, sinceEpoch_ + half);
+    PhaseState rho1 = keplerPropagate(reference_, mu_, sinceEpoch_ + h);
+
+    auto accel = [&](const PhaseState& rho, const glm::dvec3& dp, const glm::dvec3& dv) {
+        return deviationAcceleration(rho.position, dp)
+             + perturbation(rho.position + dp, rho.velocity + dv, mass);
+    };
+
+    const PhaseState& d = delta_;
+    glm::dvec3 a1 = accel(rho0, d.position, d.velocity);
+    glm::dvec3 v1 = d.velocity;
+
+    glm::dvec3 v2 = d.velocity + a1 * half;
+    glm::dvec3 a2 = accel(rhoHalf, d.position + v1 * half, v2);
+
+    glm::dvec3 v3 = d.velocity + a2 * half;
+    glm::dvec3 a3 = accel(rhoHalf, d.position + v2 * half, v3);
+
+    glm::dvec3 v4 = d.velocity + a3 * h;
+    glm::dvec3 a4 = accel(rho1, d.position + v3 * h, v4);
+
+    delta_.position += (v1 + 2.0 * v2 + 2.0 * v3 + v4) * (h / 6.0);
+    delta_.velocity += (a1 + 2.0 * a2 + 2.0 * a3 + a4) * (h / 6.0);
+    sinceEpoch_ += h;
+
+    if (glm::length(delta_.position) > rectifyRatio_ * glm::length(rho1.position)) {
+        rectify(PhaseState{rho1.position + delta_.position, rho1.velocity + delta_.velocity});
+    }
+}
+
+#endif // ENCKE_H
@@ -0,0 +1,116 @@
+#ifndef ENCOUNTER_H
+#define ENCOUNTER_H
+
+#include "core/body_tree.h"
+#include "core/event_detector.h"
+#include "core/force_model.h"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * Closest approach of a trajectory to one body.
+ */
+struct Encounter {
+    std::string body;
+    double time = 0.0;            // s, on the trajectory's clock
+    double distance = 0.0;        // Miss distance from the body's centre (m)
+    double relativeSpeed = 0.0;   // m/s at closest approach
+};
+
+/**
+ * Body ephemeris for look-ahead: every body follows a Kepler conic about
+ * its parent from a snapshot of the hierarchy (the root moves in a
+ * straight line). Cheap to evaluate anywhere in time, and exact for the
+ * two-body part of the motion, which dominates over a prediction span.
+ */
+class ConicEphemeris {
+public:
+    ConicEphemeris() = default;
+    ConicEphemeris(const BodyTree& tree, double G);
+
+    // Snapshot the tree again, in the storage the last one left behind
+    void assign(const BodyTree& tree, double G);
+
+    size_t size() const { return entries_.size(); }
+    const std::string& name(int index) const { return entries_[index].name; }
+    int parentOf(int index) const { return entries_[index].parent; }
+    double soiRadius(int index) const { return entries_[index].soiRadius; }
+
+    // World state dt seconds after the snapshot
+    PhaseState state(int index, double dt) const;
+    // All bodies at once, walking the hierarchy a single time
+    void states(double dt, std::vector<PhaseState>& out) const;
+
+private:
+    struct Entry {
+        std::string name;
+        int parent = -1;
+        PhaseState local;         // Relative to the parent (world for the root)
+        double mu = 0.0;          // G * parent mass
+        double soiRadius = 0.0;
+    };
+    std::vector<Entry> entries_;  // Parents first, as in the tree
+};
+
+/**
+ * Incremental closest-approach search along a sampled trajectory.
+ *
+ * Consecutive samples are joined by the same cubic Hermite arcs the event
+ * detector uses. For each arc and body, the relative motion is a cubic
+ * whose Bezier control points bound it; arcs whose bounding sphere stays
+ * outside the body's sphere of influence are skipped. The rest are
+ * sampled for a sign change of the range rate r . v from closing to
+ * opening, and the minimum is located with Brent's method.
+ *
+ * update() works through the arcs until its wall-clock budget runs out and
+ * resumes there on the next call, so a long trajectory is searched over
+ * several frames without stalling any of them.
+ */
+class EncounterFinder {
+public:
+    explicit EncounterFinder(double timeTolerance = 1e-3, int samplesPerArc = 4);
+
+    /**
+     * Start a new search.
+     *
+     * @param samples Trajectory states in time order; sample times are
+     *                seconds after the ephemeris snapshot
+     * @param ephemeris Bodies to search against; the root is skipped
+     *
+     * Both are copied into storage kept from the previous search.
+     */
+    void reset(const std::vector<EventState>& samples, const ConicEphemeris& ephemeris);
+
+    /**
+     * Continue the search.
+     *
+     * @param budgetSeconds Wall-clock time to spend; <= 0 runs to the end
+     * @return true once the whole trajectory has been searched
+     */
+    bool update(double budgetSeconds);
+
+    bool finished() const { return samples_.size() < 2 || next_ + 1 >= samples_.size(); }
+
+    // Closest approaches found so far, in time order
+    const std::vector<Encounter>& encounters() const { return encounters_; }
+
+    size_t arcsSearched() const { return next_; }
+    size_t arcsRefined() const { return refined_; }
+
+private:
+    double timeTolerance_;
+    int samplesPerArc_;
+    std::vector<EventState> samples_;
+    ConicEphemeris ephemeris_;
+    std::vector<PhaseState> bodyStart_;   // Body states at the start of the next arc
+    std::vector<PhaseState> bodyEnd_;     // Scratch: and at its end, swapped in after each arc
+    std::vector<Encounter> encounters_;
+    size_t next_ = 0;                     // Next arc to search
+    size_t refined_ = 0;                  // Arcs that survived the bounding test
+
+    void searchArc(const DenseStep& arc, int body, const PhaseState& start, const PhaseState& end);
+};
+
+#endif // ENCOUNTER_H
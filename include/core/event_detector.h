@@ -0,0 +1,118 @@
+#ifndef EVENT_DETECTOR_H
+#define EVENT_DETECTOR_H
+
+#include <glm/glm.hpp>
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+
+/**
+ * Event detection for the rocket integrator.
+ *
+ * Events are described by a scalar function g(state) whose zero crossing
+ * marks the event (altitude = 0, distance - SOI radius = 0, r·v = 0, ...).
+ * After each trial step the detector builds a dense-output interpolant
+ * over the step, samples every g along it and locates the earliest sign
+ * change with a bracketing root finder. The integrator then re-steps to
+ * exactly that time, so large steps no longer overshoot events.
+ */
+
+/**
+ * Integrator state seen by event functions.
+ * Time is measured from the start of the current frame.
+ */
+struct EventState {
+    double time = 0.0;
+    glm::dvec3 position = glm::dvec3(0.0);
+    glm::dvec3 velocity = glm::dvec3(0.0);
+    double mass = 0.0;
+    double fuel = 0.0;
+    double burnTime = 0.0;      // Firing time of the active stage (s)
+};
+
+/**
+ * Dense output over one integrator step [start.time, end.time].
+ *
+ * Position is a cubic Hermite interpolant matching position and velocity
+ * at both ends; velocity is its time derivative. Mass, fuel and burn
+ * time vary linearly (constant mass flow during the step). This needs no extra
+ * force evaluations beyond the step itself and is accurate enough to
+ * locate crossings, since the final state is always re-integrated.
+ */
+class DenseStep {
+public:
+    DenseStep(const EventState& start, const EventState& end);
+
+    EventState interpolate(double t) const;
+
+    double startTime() const { return start_.time; }
+    double endTime() const { return end_.time; }
+    const EventState& start() const { return start_; }
+    const EventState& end() const { return end_; }
+
+private:
+    EventState start_;
+    EventState end_;
+};
+
+enum class EventDirection {
+    Any,      // Report crossings in both directions
+    Rising,   // Only report g going from negative to non-negative
+    Falling   // Only report g going from positive to non-positive
+};
+
+struct EventSpec {
+    std::string name;
+    std::function<double(const EventState&)> function;
+    EventDirection direction = EventDirection::Any;
+    bool enabled = true;
+};
+
+struct EventHit {
+    size_t index;        // Index of the event in the detector
+    bool rising;         // True if g crossed from negative to non-negative
+    EventState state;    // Interpolated state at the event time
+};
+
+class EventDetector {
+public:
+    /**
+     * @param timeTolerance Absolute tolerance on located event times (s)
+     * @param samplesPerStep Sub-intervals scanned per step, so that a pair
+     *        of crossings inside one step (e.g. a grazing pass) is not missed
+     */
+    explicit EventDetector(double timeTolerance = 1e-6, int samplesPerStep = 4);
+
+    /**
+     * Register an event. Returns its index, reported back in EventHit.
+     */
+    size_t add(EventSpec spec);
+    void clear() { events_.clear(); }
+
+    void setEnabled(size_t index, bool enabled) { events_[index].enabled = enabled; }
+    void setTimeTolerance(double tol) { timeTolerance_ = tol; }
+
+    const EventSpec& get(size_t index) const { return events_[index]; }
+    size_t size() const { return events_.size(); }
+
+    /**
+     * Find the earliest event crossing inside the step.
+     * The returned time lies on the far side of the crossing (within the
+     * time tolerance), so resuming integration from it does not report
+     * the same event again.
+     */
+    std::optional<EventHit> findFirst(const DenseStep& step) const;
+
+private:
+    std::vector<EventSpec> events_;
+    double timeTolerance_;
+    int samplesPerStep_;
+
+    // Events whose scan state findFirst keeps without touching the heap
+    static constexpr size_t kInlineEvents = 32;
+
+    static bool crosses(double g0, double g1, EventDirection direction);
+};
+
+#endif // EVENT_DETECTOR_H
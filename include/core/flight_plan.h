@@ -1,9 +1,12 @@
 #ifndef FLIGHT_PLAN_H
 #define FLIGHT_PLAN_H
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <fstream>
 #include <stdexcept>
+#include <string>
 #include <vector>
 #include <optional>
 #include <nlohmann/json.hpp>
@@ -33,34 +36,183 @@ struct FlightCondition {
     }
 };
 
-struct FlightAction {
-    double thrust;
-    glm::dvec3 direction;
+template <typename Vec>
+struct BasicFlightAction {
+    typename Vec::value_type thrust;
+    Vec direction;
 
-    FlightAction(double t = 0.0, glm::dvec3 d = {0.0, 0.0, 0.0})
+    BasicFlightAction(typename Vec::value_type t = 0.0, Vec d = Vec(0.0))
         : thrust(t), direction(d) {}
 };
+using FlightAction = BasicFlightAction<glm::dvec3>;
 
 struct FlightStage {
     FlightCondition condition;
     FlightAction action;
 };
 
+/**
+ * A shift of every guidance point's pitch and thrust. Zero in flight; the
+ * seeded parameters when a flight is differentiated against its pitch
+ * program (Rocket::guidanceSensitivity).
+ */
+template <typename Scalar>
+struct GuidanceShift {
+    Scalar pitch = 0.0;    // rad
+    Scalar thrust = 0.0;   // N
+};
+
+enum class GuidanceVariable {
+    Altitude,   // m above Earth's surface
+    Time,       // s since launch
+    Speed       // m/s
+};
+
+/**
+ * Tabulated guidance: pitch and thrust versus one flight variable, linearly
+ * interpolated (an ascent pitch program, a throttle bucket, ...).
+ *
+ * Pitch is measured from the local vertical toward the heading, which is
+ * measured in the local horizontal plane from +X toward +Z; pitch 0 is
+ * straight up. Keys are sorted once at load time and kept as plain arrays,
+ * so a lookup is one binary search and one interpolation. Lookups are
+ * templates on the vector type like the force terms (force_model.h): the
+ * segment is picked by the key's value, and the interpolation within it
+ * is differentiated.
+ */
+class GuidanceProfile {
+public:
+    struct Point {
+        double key;
+        double pitch;    // rad
+        double thrust;   // N
+    };
+
+    /**
+     * Throws FlightPlanError if there are no points or two share a key.
+     * @param heading Heading of the pitch plane (rad)
+     */
+    GuidanceProfile(GuidanceVariable variable, std::vector<Point> points, double heading = 0.0);
+
+    GuidanceVariable variable() const { return variable_; }
+    double begin() const { return keys_.front(); }
+    double end() const { return keys_.back(); }
+    size_t size() const { return keys_.size(); }
+
+    // Interpolated action, or nullopt if key is outside [begin, end]
+    std::optional<FlightAction> at(double key) const { return at<glm::dvec3>(key, {}); }
+
+    template <typename Vec>
+    std::optional<BasicFlightAction<Vec>> at(const typename Vec::value_type& key,
+                                             const GuidanceShift<typename Vec::value_type>& shift) const;
+
+private:
+    GuidanceVariable variable_;
+    std::vector<double> keys_;
+    std::vector<double> pitch_;
+    std::vector<double> thrust_;
+    double cosHeading_ = 1.0;
+    double sinHeading_ = 0.0;
+};
+
 class FlightPlan {
 public:
     FlightPlan() = default;
     FlightPlan(std::string);
     FlightPlan(nlohmann::json&);
 
-    std::optional<FlightAction> getAction(double altitude, double speed) const;
+    /**
+     * Action for the current flight state: the first stage whose condition
+     * holds, else the first guidance profile covering its variable, else
+     * nullopt (keep the previous action). O(log n) in the plan size, so it
+     * is cheap enough to evaluate inside integrator substeps.
+     */
+    std::optional<FlightAction> getAction(double altitude, double speed, double time) const {
+        return getAction<glm::dvec3>(altitude, speed, time, {});
+    }
+
+    // The same on another vector type, with every guidance point shifted
+    template <typename Vec>
+    std::optional<BasicFlightAction<Vec>> getAction(const typename Vec::value_type& altitude,
+                                                    const typename Vec::value_type& speed,
+                                                    const typename Vec::value_type& time,
+                                                    const GuidanceShift<typename Vec::value_type>& shift) const;
 
     void addStage(const FlightStage& stage);
+    void addGuidance(const GuidanceProfile& profile);
 
     const std::vector<FlightStage>& getStages() const;
+    const std::vector<GuidanceProfile>& getGuidance() const;
+    bool hasGuidance() const { return !guidance.empty(); }
 
 private:
     std::vector<FlightStage> stages;
+    std::vector<GuidanceProfile> guidance;
+
+    // Stage conditions compiled into an altitude interval index. Slot 2i+1
+    // is exactly bounds[i], slot 2i the open interval below it; each slot
+    // lists, in plan order, the stages whose altitude range covers it.
+    std::vector<double> bounds;
+    std::vector<std::vector<size_t>> slots;
+
     void parseFlightPlan(const nlohmann::json&);
+    void buildIndex();
 };
 
+template <typename Vec>
+std::optional<BasicFlightAction<Vec>> GuidanceProfile::at(const typename Vec::value_type& key,
+                                                          const GuidanceShift<typename Vec::value_type>& shift) const {
+    using Scalar = typename Vec::value_type;
+    using std::cos;
+    using std::sin;
+    if (!(key >= keys_.front() && key <= keys_.back())) {
+        return std::nullopt;
+    }
+
+    Scalar pitch = pitch_.front();
+    Scalar thrust = thrust_.front();
+    if (keys_.size() > 1) {
+        size_t k = std::upper_bound(keys_.begin(), keys_.end(), key,
+                                    [](const Scalar& value, double point) { return value < point; }) - keys_.begin();
+        k = std::min(k, keys_.size() - 1);
+        size_t j = k - 1;
+        Scalar f = (key - keys_[j]) / (keys_[k] - keys_[j]);
+        pitch = pitch_[j] + f * (pitch_[k] - pitch_[j]);
+        thrust = thrust_[j] + f * (thrust_[k] - thrust_[j]);
+    }
+    pitch += shift.pitch;
+    thrust += shift.thrust;
+
+    Scalar horizontal = sin(pitch);
+    return BasicFlightAction<Vec>(thrust, Vec(horizontal * cosHeading_, cos(pitch), horizontal * sinHeading_));
+}
+
+template <typename Vec>
+std::optional<BasicFlightAction<Vec>> FlightPlan::getAction(const typename Vec::value_type& altitude,
+                                                            const typename Vec::value_type& speed,
+                                                            const typename Vec::value_type& time,
+                                                            const GuidanceShift<typename Vec::value_type>& shift) const {
+    if (!slots.empty()) {
+        // Stage actions are constants, picked by the nominal state
+        const double a = static_cast<double>(altitude);
+        size_t k = std::lower_bound(bounds.begin(), bounds.end(), a) - bounds.begin();
+        size_t slot = (k < bounds.size() && bounds[k] == a) ? 2 * k + 1 : 2 * k;
+        // Only stages whose altitude range covers this altitude; speed is checked per stage
+        for (size_t i : slots[slot]) {
+            if (stages[i].condition.isSatisfied(a, static_cast<double>(speed))) {
+                return BasicFlightAction<Vec>(stages[i].action.thrust, Vec(stages[i].action.direction));
+            }
+        }
+    }
+
+    for (const auto& profile : guidance) {
+        const auto& key = profile.variable() == GuidanceVariable::Altitude ? altitude
+                        : profile.variable() == GuidanceVariable::Time ? time : speed;
+        if (auto action = profile.at<Vec>(key, shift)) {
+            return action;
+        }
+    }
+    return std::nullopt;
+}
+
 #endif // FLIGHT_PLAN_H
\ No newline at end of file
@@ -0,0 +1,57 @@
+#ifndef FLIGHT_RECORDER_H
+#define FLIGHT_RECORDER_H
+
+#include "core/snapshot.h"
+#include "core/telemetry.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Records published SimulationSnapshots to a telemetry file at a fixed
+ * simulated rate: the time, every body's position and velocity, and the
+ * rocket's state, thrust, propellant, stage and flags, all in double
+ * precision. Launch, crash and staging show up as changes in the flag and
+ * stage columns.
+ *
+ * Columns: time; <body>.x .y .z .vx .vy .vz per body in tree order;
+ * rocket.x .y .z .vx .vy .vz, rocket.mass, rocket.fuel, rocket.thrust,
+ * rocket.dx .dy .dz (thrust direction); rocket.stage and rocket.flags
+ * (UInt32, see the flag bits below).
+ */
+class FlightRecorder {
+public:
+    static constexpr uint32_t kLaunched = 1u << 0;
+    static constexpr uint32_t kCrashed = 1u << 1;
+
+    /**
+     * @param bodies   Body names in snapshot order; fixes the schema
+     * @param interval Simulated seconds between rows, 0 for every snapshot
+     * @throws TelemetryError if the file cannot be created
+     */
+    FlightRecorder(const std::string& path, const std::vector<std::string>& bodies, double interval, bool compress);
+
+    static std::vector<TelemetryColumn> schema(const std::vector<std::string>& bodies);
+
+    // Append a row if `interval` has passed since the last; true if it did.
+    // Copies the values only; the coding and the disk are the writer's thread.
+    bool record(const SimulationSnapshot& state);
+
+    void close() { writer_.close(); }
+
+    const std::string& path() const { return path_; }
+    uint64_t rows() const { return writer_.rows(); }
+    bool failed() const { return writer_.failed(); }
+
+private:
+    std::string path_;
+    TelemetryWriter writer_;
+    size_t bodyCount_;
+    double interval_;
+    double nextTime_ = 0.0;
+    bool started_ = false;
+    std::vector<double> row_;
+};
+
+#endif // FLIGHT_RECORDER_H
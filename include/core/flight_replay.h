@@ -0,0 +1,95 @@
+#ifndef FLIGHT_REPLAY_H
+#define FLIGHT_REPLAY_H
+
+#include "core/snapshot.h"
+#include "core/telemetry.h"
+
+#include <algorithm>
+#include <array>
+#include <string>
+#include <vector>
+
+/**
+ * Plays back a FlightRecorder file in place of the physics. The recording
+ * is mapped, not loaded: seeking is a binary search of the chunk index and
+ * of the times within one chunk, and only the (at most two) chunks around
+ * the playback time are decoded.
+ *
+ * Between rows, positions and velocities follow the cubic Hermite curve
+ * through both ends' states, which tracks an orbit far better than a
+ * straight line at the same row rate; mass, propellant and thrust are
+ * interpolated linearly, and the stage and flags hold the earlier row's.
+ *
+ * Render thread only.
+ */
+class FlightReplay {
+public:
+    /**
+     * @param layout Snapshot supplying what a recording does not hold:
+     *               the body tree, masses and SOI radii, matched by name.
+     *               Bodies missing from the recording stay where it has them.
+     * @throws TelemetryError if the file is not a readable recording
+     */
+    FlightReplay(const std::string& path, const SimulationSnapshot& layout);
+
+    // Names shown for each stage index; otherwise "Stage N"
+    void setStageNames(std::vector<std::string> names) { stageNames_ = std::move(names); }
+
+    double startTime() const { return startTime_; }
+    double endTime() const { return endTime_; }
+
+    // Playback: advance() moves the clock by wall seconds times the speed;
+    // seek() jumps it, which SimulationSnapshot::seeks counts
+    void advance(double wallSeconds);
+    void seek(double time);
+    double time() const { return time_; }
+    void setPlaying(bool playing) { playing_ = playing; }
+    bool playing() const { return playing_; }
+    void setSpeed(double speed) { speed_ = speed; }
+    double speed() const { return speed_; }
+
+    // State at the playback time; valid until the next call
+    const SimulationSnapshot& current() { return at(time_); }
+    const SimulationSnapshot& at(double time);
+
+    const TelemetryReader& reader() const { return reader_; }
+
+private:
+    TelemetryReader reader_;
+    SimulationSnapshot frame_;
+    std::vector<std::string> stageNames_;
+
+    // Column of each frame_ body's ".x", and of the rocket's fields; -1 if absent
+    std::vector<int> bodyColumns_;
+    int rocketColumn_ = -1;
+    int massColumn_ = -1;
+    int fuelColumn_ = -1;
+    int thrustColumn_ = -1;
+    int directionColumn_ = -1;
+    int stageColumn_ = -1;
+    int flagsColumn_ = -1;
+
+    double startTime_ = 0.0;
+    double endTime_ = 0.0;
+    double time_ = 0.0;
+    double speed_ = 1.0;
+    bool playing_ = true;
+    uint64_t sequence_ = 0;
+    uint64_t seeks_ = 0;
+
+    void moveTo(double time) { time_ = std::max(startTime_, std::min(time, endTime_)); }
+
+    // Decoded chunks, the two most recently used
+    struct DecodedChunk {
+        size_t index = static_cast<size_t>(-1);
+        uint32_t rows = 0;
+        std::vector<double> values;    // values[c * rows + r]
+        uint64_t used = 0;
+    };
+    std::array<DecodedChunk, 2> cache_;
+    uint64_t useCount_ = 0;
+
+    const DecodedChunk& chunk(size_t index);
+};
+
+#endif // FLIGHT_REPLAY_H
@@ -0,0 +1,289 @@
+#ifndef FORCE_MODEL_H
+#define FORCE_MODEL_H
+
+#include "core/atmosphere.h"
+#include "core/body.h"
+#include "core/octree.h"
+#include "core/perturbers.h"
+
+#include <glm/glm.hpp>
+#include <cmath>
+#include <tuple>
+#include <utility>
+
+/**
+ * Compile-time composed force models for the rocket integrator.
+ *
+ * Each force term is a small policy type with a single inline call
+ * operator returning an acceleration:
+ *
+ *     Vec operator()(const Vec& pos, const Vec& vel, const typename Vec::value_type& mass) const;
+ *
+ * Terms hold only the data they need, captured once per integrator step
+ * (thrust direction, Earth position, drag constants, ...). ForceModel<...>
+ * sums its terms with a fold expression, so a vehicle configuration gets a
+ * dedicated, fully inlined acceleration kernel: no virtual dispatch, no
+ * per-evaluation branching on the gravity backend or thrust state, and no
+ * code at all for terms that are not part of the model.
+ *
+ * Runtime choices (perturber set, octree or direct gravity, engine on or
+ * off, which tabulated atmosphere if any, optional J2) are resolved once
+ * per step by picking which ForceModel to build.
+ *
+ * Every term, the ForceModel sum and the RK4 steps are templates on the
+ * vector type, whose value_type is the scalar: glm::dvec3 in the
+ * simulation, DualVec3 (see core/dual.h) to carry exact derivatives
+ * through a propagation. What a term captures per step (body positions,
+ * tables, the octree) stays double.
+ */
+namespace forces {
+
+/**
+ * Newtonian gravity by direct summation over all bodies except `self`.
+ */
+struct DirectGravity {
+    const BODY_MAP* bodies;
+    const Body* self;
+    double G;
+
+    template <typename Vec>
+    Vec operator()(const Vec& pos, const Vec&, const typename Vec::value_type&) const {
+        Vec acc(0.0);
+        for (const auto& [name, body] : *bodies) {
+            if (body.get() == self) continue;
+            Vec delta = pos - body->position;
+            auto r = length(delta);
+            if (r > 1e-6) {
+                acc -= (G * body->mass / (r * r * r)) * delta;
+            }
+        }
+        return acc;
+    }
+};
+
+/**
+ * Newtonian gravity from a Barnes-Hut octree built for this frame.
+ */
+struct OctreeGravity {
+    const Octree* octree;
+    double G;
+
+    template <typename Vec>
+    Vec operator()(const Vec& pos, const Vec&, const typename Vec::value_type&) const {
+        return octree->computeAcceleration(pos, G);
+    }
+};
+
+/**
+ * Newtonian gravity from the culled perturber set: exact for near bodies,
+ * frozen far field for the rest.
+ */
+struct PerturberGravity {
+    const PerturberSet* perturbers;
+
+    template <typename Vec>
+    Vec operator()(const Vec& pos, const Vec&, const typename Vec::value_type&) const {
+        return perturbers->acceleration(pos);
+    }
+};
+
+/**
+ * Engine thrust along a fixed world-space direction.
+ * The direction is resolved from the local launch frame once per step,
+ * so the frame is not rebuilt on every RK stage.
+ */
+template <typename Force>
+struct BasicThrust {
+    Force force;  // Thrust vector in world space (N)
+
+    template <typename Vec>
+    Vec operator()(const Vec&, const Vec&, const typename Vec::value_type& mass) const {
+        return force / mass;
+    }
+};
+using Thrust = BasicThrust<glm::dvec3>;
+
+/**
+ * Drag from a tabulated atmosphere with a Mach-dependent drag coefficient.
+ * The atmosphere moves with its body, so drag acts on the velocity
+ * relative to that body rather than on the heliocentric velocity.
+ */
+struct TabulatedDrag {
+    const AtmosphereTable* atmosphere;
+    const DragTable* cd;
+    glm::dvec3 center;
+    glm::dvec3 centerVelocity;
+    double surfaceRadius;
+    double area;       // Reference area (m^2)
+
+    template <typename Vec>
+    Vec operator()(const Vec& pos, const Vec& vel, const typename Vec::value_type& mass) const {
+        auto altitude = length(pos - center) - surfaceRadius;
+        if (altitude <= 0.0 || altitude >= atmosphere->ceiling()) return Vec(0.0);
+
+        Vec airVelocity = vel - centerVelocity;
+        auto v = length(airVelocity);
+        if (v <= 0.0) return Vec(0.0);
+
+        auto rho = atmosphere->density(altitude);
+        auto mach = v / atmosphere->speedOfSound(altitude);
+        return (-0.5 * rho * cd->at(mach) * area * v / mass) * airVelocity;
+    }
+};
+
+/**
+ * Oblateness (J2) perturbation of a body whose rotation axis is `pole`.
+ * Only the correction to the point-mass term; combine with a gravity term.
+ */
+struct J2Gravity {
+    glm::dvec3 center;
+    glm::dvec3 pole;   // Unit rotation axis
+    double mu;         // G * M (m^3/s^2)
+    double j2;
+    double radius;     // Equatorial reference radius (m)
+
+    template <typename Vec>
+    Vec operator()(const Vec& pos, const Vec&, const typename Vec::value_type&) const {
+        using std::sqrt;
+        Vec r = pos - center;
+        auto r2 = dot(r, r);
+        if (r2 < radius * radius * 1e-6) return Vec(0.0);
+
+        auto rn = sqrt(r2);
+        auto z = dot(r, pole);
+        auto z2r2 = (z * z) / r2;
+        auto k = 1.5 * j2 * mu * radius * radius / (r2 * r2 * rn);
+        return k * ((5.0 * z2r2 - 1.0) * r - 2.0 * z * pole);
+    }
+};
+
+}  // namespace forces
+
+/**
+ * Sum of force terms, evaluated as one inlined expression.
+ */
+template <typename... Terms>
+class ForceModel {
+public:
+    static_assert(sizeof...(Terms) > 0, "ForceModel needs at least one term");
+
+    explicit ForceModel(Terms... terms) : terms_(std::move(terms)...) {}
+
+    template <typename Vec>
+    Vec operator()(const Vec& pos, const Vec& vel, const typename Vec::value_type& mass) const {
+        return std::apply([&](const Terms&... term) {
+            return (term(pos, vel, mass) + ...);
+        }, terms_);
+    }
+
+private:
+    std::tuple<Terms...> terms_;
+};
+
+template <typename... Terms>
+ForceModel<Terms...> makeForceModel(Terms... terms) {
+    return ForceModel<Terms...>(std::move(terms)...);
+}
+
+/**
+ * State derivative for the classic RK4 step below.
+ */
+template <typename Vec>
+struct BasicPhaseState {
+    Vec position;
+    Vec velocity;
+};
+using PhaseState = BasicPhaseState<glm::dvec3>;
+
+/**
+ * One classic Runge-Kutta 4 step with constant mass, specialized for the
+ * given acceleration functor (typically a ForceModel).
+ */
+template <typename Accel, typename Vec>
+inline BasicPhaseState<Vec> rk4Step(const Accel& accel, const BasicPhaseState<Vec>& s,
+                                    const typename Vec::value_type& mass, const typename Vec::value_type& h) {
+    using Scalar = typename Vec::value_type;
+    const Scalar half = 0.5 * h;
+
+    Vec a1 = accel(s.position, s.velocity, mass);
+    Vec v1 = s.velocity;
+
+    Vec v2 = s.velocity + a1 * half;
+    Vec a2 = accel(s.position + v1 * half, v2, mass);
+
+    Vec v3 = s.velocity + a2 * half;
+    Vec a3 = accel(s.position + v2 * half, v3, mass);
+
+    Vec v4 = s.velocity + a3 * h;
+    Vec a4 = accel(s.position + v3 * h, v4, mass);
+
+    BasicPhaseState<Vec> out;
+    out.position = s.position + (v1 + 2.0 * v2 + 2.0 * v3 + v4) * (h / 6.0);
+    out.velocity = s.velocity + (a1 + 2.0 * a2 + 2.0 * a3 + a4) * (h / 6.0);
+    return out;
+}
+
+/**
+ * Engine output at one point of a burn: thrust vector (N) and propellant
+ * mass flow (kg/s).
+ */
+template <typename Vec>
+struct BasicEngineOutput {
+    Vec force;
+    typename Vec::value_type massFlow;
+};
+using EngineOutput = BasicEngineOutput<glm::dvec3>;
+
+/**
+ * Phase state plus vehicle mass, for burns.
+ */
+template <typename Vec>
+struct BasicBurnState {
+    Vec position;
+    Vec velocity;
+    typename Vec::value_type mass;
+};
+using BurnState = BasicBurnState<glm::dvec3>;
+
+/**
+ * One classic Runge-Kutta 4 step of a burn, with mass as an integrated
+ * state variable (dm/dt = -massFlow) instead of being held at its start
+ * value. The engine is called as engine(pos, vel, t), t the time since the
+ * start of the step, so thrust and mass flow can follow a curve or a
+ * guidance program within the step; accel is the rest of the force model.
+ */
+template <typename Accel, typename Engine, typename Vec>
+inline BasicBurnState<Vec> rk4BurnStep(const Accel& accel, const Engine& engine, const BasicBurnState<Vec>& s,
+                                       const typename Vec::value_type& h) {
+    using Scalar = typename Vec::value_type;
+    const Scalar half = 0.5 * h;
+    auto derivative = [&](const Vec& pos, const Vec& vel, const Scalar& mass, const Scalar& t,
+                          Vec& acc, Scalar& dm) {
+        auto out = engine(pos, vel, t);
+        acc = accel(pos, vel, mass) + out.force / mass;
+        dm = -out.massFlow;
+    };
+
+    Vec a1, a2, a3, a4;
+    Scalar m1, m2, m3, m4;
+
+    Vec v1 = s.velocity;
+    derivative(s.position, v1, s.mass, Scalar(0.0), a1, m1);
+
+    Vec v2 = s.velocity + a1 * half;
+    derivative(s.position + v1 * half, v2, s.mass + m1 * half, half, a2, m2);
+
+    Vec v3 = s.velocity + a2 * half;
+    derivative(s.position + v2 * half, v3, s.mass + m2 * half, half, a3, m3);
+
+    Vec v4 = s.velocity + a3 * h;
+    derivative(s.position + v3 * h, v4, s.mass + m3 * h, h, a4, m4);
+
+    BasicBurnState<Vec> out;
+    out.position = s.position + (v1 + 2.0 * v2 + 2.0 * v3 + v4) * (h / 6.0);
+    out.velocity = s.velocity + (a1 + 2.0 * a2 + 2.0 * a3 + a4) * (h / 6.0);
+    out.mass = s.mass + (m1 + 2.0 * m2 + 2.0 * m3 + m4) * (h / 6.0);
+    return out;
+}
+
+#endif // FORCE_MODEL_H
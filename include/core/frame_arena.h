@@ -0,0 +1,88 @@
+#ifndef FRAME_ARENA_H
+#define FRAME_ARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <vector>
+
+/**
+ * Monotonic allocator for data that lives for one physics frame.
+ *
+ * allocate() bumps a pointer through one block; nothing is freed until
+ * reset() at the start of the next frame hands the whole block back. A
+ * frame that outgrows the block spills into extra blocks, and the next
+ * reset() replaces them all with one block as large as that frame needed,
+ * so after the first few frames the arena stops touching the heap.
+ *
+ * Not thread-safe: one arena per thread, or per frame task.
+ */
+class FrameArena {
+public:
+    explicit FrameArena(size_t initialCapacity = 64 * 1024);
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    void* allocate(size_t bytes, size_t alignment = alignof(std::max_align_t));
+
+    template <typename T>
+    T* allocateArray(size_t count) {
+        return static_cast<T*>(allocate(count * sizeof(T), alignof(T)));
+    }
+
+    // Release everything allocated since the last reset
+    void reset();
+
+    size_t used() const { return used_; }           // Bytes taken since the last reset, alignment slack included
+    size_t capacity() const { return capacity_; }   // Size of the main block
+    size_t highWater() const { return highWater_; } // Largest frame seen, in bytes
+
+private:
+    struct Block {
+        std::unique_ptr<unsigned char[]> data;
+        size_t size = 0;
+    };
+
+    std::unique_ptr<unsigned char[]> block_;
+    size_t capacity_;
+    size_t offset_ = 0;
+    std::vector<Block> overflow_;   // Spill blocks of the current frame
+    size_t overflowOffset_ = 0;     // Into overflow_.back()
+    size_t used_ = 0;
+    size_t highWater_ = 0;
+
+    static void* alignInto(unsigned char* base, size_t size, size_t& offset, size_t bytes, size_t alignment);
+};
+
+/**
+ * Standard allocator over a FrameArena, for containers scoped to a frame.
+ * Deallocation is a no-op; the memory comes back at the arena's reset().
+ */
+template <typename T>
+class ArenaAllocator {
+public:
+    using value_type = T;
+
+    explicit ArenaAllocator(FrameArena& arena) noexcept : arena_(&arena) {}
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) noexcept : arena_(other.arena()) {}
+
+    T* allocate(size_t count) { return arena_->allocateArray<T>(count); }
+    void deallocate(T*, size_t) noexcept {}
+
+    FrameArena* arena() const noexcept { return arena_; }
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>& other) const noexcept { return arena_ == other.arena(); }
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U>& other) const noexcept { return arena_ != other.arena(); }
+
+private:
+    FrameArena* arena_;
+};
+
+template <typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+#endif // FRAME_ARENA_H
@@ -0,0 +1,184 @@
+#ifndef JOB_SYSTEM_H
+#define JOB_SYSTEM_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Completion count for a group of jobs. submit() counts a job in before
+ * queueing it and out after it ran, so a job may submit more work into
+ * the same counter without it reaching zero in between. The first
+ * exception thrown by a job is kept and rethrown by JobSystem::wait.
+ */
+class JobCounter {
+public:
+    bool done() const { return pending_.load(std::memory_order_acquire) == 0; }
+
+private:
+    friend class JobSystem;
+    std::atomic<int> pending_{0};
+    std::mutex errorMutex_;
+    std::exception_ptr error_;
+};
+
+/**
+ * Work-stealing thread pool shared by every parallel feature (the frame
+ * task graph, Verlet accelerations, the porkchop planner).
+ *
+ * Each worker owns a deque: it pushes and pops its own work at the back
+ * (newest first, still hot in cache) and steals from the front of the
+ * others' when it runs dry. Threads outside the pool submit into a shared
+ * injection deque that the workers steal from as well. A thread waiting on
+ * a counter runs queued jobs instead of blocking, so waiting from inside a
+ * job (nested parallelFor) cannot deadlock, and a system with no workers
+ * simply runs everything on the waiting thread.
+ */
+class JobSystem {
+public:
+    using Job = std::function<void()>;
+
+    /**
+     * @param threads Threads doing work, counting the one that waits; 0 uses
+     *                every hardware thread, 1 runs all jobs on the waiter
+     */
+    explicit JobSystem(unsigned threads = 0);
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    unsigned workerCount() const { return static_cast<unsigned>(workers_.size()); }
+    unsigned concurrency() const { return workerCount() + 1; }   // Workers plus the waiter
+
+    void submit(Job job, JobCounter& counter);
+
+    // Run queued jobs until the counter drains; rethrows a job's exception
+    void wait(JobCounter& counter);
+
+    /**
+     * Call fn(first, last) over [begin, end) in chunks of at least `grain`
+     * indices, and return when all of them are done. Chunks are split to
+     * about four per thread so stealing can even out uneven work.
+     */
+    template <typename Fn>
+    void parallelFor(size_t begin, size_t end, size_t grain, Fn&& fn);
+
+private:
+    /**
+     * Double-ended ring over retained slots. std::deque frees its blocks as
+     * it drains and allocates them again on the next burst; the ring only
+     * grows, so once it has held a frame's worth of jobs queueing is free.
+     */
+    class JobRing {
+    public:
+        using Entry = std::pair<Job, JobCounter*>;
+
+        bool empty() const { return size_ == 0; }
+        void push_back(Job job, JobCounter* counter);
+        Entry pop_back();
+        Entry pop_front();
+
+    private:
+        std::vector<Entry> slots_;
+        size_t head_ = 0;
+        size_t size_ = 0;
+
+        Entry take(size_t slot);
+    };
+
+    struct Queue {
+        std::mutex mutex;
+        JobRing jobs;
+    };
+
+    // queues_[0] is the injection queue, queues_[i + 1] belongs to workers_[i]
+    std::vector<std::unique_ptr<Queue>> queues_;
+    std::vector<std::thread> workers_;
+
+    std::atomic<bool> stop_{false};
+    std::atomic<size_t> queued_{0};   // Jobs sitting in any queue
+    std::mutex sleepMutex_;
+    std::condition_variable wake_;
+
+    size_t ownQueue() const;          // Calling thread's queue
+    bool tryRun(size_t home);         // Pop from home, else steal; false if all queues were empty
+    void execute(Job& job, JobCounter& counter);
+    void workerLoop(size_t home);
+};
+
+template <typename Fn>
+void JobSystem::parallelFor(size_t begin, size_t end, size_t grain, Fn&& fn) {
+    if (begin >= end) {
+        return;
+    }
+    const size_t count = end - begin;
+    const size_t chunk = std::max<size_t>(std::max<size_t>(grain, 1), count / (4 * concurrency()) + 1);
+    if (chunk >= count || workers_.empty()) {
+        fn(begin, end);
+        return;
+    }
+
+    JobCounter counter;
+    // Chunk jobs capture two words, which std::function keeps inline
+    auto runChunk = [&fn, end, chunk](size_t first) { fn(first, std::min(end, first + chunk)); };
+    // The first chunk runs here; the rest are up for grabs
+    for (size_t first = begin + chunk; first < end; first += chunk) {
+        submit([&runChunk, first]() { runChunk(first); }, counter);
+    }
+    fn(begin, std::min(end, begin + chunk));
+    wait(counter);
+}
+
+/**
+ * Stages with dependencies, run on a JobSystem. Each task starts as soon as
+ * everything it depends on has finished, so independent stages overlap.
+ * Build the graph once and run() it as often as needed; tasks read their
+ * inputs through captured state.
+ */
+class TaskGraph {
+public:
+    using TaskId = size_t;
+
+    TaskId add(std::string name, std::function<void()> fn);
+    void precede(TaskId before, TaskId after);          // `after` waits for `before`
+    void dependsOn(TaskId task, std::initializer_list<TaskId> before);
+
+    /**
+     * Run every task once and return when all have finished. Without a job
+     * system the tasks run on the calling thread in dependency order.
+     * @throws std::logic_error if the dependencies form a cycle
+     */
+    void run(JobSystem* jobs);
+
+    size_t size() const { return tasks_.size(); }
+    bool empty() const { return tasks_.empty(); }
+    const std::string& name(TaskId task) const { return tasks_[task].name; }
+
+private:
+    struct Task {
+        std::string name;
+        std::function<void()> fn;
+        std::vector<TaskId> successors;
+        int dependencies = 0;
+    };
+    std::vector<Task> tasks_;
+    std::vector<TaskId> order_;                       // Topological order, for the serial run
+    std::unique_ptr<std::atomic<int>[]> remaining_;   // Per run: unfinished dependencies
+    size_t remainingSize_ = 0;                        // Tasks order_ and remaining_ were made for
+    JobSystem* jobs_ = nullptr;                       // During a parallel run
+    JobCounter* counter_ = nullptr;
+
+    std::vector<TaskId> order() const;   // Topological order, throws on a cycle
+    void launch(TaskId task);
+};
+
+#endif // JOB_SYSTEM_H
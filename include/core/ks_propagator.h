@@ -0,0 +1,160 @@
+#ifndef KS_PROPAGATOR_H
+#define KS_PROPAGATOR_H
+
+#include "core/force_model.h"
+
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <cmath>
+
+/**
+ * Kustaanheimo-Stiefel regularized propagation around a central body.
+ *
+ * The relative position x (3D) is replaced by u (4D) with x = L(u) u and
+ * r = |u|^2, and time by the fictitious time s with dt = r ds. The Kepler
+ * problem becomes a harmonic oscillator,
+ *
+ *   u'' = (E / 2) u + (r / 2) L(u)^T P,    E' = 2 u' . L(u)^T P,    t' = r
+ *
+ * (E the specific Kepler energy, P the perturbing acceleration), with no
+ * singularity at r = 0. A fixed step in s is a fixed step in eccentric
+ * anomaly, so RK4 takes small physical steps near periapsis and large
+ * ones near apoapsis automatically and the error per step is uniform.
+ * Eccentric orbits and close flybys then need a fraction of the steps a
+ * fixed-step Cowell integrator needs to stay stable at periapsis.
+ */
+class KsPropagator {
+public:
+    /**
+     * @param mu G * M of the central body (m^3/s^2)
+     * @param anomalyStep Eccentric anomaly advanced per step (rad)
+     */
+    KsPropagator(double mu, double anomalyStep) : mu_(mu), anomalyStep_(anomalyStep) {}
+
+    /**
+     * Propagate a central-body-relative state by dt seconds. The
+     * perturbation (everything except the central point mass) is called
+     * as perturbation(relativePosition, relativeVelocity, mass).
+     */
+    template <typename Perturbation>
+    PhaseState propagate(const PhaseState& s, double dt, const Perturbation& perturbation, double mass) {
+        return propagate(s, dt, perturbation, mass, [](const PhaseState&, double) {});
+    }
+
+    /**
+     * As above, calling onStep(relativeState, stepTime) for each RK4 step
+     * with the state it starts from and the physical time it covers, so
+     * that quantities integrated alongside can follow the same schedule.
+     */
+    template <typename Perturbation, typename OnStep>
+    PhaseState propagate(const PhaseState& s, double dt, const Perturbation& perturbation, double mass, OnStep&& onStep);
+
+    // RK4 steps taken by the last propagate()
+    int steps() const { return steps_; }
+
+private:
+    struct State {
+        glm::dvec4 u;
+        glm::dvec4 w;          // du/ds
+        double energy;         // Specific Kepler energy v^2/2 - mu/r
+        double time;
+    };
+
+    struct Derivative {
+        glm::dvec4 du;
+        glm::dvec4 dw;
+        double denergy;
+        double dtime;
+    };
+
+    double mu_;
+    double anomalyStep_;
+    int steps_ = 0;
+
+    State toKs(const PhaseState& s) const;
+    PhaseState fromKs(const State& k) const;
+
+    template <typename Perturbation>
+    Derivative derivative(const State& k, const Perturbation& perturbation, double mass) const;
+
+    template <typename Perturbation>
+    State step(const State& k, double ds, const Perturbation& perturbation, double mass) const;
+};
+
+// KS matrix products: L(u) w and L(u)^T w
+glm::dvec4 ksL(const glm::dvec4& u, const glm::dvec4& w);
+glm::dvec4 ksLT(const glm::dvec4& u, const glm::dvec4& w);
+
+template <typename Perturbation>
+KsPropagator::Derivative KsPropagator::derivative(const State& k, const Perturbation& perturbation, double mass) const {
+    double r = glm::dot(k.u, k.u);
+    glm::dvec4 x = ksL(k.u, k.u);
+    glm::dvec4 v = ksL(k.u, k.w) * (2.0 / r);
+    glm::dvec3 p = perturbation(glm::dvec3(x), glm::dvec3(v), mass);
+    glm::dvec4 ltp = ksLT(k.u, glm::dvec4(p, 0.0));
+
+    Derivative d;
+    d.du = k.w;
+    d.dw = (0.5 * k.energy) * k.u + (0.5 * r) * ltp;
+    d.denergy = 2.0 * glm::dot(k.w, ltp);
+    d.dtime = r;
+    return d;
+}
+
+template <typename Perturbation>
+KsPropagator::State KsPropagator::step(const State& k, double ds, const Perturbation& perturbation, double mass) const {
+    auto advance = [](const State& s, const Derivative& d, double h) {
+        return State{s.u + d.du * h, s.w + d.dw * h, s.energy + d.denergy * h, s.time + d.dtime * h};
+    };
+    const double half = 0.5 * ds;
+    Derivative k1 = derivative(k, perturbation, mass);
+    Derivative k2 = derivative(advance(k, k1, half), perturbation, mass);
+    Derivative k3 = derivative(advance(k, k2, half), perturbation, mass);
+    Derivative k4 = derivative(advance(k, k3, ds), perturbation, mass);
+
+    const double sixth = ds / 6.0;
+    return State{
+        k.u + (k1.du + 2.0 * k2.du + 2.0 * k3.du + k4.du) * sixth,
+        k.w + (k1.dw + 2.0 * k2.dw + 2.0 * k3.dw + k4.dw) * sixth,
+        k.energy + (k1.denergy + 2.0 * k2.denergy + 2.0 * k3.denergy + k4.denergy) * sixth,
+        k.time + (k1.dtime + 2.0 * k2.dtime + 2.0 * k3.dtime + k4.dtime) * sixth};
+}
+
+template <typename Perturbation, typename OnStep>
+PhaseState KsPropagator::propagate(const PhaseState& s, double dt, const Perturbation& perturbation, double mass, OnStep&& onStep) {
+    steps_ = 0;
+    if (dt <= 0.0 || glm::length(s.position) <= 0.0) {
+        return s;
+    }
+
+    State k = toKs(s);
+    auto advance = [&](double ds) {
+        State next = step(k, ds, perturbation, mass);
+        onStep(fromKs(k), next.time - k.time);
+        k = next;
+        ++steps_;
+    };
+    const int maxSteps = 100000;
+    while (k.time < dt && steps_ < maxSteps) {
+        double r = glm::dot(k.u, k.u);
+        // Frequency of the oscillator is sqrt(-E/2); guard the near-parabolic case
+        double omega2 = std::max(std::abs(k.energy), 1e-6 * mu_ / r);
+        double ds = anomalyStep_ / std::sqrt(2.0 * omega2);
+        if (k.time + r * ds >= dt) {
+            break;
+        }
+        advance(ds);
+    }
+
+    // Land on dt: t' = r, so a few corrective steps converge quickly
+    for (int i = 0; i < 3 && k.time != dt; ++i) {
+        double ds = (dt - k.time) / glm::dot(k.u, k.u);
+        advance(ds);
+    }
+
+    PhaseState out = fromKs(k);
+    out.position += out.velocity * (dt - k.time);
+    return out;
+}
+
+#endif // KS_PROPAGATOR_H
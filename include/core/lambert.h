@@ -0,0 +1,37 @@
+#ifndef LAMBERT_H
+#define LAMBERT_H
+
+#include <glm/glm.hpp>
+#include <vector>
+
+/**
+ * Lambert's problem: the conic that connects two positions around a
+ * central body in a given time of flight.
+ *
+ * Izzo's formulation ("Revisiting Lambert's problem", 2015): the time of
+ * flight is written as a function of one variable x on which a third-order
+ * Householder iteration converges in two or three steps from a good initial
+ * guess, for every transfer type (elliptic, parabolic, hyperbolic) and any
+ * number of complete revolutions.
+ */
+struct LambertSolution {
+    glm::dvec3 departureVelocity;
+    glm::dvec3 arrivalVelocity;
+    int revolutions = 0;
+    bool lowPath = true;      // Which of the two multi-revolution branches (Izzo's low path: the larger x)
+};
+
+/**
+ * All transfers from r1 to r2 in tof seconds with up to maxRevolutions
+ * complete revolutions: one with zero revolutions, then two for each
+ * feasible revolution count. Empty if there is none (r1 == r2, tof <= 0,
+ * no convergence).
+ *
+ * @param mu G * M of the central body (m^3/s^2)
+ * @param pole Sense of motion: transfers are prograde about this axis,
+ *             which also fixes the plane of a 180-degree transfer
+ */
+std::vector<LambertSolution> solveLambert(const glm::dvec3& r1, const glm::dvec3& r2, double tof, double mu,
+                                          const glm::dvec3& pole, int maxRevolutions = 0);
+
+#endif // LAMBERT_H
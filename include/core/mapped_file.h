@@ -0,0 +1,35 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * A whole file mapped read-only into memory. Pages are read in by the OS
+ * on first touch, so opening a large file costs nothing up front and
+ * random access costs only the pages it reaches.
+ */
+class MappedFile {
+public:
+    MappedFile() = default;
+    // @throws std::runtime_error if the file cannot be opened or mapped
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    const uint8_t* data_ = nullptr;   // Null for an empty file
+    size_t size_ = 0;
+
+    void release();
+};
+
+#endif // MAPPED_FILE_H
@@ -0,0 +1,86 @@
+#ifndef MPSC_QUEUE_H
+#define MPSC_QUEUE_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+/**
+ * Bounded lock-free queue for any number of producer threads and one
+ * consumer. Each slot carries a sequence number that tells producers and
+ * the consumer whose turn it is, so producers claim slots with a single
+ * compare-exchange and never wait on each other's copies. push() fails
+ * instead of blocking when the queue is full.
+ */
+template <typename T, size_t Capacity>
+class MpscQueue {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "capacity must be a power of two");
+
+public:
+    MpscQueue() {
+        for (size_t i = 0; i < Capacity; ++i) {
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    // Producer side, any thread
+    template <typename Fill>
+    bool emplace(Fill&& fill) {
+        size_t head = head_.load(std::memory_order_relaxed);
+        while (true) {
+            Slot& slot = slots_[head & (Capacity - 1)];
+            size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            if (sequence == head) {
+                if (head_.compare_exchange_weak(head, head + 1, std::memory_order_relaxed)) {
+                    fill(slot.value);
+                    slot.sequence.store(head + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (sequence < head) {
+                return false;   // The consumer has not freed this slot yet: full
+            } else {
+                head = head_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool push(const T& value) {
+        return emplace([&value](T& slot) { slot = value; });
+    }
+
+    // Slots claimed so far, filled or not: every emplace() that has returned
+    // true is below this position
+    size_t claimed() const { return head_.load(std::memory_order_acquire); }
+
+    // Consumer side, one thread
+    bool pop(T& value) {
+        Slot& slot = slots_[tail_ & (Capacity - 1)];
+        if (slot.sequence.load(std::memory_order_acquire) != tail_ + 1) {
+            return false;
+        }
+        value = std::move(slot.value);
+        slot.sequence.store(tail_ + Capacity, std::memory_order_release);
+        ++tail_;
+        return true;
+    }
+
+    // Whether pop() would succeed
+    bool readable() const {
+        return slots_[tail_ & (Capacity - 1)].sequence.load(std::memory_order_acquire) == tail_ + 1;
+    }
+
+private:
+    struct Slot {
+        std::atomic<size_t> sequence;
+        T value{};
+    };
+    std::array<Slot, Capacity> slots_;
+    alignas(64) std::atomic<size_t> head_{0};   // Next slot to claim
+    alignas(64) size_t tail_ = 0;               // Next slot to read (consumer only)
+};
+
+#endif // MPSC_QUEUE_H
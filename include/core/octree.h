@@ -5,8 +5,12 @@
 #include <vector>
 #include <memory>
 #include <array>
+#include <cmath>
 #include <string>
 
+class JobSystem;
+class OctreeNodePool;
+
 /**
  * Barnes-Hut Octree for efficient N-body gravitational force calculation.
  *
@@ -80,14 +84,39 @@ struct OctreeBounds {
  */
 class OctreeNode {
 public:
-    OctreeNode(const OctreeBounds& bounds);
-    ~OctreeNode() = default;
+    /**
+     * @param bounds Region this node covers
+     * @param pool Where subdivisions take their children from; nullptr gives
+     *             the node a pool of its own on first subdivision
+     */
+    explicit OctreeNode(const OctreeBounds& bounds, OctreeNodePool* pool = nullptr);
+    OctreeNode() = default;
+    ~OctreeNode();
+
+    OctreeNode(const OctreeNode&) = delete;
+    OctreeNode& operator=(const OctreeNode&) = delete;
+
+    /**
+     * Empty this node for reuse over `bounds`. Its children, if any, stay in
+     * their pool to be handed out again once the pool is reset.
+     */
+    void reset(const OctreeBounds& bounds, int depth, OctreeNodePool* pool);
     
     /**
      * Insert a body into this node.
      * If the node already contains a body, it will subdivide.
      */
     void insert(const OctreeBody& body);
+
+    /**
+     * Insert all of `bodies` into this empty node, building the eight
+     * subtrees in parallel. The tree is identical, bit for bit, to inserting
+     * them one by one in order: this node folds its aggregate in index
+     * order and each octant receives its bodies in index order. Each
+     * octant's subtree draws from its own pool so the inserts never share one.
+     */
+    void insertAll(const std::vector<OctreeBody>& bodies, JobSystem& jobs,
+                   std::array<OctreeNodePool, 8>& octantPools);
     
     /**
      * Calculate gravitational acceleration on a body at the given position
@@ -97,10 +126,11 @@ public:
      * @param theta Opening angle parameter (0 = exact, 0.5 = typical)
      * @param G Gravitational constant
      * @param softening Softening length to prevent singularities
-     * @return Gravitational acceleration vector
+     * @return Gravitational acceleration vector; a template on the vector
+     *         type, like the force terms (force_model.h)
      */
-    glm::dvec3 computeAcceleration(const glm::dvec3& position, double theta, 
-                                   double G, double softening = 1e-6) const;
+    template <typename Vec>
+    Vec computeAcceleration(const Vec& position, double theta, double G, double softening = 1e-6) const;
     
     // Accessors for testing
     bool isEmpty() const { return !hasBody_ && !isInternal_; }
@@ -129,8 +159,10 @@ private:
     bool isInternal_ = false;      // True if this node has been subdivided
     OctreeBody body_;              // The body stored in this leaf (only valid if hasBody_)
     
-    // Children (8 octants), only allocated when subdivided
-    std::array<std::unique_ptr<OctreeNode>, 8> children_;
+    // Children (8 contiguous octants from pool_), only set when subdivided
+    OctreeNode* children_ = nullptr;
+    OctreeNodePool* pool_ = nullptr;
+    std::unique_ptr<OctreeNodePool> ownedPool_;
     
     /**
      * Determine which octant a position falls into.
@@ -151,8 +183,26 @@ private:
     // when two bodies are at the exact same position
     static constexpr int MAX_DEPTH = 40;
     int depth_ = 0;
-    
-    void setDepth(int d) { depth_ = d; }
+};
+
+/**
+ * Storage for octree nodes, eight siblings at a time. The octree is rebuilt
+ * every frame; the pool keeps every block it has handed out, so once it has
+ * grown to the largest tree seen a rebuild allocates nothing.
+ */
+class OctreeNodePool {
+public:
+    // Eight contiguous nodes, valid until the pool is destroyed
+    OctreeNode* acquireOctants();
+
+    // Take back every block for the next build
+    void reset() { used_ = 0; }
+
+    size_t blockCount() const { return blocks_.size(); }
+
+private:
+    std::vector<std::unique_ptr<std::array<OctreeNode, 8>>> blocks_;
+    size_t used_ = 0;
 };
 
 /**
@@ -171,11 +221,14 @@ public:
     
     /**
      * Build the octree from a collection of bodies.
-     * This rebuilds the tree from scratch each time.
+     * This rebuilds the tree from scratch each time. With a job system,
+     * large body sets are built in parallel; the result does not depend on
+     * whether or on how many threads.
      *
      * @param bodies Vector of bodies to insert
+     * @param jobs Optional worker pool
      */
-    void build(const std::vector<OctreeBody>& bodies);
+    void build(const std::vector<OctreeBody>& bodies, JobSystem* jobs = nullptr);
     
     /**
      * Calculate gravitational acceleration on a body at the given position.
@@ -184,7 +237,13 @@ public:
      * @param G Gravitational constant
      * @return Gravitational acceleration vector
      */
-    glm::dvec3 computeAcceleration(const glm::dvec3& position, double G) const;
+    template <typename Vec>
+    Vec computeAcceleration(const Vec& position, double G) const {
+        if (!built_) {
+            return Vec(0.0);
+        }
+        return root_->computeAcceleration(position, theta_, G);
+    }
     
     /**
      * Set the opening angle parameter.
@@ -197,16 +256,73 @@ public:
      */
     int getNodeCount() const;
     int getBodyCount() const;
-    bool isBuilt() const { return root_ != nullptr; }
+    bool isBuilt() const { return built_; }
     
 private:
     float theta_;
     std::unique_ptr<OctreeNode> root_;
+    bool built_ = false;
+
+    // Node storage retained across builds; the octant pools serve the
+    // parallel build's subtrees
+    OctreeNodePool pool_;
+    std::array<OctreeNodePool, 8> octantPools_;
     
     /**
      * Calculate bounding box that contains all bodies.
      */
-    OctreeBounds computeBounds(const std::vector<OctreeBody>& bodies) const;
+    OctreeBounds computeBounds(const std::vector<OctreeBody>& bodies, JobSystem* jobs = nullptr) const;
+
+    // Below this many bodies a parallel build costs more than it saves
+    static constexpr size_t kParallelBuildMin = 2048;
 };
 
+template <typename Vec>
+Vec OctreeNode::computeAcceleration(const Vec& position, double theta, double G, double softening) const {
+    using std::sqrt;
+    if (bodyCount_ == 0) {
+        return Vec(0.0);
+    }
+    
+    Vec delta = centerOfMass_ - position;
+    auto distSq = dot(delta, delta);
+    auto dist = sqrt(distSq);
+    
+    // Skip if the query position is at the center of mass (self-interaction)
+    if (dist < softening) {
+        // For leaf nodes with one body, this means we're computing force on ourselves
+        if (isLeaf()) {
+            return Vec(0.0);
+        }
+        // For internal nodes, recurse into children to handle properly
+        if (isInternal_) {
+            Vec acc(0.0);
+            for (int i = 0; i < 8; ++i) {
+                acc += children_[i].computeAcceleration(position, theta, G, softening);
+            }
+            return acc;
+        }
+        return Vec(0.0);
+    }
+    
+    // Barnes-Hut criterion: s/d < theta
+    // where s = side length of the node, d = distance to center of mass
+    double nodeSize = bounds_.halfSize * 2.0;
+    
+    if (isLeaf() || (nodeSize / dist < theta)) {
+        // Treat this node as a single body with aggregate mass
+        // a = G * M / r^3 * delta
+        auto distCubed = distSq * dist;
+        auto factor = G * totalMass_ / distCubed;
+        return factor * delta;
+    }
+    
+    // Node is too close / too large: recurse into children
+    Vec acc(0.0);
+    for (int i = 0; i < 8; ++i) {
+        acc += children_[i].computeAcceleration(position, theta, G, softening);
+    }
+    return acc;
+}
+
 #endif // OCTREE_H
\ No newline at end of file
@@ -0,0 +1,128 @@
+#ifndef PERTURBERS_H
+#define PERTURBERS_H
+
+#include "core/body.h"
+
+#include <glm/glm.hpp>
+#include <cmath>
+#include <string>
+#include <vector>
+
+/**
+ * Adaptive selection of the bodies that matter for a vehicle's gravity.
+ *
+ * Summing every body in BODY_MAP on each force evaluation wastes most of
+ * the work: in low Earth orbit Neptune contributes ~1e-11 of the total
+ * acceleration. PerturberSet classifies bodies by their point-mass
+ * acceleration GM/r^2 at the vehicle, relative to the largest one:
+ *
+ *   - near bodies (ratio >= tolerance) are evaluated exactly, every time;
+ *   - far bodies are folded into a far-field term frozen at refresh time:
+ *     their summed acceleration at the anchor point plus the tidal tensor
+ *     (gravity gradient), so a(x) ~ a0 + T (x - anchor).
+ *
+ * The classification is refreshed periodically and whenever the vehicle
+ * has drifted far enough from the anchor that the linearized far field
+ * could lose accuracy. For cislunar flight this leaves Earth, Moon and
+ * Sun as the only exact terms.
+ */
+class PerturberSet {
+public:
+    struct Perturber {
+        const Body* body;
+        double gm;         // G * mass (m^3/s^2)
+    };
+
+    /**
+     * @param tolerance Relative acceleration below which a body is far
+     *        (0 keeps every body near, i.e. exact direct summation)
+     * @param refreshInterval Simulation seconds between reclassifications
+     * @param driftFraction Reclassify once the vehicle has moved this
+     *        fraction of the distance to the closest far body
+     */
+    explicit PerturberSet(double tolerance = 1e-7, double refreshInterval = 60.0, double driftFraction = 0.01);
+
+    /**
+     * Whether refresh() should be called: never classified, the body map
+     * changed, the refresh interval elapsed, or the vehicle left covers().
+     */
+    bool needsRefresh(const glm::dvec3& position, double time, const BODY_MAP& bodies) const;
+
+    /**
+     * Reclassify all bodies (except `self`) at `position`.
+     */
+    void refresh(const glm::dvec3& position, double time, const BODY_MAP& bodies, const Body* self, double G);
+
+    /**
+     * Whether the far-field linearization is valid at `position`.
+     */
+    bool covers(const glm::dvec3& position) const {
+        glm::dvec3 d = position - anchor_;
+        return valid_ && glm::dot(d, d) <= maxDrift_ * maxDrift_;
+    }
+
+    /**
+     * Gravitational acceleration: exact for near bodies, linearized
+     * far field for the rest. Only meaningful where covers() is true.
+     * A template on the vector type, like the force terms (force_model.h).
+     */
+    template <typename Vec>
+    Vec acceleration(const Vec& position) const {
+        using std::sqrt;
+        // The tidal tensor times the offset, column by column as glm multiplies
+        Vec d = position - anchor_;
+        Vec acc = farAcceleration_ + (farTidal_[0] * d.x + farTidal_[1] * d.y + farTidal_[2] * d.z);
+        for (const auto& p : near_) {
+            Vec delta = position - p.body->position;
+            auto r2 = dot(delta, delta);
+            if (r2 > 1e-12) {
+                auto r = sqrt(r2);
+                acc -= (p.gm / (r2 * r)) * delta;
+            }
+        }
+        return acc;
+    }
+
+    // Whether the set was classified against this body map
+    bool boundTo(const BODY_MAP& bodies) const { return valid_ && bodies_ == &bodies && bodyCount_ == bodies.size(); }
+
+    void invalidate() { valid_ = false; }
+    bool isValid() const { return valid_; }
+
+    const std::vector<Perturber>& nearBodies() const { return near_; }
+    const std::vector<std::string>& farBodies() const { return farNames_; }
+
+    void setTolerance(double tolerance) { tolerance_ = tolerance; valid_ = false; }
+    void setRefreshInterval(double interval) { refreshInterval_ = interval; }
+
+private:
+    double tolerance_;
+    double refreshInterval_;
+    double driftFraction_;
+
+    bool valid_ = false;
+    double refreshTime_ = 0.0;
+    glm::dvec3 anchor_ = glm::dvec3(0.0);
+    double maxDrift_ = 0.0;
+
+    std::vector<Perturber> near_;
+    std::vector<std::string> nearNames_;      // To detect a replaced body map
+    std::vector<std::string> farNames_;
+    const BODY_MAP* bodies_ = nullptr;
+
+    // Point-mass acceleration magnitude of each body at the vehicle; kept
+    // between refreshes so a refresh does not allocate
+    struct Candidate {
+        const std::string* name;
+        const Body* body;
+        double gm;
+        double accel;
+    };
+    std::vector<Candidate> candidates_;
+    size_t bodyCount_ = 0;
+
+    glm::dvec3 farAcceleration_ = glm::dvec3(0.0);
+    glm::dmat3 farTidal_ = glm::dmat3(0.0);
+};
+
+#endif // PERTURBERS_H
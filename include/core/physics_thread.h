@@ -0,0 +1,41 @@
+#ifndef PHYSICS_THREAD_H
+#define PHYSICS_THREAD_H
+
+#include <atomic>
+#include <thread>
+
+class SimulationCore;
+
+/**
+ * Runs SimulationCore::update on a dedicated thread at a fixed wall-clock
+ * rate, so physics cost (high time warp, long predictions) no longer holds up
+ * rendering and input. Each step is fed the wall time since the previous
+ * one, as the render loop did. Results reach the render thread only
+ * through the simulation's snapshots, and input through its command queue.
+ */
+class PhysicsThread {
+public:
+    /**
+     * @param simulation Initialized simulation; must outlive the thread
+     * @param rate Steps per second (wall clock)
+     */
+    PhysicsThread(SimulationCore& simulation, double rate);
+    ~PhysicsThread();
+
+    PhysicsThread(const PhysicsThread&) = delete;
+    PhysicsThread& operator=(const PhysicsThread&) = delete;
+
+    void start();
+    void stop();
+    bool running() const { return running_.load(std::memory_order_relaxed); }
+
+private:
+    SimulationCore& simulation_;
+    double period_;   // s
+    std::atomic<bool> running_{false};
+    std::thread thread_;
+
+    void run();
+};
+
+#endif // PHYSICS_THREAD_H
@@ -0,0 +1,66 @@
+#ifndef PORKCHOP_H
+#define PORKCHOP_H
+
+#include "core/force_model.h"
+#include "core/job_system.h"
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * Porkchop plot: transfer cost over a grid of departure and arrival dates.
+ *
+ * Both bodies follow conics about the central body from their current
+ * states (the simulation's bodies at the epoch), which is the ephemeris a
+ * mission planner uses for first-cut windows. The ephemeris is sampled
+ * once per grid row and column, so each cell costs a single Lambert
+ * solve; rows are spread over a job system.
+ */
+struct PorkchopRequest {
+    double departureStart = 0.0;      // s after the epoch
+    double departureEnd = 0.0;
+    double arrivalStart = 0.0;
+    double arrivalEnd = 0.0;
+    size_t departureSteps = 100;
+    size_t arrivalSteps = 100;
+    int maxRevolutions = 0;
+    JobSystem* jobs = nullptr;        // Shared pool; without one, a pool of `threads` for this call
+    unsigned threads = 0;             // 0: one per hardware thread
+};
+
+class Porkchop {
+public:
+    Porkchop() = default;
+    explicit Porkchop(const PorkchopRequest& request);
+
+    size_t departureSteps() const { return request_.departureSteps; }
+    size_t arrivalSteps() const { return request_.arrivalSteps; }
+    double departureTime(size_t i) const;
+    double arrivalTime(size_t j) const;
+
+    // Departure plus arrival hyperbolic excess speed (m/s); NaN where arrival
+    // is not after departure or no transfer converged
+    float deltaV(size_t i, size_t j) const { return deltaV_[j * request_.departureSteps + i]; }
+    const std::vector<float>& values() const { return deltaV_; }
+
+    // The cheapest cell; false if the grid has no transfer at all
+    bool best(size_t& i, size_t& j) const;
+
+private:
+    friend Porkchop computePorkchop(const PhaseState&, const PhaseState&, double, const PorkchopRequest&);
+
+    PorkchopRequest request_;
+    std::vector<float> deltaV_;       // Row-major, one row per arrival date
+};
+
+/**
+ * Fill the grid for a transfer between two bodies around a central body.
+ *
+ * @param departure Departure body state relative to the central body at the epoch
+ * @param arrival Arrival body state relative to the central body at the epoch
+ * @param mu G * M of the central body (m^3/s^2)
+ */
+Porkchop computePorkchop(const PhaseState& departure, const PhaseState& arrival, double mu,
+                         const PorkchopRequest& request);
+
+#endif // PORKCHOP_H
@@ -0,0 +1,140 @@
+#ifndef PROPULSION_H
+#define PROPULSION_H
+
+#include "app/config.h"
+#include "core/atmosphere.h"
+#include "core/force_model.h"
+
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * Staged rocket propulsion with tabulated engine performance.
+ *
+ * A stage's vacuum thrust is a curve over its firing time (a solid motor's
+ * grain profile, a scheduled throttle-down) and its specific impulse a
+ * curve over ambient pressure (nozzle performance from sea level to
+ * vacuum). Propellant flow follows from the vacuum point,
+ * mdot = F_vac / (g0 Isp_vac), and the delivered thrust is
+ * mdot g0 Isp(p): low in the atmosphere the engine loses thrust, not flow.
+ */
+
+constexpr double kStandardGravity = 9.80665;   // m/s^2, defines Isp in seconds
+
+/**
+ * Piecewise-linear y(x), clamped to the end values outside the samples.
+ * Curves hold a handful of points, so a lookup is a short binary search.
+ * The lookups here and below are templates on the scalar, like the
+ * atmosphere tables.
+ */
+class PerformanceCurve {
+public:
+    PerformanceCurve() = default;
+
+    // Throws ConfigError unless x is strictly increasing
+    explicit PerformanceCurve(std::vector<std::pair<double, double>> points);
+
+    bool empty() const { return points_.empty(); }
+
+    template <typename Scalar>
+    Scalar at(const Scalar& x) const {
+        if (points_.empty()) return 0.0;
+        if (x <= points_.front().first) return points_.front().second;
+        if (x >= points_.back().first) return points_.back().second;
+
+        auto upper = std::upper_bound(points_.begin(), points_.end(), x,
+            [](const Scalar& value, const std::pair<double, double>& p) { return value < p.first; });
+        const auto& b = *upper;
+        const auto& a = *(upper - 1);
+        Scalar f = (x - a.first) / (b.first - a.first);
+        return a.second + f * (b.second - a.second);
+    }
+
+private:
+    std::vector<std::pair<double, double>> points_;
+};
+
+/**
+ * One stage of the stack: its masses and engine performance.
+ */
+class PropulsionStage {
+public:
+    PropulsionStage() = default;
+
+    /**
+     * Build from config. Throws ConfigError on negative masses, a missing
+     * or non-positive Isp, negative thrust or an unsorted curve.
+     */
+    explicit PropulsionStage(const RocketStageConfig& config);
+
+    /**
+     * A stage with a constant exhaust velocity and no thrust curve, which
+     * delivers whatever the flight plan commands (the single-stage rocket).
+     */
+    static PropulsionStage constant(double propellantMass, double exhaustVelocity);
+
+    const std::string& name() const { return name_; }
+    double dryMass() const { return dryMass_; }
+    double propellantMass() const { return propellantMass_; }
+
+    /**
+     * Vacuum thrust (N) for a commanded thrust after burnTime seconds of
+     * firing: the command, limited by the thrust curve if there is one.
+     */
+    template <typename Scalar>
+    Scalar vacuumThrust(const Scalar& burnTime, const Scalar& commanded) const {
+        if (commanded <= 0.0) return 0.0;
+        if (thrust_.empty()) return commanded;
+        Scalar limit = thrust_.at(burnTime);
+        return limit < commanded ? limit : commanded;
+    }
+
+    template <typename Scalar>
+    Scalar isp(const Scalar& pressure) const { return isp_.at(pressure); }
+    double vacuumIsp() const { return vacuumIsp_; }
+
+private:
+    std::string name_;
+    double dryMass_ = 0.0;
+    double propellantMass_ = 0.0;
+    PerformanceCurve thrust_;      // Empty: as commanded
+    PerformanceCurve isp_;
+    double vacuumIsp_ = 0.0;
+};
+
+/**
+ * The active stage's engine over one integrator step, in the form
+ * rk4BurnStep expects. Direction and back-pressure atmosphere are fixed
+ * per step; firing time and ambient pressure vary within it. A template
+ * on the vector type like the force terms (force_model.h).
+ */
+template <typename Vec>
+struct BasicStageEngine {
+    using Scalar = typename Vec::value_type;
+
+    const PropulsionStage* stage;
+    Vec direction;                        // Unit thrust direction in world space
+    Scalar commanded;                     // Flight-plan thrust (N)
+    double burnTime;                      // Stage firing time at the start of the step (s)
+    const AtmosphereTable* atmosphere;    // nullptr: vacuum
+    glm::dvec3 center;
+    double surfaceRadius;
+
+    BasicEngineOutput<Vec> operator()(const Vec& pos, const Vec&, const Scalar& t) const {
+        return output(pos, t, commanded, direction);
+    }
+
+    // The same for a command and direction that change within the step (guidance)
+    BasicEngineOutput<Vec> output(const Vec& pos, const Scalar& t, const Scalar& thrust, const Vec& dir) const {
+        Scalar vacuum = stage->vacuumThrust(burnTime + t, thrust);
+        Scalar massFlow = vacuum / (kStandardGravity * stage->vacuumIsp());
+        Scalar pressure = atmosphere ? atmosphere->pressure(length(pos - center) - surfaceRadius) : Scalar(0.0);
+        return {(massFlow * kStandardGravity * stage->isp(pressure)) * dir, massFlow};
+    }
+};
+using StageEngine = BasicStageEngine<glm::dvec3>;
+
+#endif // PROPULSION_H
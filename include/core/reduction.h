@@ -0,0 +1,67 @@
+#ifndef REDUCTION_H
+#define REDUCTION_H
+
+#include "core/job_system.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+/**
+ * Parallel reduction whose result does not depend on the thread count.
+ *
+ * [0, count) is cut into blocks of `block` indices, each folded in index
+ * order into a partial; the partials are then combined pairwise in a
+ * fixed binary tree, ((p0 + p1) + (p2 + p3)) + ... Which values meet and
+ * in what order depends only on count and block, never on which thread
+ * ran a block, so floating-point results are bit-identical for any number
+ * of workers, and without a job system.
+ *
+ * @param fold    fold(T& partial, size_t index)
+ * @param combine T combine(const T& left, const T& right)
+ */
+template <typename T, typename Fold, typename Combine>
+T deterministicReduce(JobSystem* jobs, size_t count, size_t block, const T& identity,
+                      Fold&& fold, Combine&& combine) {
+    if (count == 0) {
+        return identity;
+    }
+    block = block ? block : 1;
+    const size_t blocks = (count + block - 1) / block;
+    if (blocks == 1) {
+        // One block is one partial: nothing to combine and nothing to allocate
+        T partial = identity;
+        for (size_t i = 0; i < count; ++i) {
+            fold(partial, i);
+        }
+        return partial;
+    }
+
+    std::vector<T> partials(blocks, identity);
+    auto foldBlocks = [&](size_t first, size_t last) {
+        for (size_t b = first; b < last; ++b) {
+            const size_t end = std::min(count, (b + 1) * block);
+            for (size_t i = b * block; i < end; ++i) {
+                fold(partials[b], i);
+            }
+        }
+    };
+    if (jobs) {
+        jobs->parallelFor(0, blocks, 1, foldBlocks);
+    } else {
+        foldBlocks(0, blocks);
+    }
+
+    // Pairwise, level by level; an odd partial moves up unchanged
+    for (size_t n = blocks; n > 1; n = (n + 1) / 2) {
+        for (size_t k = 0; k < n / 2; ++k) {
+            partials[k] = combine(partials[2 * k], partials[2 * k + 1]);
+        }
+        if (n % 2) {
+            partials[n / 2] = partials[n - 1];
+        }
+    }
+    return partials[0];
+}
+
+#endif // REDUCTION_H
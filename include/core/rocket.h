@@ -5,13 +5,20 @@
 
 #include "body.h"
 #include "app/config.h"
+#include "core/atmosphere.h"
+#include "core/body_tree.h"
+#include "core/checkpoint.h"
+#include "core/covariance.h"
+#include "core/dual.h"
+#include "core/encke.h"
+#include "core/event_detector.h"
 #include "core/flight_plan.h"
+#include "core/ks_propagator.h"
 #include "core/octree.h"
+#include "core/perturbers.h"
+#include "core/propulsion.h"
+#include "core/snapshot.h"
 #include "logging/logger.h"
-#include "rendering/shader.h"
-#include "rendering/render_object.h"
-#include "rendering/trajectory.h"
-#include "rendering/trajectory_factory.h"
 
 #include <glm/ext.hpp>
 #include <glm/glm.hpp>
@@ -21,12 +28,18 @@
 #include <vector>
 #include <unordered_map>
 
+/**
+ * Rocket - Vehicle physics: staging, guidance, events and the predicted
+ * trajectory. Holds no render resources (see RocketRenderer), so it builds
+ * into the GL-free simulation core.
+ */
 class Rocket : Body {
 private:
-    // Rocket's own rendering (separate from Body's BodyRenderer)
-    std::unique_ptr<IRenderObject> renderObject;     // Rocket mesh
-    std::unique_ptr<Trajectory> trajectory_;          // Rocket flight trajectory
-    std::unique_ptr<Trajectory> prediction_;          // Predicted trajectory
+    std::vector<ErrorEllipsoid> predictionUncertainty_;     // Along the prediction when simulation_covariance is on
+    std::vector<EventState> predictionSamples_;             // Every prediction step, times from its start
+    size_t predictionRevision_ = 0;                         // Bumped whenever the prediction is recomputed
+    std::shared_ptr<const PredictionSnapshot> publishedPrediction_;  // Latest prediction, for snapshots
+    std::vector<std::shared_ptr<PredictionSnapshot>> predictionPool_;  // Every prediction published, rewritten once no snapshot holds it
 
     float predictionDuration = 0.0f, predictionStep = 0.0f; // Prediction parameters
     float predictionTimer_ = 0.0f;            // Timer for prediction update frequency
@@ -43,10 +56,11 @@ private:
 
     // Check if prediction needs to be recalculated based on state changes
     bool needsPredictionUpdate() const;
+    // An emptied prediction from the pool that nothing else holds, else a new one
+    std::shared_ptr<PredictionSnapshot> recyclePrediction();
 
-    double fuel_mass;           // Fuel mass (kg)
-    double thrust;              // Thrust (N)
-    double exhaust_velocity;    // Exhaust velocity (m/s)
+    double fuel_mass;           // Propellant left in the active stage (kg)
+    double thrust;              // Commanded thrust (N)
     float time = 0.0f;                // Time (s)
     glm::dvec3 thrustDirection = glm::dvec3(0.0); // Thrust direction (in local frame relative to Earth surface)
     bool launched = false;             // Whether the rocket is launched
@@ -60,34 +74,158 @@ private:
     
     FlightPlan flightPlan;
 
+    // Atmospheres the rocket can fly through: Earth (US76) plus any planet
+    // with a configured profile. Tables are built once in the constructor.
+    struct AtmosphereBody {
+        std::string name;
+        double radius;
+        AtmosphereTable table;
+    };
+    std::vector<AtmosphereBody> atmospheres_;
+    DragTable dragTable_;
+
+    void setupAtmospheres();
+    // First atmosphere a step of h from (stepPosition, stepVelocity) can reach below the
+    // ceiling of, with its body's position and velocity; nullptr if none
+    const AtmosphereBody* atmosphereNear(const glm::dvec3& stepPosition, const glm::dvec3& stepVelocity, double h,
+                                         const BODY_MAP& bodies, glm::dvec3& center, glm::dvec3& centerVelocity) const;
+
+    // Stage stack, bottom first: rocket.stages, or one constant stage from
+    // fuel_mass and exhaust_velocity. fuel_mass belongs to the active stage.
+    std::vector<PropulsionStage> stages_;
+    size_t activeStage_ = 0;
+    double stageBurnTime_ = 0.0;              // Firing time of the active stage (s)
+
+    void setupStages();
+    // Jettison the stage (dry mass and any residual propellant) and ignite the next; false on the last stage
+    bool separateStage(size_t& stage, double& currentMass, double& currentFuel, double& burnTime) const;
+    // The stage's engine for a step of h starting at (stepPosition, stepVelocity)
+    StageEngine stageEngine(size_t stage, double burnTime, const glm::dvec3& stepPosition, const glm::dvec3& stepVelocity,
+                            double h, const BODY_MAP& bodies) const;
+
+    // Bodies that matter for the rocket's gravity, reclassified as it moves
+    PerturberSet perturbers_;
+    double perturberClock_ = 0.0;             // Simulation time seen by update() (s)
+
+    // Body hierarchy for O(1) Earth/Moon lookup and cached SOI; optional
+    const BodyTree* bodyTree_ = nullptr;
+    int earthIndex_ = BodyTree::kNone;
+    int moonIndex_ = BodyTree::kNone;
+
+    // Central body for Encke propagation (innermost SOI, else Earth), refreshed in update()
+    glm::dvec3 centralPosition_ = glm::dvec3(0.0);
+    glm::dvec3 centralVelocity_ = glm::dvec3(0.0);
+    double centralMu_ = 0.0;                  // 0: no central body, always Cowell
+
+    // While coasting with a central body: KS when the orbit is highly eccentric
+    // or the step is a close approach, else Encke. Burns always use Cowell.
+    bool isCoasting(double currentFuel) const { return !(currentFuel > 0.0 && thrust > 0.0); }
+    // Whether a step of h from state burns: under the commanded thrust, or
+    // under a guidance profile that thrusts at either end of the step, so
+    // guidance can ignite the engine from a coast. missionTime: at the step start.
+    bool burnsDuring(const Body& state, double h, double currentFuel, double commanded, double missionTime) const;
+    bool usesEncke(double currentFuel) const {
+        return config_.simulation_encke && centralMu_ > 0.0 && isCoasting(currentFuel);
+    }
+    bool usesKs(const PhaseState& relative, double h, double currentFuel) const;
+
+    // Event detection inside the integrator step. Event functions read the
+    // frame's body positions below, which are refreshed at the start of update().
+    EventDetector events_;
+    EventDetector predictionEvents_;          // Impact only, for predictTrajectory
+    size_t impactEvent_ = 0;
+    size_t fuelEvent_ = 0;
+    size_t moonSoiEvent_ = 0;
+    size_t apsisEvent_ = 0;
+    size_t firstFlightPlanEvent_ = 0;         // Flight-plan boundaries occupy [first, size)
+    glm::dvec3 moonPosition_ = glm::dvec3(0.0);
+    double moonSoiRadius_ = 0.0;              // 0 when there is no Moon in the body map
+    static constexpr int kMaxEventsPerFrame = 16;
+    static constexpr double kEventRefireWindow = 1e-3;   // A handled event stays off this long (s)
+
+    void setupEvents();
+    double altitudeAt(const glm::dvec3& pos) const;
+    EventState currentEventState(double t) const;
+    // epoch: mission time at EventState time 0, the start of the frame (s)
+    EventState integrateStep(const EventState& start, double h, double epoch, const BODY_MAP& bodies, const Octree* octree) const;
+    void applyEventState(const EventState& state);
+    void handleEvent(const EventHit& hit, double epoch, const BODY_MAP& bodies);
+    const Body* earthBody(const BODY_MAP& bodies) const;
+
     // For testing
-    FRIEND_TEST(RocketTest, InitInjectsMockRenderObject);
     FRIEND_TEST(RocketTest, Initialization);
     FRIEND_TEST(RocketTest, OffsetPosition_Default);
     FRIEND_TEST(RocketTest, OffsetPosition_CustomPosition);
     FRIEND_TEST(RocketTest, FlightPlanExecution);
     FRIEND_TEST(RocketTest, ConcurrentUpdate);
-
-    void setRender(std::unique_ptr<IRenderObject> render);
-    void setTrajectoryRender(std::unique_ptr<IRenderObject> trajectory, std::unique_ptr<IRenderObject> prediction);
+    FRIEND_TEST(RocketTest, FuelDepletionSplitsStep);
+    FRIEND_TEST(RocketTest, ImpactLandsOnSurface);
+    FRIEND_TEST(RocketTest, DragReachesIntoLongSteps);
+    FRIEND_TEST(RocketTest, EventRefiresLaterInTheFrame);
+    FRIEND_TEST(RocketTest, EnckeCoastFollowsKeplerOrbit);
+    FRIEND_TEST(RocketTest, SwitchesToKsOnEccentricOrbits);
+    FRIEND_TEST(RocketTest, StagesSeparateAtBurnout);
+    FRIEND_TEST(RocketTest, GuidanceSteersInsideTheStep);
+    FRIEND_TEST(RocketTest, GuidanceIgnitesFromCoast);
+    FRIEND_TEST(RocketTest, StateTransitionMatchesPerturbedSteps);
+    FRIEND_TEST(RocketTest, StateTransitionFollowsKsSteps);
 
     // Private functions
+    // Build the force model for the current vehicle configuration (gravity
+    // backend, engine state, atmosphere, optional J2) for a step of h from
+    // (stepPosition, stepVelocity) once and hand it to fn, so the RK stages run
+    // a specialized kernel without per-evaluation branching. Without `engine`
+    // the model has no thrust term (coasting, or burns where rk4BurnStep
+    // drives the engine).
+    template <typename Fn>
+    auto withForceModel(const glm::dvec3& stepPosition, const glm::dvec3& stepVelocity, double h, double currentMass, const BODY_MAP& bodies, const Octree* octree, Fn&& fn, bool engine = true) const;
+    // The same, minus the central body's point-mass term, as a function of the
+    // central-body-relative state (for the Encke and KS propagators)
+    template <typename Fn>
+    auto withPerturbation(const PhaseState& relative, double h, double currentMass, const BODY_MAP& bodies, const Octree* octree, Fn&& fn) const;
+
     // Runge-Kutta 4th order method
     glm::dvec3 computeAccelerationRK4(double currentMass, const BODY_MAP& bodies, const Octree* octree = nullptr) const;
     glm::dvec3 computeAccelerationAt(const glm::dvec3& pos, const glm::dvec3& vel, double currentMass, const BODY_MAP& bodies, const Octree* octree = nullptr) const;
     void updateTrajectory();
     glm::vec3 offsetPosition() const;
     glm::vec3 offsetPosition(const glm::dvec3&) const;
-    Body updateStateRK4(const Body& state, double deltaTime, double& currentMass, double& currentFuel, const BODY_MAP& bodies, const Octree* octree = nullptr) const;
+    // Burns integrate mass with the state and advance burnTime; the propellant
+    // is not clamped, so a step past burnout leaves currentFuel negative.
+    // With stm, the step's state transition matrix is accumulated into it.
+    // startTime is measured from the frame (or prediction) start, which is
+    // mission time epoch; guidance profiles are evaluated in mission time.
+    Body updateStateRK4(const Body& state, double deltaTime, double& currentMass, double& currentFuel, double& burnTime, size_t stage, const BODY_MAP& bodies, const Octree* octree = nullptr, double startTime = 0.0, double epoch = 0.0, Matrix6* stm = nullptr) const;
+    // State transition matrix of one step from the variational equations of
+    // gravity and drag, integrated in substeps equal Cowell steps. Thrust is
+    // taken as open-loop, so it adds no partials.
+    Matrix6 stepTransition(const PhaseState& state, double h, int substeps, double currentMass, const BODY_MAP& bodies, const Octree* octree) const;
+    // One Encke step of a coasting state. Bodies are frozen for the frame, so the
+    // central body is taken to move uniformly: at centralPosition_ + centralVelocity_ * t.
+    void enckeStep(EnckePropagator& encke, double currentMass, double h, const BODY_MAP& bodies, const Octree* octree) const;
 
 public:
     Rocket(const Config&, std::shared_ptr<ILogger> logger, const FlightPlan&);
+    // Event functions hold `this` (see setupEvents)
+    Rocket(const Rocket&) = delete;
+    Rocket& operator=(const Rocket&) = delete;
 
     // Public functions
     void init();
     void update(float, const BODY_MAP&, const Octree* octree = nullptr);
-    void render(const Shader&) const;
-    void render(const Shader&, const glm::dvec3& renderOrigin) const;
+    // update() in its three stages, for callers that schedule them separately
+    // (the frame task graph). They must run in this order; only the
+    // prediction writes the prediction samples, so they may be read while
+    // completeStep() runs.
+    void prepareStep(float, const BODY_MAP&);           // Environment, clock, pre-launch tracking
+    void updatePrediction(float, const BODY_MAP&, const Octree* octree = nullptr);
+    void completeStep(float, const BODY_MAP&, const Octree* octree = nullptr);   // Integrate, events, flight plan
+    // Copy the state for a published snapshot (physics thread)
+    void fillSnapshot(RocketSnapshot& state) const;
+    // Checkpoints: the flight state, without what is derived from it (prediction, events)
+    void saveState(RocketCheckpoint& state) const;
+    // @throws CheckpointError if the stage does not exist in this rocket; nothing is changed then
+    void restoreState(const RocketCheckpoint& state);
     void toggleLaunch();
     void resetTime();
 
@@ -101,7 +239,12 @@ public:
     double getMass() const;
     double getFuelMass() const;
     double getThrust() const;
-    double getExhaustVelocity() const;
+    double getExhaustVelocity() const;     // Vacuum exhaust velocity of the active stage
+    const std::string& getStageName() const;
+    std::vector<std::string> getStageNames() const;   // Bottom first, as RocketSnapshot::stage counts
+    const std::vector<ErrorEllipsoid>& getPredictionUncertainty() const;  // 1-sigma, empty unless simulation_covariance
+    const std::vector<EventState>& getPredictionSamples() const { return predictionSamples_; }
+    size_t getPredictionRevision() const { return predictionRevision_; }
     glm::dvec3 getThrustDirection() const;
 
     // Setter
@@ -109,9 +252,29 @@ public:
     void setPosition(const glm::dvec3& pos) { position = pos; }
     void setVelocity(const glm::dvec3& vel) { velocity = vel; }
     void setEarthPosition(const glm::dvec3& pos) { earthPosition_ = pos; }
+    // Read Earth/Moon state and the Moon's SOI from a body tree instead of the body map; nullptr disables it
+    void setBodyTree(const BodyTree* tree);
 
     // Prediction
     void predictTrajectory(float, float, const BODY_MAP&, const Octree* octree = nullptr);
+
+    // Parameters of guidanceSensitivity(), in gradient order: a shift of every
+    // guidance point's pitch (rad) and thrust (N)
+    static constexpr int kGuidancePitch = 0;
+    static constexpr int kGuidanceThrust = 1;
+    using GuidanceGradient = BasicBurnState<DualVec3<2>>;
+
+    /**
+     * How the flight answers to its pitch program, from one propagation:
+     * flies on from the current state for `frames` frames of deltaTime as
+     * update() would, on dual numbers seeded with a shift of the guidance
+     * points (see GuidanceShift), and returns the final state and mass with
+     * their derivatives. The rocket is not changed. The bodies stay where
+     * they are and no events are applied, so the interval should lie within
+     * one stage and one flight-plan stage; coasts are Cowell RK4 steps.
+     */
+    GuidanceGradient guidanceSensitivity(float deltaTime, int frames, const BODY_MAP& bodies,
+                                         const Octree* octree = nullptr) const;
 };
 
 #endif
\ No newline at end of file
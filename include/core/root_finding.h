@@ -0,0 +1,181 @@
+#ifndef ROOT_FINDING_H
+#define ROOT_FINDING_H
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+/**
+ * Bracketing root finders used by the integrator's event detection.
+ *
+ * Both methods require a bracket [a, b] with f(a) and f(b) of opposite
+ * sign (or one of them zero) and never leave it, so they are guaranteed
+ * to converge for any continuous function.
+ *
+ * The result always reports both ends of the final bracket. Event
+ * handling uses the "after" side (the end whose sign matches f(b)) so
+ * that an event located at time t has actually happened at t and will
+ * not be detected again when integration resumes from there.
+ */
+struct RootResult {
+    double root = 0.0;       // Best estimate of the root
+    double after = 0.0;      // Bracket end with the same sign as f(b)
+    double before = 0.0;     // Bracket end with the same sign as f(a)
+    int iterations = 0;
+    bool converged = false;
+};
+
+class RootFinder {
+public:
+    /**
+     * Illinois variant of regula falsi.
+     * Cheap per iteration and superlinear on smooth event functions;
+     * halves the weight of a stale end point to avoid the one-sided
+     * stagnation of plain false position.
+     *
+     * @param f Function to solve, called as f(double)
+     * @param a Left end of the bracket
+     * @param b Right end of the bracket
+     * @param fa f(a), already known by the caller
+     * @param fb f(b), already known by the caller
+     * @param tol Absolute tolerance on the bracket width
+     * @param maxIter Iteration cap
+     */
+    template <typename F>
+    static RootResult illinois(F&& f, double a, double b, double fa, double fb,
+                               double tol, int maxIter = 100) {
+        RootResult result;
+        if (fa == 0.0) return exact(a);
+        if (fb == 0.0) return exact(b);
+        if ((fa > 0.0) == (fb > 0.0)) return result;  // Not bracketed
+
+        // x0/f0 track the "before" side (sign of f(a)), x1/f1 the "after" side
+        double x0 = a, f0 = fa;
+        double x1 = b, f1 = fb;
+        int side = 0;
+
+        for (int i = 0; i < maxIter; ++i) {
+            result.iterations = i + 1;
+            if (std::abs(x1 - x0) <= tol) break;
+
+            double x = (x0 * f1 - x1 * f0) / (f1 - f0);
+            double fx = f(x);
+            if (fx == 0.0) return exact(x, result.iterations);
+
+            if ((fx > 0.0) == (f1 > 0.0)) {
+                x1 = x; f1 = fx;
+                if (side == 1) f0 *= 0.5;
+                side = 1;
+            } else {
+                x0 = x; f0 = fx;
+                if (side == -1) f1 *= 0.5;
+                side = -1;
+            }
+        }
+
+        result.before = x0;
+        result.after = x1;
+        result.root = std::abs(f0) < std::abs(f1) ? x0 : x1;
+        result.converged = std::abs(x1 - x0) <= tol;
+        return result;
+    }
+
+    /**
+     * Brent's method: inverse quadratic interpolation / secant steps with
+     * a bisection fallback. Robust on poorly behaved event functions
+     * (near-tangent crossings, kinks at staging) at a small extra cost.
+     *
+     * Parameters are the same as illinois().
+     */
+    template <typename F>
+    static RootResult brent(F&& f, double a, double b, double fa, double fb,
+                            double tol, int maxIter = 100) {
+        RootResult result;
+        if (fa == 0.0) return exact(a);
+        if (fb == 0.0) return exact(b);
+        if ((fa > 0.0) == (fb > 0.0)) return result;  // Not bracketed
+
+        const bool afterPositive = fb > 0.0;
+
+        // Classic formulation: b is the best estimate, [b, c] brackets the root
+        double c = a, fc = fa;
+        double d = b - a, e = d;
+
+        for (int i = 0; i < maxIter; ++i) {
+            result.iterations = i + 1;
+
+            if ((fb > 0.0) == (fc > 0.0)) {
+                c = a; fc = fa;
+                d = e = b - a;
+            }
+            if (std::abs(fc) < std::abs(fb)) {
+                a = b; b = c; c = a;
+                fa = fb; fb = fc; fc = fa;
+            }
+
+            double tol1 = 2.0 * 1e-16 * std::abs(b) + 0.5 * tol;
+            double m = 0.5 * (c - b);
+            if (std::abs(m) <= tol1 || fb == 0.0) {
+                result.converged = true;
+                break;
+            }
+
+            if (std::abs(e) >= tol1 && std::abs(fa) > std::abs(fb)) {
+                double s = fb / fa;
+                double p, q;
+                if (a == c) {
+                    // Secant step
+                    p = 2.0 * m * s;
+                    q = 1.0 - s;
+                } else {
+                    // Inverse quadratic interpolation
+                    double qa = fa / fc;
+                    double r = fb / fc;
+                    p = s * (2.0 * m * qa * (qa - r) - (b - a) * (r - 1.0));
+                    q = (qa - 1.0) * (r - 1.0) * (s - 1.0);
+                }
+                if (p > 0.0) q = -q; else p = -p;
+
+                if (2.0 * p < std::min(3.0 * m * q - std::abs(tol1 * q), std::abs(e * q))) {
+                    e = d;
+                    d = p / q;
+                } else {
+                    d = m;
+                    e = m;
+                }
+            } else {
+                d = m;
+                e = m;
+            }
+
+            a = b; fa = fb;
+            b += (std::abs(d) > tol1) ? d : (m > 0.0 ? tol1 : -tol1);
+            fb = f(b);
+        }
+
+        // If the iteration cap hit right after a step, [a, b] is the live bracket
+        if ((fb > 0.0) == (fc > 0.0)) c = a;
+
+        // Report the bracket oriented the way the caller gave it
+        result.root = b;
+        if ((fb > 0.0) == afterPositive || fb == 0.0) {
+            result.after = b;
+            result.before = c;
+        } else {
+            result.after = c;
+            result.before = b;
+        }
+        return result;
+    }
+
+private:
+    static RootResult exact(double x, int iterations = 0) {
+        RootResult result;
+        result.root = result.after = result.before = x;
+        result.iterations = iterations;
+        result.converged = true;
+        return result;
+    }
+};
+
+#endif // ROOT_FINDING_H
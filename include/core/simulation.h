@@ -3,15 +3,14 @@
 
 #define GLM_ENABLE_EXPERIMENTAL
 
-#include "body.h"
+#include "core/simulation_core.h"
+#include "rendering/body_renderer.h"
 #include "rendering/camera.h"
-#include "logging/logger.h"
-#include "core/flight_plan.h"
-#include "core/octree.h"
 #include "rendering/render_object.h"
+#include "rendering/rocket_renderer.h"
 #include "rendering/saturn_rings.h"
-#include "core/rocket.h"
 #include "rendering/shader.h"
+#include "logging/logger.h"
 #include "logging/spdlog_logger.h"
 
 #include <glm/ext.hpp>
@@ -22,55 +21,77 @@
 #include <memory>
 #include <string>
 
+/**
+ * The solar system and the rocket in a window: a SimulationCore for the
+ * physics, plus the render resources and the camera.
+ *
+ * update() is the physics step and may run on its own thread (see
+ * PhysicsThread). Each step publishes a SimulationSnapshot; the render
+ * thread reads the latest one with latestSnapshot(), feeds the trails
+ * with syncRender() and draws it with render(). Input goes the other way
+ * through post(). Camera controls stay on the render thread.
+ */
 class Simulation {
 public:
     Simulation(Camera &camera);
-    explicit Simulation(Config& config, std::shared_ptr<ILogger> logger, Camera &camera);
+    explicit Simulation(const Config& config, std::shared_ptr<ILogger> logger, Camera &camera);
     ~Simulation();
 
     void init();
-    void update(float deltaTime);
-    void render(const Shader& shader) const;
+    // Worker pool for the frame graph and parallel loops; nullptr runs them
+    // on the calling thread. Must outlive the simulation's updates.
+    void setJobSystem(JobSystem* jobs) { core_.setJobSystem(jobs); }
+    JobSystem* getJobSystem() const { return core_.getJobSystem(); }
+
+    // Physics thread
+    void update(float deltaTime) { core_.update(deltaTime); }
+
+    // Render thread
+    bool post(const SimulationCommand& command) { return core_.post(command); }
+    const SimulationSnapshot& latestSnapshot() { return core_.latestSnapshot(); }
+    void syncRender(const SimulationSnapshot& state);
+    void render(const Shader& shader, const SimulationSnapshot& state) const;
 
-    void setTimeScale(float ts);
-    void adjustTimeScale(float delta);
     void adjustCameraDistance(float delta);
     void adjustCameraRotation(float deltaPitch, float deltaYaw); // Adjust camera rotation
     void adjustCameraMode(Camera::Mode mode); // Adjust camera mode
     void adjustCameraTarget(const glm::vec3& target); // Adjust camera target    
     void focusOnBody(const std::string& bodyName);  // Focus camera on a specific body
 
-    glm::dvec3 computeBodyAcceleration(const Body& body, const BODY_MAP& bodies) const; // Velocity Verlet
-
-
-    float getTimeScale() const;
-    Rocket& getRocket();
+    // Render thread: checkpoints of the physics plus the camera and trails.
+    // The physics side is saved or restored at its next step and the camera
+    // and trails follow with the first snapshot after it; failures are
+    // logged. restoreCheckpoint() returns false if the file cannot be read.
+    void saveCheckpoint(const std::string& path);
+    bool restoreCheckpoint(const std::string& path);
+
+    // Live physics state: only safe from the physics thread (or before it starts)
+    SimulationCore& getCore() { return core_; }
+    float getTimeScale() const { return core_.getTimeScale(); }
+    Rocket& getRocket() { return core_.getRocket(); }
     Camera& getCamera();
 
-    glm::dvec3 getMoonPos() const;
-    const BODY_MAP& getBodies() const;
+    glm::dvec3 getMoonPos() const { return core_.getMoonPos(); }
+    const BODY_MAP& getBodies() const { return core_.getBodies(); }
+    const BodyTree& getBodyTree() const { return core_.getBodyTree(); }
     float getRenderScale() const;  // Get rendering scale factor
     const glm::dvec3& getRenderOrigin() const { return renderOrigin_; }
-    const Config& getConfig() const { return config; }
+    const Config& getConfig() const { return core_.getConfig(); }
     
     // Get projection and view matrices for UI rendering
     void getRenderMatrices(int width, int height, glm::mat4& projection, glm::mat4& view) const;
 
 private:
-    Config config;
-    Rocket rocket;
-    BODY_MAP bodies;
+    SimulationCore core_;
+    const Config& config;   // core_'s copy
 
     Camera& camera;
 
-    float timeScale;
-
     void updateCameraPosition() const; // Update camera position
 
-    glm::dvec3 moonPos;
-    std::unique_ptr<RenderObject> mapEarth;
-    std::unique_ptr<RenderObject> mapMoon;
-    std::unique_ptr<RenderObject> mapRocket;
+    // Render side of the bodies (sphere mesh, orbit trail) by name, and of the rocket
+    std::unordered_map<std::string, BodyRenderer> renderers_;
+    RocketRenderer rocketRenderer_;
     
     // Saturn's rings
     std::unique_ptr<SaturnRings> saturnRings_;
@@ -79,11 +100,16 @@ private:
     // All render positions are computed relative to this point to avoid float precision loss
     mutable glm::dvec3 renderOrigin_;
 
-    // Barnes-Hut octree for O(n log n) gravitational force calculation
-    Octree octree_;
+    double renderedTime_ = 0.0;     // Snapshot time the trails were last fed (render thread)
 
-    // Build octree from current body state (call once per frame)
-    void buildOctree();
+    // Checkpoint being restored, for its view; restores seen in the snapshots so far
+    std::shared_ptr<const Checkpoint> restoring_;
+    uint64_t restoresSeen_ = 0;
+    uint64_t seeksSeen_ = 0;        // Replay jumps seen in the snapshots so far
+    CheckpointView captureView() const;
+    void restoreView(const SimulationSnapshot& state);
+    // Trails from the view's, or empty without one, sampled on from the snapshot's clock
+    void restoreTrails(const CheckpointView* view, const SimulationSnapshot& state);
 
     std::shared_ptr<ILogger> logger_;
 };
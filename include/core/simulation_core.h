@@ -0,0 +1,198 @@
+#ifndef SIMULATION_CORE_H
+#define SIMULATION_CORE_H
+
+#define GLM_ENABLE_EXPERIMENTAL
+
+#include "body.h"
+#include "app/config.h"
+#include "logging/logger.h"
+#include "core/block_integrator.h"
+#include "core/body_tree.h"
+#include "core/checkpoint.h"
+#include "core/encounter.h"
+#include "core/flight_recorder.h"
+#include "core/frame_arena.h"
+#include "core/job_system.h"
+#include "core/octree.h"
+#include "core/rocket.h"
+#include "core/snapshot.h"
+#include "core/spsc_queue.h"
+#include "core/triple_buffer.h"
+
+#include <glm/ext.hpp>
+#include <glm/glm.hpp>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * Input for the physics side, queued by the render thread and applied at
+ * the start of the next physics step.
+ */
+struct SimulationCommand {
+    enum class Type {
+        ToggleLaunch,
+        RotateThrust,       // value: angle (rad) about the z axis
+        SetTimeScale,       // value: new time scale
+        AdjustTimeScale     // value: step, as for adjustTimeScale()
+    };
+    Type type = Type::ToggleLaunch;
+    double value = 0.0;
+};
+
+/**
+ * Physics of the solar system and the rocket, with no window or GL
+ * dependency; the windowed Simulation draws it, the headless runner
+ * drives it directly.
+ *
+ * update() is the physics step and may run on its own thread (see
+ * PhysicsThread). Each step publishes a SimulationSnapshot, read with
+ * latestSnapshot(); input goes the other way through post().
+ */
+class SimulationCore {
+public:
+    SimulationCore(const Config& config, std::shared_ptr<ILogger> logger);
+    ~SimulationCore();
+
+    SimulationCore(const SimulationCore&) = delete;
+    SimulationCore& operator=(const SimulationCore&) = delete;
+
+    void init();
+    // Worker pool for the frame graph and parallel loops; nullptr runs them
+    // on the calling thread. Must outlive the simulation's updates.
+    void setJobSystem(JobSystem* jobs) { jobs_ = jobs; }
+    JobSystem* getJobSystem() const { return jobs_; }
+
+    // Physics thread. The time scale is the physics thread's; other threads
+    // change it with the SetTimeScale and AdjustTimeScale commands.
+    void update(float deltaTime);
+    void setTimeScale(float ts);
+    void adjustTimeScale(float delta);
+
+    // Render thread, or whichever single thread drives the input and the
+    // display: the command queue has one producer, the snapshots one reader
+    bool post(const SimulationCommand& command);          // false if the queue is full
+    const SimulationSnapshot& latestSnapshot();           // Valid until the next call
+
+    glm::dvec3 computeBodyAcceleration(const Body& body, const BODY_MAP& bodies) const; // Velocity Verlet
+
+    // Live physics state: only safe from the physics thread (or before it starts)
+    float getTimeScale() const;
+    double getTime() const { return time_; }
+    Rocket& getRocket();
+    glm::dvec3 getMoonPos() const;
+    const BODY_MAP& getBodies() const;
+    const BodyTree& getBodyTree() const { return bodyTree_; }
+    const Config& getConfig() const { return config; }
+    // Heap allocations during the last update(), 0 unless AllocationCounter is enabled
+    uint64_t getFrameAllocations() const { return frameAllocations_; }
+
+    /**
+     * Record the published snapshots to a telemetry file at the configured
+     * interval, starting with the latest, replacing any recording in
+     * progress. init() starts one when telemetry_enabled is set. A file runs forward in time, so a checkpoint
+     * restore carries on in a new one, <path>.<n> after the n-th restore.
+     * Physics thread only, like update().
+     * @throws TelemetryError if the file cannot be created
+     */
+    void startRecording(const std::string& path);
+    void stopRecording();
+    const FlightRecorder* getRecorder() const { return recorder_.get(); }
+
+    /**
+     * Checkpoints, physics thread only like update(). saveCheckpoint()
+     * copies the state and leaves the writing to a background thread, so it
+     * returns at once. restoreCheckpoint() replaces the bodies, rocket,
+     * clock and time scale and publishes the result; what is derived from
+     * them (prediction, encounters, the multi-rate integrator's blocks)
+     * starts over from there.
+     * @throws CheckpointError if the checkpoint does not fit this simulation
+     *         or the file cannot be read; nothing is changed then
+     */
+    Checkpoint captureCheckpoint() const;
+    void saveCheckpoint(const std::string& path, std::optional<CheckpointView> view = std::nullopt);
+    void restoreCheckpoint(const Checkpoint& state);
+    void restoreCheckpoint(const std::string& path);
+    void flushCheckpoints() { checkpoints_.flush(); }   // Wait for the saves in progress
+    const CheckpointWriter& getCheckpointWriter() const { return checkpoints_; }
+
+    // Any thread: saved or restored at the start of the next update(). A
+    // restore shows up as SimulationSnapshot::restores going up; one that
+    // does not fit is logged and dropped there.
+    void postCheckpoint(const std::string& path, std::optional<CheckpointView> view = std::nullopt);
+    void postRestore(std::shared_ptr<const Checkpoint> state);
+
+private:
+    Config config;          // Before rocket, which keeps a reference to it
+    std::shared_ptr<ILogger> logger_;
+    Rocket rocket;
+    BODY_MAP bodies;
+    BodyTree bodyTree_;   // Sun -> planets -> Moon, parent-relative state over `bodies`
+
+    float timeScale = 1.0f;
+    glm::dvec3 moonPos;
+
+    // Barnes-Hut octree for O(n log n) gravitational force calculation
+    Octree octree_;
+    std::vector<OctreeBody> octreeBodies_;   // Its input, refilled each frame
+
+    // Build octree from current body state (call once per frame)
+    void buildOctree();
+
+    // Single-rate Velocity Verlet step for all bodies (block timesteps off)
+    void updateBodiesVerlet(double dt);
+    // Advance the bodies by one frame with whichever integrator is configured
+    void stepBodies(double dt);
+
+    // Multi-rate integrator for the bodies (used when simulation_block_timesteps is on)
+    BlockIntegrator blockIntegrator_;
+
+    // Encounter search over the rocket's prediction, a slice per frame
+    EncounterFinder encounterFinder_;
+    ConicEphemeris encounterEphemeris_;   // Bodies at the latest prediction's start
+    size_t encounterRevision_ = 0;   // Prediction revision the search is running on
+    void updateEncounters();
+
+    // Physics -> render snapshots, render -> physics commands
+    TripleBuffer<SimulationSnapshot> snapshots_;
+    SpscQueue<SimulationCommand, 256> commands_;
+    uint64_t published_ = 0;
+    double time_ = 0.0;             // Simulated time (physics thread)
+    void applyCommands();
+    void publishSnapshot();
+    void stageBodies(SimulationSnapshot& state) const;
+    void stageRocket(SimulationSnapshot& state);
+
+    std::unique_ptr<FlightRecorder> recorder_;   // Null when not recording
+    std::string recordingPath_;                  // As passed to startRecording()
+    void openRecorder(const std::string& path);
+
+    // Checkpoints; requests from other threads wait under checkpointMutex_,
+    // and the flag lets update() skip the lock when there are none
+    CheckpointWriter checkpoints_;
+    std::mutex checkpointMutex_;
+    std::vector<std::pair<std::string, std::optional<CheckpointView>>> saveRequests_;
+    std::shared_ptr<const Checkpoint> restoreRequest_;
+    std::atomic<bool> checkpointRequests_{false};
+    uint64_t restores_ = 0;
+    void applyCheckpointRequests();
+    // Throws CheckpointError unless the checkpoint has the same bodies and a stage the rocket has
+    void checkCheckpoint(const Checkpoint& state) const;
+
+    // One physics frame as a task graph, built on the first update
+    JobSystem* jobs_ = nullptr;
+    TaskGraph frame_;
+    double frameDt_ = 0.0;          // Simulated step of the frame being run
+    void buildFrameGraph();
+
+    // Scratch that lives for one frame, released at the start of the next;
+    // only the "bodies" stage draws on it, so it needs no locking
+    FrameArena frameArena_;
+    uint64_t frameAllocations_ = 0;   // Heap allocations during the last update()
+};
+
+#endif // SIMULATION_CORE_H
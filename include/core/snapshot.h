@@ -0,0 +1,73 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include "core/covariance.h"
+#include "core/encounter.h"
+
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * Immutable views of the simulation, published by the physics thread for
+ * rendering and the UI (see Simulation::latestSnapshot). Nothing here
+ * points back into live physics state.
+ */
+struct BodySnapshot {
+    std::string name;
+    int parent = -1;              // Index into SimulationSnapshot::bodies, -1 for the root
+    double mass = 0.0;
+    double soiRadius = 0.0;
+    glm::dvec3 position{0.0};
+    glm::dvec3 velocity{0.0};
+};
+
+// One computed prediction; shared by every snapshot until the next one
+struct PredictionSnapshot {
+    size_t revision = 0;
+    float renderInterval = 0.0f;              // Sample spacing passed to the prediction trajectory
+    std::vector<glm::vec3> points;            // Render-scaled positions
+    std::vector<ErrorEllipsoid> uncertainty;  // 1-sigma, empty unless simulation_covariance
+};
+
+struct RocketSnapshot {
+    glm::dvec3 position{0.0};
+    glm::dvec3 velocity{0.0};
+    glm::dvec3 thrustDirection{0.0, 1.0, 0.0};
+    double mass = 0.0;
+    double fuelMass = 0.0;
+    double thrust = 0.0;
+    double exhaustVelocity = 0.0;
+    std::string stageName;
+    uint32_t stage = 0;                       // Active stage, bottom first
+    float time = 0.0f;
+    bool launched = false;
+    bool crashed = false;
+    std::shared_ptr<const PredictionSnapshot> prediction;
+};
+
+struct SimulationSnapshot {
+    uint64_t sequence = 0;                // Physics steps published so far
+    uint64_t restores = 0;                // Checkpoints restored so far
+    uint64_t seeks = 0;                   // Replay jumps so far; trails start over on a change
+    double time = 0.0;                    // Simulated seconds since the start
+    float timeScale = 1.0f;
+    std::vector<BodySnapshot> bodies;     // Body tree order: parents first
+    RocketSnapshot rocket;
+    std::vector<Encounter> encounters;
+    bool encounterSearchFinished = true;
+    uint64_t frameAllocations = 0;        // Heap allocations during the previous step (see AllocationCounter)
+
+    int indexOf(const std::string& name) const;
+    const BodySnapshot* find(const std::string& name) const;
+
+    /**
+     * Innermost body whose SOI contains a world position, descending from
+     * the root as BodyTree::dominantBody does; -1 if there are no bodies.
+     */
+    int dominantBody(const glm::dvec3& worldPosition) const;
+};
+
+#endif // SNAPSHOT_H
@@ -0,0 +1,51 @@
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+/**
+ * Bounded lock-free queue for exactly one producer and one consumer
+ * thread (a ring buffer with acquire/release indices). push() fails
+ * instead of blocking when the queue is full.
+ */
+template <typename T, size_t Capacity>
+class SpscQueue {
+    static_assert(Capacity >= 2, "one slot is kept empty to tell full from empty");
+
+public:
+    // Producer side
+    bool push(const T& value) {
+        size_t head = head_.load(std::memory_order_relaxed);
+        size_t next = (head + 1) % Capacity;
+        if (next == tail_.load(std::memory_order_acquire)) {
+            return false;
+        }
+        slots_[head] = value;
+        head_.store(next, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side
+    bool pop(T& value) {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail == head_.load(std::memory_order_acquire)) {
+            return false;
+        }
+        value = slots_[tail];
+        tail_.store((tail + 1) % Capacity, std::memory_order_release);
+        return true;
+    }
+
+    bool empty() const {
+        return tail_.load(std::memory_order_acquire) == head_.load(std::memory_order_acquire);
+    }
+
+private:
+    std::array<T, Capacity> slots_{};
+    alignas(64) std::atomic<size_t> head_{0};   // Next slot to write
+    alignas(64) std::atomic<size_t> tail_{0};   // Next slot to read
+};
+
+#endif // SPSC_QUEUE_H
@@ -0,0 +1,192 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include "core/mapped_file.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <iosfwd>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Chunked columnar binary telemetry.
+ *
+ * A file is a header with the schema (column names and types), then
+ * chunks of up to a fixed number of rows stored column by column, then an
+ * index of the chunks with their time spans. Column 0 is always "time".
+ * Within a chunk each column is XOR-delta coded against the previous row,
+ * byte-shuffled so the planes of equal significance sit together, and
+ * run-length packed. The unchanging high bytes of slowly varying doubles
+ * and nearly all of a flag or counter column pack away, which typically
+ * halves a file; the decoding is exact. All values are little-endian.
+ *
+ * A file cut short (a crash before close()) is still readable: the reader
+ * falls back to walking the chunk headers when the index is missing.
+ */
+
+class TelemetryError : public std::runtime_error {
+public:
+    explicit TelemetryError(const std::string& message) : std::runtime_error(message) {}
+};
+
+enum class TelemetryType : uint8_t {
+    Float64 = 0,
+    UInt32 = 1
+};
+
+struct TelemetryColumn {
+    std::string name;
+    TelemetryType type = TelemetryType::Float64;
+};
+
+struct TelemetryChunkInfo {
+    uint64_t offset = 0;        // File offset of the chunk header
+    uint32_t rows = 0;
+    double firstTime = 0.0;
+    double lastTime = 0.0;
+};
+
+namespace telemetry {
+
+constexpr uint32_t kVersion = 1;
+
+size_t widthOf(TelemetryType type);
+
+/**
+ * Chunk payload coding. Values are stored column by column, value (c, r)
+ * at values[c * stride + r]; UInt32 columns use the low half of the word.
+ * Decoding writes them back with stride == rows.
+ */
+void encodeChunk(const std::vector<TelemetryColumn>& columns, const uint64_t* values, size_t stride, size_t rows,
+                 bool compress, std::vector<uint8_t>& out);
+void decodeChunk(const std::vector<TelemetryColumn>& columns, const uint8_t* data, size_t size,
+                 bool compressed, size_t rows, std::vector<uint64_t>& values);
+
+}  // namespace telemetry
+
+/**
+ * Writes telemetry rows to a file. append() only copies the row into the
+ * chunk being filled; full chunks are coded and written by a background
+ * thread, so the caller never waits on the disk unless it outruns it by a
+ * whole chunk.
+ */
+class TelemetryWriter {
+public:
+    struct Options {
+        size_t rowsPerChunk = 1024;
+        bool compress = true;
+    };
+
+    /**
+     * @param columns Schema; the first column must be "time"
+     * @throws TelemetryError if the schema is invalid or the file cannot be created
+     */
+    TelemetryWriter(const std::string& path, std::vector<TelemetryColumn> columns, const Options& options);
+    ~TelemetryWriter();   // close()
+
+    TelemetryWriter(const TelemetryWriter&) = delete;
+    TelemetryWriter& operator=(const TelemetryWriter&) = delete;
+
+    /**
+     * Append one row; `values` has one entry per column, in schema order,
+     * with UInt32 columns given as doubles.
+     */
+    void append(const double* values);
+
+    // Write out the partial chunk and the index, and close the file
+    void close();
+
+    const std::vector<TelemetryColumn>& columns() const { return columns_; }
+    uint64_t rows() const { return rows_; }
+    // A write to the file failed; nothing after it was written
+    bool failed() const { return failed_.load(std::memory_order_relaxed); }
+
+private:
+    std::vector<TelemetryColumn> columns_;
+    Options options_;
+    std::FILE* file_ = nullptr;
+    uint64_t rows_ = 0;
+    std::atomic<bool> failed_{false};
+
+    // Chunk being filled (caller) and chunk being written (background)
+    std::vector<uint64_t> filling_;
+    size_t fillingRows_ = 0;
+    std::vector<uint64_t> writing_;
+    size_t writingRows_ = 0;
+    bool writePending_ = false;
+    bool stop_ = false;
+    std::mutex mutex_;
+    std::condition_variable ready_;     // Background: a chunk to write, or stop
+    std::condition_variable written_;   // Caller: the background chunk is done
+    std::thread worker_;
+
+    // Background thread only
+    std::vector<uint8_t> encoded_;
+    std::vector<TelemetryChunkInfo> index_;
+    uint64_t offset_ = 0;
+
+    void handOff();
+    void run();
+    void writeChunk(const std::vector<uint64_t>& values, size_t rows);
+    void writeIndex();
+    void writeBytes(const void* data, size_t size);
+};
+
+/**
+ * Reads a telemetry file written by TelemetryWriter. The file is mapped
+ * rather than read: opening costs the header and the index, and a chunk
+ * is decoded straight from the mapping when asked for, so any point of a
+ * long recording is a binary search and one chunk away.
+ */
+class TelemetryReader {
+public:
+    // @throws TelemetryError if the file is missing or not telemetry
+    explicit TelemetryReader(const std::string& path);
+
+    const std::vector<TelemetryColumn>& columns() const { return columns_; }
+    int columnIndex(const std::string& name) const;   // -1 if absent
+
+    const std::vector<TelemetryChunkInfo>& chunks() const { return chunks_; }
+    uint64_t rowCount() const { return rowCount_; }
+    bool hasIndex() const { return indexed_; }        // False for a file cut short
+
+    // Last chunk starting at or before `time`, 0 if it precedes them all
+    size_t findChunk(double time) const;
+
+    /**
+     * Decode one chunk into values[c * rows + r], UInt32 columns widened
+     * to double. Not safe to call from two threads at once.
+     */
+    void readChunk(size_t chunk, std::vector<double>& values) const;
+
+private:
+    MappedFile file_;
+    std::vector<TelemetryColumn> columns_;
+    std::vector<TelemetryChunkInfo> chunks_;
+    uint64_t rowCount_ = 0;
+    bool indexed_ = false;
+    mutable std::vector<uint64_t> words_;   // readChunk's scratch
+
+    void readAt(uint64_t offset, void* data, size_t size) const;
+    bool readIndex();
+    void scanChunks(uint64_t offset);
+};
+
+namespace telemetry {
+
+/**
+ * Write a whole recording as CSV for tools that read nothing else: a
+ * header of the column names, then one line per row, doubles to full
+ * precision and UInt32 columns as integers.
+ */
+void exportCsv(const TelemetryReader& reader, std::ostream& out);
+
+}  // namespace telemetry
+
+#endif // TELEMETRY_H
@@ -0,0 +1,52 @@
+#ifndef TRIPLE_BUFFER_H
+#define TRIPLE_BUFFER_H
+
+#include <atomic>
+#include <cstdint>
+
+/**
+ * Lock-free triple buffer: one writer publishes complete values, one
+ * reader always sees the latest published one.
+ *
+ * The writer fills back() and calls publish(), which swaps it with the
+ * middle slot; the reader's read() swaps the middle slot with its front
+ * slot when something new has been published. Neither side ever waits,
+ * and a value is never read while it is being written.
+ *
+ * Slots are reused, so back() holds stale data after publish(): the
+ * writer must overwrite every field (containers keep their capacity, so
+ * steady-state publishing does not allocate).
+ */
+template <typename T>
+class TripleBuffer {
+public:
+    TripleBuffer() = default;
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    // Writer side
+    T& back() { return slots_[back_]; }
+    void publish() {
+        back_ = middle_.exchange(static_cast<uint8_t>(back_ | kFresh), std::memory_order_acq_rel) & kIndex;
+    }
+
+    // Reader side: the reference stays valid until the next read()
+    const T& read() {
+        if (middle_.load(std::memory_order_relaxed) & kFresh) {
+            front_ = middle_.exchange(front_, std::memory_order_acq_rel) & kIndex;
+        }
+        return slots_[front_];
+    }
+    bool fresh() const { return (middle_.load(std::memory_order_relaxed) & kFresh) != 0; }
+
+private:
+    static constexpr uint8_t kIndex = 0x3;
+    static constexpr uint8_t kFresh = 0x4;   // Middle slot holds an unread value
+
+    T slots_[3];
+    uint8_t back_ = 0;                       // Writer only
+    std::atomic<uint8_t> middle_{1};         // Index, plus kFresh
+    uint8_t front_ = 2;                      // Reader only
+};
+
+#endif // TRIPLE_BUFFER_H
@@ -0,0 +1,85 @@
+#ifndef ASYNC_LOGGER_H
+#define ASYNC_LOGGER_H
+
+#include "core/mpsc_queue.h"
+#include "logging/logger.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+/**
+ * Logger that hands records to a background thread instead of writing
+ * them. Any thread's log() copies the record into a bounded lock-free
+ * queue, with no heap allocation and no I/O; the background thread drains
+ * it into the wrapped logger, whose sinks may format, flush and block as
+ * they like without holding up a frame.
+ *
+ * When the queue is full a record is dropped (and counted) or, if asked
+ * for, the caller waits for room. Text longer than a record holds is cut
+ * short.
+ */
+class AsyncLogger : public ILogger {
+public:
+    enum class Overflow {
+        Drop,    // Count the record as dropped and return
+        Block    // Wait for the background thread to make room
+    };
+
+    static constexpr size_t kQueueCapacity = 4096;     // Records
+    static constexpr size_t kModuleLength = 32;        // Bytes kept of a module name
+    static constexpr size_t kMessageLength = 256;      // Bytes kept of a message
+
+    AsyncLogger(std::shared_ptr<ILogger> sink, Overflow overflow = Overflow::Drop);
+    ~AsyncLogger() override;   // Writes out everything queued, then stops
+
+    AsyncLogger(const AsyncLogger&) = delete;
+    AsyncLogger& operator=(const AsyncLogger&) = delete;
+
+    void log(LogLevel level, const std::string& module, const std::string& message) override;
+    void set_level(LogLevel level) override;
+
+    // Wait until every record queued before the call has reached the sink
+    void flush();
+
+    uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+    uint64_t truncated() const { return truncated_.load(std::memory_order_relaxed); }
+    uint64_t written() const { return written_.load(std::memory_order_acquire); }
+
+private:
+    struct Record {
+        LogLevel level = LogLevel::INFO;
+        uint16_t moduleLength = 0;
+        uint16_t messageLength = 0;
+        char module[kModuleLength];
+        char message[kMessageLength];
+    };
+
+    std::shared_ptr<ILogger> sink_;
+    Overflow overflow_;
+    // Records are large; the queue lives on the heap so the logger may too
+    std::unique_ptr<MpscQueue<Record, kQueueCapacity>> queue_;
+
+    std::atomic<uint64_t> written_{0};   // Also the queue position the background thread has reached
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint64_t> truncated_{0};
+
+    std::atomic<bool> stop_{false};
+    std::atomic<bool> sleeping_{false};  // Background thread is waiting on wake_
+    std::mutex mutex_;
+    std::condition_variable wake_;       // Background thread: records or stop
+    std::condition_variable progress_;   // flush() and blocked producers: records written
+    std::thread worker_;
+
+    template <typename Fill>
+    void enqueue(Fill&& fill);
+    void copyText(char* out, uint16_t& length, size_t capacity, const std::string& text);
+    void run();
+    size_t drain();
+    void notifyProgress();
+};
+
+#endif // ASYNC_LOGGER_H
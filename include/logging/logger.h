@@ -1,8 +1,10 @@
 #ifndef LOGGER_H
 #define LOGGER_H
 
+#include <atomic>
 #include <string>
 #include <glm/glm.hpp>
+#include <spdlog/fmt/fmt.h>
 
 // Log levels
 enum class LogLevel {
@@ -20,20 +22,49 @@ public:
     // General logging method
     virtual void log(LogLevel level, const std::string& module, const std::string& message) = 0;
     
-    // Structured logging method (orbital data)
-    virtual void log_orbit(LogLevel level, const std::string& module, float time,
-                          const glm::vec3& position, float radius, const glm::vec3& velocity) = 0;
-    
     // Set log level
     virtual void set_level(LogLevel level) = 0;
+
+    // Whether a message at `level` would be written; the macros below check
+    // this before evaluating their arguments
+    bool enabled(LogLevel level) const {
+        return static_cast<int>(level) >= threshold_.load(std::memory_order_relaxed);
+    }
+
+protected:
+    // Implementations call this from set_level
+    void setThreshold(LogLevel level) { threshold_.store(static_cast<int>(level), std::memory_order_relaxed); }
+
+private:
+    std::atomic<int> threshold_{static_cast<int>(LogLevel::DEBUG)};
 };
 
+// Lowest level compiled in: 0 DEBUG, 1 INFO, 2 WARN, 3 ERROR, 4 none.
+// Calls below it fold to nothing, arguments included.
+#ifndef ROCKETSIM_LOG_MIN_LEVEL
+#define ROCKETSIM_LOG_MIN_LEVEL 0
+#endif
+
+// The message expression is only evaluated when the level is enabled, so
+// a disabled call costs one relaxed load and builds no strings
+#define ROCKETSIM_LOG_AT(logger, level, module, msg) \
+    do { \
+        if (static_cast<int>(level) >= ROCKETSIM_LOG_MIN_LEVEL && (logger)->enabled(level)) { \
+            (logger)->log(level, module, msg); \
+        } \
+    } while (0)
+
 // Logging macros (simplify calls)
-#define LOG_DEBUG(logger, module, msg) (logger)->log(LogLevel::DEBUG, module, msg)
-#define LOG_INFO(logger, module, msg) (logger)->log(LogLevel::INFO, module, msg)
-#define LOG_ERROR(logger, module, msg) (logger)->log(LogLevel::ERROR, module, msg)
-#define LOG_WARN(logger, module, msg) (logger)->log(LogLevel::WARN, module, msg)
-#define LOG_ORBIT(logger, module, time, pos, radius, vel) \
-    (logger)->log_orbit(LogLevel::DEBUG, module, time, pos, radius, vel)
+#define LOG_DEBUG(logger, module, msg) ROCKETSIM_LOG_AT(logger, LogLevel::DEBUG, module, msg)
+#define LOG_INFO(logger, module, msg) ROCKETSIM_LOG_AT(logger, LogLevel::INFO, module, msg)
+#define LOG_ERROR(logger, module, msg) ROCKETSIM_LOG_AT(logger, LogLevel::ERROR, module, msg)
+#define LOG_WARN(logger, module, msg) ROCKETSIM_LOG_AT(logger, LogLevel::WARN, module, msg)
+
+// fmt-style variants: LOG_DEBUGF(logger, "Rocket", "Acc={} m/s^2", a).
+// Formatting happens only once the level check has passed.
+#define LOG_DEBUGF(logger, module, ...) ROCKETSIM_LOG_AT(logger, LogLevel::DEBUG, module, fmt::format(__VA_ARGS__))
+#define LOG_INFOF(logger, module, ...) ROCKETSIM_LOG_AT(logger, LogLevel::INFO, module, fmt::format(__VA_ARGS__))
+#define LOG_WARNF(logger, module, ...) ROCKETSIM_LOG_AT(logger, LogLevel::WARN, module, fmt::format(__VA_ARGS__))
+#define LOG_ERRORF(logger, module, ...) ROCKETSIM_LOG_AT(logger, LogLevel::ERROR, module, fmt::format(__VA_ARGS__))
 
 #endif
\ No newline at end of file
@@ -13,14 +13,11 @@ public:
     ~SpdlogLogger() override = default;
 
     void log(LogLevel level, const std::string& module, const std::string& message) override;
-    void log_orbit(LogLevel level, const std::string& module, float time,
-                   const glm::vec3& position, float radius, const glm::vec3& velocity) override;
 
     void set_level(LogLevel level) override;
 
 private:
     std::shared_ptr<spdlog::logger> logger_; // Main logger (console and log file)
-    std::shared_ptr<spdlog::logger> csv_logger_; // CSV logger (structured data)
 };
 
 #endif
\ No newline at end of file
@@ -35,6 +35,7 @@ public:
     // --- Orbit trajectory ---
     void setTrajectory(std::unique_ptr<Trajectory> trajectory) { trajectory_ = std::move(trajectory); }
     bool hasTrajectory() const { return trajectory_ != nullptr; }
+    Trajectory* getTrajectory() const { return trajectory_.get(); }
 
     // Update trajectory with current position (called each physics step)
     void updateTrajectory(const glm::dvec3& position, double renderScale, float deltaTime) {
@@ -0,0 +1,68 @@
+#ifndef ROCKET_RENDERER_H
+#define ROCKET_RENDERER_H
+
+#include "app/config.h"
+#include "core/checkpoint.h"
+#include "core/covariance.h"
+#include "core/snapshot.h"
+#include "logging/logger.h"
+#include "rendering/render_object.h"
+#include "rendering/shader.h"
+#include "rendering/trajectory.h"
+
+#include <glm/glm.hpp>
+#include <memory>
+#include <vector>
+
+/**
+ * RocketRenderer - Draws the rocket from published snapshots.
+ *
+ * Owns the rocket mesh, the flown trail, the predicted trajectory and the
+ * uncertainty outlines along it, so the Rocket itself holds physics only.
+ * Everything here runs on the render thread.
+ */
+class RocketRenderer {
+public:
+    RocketRenderer(const Config& config, std::shared_ptr<ILogger> logger);
+
+    // Non-copyable (owns GPU resources)
+    RocketRenderer(const RocketRenderer&) = delete;
+    RocketRenderer& operator=(const RocketRenderer&) = delete;
+
+    // Create the GPU resources that were not injected
+    void init();
+
+    // Feed the flown and predicted trajectories from a snapshot
+    void syncRender(const RocketSnapshot& state);
+    void render(const Shader& shader, const glm::dvec3& renderOrigin, const RocketSnapshot& state) const;
+
+    // Checkpoints: the flown path. Restoring without a trail clears it (as
+    // a replay seek does); either way sampling carries on from the rocket's
+    // restored clock
+    void saveTrail(TrailCheckpoint& trail) const;
+    void restoreTrail(const TrailCheckpoint* trail, float rocketTime);
+
+    // For unit tests
+    void setRender(std::unique_ptr<IRenderObject> render);
+    void setTrajectoryRender(std::unique_ptr<IRenderObject> trajectory, std::unique_ptr<IRenderObject> prediction);
+
+private:
+    const Config& config_;
+    std::shared_ptr<ILogger> logger_;
+
+    std::unique_ptr<IRenderObject> renderObject_;            // Rocket mesh
+    std::unique_ptr<Trajectory> trajectory_;                 // Rocket flight trajectory
+    std::unique_ptr<Trajectory> prediction_;                 // Predicted trajectory
+    std::vector<std::unique_ptr<Trajectory>> uncertainty_;   // 1- and 3-sigma outlines, two per ellipsoid
+
+    // What the trajectories currently show
+    float renderedTime_ = 0.0f;
+    size_t renderedPrediction_ = 0;
+
+    // Physics position (m) to heliocentric render coordinates
+    glm::vec3 toRender(const glm::dvec3& position) const;
+    // Rebuild the error ellipsoid outlines drawn along the prediction
+    void updateUncertaintyOutlines(const std::vector<ErrorEllipsoid>& ellipsoids);
+};
+
+#endif // ROCKET_RENDERER_H
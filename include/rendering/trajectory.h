@@ -46,6 +46,12 @@ public:
 
     void setSampleTimer(float sampleTimer);
     void setPoints(std::vector<glm::vec3> points);
+    bool isStatic() const { return config_.isStatic; }
+
+    // Ring buffer contents, oldest point first (for checkpoints)
+    std::vector<glm::vec3> getHistory() const;
+    // Refill the ring with the newest maxPoints of `points`; uploaded on the next render
+    void restoreHistory(const std::vector<glm::vec3>& points, float sampleTimer);
 
     // For testing
     void setRenderObject(std::unique_ptr<IRenderObject> renderObject) {
@@ -71,8 +77,11 @@ private:
     size_t dirtyEnd_ = 0;    // One past the last modified index
     bool dirtyWrapped_ = false;  // True if dirty region wraps around the ring buffer
 
+    std::vector<GLfloat> staging_;  // Upload scratch for flushToGPU
+
     // Flush pending point data to the GPU (called before render)
     void flushToGPU();
+    void uploadRange(size_t first, size_t count);
 
     // Mark an index as modified
     void markDirty(size_t index);
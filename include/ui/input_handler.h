@@ -3,10 +3,12 @@
 
 #include "app/config.h"
 #include "core/simulation.h"
+#include "core/flight_replay.h"
 
 #include <GLFW/glfw3.h>
 #include <unordered_map>
 #include <functional>
+#include <string>
 
 class InputHandler {
 public:
@@ -30,11 +32,15 @@ public:
         toggleOrbitalInfoCallback_ = callback;
     }
 
+    // While replaying, Space/Q/E/R drive playback instead of the rocket and time scale
+    void setReplay(FlightReplay* replay) { replay_ = replay; }
+
 private:
     GLFWwindow* window;
     Simulation& simulation;
     double rotationSpeed;
     double directionCooldown;
+    std::string checkpointPath;
     std::unordered_map<int, double> lastPressTimes;
 
     float lastX, lastY;
@@ -44,6 +50,7 @@ private:
     ToggleCallback togglePlanetLabelsCallback_;
     ToggleCallback toggleNavBallCallback_;
     ToggleCallback toggleOrbitalInfoCallback_;
+    FlightReplay* replay_ = nullptr;
 };
 
 #endif
\ No newline at end of file
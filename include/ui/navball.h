@@ -1,7 +1,7 @@
 #ifndef NAVBALL_H
 #define NAVBALL_H
 
-#include "core/rocket.h"
+#include "core/snapshot.h"
 
 #include <imgui.h>
 #include <glm/glm.hpp>
@@ -31,7 +31,7 @@ public:
      * @param panelY Y position of the panel
      * @param size Size of the navball (diameter)
      */
-    void render(const Rocket& rocket, const glm::vec3& earthPos, 
+    void render(const RocketSnapshot& rocket, const glm::vec3& earthPos, 
                 float panelX, float panelY, float size = 150.0f);
 
 private:
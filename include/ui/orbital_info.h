@@ -3,7 +3,7 @@
 
 #include "app/config.h"
 #include "core/orbital_elements.h"
-#include "core/rocket.h"
+#include "core/snapshot.h"
 
 #include <imgui.h>
 #include <glm/glm.hpp>
@@ -11,10 +11,6 @@
 #include <unordered_map>
 #include <memory>
 
-// Forward declaration
-class Body;
-using BODY_MAP = std::unordered_map<std::string, std::unique_ptr<Body>>;
-
 /**
  * OrbitalInfo - UI panel displaying orbital elements
  */
@@ -25,21 +21,17 @@ public:
     
     /**
      * Render the orbital info panel
-     * @param rocket The rocket to display orbital info for
-     * @param bodies Map of celestial bodies
+     * @param state Published simulation state (reference body = innermost SOI)
      * @param panelX X position of the panel
      * @param panelY Y position of the panel
      */
-    void render(const Rocket& rocket, const BODY_MAP& bodies, 
-                float panelX, float panelY);
+    void render(const SimulationSnapshot& state, float panelX, float panelY);
 
 private:
     const Config* config_;  // Config reference for body parameters
     
     // Get body radius by name from config (meters)
     double getBodyRadius(const std::string& name) const;
-    // Find the most influential body (for determining SOI)
-    std::string findDominantBody(const glm::dvec3& position, const BODY_MAP& bodies) const;
     
     // Render a single orbital element with label and value
     void renderElement(const char* label, const std::string& value, 
@@ -0,0 +1,69 @@
+#ifndef PORKCHOP_PANEL_H
+#define PORKCHOP_PANEL_H
+
+#include "app/config.h"
+#include "core/porkchop.h"
+#include "core/snapshot.h"
+
+#include <GL/glew.h>
+#include <imgui.h>
+#include <future>
+#include <string>
+#include <vector>
+
+/**
+ * PorkchopPanel - UI panel for planning transfers between the planets
+ *
+ * Sweeps departure and arrival dates (days from now) between two children
+ * of the root body and shows the delta-v as a banded contour texture.
+ * The sweep runs in the background on a pool of its own, never on the
+ * physics' shared JobSystem, and render() picks the grid up when it is done.
+ */
+class PorkchopPanel {
+public:
+    PorkchopPanel() : config_(nullptr) {}
+    explicit PorkchopPanel(const Config& config) : config_(&config) {}
+    ~PorkchopPanel();   // Waits for a sweep in progress
+
+    PorkchopPanel(const PorkchopPanel&) = delete;
+    PorkchopPanel& operator=(const PorkchopPanel&) = delete;
+
+    /**
+     * Render the panel
+     * @param state Published simulation state; candidates are the root's children
+     * @param panelX X position of the panel
+     * @param panelY Y position of the panel
+     */
+    void render(const SimulationSnapshot& state, float panelX, float panelY);
+
+private:
+    const Config* config_;  // Config reference for the gravitational constant
+
+    int departureBody_ = -1;  // Indices into SimulationSnapshot::bodies
+    int arrivalBody_ = -1;
+    float departureWindow_[2] = {0.0f, 800.0f};  // Days from now
+    float arrivalWindow_[2] = {100.0f, 1200.0f};
+    int gridSize_ = 300;
+    int maxRevolutions_ = 0;
+
+    struct Sweep {
+        Porkchop grid;
+        std::string label;
+        double seconds = 0.0;
+    };
+    std::future<Sweep> pending_;   // Valid while a sweep runs
+
+    Porkchop grid_;
+    std::string gridLabel_;
+    double computeSeconds_ = 0.0;
+    float minDeltaV_ = 0.0f;
+    float maxDeltaV_ = 0.0f;
+    GLuint texture_ = 0;
+
+    void compute(const SimulationSnapshot& state);   // Starts a sweep
+    void collect();                                  // Takes a finished sweep
+    void uploadTexture();
+    void renderPlot();
+};
+
+#endif // PORKCHOP_PANEL_H
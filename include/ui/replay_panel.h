@@ -0,0 +1,34 @@
+#ifndef REPLAY_PANEL_H
+#define REPLAY_PANEL_H
+
+#include "core/flight_replay.h"
+
+#include <imgui.h>
+
+/**
+ * ReplayPanel - timeline for a FlightReplay
+ *
+ * Play/pause, playback speed and a slider over the whole recording; a
+ * seek anywhere takes effect on the next frame.
+ */
+class ReplayPanel {
+public:
+    static constexpr double kMinSpeed = 1.0 / 16.0;
+    static constexpr double kMaxSpeed = 1e6;
+
+    void setReplay(FlightReplay* replay) { replay_ = replay; }
+    bool active() const { return replay_ != nullptr; }
+
+    /**
+     * Render the panel
+     * @param panelX X position of the panel
+     * @param panelY Y position of the panel
+     * @param panelWidth Width of the panel
+     */
+    void render(float panelX, float panelY, float panelWidth);
+
+private:
+    FlightReplay* replay_ = nullptr;
+};
+
+#endif // REPLAY_PANEL_H
@@ -2,11 +2,13 @@
 #define UI_H
 
 #include "app/map.h"
-#include "core/rocket.h"
+#include "core/snapshot.h"
 #include "rendering/camera.h"
 #include "ui/fps_counter.h"
 #include "ui/navball.h"
 #include "ui/orbital_info.h"
+#include "ui/porkchop_panel.h"
+#include "ui/replay_panel.h"
 
 #include <imgui.h>
 #include <imgui_impl_glfw.h>
@@ -23,11 +25,13 @@ public:
 
     UI(GLFWwindow* win, Simulation& sim);
     ~UI();
-    void render(float timeScale, const Rocket& rocket, const Camera& camera, int width, int height);
+    // Everything shown comes from one published snapshot
+    void render(const SimulationSnapshot& state, const Camera& camera, int width, int height);
     void shutdown();
     void renderFPS();
     void renderCameraMode(const Camera& camera, int width, int height);
     void renderBodySelector(const Camera& camera, int width, int height);
+    void renderEncounters(const SimulationSnapshot& state, float panelX, float panelY);
     
     // Set pending planet label render data (called before render())
     void renderPlanetLabels(const Camera& camera, const glm::mat4& projection, const glm::mat4& view, 
@@ -50,6 +54,13 @@ public:
     // Toggle Orbital Info visibility
     void toggleOrbitalInfo() { showOrbitalInfo_ = !showOrbitalInfo_; }
     bool isOrbitalInfoVisible() const { return showOrbitalInfo_; }
+    
+    // Toggle Transfer Planner visibility
+    void togglePorkchop() { showPorkchop_ = !showPorkchop_; }
+    bool isPorkchopVisible() const { return showPorkchop_; }
+
+    // Show the timeline for a replay in progress; nullptr for live physics
+    void setReplay(FlightReplay* replay) { replayPanel_.setReplay(replay); }
 
 private:
     GLFWwindow* window_;
@@ -62,8 +73,11 @@ private:
     bool showPlanetLabels_ = true;  // Show planet labels in solar system view
     bool showNavBall_ = true;       // Show NavBall HUD
     bool showOrbitalInfo_ = true;   // Show Orbital Info panel
+    bool showPorkchop_ = true;      // Show Transfer Planner panel
     NavBall navBall_;               // NavBall instance
     OrbitalInfo orbitalInfo_;       // Orbital Info instance
+    PorkchopPanel porkchop_;        // Transfer Planner instance
+    ReplayPanel replayPanel_;       // Replay timeline, active only when replaying
     
     // Pending planet label render data
     bool hasPendingLabelRender_ = false;
@@ -76,7 +90,7 @@ private:
                             const glm::mat4& view, int width, int height);
     
     // Internal function to actually render planet labels (called within ImGui frame)
-    void renderPlanetLabelsInternal(const Camera& camera, const glm::mat4& projection, 
+    void renderPlanetLabelsInternal(const SimulationSnapshot& state, const Camera& camera, const glm::mat4& projection, 
                                     const glm::mat4& view, float scale, int width, int height);
 };
 #endif
\ No newline at end of file
@@ -3,8 +3,10 @@
 
 #include "app/app.h"
 
-App::App(const std::string& title, int width, int height, Config& config, std::shared_ptr<ILogger> logger, Camera& camera) 
-    : window(nullptr), config(config), simulation(Simulation(config, logger, camera)) {
+App::App(const std::string& title, int width, int height, Config& config, std::shared_ptr<ILogger> logger, Camera& camera,
+         const std::string& replayPath)
+    : window(nullptr), config(config), jobs(std::make_unique<JobSystem>(config.simulation_job_threads)),
+      simulation(Simulation(config, logger, camera)) {
     if (!glfwInit()) 
         throw std::runtime_error("Failed to initialize GLFW");
 
@@ -26,9 +28,18 @@ App::App(const std::string& title, int width, int height, Config& config, std::s
     }
 
     shader.init();
+    simulation.setJobSystem(jobs.get());
     simulation.init();
     inputHandler = std::make_unique<InputHandler>(window, simulation, config);
     ui = std::make_unique<UI>(window, simulation);
+
+    // The initial snapshot supplies what a recording lacks: the body tree, masses and SOIs
+    if (!replayPath.empty()) {
+        replay = std::make_unique<FlightReplay>(replayPath, simulation.latestSnapshot());
+        replay->setStageNames(simulation.getRocket().getStageNames());
+        inputHandler->setReplay(replay.get());
+        ui->setReplay(replay.get());
+    }
     
     // Set up callback for body selection
     ui->setBodySelectCallback([this](const std::string& bodyName) {
@@ -60,6 +71,12 @@ App::~App() {
 }
 
 void App::run() {
+    // Physics at its own rate; this loop only renders published snapshots
+    if (config.simulation_physics_thread && !replay) {
+        physics = std::make_unique<PhysicsThread>(simulation.getCore(), config.simulation_physics_rate);
+        physics->start();
+    }
+
     double lastTime = glfwGetTime();
     while (!glfwWindowShouldClose(window)) {
         double currentTime = glfwGetTime();
@@ -69,7 +86,13 @@ void App::run() {
         glfwPollEvents();
         inputHandler->process(simulation);
 
-        simulation.update(deltaTime);
+        if (replay) {
+            replay->advance(deltaTime);
+        } else if (!physics) {
+            simulation.update(deltaTime);
+        }
+        const SimulationSnapshot& state = replay ? replay->current() : simulation.latestSnapshot();
+        simulation.syncRender(state);
 
         int width, height;
         glfwGetFramebufferSize(window, &width, &height);
@@ -77,7 +100,7 @@ void App::run() {
         glClearColor(0.1f, 0.1f, 0.2f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-        simulation.render(shader);
+        simulation.render(shader, state);
         
         // Get matrices for planet label rendering
         glm::mat4 projection, view;
@@ -85,7 +108,11 @@ void App::run() {
         ui->renderPlanetLabels(simulation.getCamera(), projection, view, 
                                simulation.getRenderScale(), width, height);
         
-        ui->render(simulation.getTimeScale(), simulation.getRocket(), simulation.getCamera(), width, height);
+        ui->render(state, simulation.getCamera(), width, height);
         glfwSwapBuffers(window);
     }
+
+    if (physics) {
+        physics->stop();
+    }
 }
\ No newline at end of file
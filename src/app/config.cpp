@@ -32,6 +32,7 @@ void Config::setDefaults() {
     rocket_initial_velocity = {0.0, 0.0, 0.0};
     rocket_rotation_speed = 360.0f;
     rocket_direction_cooldown = 0.05f;
+    rocket_stages.clear();
     flight_plan_path = "etc/flight_plan.json";
 
     // Physics parameters
@@ -39,10 +40,14 @@ void Config::setDefaults() {
     physics_earth_radius = 6371000.0;
     physics_gravity_constant = 6.674e-11;
     physics_earth_mass = 5.972e24;
-    physics_air_density = 1.225;
-    physics_scale_height = 8000.0;
     physics_drag_coefficient = 0.13;
     physics_cross_section_area = 1.0;
+    physics_earth_j2 = 0.0;
+    physics_perturber_tolerance = 1e-7;
+    physics_perturber_refresh_interval = 60.0;
+    physics_atmosphere_resolution = 100.0;
+    physics_atmosphere_ceiling = 100000.0;
+    physics_drag_mach_table.clear();
     // Moon parameters
     physics_moon_radius = 1737100.0;
     physics_moon_mass = 7.34767309e22;
@@ -82,15 +87,49 @@ void Config::setDefaults() {
     simulation_prediction_duration = 30.0f;
     simulation_prediction_step = 0.1f;
     simulation_rendering_scale = 0.001f;
+    simulation_event_tolerance = 1e-6;
+    simulation_block_timesteps = true;
+    simulation_block_max_step = 345600.0;
+    simulation_block_eta = 0.005;
+    simulation_block_max_level = 16;
+    simulation_encke = true;
+    simulation_encke_rectify_ratio = 1e-3;
+    simulation_encke_step_scale = 4.0f;
+    simulation_ks = true;
+    simulation_ks_eccentricity = 0.9;
+    simulation_ks_step_fraction = 0.05;
+    simulation_ks_anomaly_step = 0.0314;
+    simulation_burn_step_scale = 2.0f;
+    simulation_covariance = false;
+    simulation_covariance_position_sigma = 100.0;
+    simulation_covariance_velocity_sigma = 0.1;
+    simulation_covariance_ellipsoids = 8;
+    simulation_encounters = true;
+    simulation_encounter_budget_ms = 0.5;
+    simulation_physics_thread = true;
+    simulation_physics_rate = 240.0;
+    simulation_job_threads = 0;
     
     // Trajectory colors
     trajectory_rocket_color = {1.0f, 0.0f, 0.0f, 1.0f};
     trajectory_prediction_color = {0.0f, 1.0f, 0.0f, 0.7f};
+    trajectory_covariance_color = {1.0f, 0.6f, 0.0f, 0.8f};
     trajectory_moon_color = {0.5f, 0.5f, 0.5f, 0.8f};
     trajectory_earth_color = {0.0f, 0.5f, 1.0f, 0.8f};
 
     // Logger settings
     logger_level = 3; // 0: DEBUG, 1: INFO, 2: WARN, 3: ERROR
+    logger_async = true;
+    logger_block_when_full = false;
+
+    // Telemetry recording
+    telemetry_enabled = false;
+    telemetry_path = "logs/telemetry.rst";
+    telemetry_interval = 0.1;
+    telemetry_compress = true;
+
+    // Checkpoints
+    checkpoint_path = "saves/quicksave.rsc";
 
     // Camera settings
     camera_pitch = 45.0f;
@@ -134,6 +173,35 @@ void Config::parseConfig(const json& config) {
         rocket_rotation_speed = rocket.value("rotation_speed", rocket_rotation_speed);
         rocket_direction_cooldown = rocket.value("direction_cooldown", rocket_direction_cooldown);
         flight_plan_path = rocket.value("flight_plan_path", flight_plan_path);
+        if (rocket.contains("stages")) {
+            // A scalar "thrust" / "isp" is shorthand for a one-point curve
+            auto parseCurve = [](const json& stage, const char* curveKey, const char* scalarKey,
+                                 const std::string& what) {
+                std::vector<std::pair<double, double>> curve;
+                if (stage.contains(curveKey)) {
+                    for (const auto& point : stage[curveKey]) {
+                        if (!point.is_array() || point.size() != 2) {
+                            throw ConfigError("rocket.stages " + what + " entries must be pairs");
+                        }
+                        curve.emplace_back(point[0].get<double>(), point[1].get<double>());
+                    }
+                } else if (stage.contains(scalarKey)) {
+                    curve.emplace_back(0.0, stage[scalarKey].get<double>());
+                }
+                return curve;
+            };
+
+            rocket_stages.clear();
+            for (const auto& stage : rocket["stages"]) {
+                RocketStageConfig s;
+                s.name = stage.value("name", "stage " + std::to_string(rocket_stages.size() + 1));
+                s.dry_mass = stage.value("dry_mass", s.dry_mass);
+                s.propellant_mass = stage.value("propellant_mass", s.propellant_mass);
+                s.thrust_curve = parseCurve(stage, "thrust_curve", "thrust", "thrust_curve [time, thrust]");
+                s.isp_curve = parseCurve(stage, "isp_curve", "isp", "isp_curve [pressure, isp]");
+                rocket_stages.push_back(std::move(s));
+            }
+        }
     }
 
     // Physics parameters
@@ -143,10 +211,22 @@ void Config::parseConfig(const json& config) {
         physics_earth_radius = physics.value("earth_radius", physics_earth_radius);
         physics_gravity_constant = physics.value("gravity_constant", physics_gravity_constant);
         physics_earth_mass = physics.value("earth_mass", physics_earth_mass);
-        physics_air_density = physics.value("air_density", physics_air_density);
-        physics_scale_height = physics.value("scale_height", physics_scale_height);
         physics_drag_coefficient = physics.value("drag_coefficient", physics_drag_coefficient);
         physics_cross_section_area = physics.value("cross_section_area", physics_cross_section_area);
+        physics_earth_j2 = physics.value("earth_j2", physics_earth_j2);
+        physics_perturber_tolerance = physics.value("perturber_tolerance", physics_perturber_tolerance);
+        physics_perturber_refresh_interval = physics.value("perturber_refresh_interval", physics_perturber_refresh_interval);
+        physics_atmosphere_resolution = physics.value("atmosphere_resolution", physics_atmosphere_resolution);
+        physics_atmosphere_ceiling = physics.value("atmosphere_ceiling", physics_atmosphere_ceiling);
+        if (physics.contains("drag_mach_table")) {
+            physics_drag_mach_table.clear();
+            for (const auto& point : physics["drag_mach_table"]) {
+                if (!point.is_array() || point.size() != 2) {
+                    throw ConfigError("physics.drag_mach_table entries must be [mach, cd] pairs");
+                }
+                physics_drag_mach_table.emplace_back(point[0].get<double>(), point[1].get<double>());
+            }
+        }
         // Moon parameters
         physics_moon_radius = physics.value("moon_radius", physics_moon_radius);
         physics_moon_mass = physics.value("moon_mass", physics_moon_mass);
@@ -167,9 +247,18 @@ void Config::parseConfig(const json& config) {
                     planet.mass             = p.value("mass",             planet.mass);
                     planet.orbit_radius     = p.value("orbit_radius",     planet.orbit_radius);
                     planet.orbital_velocity = p.value("orbital_velocity", planet.orbital_velocity);
+                    planet.parent           = p.value("parent",           planet.parent);
                     if (p.contains("inclination_deg")) {
                         planet.orbital_inclination = glm::radians(p["inclination_deg"].get<float>());
                     }
+                    if (p.contains("atmosphere")) {
+                        const auto& a = p["atmosphere"];
+                        planet.atmosphere.altitudes    = a.value("altitudes",    std::vector<double>{});
+                        planet.atmosphere.densities    = a.value("densities",    std::vector<double>{});
+                        planet.atmosphere.temperatures = a.value("temperatures", std::vector<double>{});
+                        planet.atmosphere.gas_constant = a.value("gas_constant", planet.atmosphere.gas_constant);
+                        planet.atmosphere.gamma        = a.value("gamma",        planet.atmosphere.gamma);
+                    }
                 }
             }
         }
@@ -190,6 +279,28 @@ void Config::parseConfig(const json& config) {
         simulation_prediction_duration = simulation.value("prediction_duration", simulation_prediction_duration);
         simulation_prediction_step = simulation.value("prediction_step", simulation_prediction_step);
         simulation_rendering_scale = simulation.value("rendering_scale", simulation_rendering_scale);
+        simulation_event_tolerance = simulation.value("event_tolerance", simulation_event_tolerance);
+        simulation_block_timesteps = simulation.value("block_timesteps", simulation_block_timesteps);
+        simulation_block_max_step = simulation.value("block_max_step", simulation_block_max_step);
+        simulation_block_eta = simulation.value("block_eta", simulation_block_eta);
+        simulation_block_max_level = simulation.value("block_max_level", simulation_block_max_level);
+        simulation_encke = simulation.value("encke", simulation_encke);
+        simulation_encke_rectify_ratio = simulation.value("encke_rectify_ratio", simulation_encke_rectify_ratio);
+        simulation_encke_step_scale = simulation.value("encke_step_scale", simulation_encke_step_scale);
+        simulation_ks = simulation.value("ks", simulation_ks);
+        simulation_ks_eccentricity = simulation.value("ks_eccentricity", simulation_ks_eccentricity);
+        simulation_ks_step_fraction = simulation.value("ks_step_fraction", simulation_ks_step_fraction);
+        simulation_ks_anomaly_step = simulation.value("ks_anomaly_step", simulation_ks_anomaly_step);
+        simulation_burn_step_scale = simulation.value("burn_step_scale", simulation_burn_step_scale);
+        simulation_covariance = simulation.value("covariance", simulation_covariance);
+        simulation_covariance_position_sigma = simulation.value("covariance_position_sigma", simulation_covariance_position_sigma);
+        simulation_covariance_velocity_sigma = simulation.value("covariance_velocity_sigma", simulation_covariance_velocity_sigma);
+        simulation_covariance_ellipsoids = simulation.value("covariance_ellipsoids", simulation_covariance_ellipsoids);
+        simulation_encounters = simulation.value("encounters", simulation_encounters);
+        simulation_encounter_budget_ms = simulation.value("encounter_budget_ms", simulation_encounter_budget_ms);
+        simulation_physics_thread = simulation.value("physics_thread", simulation_physics_thread);
+        simulation_physics_rate = simulation.value("physics_rate", simulation_physics_rate);
+        simulation_job_threads = simulation.value("job_threads", simulation_job_threads);
     }
     
     // Trajectory colors
@@ -208,6 +319,9 @@ void Config::parseConfig(const json& config) {
         if (traj.contains("prediction_color")) {
             trajectory_prediction_color = parseColor(traj["prediction_color"], trajectory_prediction_color);
         }
+        if (traj.contains("covariance_color")) {
+            trajectory_covariance_color = parseColor(traj["covariance_color"], trajectory_covariance_color);
+        }
         if (traj.contains("moon_color")) {
             trajectory_moon_color = parseColor(traj["moon_color"], trajectory_moon_color);
         }
@@ -220,6 +334,23 @@ void Config::parseConfig(const json& config) {
     if (config.contains("logger")) {
         const auto& logger = config["logger"];
         logger_level = logger.value("level", logger_level);
+        logger_async = logger.value("async", logger_async);
+        logger_block_when_full = logger.value("block_when_full", logger_block_when_full);
+    }
+
+    // Telemetry recording
+    if (config.contains("telemetry")) {
+        const auto& telemetry = config["telemetry"];
+        telemetry_enabled = telemetry.value("enabled", telemetry_enabled);
+        telemetry_path = telemetry.value("path", telemetry_path);
+        telemetry_interval = telemetry.value("interval", telemetry_interval);
+        telemetry_compress = telemetry.value("compress", telemetry_compress);
+    }
+
+    // Checkpoints
+    if (config.contains("checkpoint")) {
+        const auto& checkpoint = config["checkpoint"];
+        checkpoint_path = checkpoint.value("path", checkpoint_path);
     }
 
     // Camera settings
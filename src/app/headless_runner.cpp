@@ -0,0 +1,69 @@
+#include "app/headless_runner.h"
+
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+
+// The runner starts the recording itself, once the run's first state is known
+Config withoutTelemetry(Config config, const HeadlessOptions& options) {
+    config.telemetry_enabled = false;
+    config.telemetry_interval = options.telemetryInterval;
+    return config;
+}
+
+}  // namespace
+
+HeadlessRunner::HeadlessRunner(const Config& config, std::shared_ptr<ILogger> logger, const HeadlessOptions& options)
+    : core_(withoutTelemetry(config, options), logger), options_(options), logger_(logger) {
+    if (!(options_.step > 0.0) || !(options_.duration >= 0.0)) {
+        throw std::invalid_argument("HeadlessRunner: step must be positive and duration non-negative");
+    }
+}
+
+HeadlessResult HeadlessRunner::run() {
+    const auto start = std::chrono::steady_clock::now();
+    core_.init();
+    if (!options_.restorePath.empty()) {
+        core_.restoreCheckpoint(options_.restorePath);
+    }
+    core_.setTimeScale(1.0f);
+    if (options_.launch && !core_.getRocket().isLaunched()) {
+        core_.post({SimulationCommand::Type::ToggleLaunch});
+    }
+    if (!options_.telemetryPath.empty()) {
+        core_.startRecording(options_.telemetryPath);
+    }
+
+    HeadlessResult result;
+    auto sample = [&](const SimulationSnapshot& state) {
+        result.simulatedTime = state.time;
+        result.crashed = state.rocket.crashed;
+    };
+    sample(core_.latestSnapshot());
+
+    const uint64_t steps = static_cast<uint64_t>(std::ceil(options_.duration / options_.step - 1e-9));
+    for (uint64_t i = 0; i < steps && !result.crashed; ++i) {
+        core_.update(static_cast<float>(options_.step));
+        ++result.steps;
+        sample(core_.latestSnapshot());
+    }
+    if (result.crashed) {
+        LOG_INFO(logger_, "HeadlessRunner", "Rocket crashed at t=" + std::to_string(result.simulatedTime) + " s");
+    }
+    if (const FlightRecorder* recorder = core_.getRecorder()) {
+        result.telemetryRows = recorder->rows();
+        core_.stopRecording();   // Writes out the last chunk and the index
+    }
+    if (!options_.checkpointPath.empty()) {
+        core_.saveCheckpoint(options_.checkpointPath);
+        core_.flushCheckpoints();
+        if (core_.getCheckpointWriter().failed() > 0) {
+            throw CheckpointError("Failed to save a checkpoint to " + options_.checkpointPath);
+        }
+    }
+
+    result.wallTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
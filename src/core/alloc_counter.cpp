@@ -0,0 +1,69 @@
+#include "core/alloc_counter.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#ifdef ROCKETSIM_COUNT_ALLOCATIONS
+
+namespace {
+
+std::atomic<uint64_t> allocationCount{0};
+std::atomic<uint64_t> allocationBytes{0};
+
+void* countedAlloc(std::size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    allocationBytes.fetch_add(size, std::memory_order_relaxed);
+    return std::malloc(size > 0 ? size : 1);
+}
+
+void* countedAlignedAlloc(std::size_t size, std::size_t alignment) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    allocationBytes.fetch_add(size, std::memory_order_relaxed);
+    // aligned_alloc wants a multiple of the alignment
+    std::size_t rounded = (size + alignment - 1) / alignment * alignment;
+    return std::aligned_alloc(alignment, rounded > 0 ? rounded : alignment);
+}
+
+void* throwingAlloc(void* p) {
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+}  // namespace
+
+void* operator new(std::size_t size) { return throwingAlloc(countedAlloc(size)); }
+void* operator new[](std::size_t size) { return throwingAlloc(countedAlloc(size)); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return countedAlloc(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return countedAlloc(size); }
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    return throwingAlloc(countedAlignedAlloc(size, static_cast<std::size_t>(alignment)));
+}
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    return throwingAlloc(countedAlignedAlloc(size, static_cast<std::size_t>(alignment)));
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+
+bool AllocationCounter::enabled() { return true; }
+uint64_t AllocationCounter::count() { return allocationCount.load(std::memory_order_relaxed); }
+uint64_t AllocationCounter::bytes() { return allocationBytes.load(std::memory_order_relaxed); }
+
+#else
+
+bool AllocationCounter::enabled() { return false; }
+uint64_t AllocationCounter::count() { return 0; }
+uint64_t AllocationCounter::bytes() { return 0; }
+
+#endif
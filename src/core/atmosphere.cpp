@@ -0,0 +1,230 @@
+#include "core/atmosphere.h"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+namespace {
+
+// U.S. Standard Atmosphere 1976 constants
+constexpr double kUs76EarthRadius = 6356766.0;    // Effective radius for geopotential altitude (m)
+constexpr double kUs76G0 = 9.80665;               // m/s^2
+constexpr double kUs76GasConstant = 287.0528;     // Specific gas constant of air J/(kg K)
+constexpr double kUs76Gamma = 1.4;
+
+struct Us76Layer {
+    double baseAltitude;   // Geopotential (m)
+    double lapseRate;      // K/m
+};
+
+constexpr Us76Layer kUs76Layers[] = {
+    {0.0,     -0.0065},
+    {11000.0,  0.0},
+    {20000.0,  0.0010},
+    {32000.0,  0.0028},
+    {47000.0,  0.0},
+    {51000.0, -0.0028},
+    {71000.0, -0.0020},
+};
+constexpr size_t kUs76LayerCount = sizeof(kUs76Layers) / sizeof(kUs76Layers[0]);
+
+// Pressure after climbing dh within a layer starting at (T, P) with lapse rate L
+double layerPressure(double T, double P, double L, double dh) {
+    if (L == 0.0) {
+        return P * std::exp(-kUs76G0 * dh / (kUs76GasConstant * T));
+    }
+    return P * std::pow(T / (T + L * dh), kUs76G0 / (kUs76GasConstant * L));
+}
+
+size_t gridSize(double extent, double step) {
+    return std::max<size_t>(2, static_cast<size_t>(std::ceil(extent / step)) + 1);
+}
+
+}  // namespace
+
+// ============================================================
+// AtmosphereTable implementation
+// ============================================================
+
+AtmosphereTable AtmosphereTable::us76(double resolution, double ceiling) {
+    if (resolution <= 0.0 || ceiling <= 0.0) {
+        throw ConfigError("Atmosphere resolution and ceiling must be positive");
+    }
+
+    // Base temperature and pressure of each layer
+    double baseT[kUs76LayerCount];
+    double baseP[kUs76LayerCount];
+    baseT[0] = 288.15;
+    baseP[0] = 101325.0;
+    for (size_t i = 1; i < kUs76LayerCount; ++i) {
+        double dh = kUs76Layers[i].baseAltitude - kUs76Layers[i - 1].baseAltitude;
+        baseT[i] = baseT[i - 1] + kUs76Layers[i - 1].lapseRate * dh;
+        baseP[i] = layerPressure(baseT[i - 1], baseP[i - 1], kUs76Layers[i - 1].lapseRate, dh);
+    }
+
+    AtmosphereTable table;
+    table.step_ = resolution;
+    table.invStep_ = 1.0 / resolution;
+    table.ceiling_ = ceiling;
+
+    size_t n = gridSize(ceiling, resolution);
+    table.density_.resize(n);
+    table.soundSpeed_.resize(n);
+    table.pressure_.resize(n);
+
+    size_t layer = 0;
+    for (size_t k = 0; k < n; ++k) {
+        double z = static_cast<double>(k) * resolution;
+        double h = kUs76EarthRadius * z / (kUs76EarthRadius + z);  // Geopotential altitude
+        while (layer + 1 < kUs76LayerCount && h >= kUs76Layers[layer + 1].baseAltitude) {
+            ++layer;
+        }
+        double dh = h - kUs76Layers[layer].baseAltitude;
+        double T = baseT[layer] + kUs76Layers[layer].lapseRate * dh;
+        double P = layerPressure(baseT[layer], baseP[layer], kUs76Layers[layer].lapseRate, dh);
+
+        table.density_[k] = P / (kUs76GasConstant * T);
+        table.soundSpeed_[k] = std::sqrt(kUs76Gamma * kUs76GasConstant * T);
+        table.pressure_[k] = P;
+    }
+    return table;
+}
+
+AtmosphereTable AtmosphereTable::fromProfile(const AtmosphereProfile& profile, double resolution) {
+    const auto& alt = profile.altitudes;
+    const auto& rho = profile.densities;
+    const auto& temp = profile.temperatures;
+
+    if (resolution <= 0.0) {
+        throw ConfigError("Atmosphere resolution must be positive");
+    }
+    if (alt.size() < 2 || rho.size() != alt.size() || temp.size() != alt.size()) {
+        throw ConfigError("Atmosphere profile needs at least two samples with matching "
+                          "altitudes, densities and temperatures");
+    }
+    for (size_t i = 0; i < alt.size(); ++i) {
+        if (i > 0 && alt[i] <= alt[i - 1]) {
+            throw ConfigError("Atmosphere profile altitudes must be strictly increasing");
+        }
+        if (rho[i] <= 0.0 || temp[i] <= 0.0) {
+            throw ConfigError("Atmosphere profile densities and temperatures must be positive (sample " +
+                              std::to_string(i) + ")");
+        }
+    }
+
+    AtmosphereTable table;
+    table.step_ = resolution;
+    table.invStep_ = 1.0 / resolution;
+    table.ceiling_ = alt.back();
+
+    size_t n = gridSize(alt.back(), resolution);
+    table.density_.resize(n);
+    table.soundSpeed_.resize(n);
+    table.pressure_.resize(n);
+
+    size_t j = 0;
+    for (size_t k = 0; k < n; ++k) {
+        double z = std::min(static_cast<double>(k) * resolution, alt.back());
+        while (j + 2 < alt.size() && z > alt[j + 1]) {
+            ++j;
+        }
+        double f = std::clamp((z - alt[j]) / (alt[j + 1] - alt[j]), 0.0, 1.0);
+        double T = temp[j] + f * (temp[j + 1] - temp[j]);
+
+        // Log-linear in density: exact for an isothermal layer between samples
+        table.density_[k] = rho[j] * std::pow(rho[j + 1] / rho[j], f);
+        table.soundSpeed_[k] = std::sqrt(profile.gamma * profile.gas_constant * T);
+        table.pressure_[k] = table.density_[k] * profile.gas_constant * T;   // Ideal gas
+    }
+    return table;
+}
+
+void AtmosphereTable::sample(const double* altitudes, double* density, double* soundSpeed, size_t count) const {
+    if (density_.empty()) {
+        std::fill(density, density + count, 0.0);
+        std::fill(soundSpeed, soundSpeed + count, 0.0);
+        return;
+    }
+
+    const double* d = density_.data();
+    const double* a = soundSpeed_.data();
+    const double last = static_cast<double>(density_.size() - 1);
+    const double lastCell = static_cast<double>(density_.size() - 2);
+
+    // Branch-free body (selects only) so the loop vectorizes
+    for (size_t i = 0; i < count; ++i) {
+        double x = altitudes[i] * invStep_;
+        x = x < 0.0 ? 0.0 : (x > last ? last : x);
+        double cell = std::floor(x);
+        cell = cell > lastCell ? lastCell : cell;
+        size_t k = static_cast<size_t>(cell);
+        double f = x - cell;
+
+        double rho = d[k] + f * (d[k + 1] - d[k]);
+        density[i] = altitudes[i] < ceiling_ ? rho : 0.0;
+        soundSpeed[i] = a[k] + f * (a[k + 1] - a[k]);
+    }
+}
+
+// ============================================================
+// DragTable implementation
+// ============================================================
+
+DragTable DragTable::constant(double cd) {
+    DragTable table;
+    table.cd_ = {cd, cd};
+    table.invStep_ = 1.0;
+    return table;
+}
+
+DragTable DragTable::fromPoints(const std::vector<std::pair<double, double>>& points, double resolution) {
+    if (points.empty()) {
+        throw ConfigError("Drag table needs at least one (mach, cd) point");
+    }
+    if (points.size() == 1) {
+        return constant(points.front().second);
+    }
+    if (resolution <= 0.0) {
+        throw ConfigError("Drag table resolution must be positive");
+    }
+    for (size_t i = 0; i < points.size(); ++i) {
+        if (points[i].first < 0.0 || points[i].second < 0.0) {
+            throw ConfigError("Drag table Mach numbers and coefficients must be non-negative");
+        }
+        if (i > 0 && points[i].first <= points[i - 1].first) {
+            throw ConfigError("Drag table Mach numbers must be strictly increasing");
+        }
+    }
+
+    DragTable table;
+    table.invStep_ = 1.0 / resolution;
+    size_t n = gridSize(points.back().first, resolution);
+    table.cd_.resize(n);
+
+    size_t j = 0;
+    for (size_t k = 0; k < n; ++k) {
+        double m = static_cast<double>(k) * resolution;
+        while (j + 2 < points.size() && m > points[j + 1].first) {
+            ++j;
+        }
+        double f = std::clamp((m - points[j].first) / (points[j + 1].first - points[j].first), 0.0, 1.0);
+        table.cd_[k] = points[j].second + f * (points[j + 1].second - points[j].second);
+    }
+    return table;
+}
+
+void DragTable::sample(const double* mach, double* cd, size_t count) const {
+    const double* c = cd_.data();
+    const double last = static_cast<double>(cd_.size() - 1);
+    const double lastCell = static_cast<double>(cd_.size() - 2);
+
+    for (size_t i = 0; i < count; ++i) {
+        double x = mach[i] * invStep_;
+        x = x < 0.0 ? 0.0 : (x > last ? last : x);
+        double cell = std::floor(x);
+        cell = cell > lastCell ? lastCell : cell;
+        size_t k = static_cast<size_t>(cell);
+        double f = x - cell;
+        cd[i] = c[k] + f * (c[k + 1] - c[k]);
+    }
+}
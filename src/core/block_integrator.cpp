@@ -0,0 +1,194 @@
+#include "core/block_integrator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+BlockIntegrator::BlockIntegrator(double G, double maxStep, double eta, int maxLevel)
+    : G_(G), maxStep_(maxStep), eta_(eta), maxLevel_(std::clamp(maxLevel, 0, 30)) {}
+
+void BlockIntegrator::reset(BodyTree& tree) {
+    tree_ = &tree;
+    entries_.clear();
+    entries_.reserve(tree.size());
+    for (size_t i = 0; i < tree.size(); ++i) {
+        const BodyNode& n = tree.node(static_cast<int>(i));
+        entries_.push_back({n.body, n.parent, n.localPosition, n.localPosition, n.localVelocity, glm::dvec3(0.0), 0, 0.0});
+    }
+
+    computeWorld();
+    for (size_t i = 0; i < entries_.size(); ++i) {
+        entries_[i].acceleration = accelerationOf(i);
+    }
+
+    blockStart_ = 0.0;
+    target_ = 0.0;
+    startBlock();
+}
+
+glm::dvec3 BlockIntegrator::predictPosition(const Entry& e, double tau) const {
+    // x0 + v0 t + a0 t^2 / 2 with v0 = v_half - a0 h / 2; at t = h this is the
+    // leapfrog drift x0 + v_half h
+    return e.stepPosition + e.velocity * tau + e.acceleration * (0.5 * tau * (tau - stepOf(e)));
+}
+
+void BlockIntegrator::computeWorld() {
+    // Parents precede their children
+    world_.resize(entries_.size());
+    for (size_t i = 0; i < entries_.size(); ++i) {
+        const Entry& e = entries_[i];
+        world_[i] = e.parent == BodyTree::kNone ? e.position : world_[e.parent] + e.position;
+    }
+}
+
+glm::dvec3 BlockIntegrator::accelerationOf(size_t i) const {
+    // Direct summation with the same 1 m softening as Simulation::computeBodyAcceleration
+    const Entry& e = entries_[i];
+    glm::dvec3 acc(0.0);
+
+    if (e.parent == BodyTree::kNone) {
+        for (size_t j = 0; j < entries_.size(); ++j) {
+            if (j == i) continue;
+            glm::dvec3 delta = world_[j] - world_[i];
+            double distSq = glm::dot(delta, delta);
+            double dist = std::sqrt(distSq);
+            if (dist < 1.0) continue;
+            acc += (G_ * entries_[j].body->mass / (distSq * dist)) * delta;
+        }
+        return acc;
+    }
+
+    // Relative to the parent: two-body term from the local vector, plus the
+    // difference of every other body's pull on the body and on the parent
+    const size_t p = static_cast<size_t>(e.parent);
+    const glm::dvec3& r = e.position;
+    double rSq = glm::dot(r, r);
+    double rLen = std::sqrt(rSq);
+    if (rLen >= 1.0) {
+        acc -= (G_ * (e.body->mass + entries_[p].body->mass) / (rSq * rLen)) * r;
+    }
+    for (size_t j = 0; j < entries_.size(); ++j) {
+        if (j == i || j == p) continue;
+        glm::dvec3 toParent = world_[j] - world_[p];
+        glm::dvec3 toBody = toParent - r;
+        double gm = G_ * entries_[j].body->mass;
+        double dParent = glm::length(toParent);
+        double dBody = glm::length(toBody);
+        if (dBody >= 1.0) acc += (gm / (dBody * dBody * dBody)) * toBody;
+        if (dParent >= 1.0) acc -= (gm / (dParent * dParent * dParent)) * toParent;
+    }
+    return acc;
+}
+
+void BlockIntegrator::assignLevels() {
+    finestLevel_ = 0;
+    for (size_t i = 0; i < entries_.size(); ++i) {
+        // Shortest two-body dynamical time to any other body
+        double tau = std::numeric_limits<double>::infinity();
+        for (size_t j = 0; j < entries_.size(); ++j) {
+            if (j == i) continue;
+            double r = entries_[j].parent == static_cast<int>(i) ? glm::length(entries_[j].position)
+                     : entries_[i].parent == static_cast<int>(j) ? glm::length(entries_[i].position)
+                     : glm::length(world_[j] - world_[i]);
+            double gm = G_ * (entries_[i].body->mass + entries_[j].body->mass);
+            if (r < 1.0 || gm <= 0.0) continue;
+            tau = std::min(tau, std::sqrt(r * r * r / gm));
+        }
+
+        int level = 0;
+        double desired = eta_ * tau;
+        while (level < maxLevel_ && maxStep_ / static_cast<double>(1L << level) > desired) {
+            ++level;
+        }
+        entries_[i].level = level;
+        finestLevel_ = std::max(finestLevel_, level);
+    }
+}
+
+void BlockIntegrator::startBlock() {
+    computeWorld();
+    assignLevels();
+    ticksPerBlock_ = 1L << finestLevel_;
+    tick_ = 0;
+
+    // Opening half kick for every body (all synchronized at a block boundary)
+    for (auto& e : entries_) {
+        e.velocity += e.acceleration * (0.5 * stepOf(e));
+        e.stepPosition = e.position;
+        e.stepStart = blockStart_;
+    }
+}
+
+void BlockIntegrator::doTick() {
+    ++tick_;
+    const double now = tickTime();
+    for (auto& e : entries_) {
+        e.position = predictPosition(e, now - e.stepStart);
+    }
+    computeWorld();
+    const bool blockEnd = (tick_ == ticksPerBlock_);
+
+    // Forces first for every body whose step ends now, at the drifted positions
+    active_.clear();
+    for (size_t i = 0; i < entries_.size(); ++i) {
+        long stride = 1L << (finestLevel_ - entries_[i].level);
+        if (tick_ % stride == 0) {
+            active_.push_back(i);
+        }
+    }
+    newAcc_.resize(active_.size());
+    for (size_t k = 0; k < active_.size(); ++k) {
+        newAcc_[k] = accelerationOf(active_[k]);
+    }
+    forceEvaluations_ += active_.size();
+
+    for (size_t k = 0; k < active_.size(); ++k) {
+        Entry& e = entries_[active_[k]];
+        double half = 0.5 * stepOf(e);
+        e.acceleration = newAcc_[k];
+        e.velocity += e.acceleration * half;          // Closing kick: velocity now synchronized
+        if (!blockEnd) {
+            e.velocity += e.acceleration * half;      // Opening kick of the next step
+            e.stepPosition = e.position;
+            e.stepStart = now;
+        }
+    }
+}
+
+void BlockIntegrator::advance(double dt) {
+    if (entries_.empty() || !(dt > 0.0)) {
+        return;
+    }
+    target_ += dt;
+
+    while (true) {
+        if (tick_ == ticksPerBlock_) {
+            // Block done, velocities synchronized: start the next one
+            blockStart_ += maxStep_;
+            startBlock();
+        }
+        double next = blockStart_ + static_cast<double>(tick_ + 1) * (maxStep_ / ticksPerBlock_);
+        if (next > target_) break;
+        doTick();
+    }
+    present();
+}
+
+void BlockIntegrator::present() {
+    for (size_t i = 0; i < entries_.size(); ++i) {
+        const Entry& e = entries_[i];
+        // Second-order prediction within the body's step; the mid-step
+        // velocity corrected to the presented time
+        const double tau = target_ - e.stepStart;
+        tree_->setLocalState(static_cast<int>(i), predictPosition(e, tau),
+                             e.velocity + e.acceleration * (tau - 0.5 * stepOf(e)));
+    }
+    tree_->updateWorld();
+}
+
+int BlockIntegrator::levelOf(const std::string& name) const {
+    for (const auto& e : entries_) {
+        if (e.body->name == name) return e.level;
+    }
+    return -1;
+}
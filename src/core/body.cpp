@@ -1,7 +1,17 @@
 #include "core/body.h"
 
+#include <stdexcept>
+
+namespace {
+// What a bare state refers to; shared so a temporary Body costs no Config
+const Config& defaultConfig() {
+    static const Config config;
+    return config;
+}
+}  // namespace
+
 // Use as State
-Body::Body() : config_(Config()), name(""), mass(0.0), position(0.0), velocity(0.0) {
+Body::Body() : config_(defaultConfig()), name(""), mass(0.0), position(0.0), velocity(0.0) {
 };
 
 Body::Body(const Config& config, std::shared_ptr<ILogger> logger)
@@ -22,18 +32,6 @@ Body::Body(const Body& other)
     : config_(other.config_), name(other.name), mass(other.mass), position(other.position), velocity(other.velocity) {
 }
 
-void Body::update(float deltaTime) {
-    renderer.updateTrajectory(position, static_cast<double>(config_.simulation_rendering_scale), deltaTime);
-}
-
-void Body::render(const Shader& shader) const {
-    render(shader, glm::vec3(0.0f));
-}
-
-void Body::render(const Shader& shader, const glm::vec3& orbitCenter) const {
-    renderer.renderTrajectory(shader, orbitCenter);
-}
-
 Body& Body::operator=(const Body& other) {
     if (this != &other) {
         position = other.position;
@@ -0,0 +1,146 @@
+#include "core/body_tree.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+void BodyTree::build(BODY_MAP& bodies, const std::unordered_map<std::string, std::string>& parents) {
+    nodes_.clear();
+    index_.clear();
+
+    // Depth of every body from its parent chain
+    std::unordered_map<std::string, int> depth;
+    for (const auto& [name, body] : bodies) {
+        int d = 0;
+        std::string current = name;
+        for (auto it = parents.find(current); it != parents.end(); it = parents.find(current)) {
+            if (bodies.find(it->second) == bodies.end()) {
+                throw std::invalid_argument("Unknown parent '" + it->second + "' for body '" + current + "'");
+            }
+            current = it->second;
+            if (++d > static_cast<int>(bodies.size())) {
+                throw std::invalid_argument("Cycle in body hierarchy at '" + name + "'");
+            }
+        }
+        depth[name] = d;
+    }
+
+    std::vector<std::string> order;
+    order.reserve(bodies.size());
+    for (const auto& [name, body] : bodies) {
+        order.push_back(name);
+    }
+    std::sort(order.begin(), order.end(), [&](const std::string& a, const std::string& b) {
+        return depth[a] != depth[b] ? depth[a] < depth[b] : a < b;
+    });
+    if (order.size() > 1 && depth[order[1]] == 0) {
+        throw std::invalid_argument("Body hierarchy has more than one root");
+    }
+
+    nodes_.resize(order.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        index_[order[i]] = static_cast<int>(i);
+        nodes_[i].body = bodies.at(order[i]).get();
+        nodes_[i].depth = depth[order[i]];
+    }
+    for (size_t i = 0; i < order.size(); ++i) {
+        auto it = parents.find(order[i]);
+        if (it != parents.end()) {
+            nodes_[i].parent = index_.at(it->second);
+            nodes_[nodes_[i].parent].children.push_back(static_cast<int>(i));
+        }
+    }
+
+    syncFromWorld();
+    refreshSoi();
+}
+
+int BodyTree::indexOf(const std::string& name) const {
+    auto it = index_.find(name);
+    return it == index_.end() ? kNone : it->second;
+}
+
+glm::dvec3 BodyTree::worldPosition(int index) const {
+    glm::dvec3 p(0.0);
+    for (int i = index; i != kNone; i = nodes_[i].parent) {
+        p += nodes_[i].localPosition;
+    }
+    return p;
+}
+
+glm::dvec3 BodyTree::worldVelocity(int index) const {
+    glm::dvec3 v(0.0);
+    for (int i = index; i != kNone; i = nodes_[i].parent) {
+        v += nodes_[i].localVelocity;
+    }
+    return v;
+}
+
+void BodyTree::updateWorld() {
+    // Parents come first, so their world state is already final
+    for (auto& n : nodes_) {
+        if (n.parent == kNone) {
+            n.body->position = n.localPosition;
+            n.body->velocity = n.localVelocity;
+        } else {
+            const Body& p = *nodes_[n.parent].body;
+            n.body->position = p.position + n.localPosition;
+            n.body->velocity = p.velocity + n.localVelocity;
+        }
+    }
+}
+
+void BodyTree::syncFromWorld() {
+    for (auto& n : nodes_) {
+        if (n.parent == kNone) {
+            n.localPosition = n.body->position;
+            n.localVelocity = n.body->velocity;
+        } else {
+            const Body& p = *nodes_[n.parent].body;
+            n.localPosition = n.body->position - p.position;
+            n.localVelocity = n.body->velocity - p.velocity;
+        }
+    }
+}
+
+void BodyTree::refreshSoi() {
+    for (auto& n : nodes_) {
+        if (n.parent == kNone) {
+            n.soiRadius = std::numeric_limits<double>::infinity();
+            continue;
+        }
+        double parentMass = nodes_[n.parent].body->mass;
+        n.soiRadius = parentMass > 0.0
+            ? glm::length(n.localPosition) * std::pow(n.body->mass / parentMass, 0.4)
+            : 0.0;
+    }
+}
+
+int BodyTree::dominantBody(const glm::dvec3& worldPosition) const {
+    if (nodes_.empty()) {
+        return kNone;
+    }
+
+    int current = 0;
+    glm::dvec3 relative = worldPosition - nodes_[0].localPosition;
+    while (true) {
+        int next = kNone;
+        glm::dvec3 nextRelative(0.0);
+        double closest = std::numeric_limits<double>::max();
+        for (int c : nodes_[current].children) {
+            glm::dvec3 r = relative - nodes_[c].localPosition;
+            double d = glm::length(r);
+            if (d < nodes_[c].soiRadius && d < closest) {
+                closest = d;
+                next = c;
+                nextRelative = r;
+            }
+        }
+        if (next == kNone) {
+            return current;
+        }
+        current = next;
+        relative = nextRelative;
+    }
+}
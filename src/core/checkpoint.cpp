@@ -0,0 +1,349 @@
+#include "core/checkpoint.h"
+#include "core/mapped_file.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+
+namespace {
+
+// File layout (see checkpoint.h):
+//   header   magic, u32 version, u32 flags, u64 payload size
+//   payload  f64 time, f32 time scale
+//            u32 bodies, per body: name, f64 mass, 3 x f64 position, 3 x f64 velocity
+//            rocket: RocketCheckpoint's vectors and scalars in declaration order, u8 launched, u8 crashed
+//            with kHasView: u32 mode, 3 x vec3, pitch, yaw, distance, focus name,
+//                           u32 trails, per trail: name, f32 sample timer, u32 points, points x vec3
+// Strings are a u16 length and the bytes.
+constexpr char kMagic[8] = {'R', 'S', 'I', 'M', 'C', 'K', 'P', '\0'};
+constexpr uint32_t kHasView = 1;
+constexpr size_t kHeaderSize = sizeof(kMagic) + 2 * sizeof(uint32_t) + sizeof(uint64_t);
+
+static_assert(sizeof(glm::vec3) == 3 * sizeof(float), "Trail points are copied as packed floats");
+static_assert(sizeof(glm::dvec3) == 3 * sizeof(double), "Vectors are copied as packed doubles");
+
+class Encoder {
+public:
+    explicit Encoder(std::vector<uint8_t>& out) : out_(out) {}
+
+    void bytes(const void* data, size_t size) {
+        const uint8_t* in = static_cast<const uint8_t*>(data);
+        out_.insert(out_.end(), in, in + size);
+    }
+    template <typename T>
+    void value(const T& v) { bytes(&v, sizeof(T)); }
+    void flag(bool v) { value(static_cast<uint8_t>(v ? 1 : 0)); }
+    void string(const std::string& s) {
+        if (s.size() > 0xFFFF) {
+            throw CheckpointError("Checkpoint name longer than 65535 bytes: " + s.substr(0, 32) + "...");
+        }
+        value(static_cast<uint16_t>(s.size()));
+        bytes(s.data(), s.size());
+    }
+
+private:
+    std::vector<uint8_t>& out_;
+};
+
+class Decoder {
+public:
+    Decoder(const uint8_t* data, size_t size) : at_(data), end_(data + size) {}
+
+    const uint8_t* take(size_t size) {
+        if (size > static_cast<size_t>(end_ - at_)) {
+            throw CheckpointError("Checkpoint is cut short");
+        }
+        const uint8_t* taken = at_;
+        at_ += size;
+        return taken;
+    }
+    template <typename T>
+    T value() {
+        T v;
+        std::memcpy(&v, take(sizeof(T)), sizeof(T));
+        return v;
+    }
+    template <typename T>
+    void into(T& v) { v = value<T>(); }
+    bool flag() { return value<uint8_t>() != 0; }
+    std::string string() {
+        const uint16_t length = value<uint16_t>();
+        const char* data = reinterpret_cast<const char*>(take(length));
+        return std::string(data, length);
+    }
+    bool done() const { return at_ == end_; }
+
+private:
+    const uint8_t* at_;
+    const uint8_t* end_;
+};
+
+void encodeView(Encoder& out, const CheckpointView& view) {
+    const CameraCheckpoint& camera = view.camera;
+    out.value(camera.mode);
+    out.value(camera.position);
+    out.value(camera.target);
+    out.value(camera.fixedTarget);
+    out.value(camera.pitch);
+    out.value(camera.yaw);
+    out.value(camera.distance);
+    out.string(camera.focusBodyName);
+
+    out.value(static_cast<uint32_t>(view.trails.size()));
+    for (const TrailCheckpoint& trail : view.trails) {
+        out.string(trail.name);
+        out.value(trail.sampleTimer);
+        out.value(static_cast<uint32_t>(trail.points.size()));
+        out.bytes(trail.points.data(), trail.points.size() * sizeof(glm::vec3));
+    }
+}
+
+CheckpointView decodeView(Decoder& in) {
+    CheckpointView view;
+    CameraCheckpoint& camera = view.camera;
+    in.into(camera.mode);
+    in.into(camera.position);
+    in.into(camera.target);
+    in.into(camera.fixedTarget);
+    in.into(camera.pitch);
+    in.into(camera.yaw);
+    in.into(camera.distance);
+    camera.focusBodyName = in.string();
+
+    const uint32_t trails = in.value<uint32_t>();
+    for (uint32_t i = 0; i < trails; ++i) {
+        TrailCheckpoint trail;
+        trail.name = in.string();
+        in.into(trail.sampleTimer);
+        const uint32_t points = in.value<uint32_t>();
+        const size_t size = static_cast<size_t>(points) * sizeof(glm::vec3);
+        const uint8_t* data = in.take(size);
+        trail.points.resize(points);
+        std::memcpy(trail.points.data(), data, size);
+        view.trails.push_back(std::move(trail));
+    }
+    return view;
+}
+
+}  // namespace
+
+namespace checkpoint {
+
+void encode(const Checkpoint& state, std::vector<uint8_t>& out) {
+    out.clear();
+    Encoder encoder(out);
+    encoder.bytes(kMagic, sizeof(kMagic));
+    encoder.value(kVersion);
+    encoder.value(state.view ? kHasView : 0u);
+    encoder.value(uint64_t{0});   // Payload size, filled in below
+
+    encoder.value(state.time);
+    encoder.value(state.timeScale);
+
+    encoder.value(static_cast<uint32_t>(state.bodies.size()));
+    for (const BodyCheckpoint& body : state.bodies) {
+        encoder.string(body.name);
+        encoder.value(body.mass);
+        encoder.value(body.position);
+        encoder.value(body.velocity);
+    }
+
+    const RocketCheckpoint& rocket = state.rocket;
+    encoder.value(rocket.position);
+    encoder.value(rocket.velocity);
+    encoder.value(rocket.thrustDirection);
+    encoder.value(rocket.earthPosition);
+    encoder.value(rocket.mass);
+    encoder.value(rocket.fuelMass);
+    encoder.value(rocket.thrust);
+    encoder.value(rocket.stageBurnTime);
+    encoder.value(rocket.perturberClock);
+    encoder.value(rocket.time);
+    encoder.value(rocket.stage);
+    encoder.flag(rocket.launched);
+    encoder.flag(rocket.crashed);
+
+    if (state.view) {
+        encodeView(encoder, *state.view);
+    }
+
+    const uint64_t payload = out.size() - kHeaderSize;
+    std::memcpy(out.data() + kHeaderSize - sizeof(payload), &payload, sizeof(payload));
+}
+
+Checkpoint decode(const uint8_t* data, size_t size) {
+    Decoder header(data, size);
+    if (size < kHeaderSize || std::memcmp(header.take(sizeof(kMagic)), kMagic, sizeof(kMagic)) != 0) {
+        throw CheckpointError("Not a checkpoint");
+    }
+    const uint32_t version = header.value<uint32_t>();
+    if (version != kVersion) {
+        throw CheckpointError("Checkpoint version " + std::to_string(version) + " is not supported (expected " +
+                              std::to_string(kVersion) + ")");
+    }
+    const uint32_t flags = header.value<uint32_t>();
+    const uint64_t payload = header.value<uint64_t>();
+    if (payload != size - kHeaderSize) {
+        throw CheckpointError("Checkpoint is cut short");
+    }
+
+    Decoder in(data + kHeaderSize, size - kHeaderSize);
+    Checkpoint state;
+    in.into(state.time);
+    in.into(state.timeScale);
+
+    const uint32_t bodies = in.value<uint32_t>();
+    state.bodies.reserve(std::min<size_t>(bodies, payload));
+    for (uint32_t i = 0; i < bodies; ++i) {
+        BodyCheckpoint body;
+        body.name = in.string();
+        in.into(body.mass);
+        in.into(body.position);
+        in.into(body.velocity);
+        state.bodies.push_back(std::move(body));
+    }
+
+    RocketCheckpoint& rocket = state.rocket;
+    in.into(rocket.position);
+    in.into(rocket.velocity);
+    in.into(rocket.thrustDirection);
+    in.into(rocket.earthPosition);
+    in.into(rocket.mass);
+    in.into(rocket.fuelMass);
+    in.into(rocket.thrust);
+    in.into(rocket.stageBurnTime);
+    in.into(rocket.perturberClock);
+    in.into(rocket.time);
+    in.into(rocket.stage);
+    rocket.launched = in.flag();
+    rocket.crashed = in.flag();
+
+    if (flags & kHasView) {
+        state.view = decodeView(in);
+    }
+    if (!in.done()) {
+        throw CheckpointError("Checkpoint has trailing data");
+    }
+    return state;
+}
+
+}  // namespace checkpoint
+
+void writeCheckpoint(const std::string& path, const Checkpoint& state) {
+    std::vector<uint8_t> data;
+    checkpoint::encode(state, data);
+
+    const std::filesystem::path target(path);
+    std::error_code error;
+    if (target.has_parent_path()) {
+        std::filesystem::create_directories(target.parent_path(), error);
+    }
+    const std::string temporary = path + ".tmp";
+    std::FILE* file = std::fopen(temporary.c_str(), "wb");
+    if (!file) {
+        throw CheckpointError("Failed to create checkpoint file: " + temporary);
+    }
+    const bool written = std::fwrite(data.data(), 1, data.size(), file) == data.size();
+    const bool closed = std::fclose(file) == 0;
+    if (!written || !closed) {
+        std::remove(temporary.c_str());
+        throw CheckpointError("Failed to write checkpoint file: " + temporary);
+    }
+    std::filesystem::rename(temporary, target, error);
+    if (error) {
+        std::remove(temporary.c_str());
+        throw CheckpointError("Failed to replace " + path + ": " + error.message());
+    }
+}
+
+Checkpoint readCheckpoint(const std::string& path) {
+    MappedFile file;
+    try {
+        file = MappedFile(path);
+    } catch (const std::runtime_error& e) {
+        throw CheckpointError(e.what());
+    }
+    try {
+        return checkpoint::decode(file.data(), file.size());
+    } catch (const CheckpointError& e) {
+        throw CheckpointError(path + ": " + e.what());
+    }
+}
+
+CheckpointWriter::CheckpointWriter(std::shared_ptr<ILogger> logger) : logger_(std::move(logger)) {}
+
+CheckpointWriter::~CheckpointWriter() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    ready_.notify_one();
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+}
+
+void CheckpointWriter::save(const std::string& path, Checkpoint state) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queue_.emplace_back(path, std::move(state));
+        if (!worker_.joinable()) {
+            worker_ = std::thread(&CheckpointWriter::run, this);
+        }
+    }
+    ready_.notify_one();
+}
+
+void CheckpointWriter::flush() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    idle_.wait(lock, [this]() { return queue_.empty() && !busy_; });
+}
+
+uint64_t CheckpointWriter::saved() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return saved_;
+}
+
+uint64_t CheckpointWriter::failed() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return failed_;
+}
+
+void CheckpointWriter::run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        // Saves still queued at shutdown are written before the thread ends
+        ready_.wait(lock, [this]() { return !queue_.empty() || stop_; });
+        if (queue_.empty()) {
+            break;
+        }
+        auto [path, state] = std::move(queue_.front());
+        queue_.pop_front();
+        busy_ = true;
+        lock.unlock();
+
+        const auto start = std::chrono::steady_clock::now();
+        bool ok = true;
+        try {
+            writeCheckpoint(path, state);
+            const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            LOG_INFOF(logger_, "Checkpoint", "Saved t={:.1f} s to {} in {:.1f} ms", state.time, path, ms);
+        } catch (const CheckpointError& e) {
+            ok = false;
+            LOG_ERROR(logger_, "Checkpoint", e.what());
+        }
+
+        lock.lock();
+        busy_ = false;
+        if (ok) {
+            ++saved_;
+        } else {
+            ++failed_;
+        }
+        if (queue_.empty()) {
+            idle_.notify_all();
+        }
+    }
+}
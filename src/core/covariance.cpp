@@ -0,0 +1,150 @@
+#include "core/covariance.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+
+// Eigen-decomposition of a symmetric 3x3 matrix by cyclic Jacobi rotations.
+// On return m is diagonal (the eigenvalues) and the columns of v are the eigenvectors.
+void jacobiEigen(std::array<std::array<double, 3>, 3>& m, std::array<std::array<double, 3>, 3>& v) {
+    v = {{{1.0, 0.0, 0.0}, {0.0, 1.0, 0.0}, {0.0, 0.0, 1.0}}};
+    for (int sweep = 0; sweep < 50; ++sweep) {
+        double off = m[0][1] * m[0][1] + m[0][2] * m[0][2] + m[1][2] * m[1][2];
+        double scale = m[0][0] * m[0][0] + m[1][1] * m[1][1] + m[2][2] * m[2][2];
+        if (off <= 1e-30 * scale || off == 0.0) {
+            return;
+        }
+        for (int p = 0; p < 2; ++p) {
+            for (int q = p + 1; q < 3; ++q) {
+                if (m[p][q] == 0.0) continue;
+                double theta = (m[q][q] - m[p][p]) / (2.0 * m[p][q]);
+                double t = (theta >= 0.0 ? 1.0 : -1.0) / (std::abs(theta) + std::sqrt(theta * theta + 1.0));
+                double c = 1.0 / std::sqrt(t * t + 1.0);
+                double s = t * c;
+                for (int k = 0; k < 3; ++k) {
+                    double mkp = m[k][p], mkq = m[k][q];
+                    m[k][p] = c * mkp - s * mkq;
+                    m[k][q] = s * mkp + c * mkq;
+                }
+                for (int k = 0; k < 3; ++k) {
+                    double mpk = m[p][k], mqk = m[q][k];
+                    m[p][k] = c * mpk - s * mqk;
+                    m[q][k] = s * mpk + c * mqk;
+                }
+                for (int k = 0; k < 3; ++k) {
+                    double vkp = v[k][p], vkq = v[k][q];
+                    v[k][p] = c * vkp - s * vkq;
+                    v[k][q] = s * vkp + c * vkq;
+                }
+            }
+        }
+    }
+}
+
+// Points cos(t) u + sin(t) w for t in [from, to), the end excluded
+void appendArc(std::vector<glm::dvec3>& points, const glm::dvec3& center, const glm::dvec3& u, const glm::dvec3& w,
+               double from, double to, int segments) {
+    for (int i = 0; i < segments; ++i) {
+        double t = from + (to - from) * i / segments;
+        points.push_back(center + u * std::cos(t) + w * std::sin(t));
+    }
+}
+
+}  // namespace
+
+// ============================================================
+// Matrix6 helpers
+// ============================================================
+
+Matrix6 identityMatrix6() {
+    Matrix6 m{};
+    for (int i = 0; i < 6; ++i) {
+        m[i][i] = 1.0;
+    }
+    return m;
+}
+
+Matrix6 multiply(const Matrix6& a, const Matrix6& b) {
+    Matrix6 out{};
+    for (int i = 0; i < 6; ++i) {
+        for (int k = 0; k < 6; ++k) {
+            if (a[i][k] == 0.0) continue;
+            for (int j = 0; j < 6; ++j) {
+                out[i][j] += a[i][k] * b[k][j];
+            }
+        }
+    }
+    return out;
+}
+
+Matrix6 propagateCovariance(const Matrix6& phi, const Matrix6& covariance) {
+    Matrix6 left = multiply(phi, covariance);
+    Matrix6 out{};
+    for (int i = 0; i < 6; ++i) {
+        for (int j = 0; j < 6; ++j) {
+            double sum = 0.0;
+            for (int k = 0; k < 6; ++k) {
+                sum += left[i][k] * phi[j][k];
+            }
+            out[i][j] = sum;
+        }
+    }
+    return out;
+}
+
+Matrix6 diagonalCovariance(double positionSigma, double velocitySigma) {
+    Matrix6 m{};
+    for (int i = 0; i < 3; ++i) {
+        m[i][i] = positionSigma * positionSigma;
+        m[3 + i][3 + i] = velocitySigma * velocitySigma;
+    }
+    return m;
+}
+
+// ============================================================
+// ErrorEllipsoid implementation
+// ============================================================
+
+ErrorEllipsoid ErrorEllipsoid::fromCovariance(const glm::dvec3& center, const Matrix6& covariance) {
+    std::array<std::array<double, 3>, 3> m;
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 3; ++j) {
+            // Symmetrize: round-off in Phi P Phi^T leaves tiny asymmetries
+            m[i][j] = 0.5 * (covariance[i][j] + covariance[j][i]);
+        }
+    }
+    std::array<std::array<double, 3>, 3> v;
+    jacobiEigen(m, v);
+
+    std::array<int, 3> order = {0, 1, 2};
+    std::sort(order.begin(), order.end(), [&](int a, int b) { return m[a][a] > m[b][b]; });
+
+    ErrorEllipsoid ellipsoid;
+    ellipsoid.center = center;
+    for (int k = 0; k < 3; ++k) {
+        int c = order[k];
+        double sigma = std::sqrt(std::max(m[c][c], 0.0));
+        ellipsoid.axes[k] = sigma * glm::dvec3(v[0][c], v[1][c], v[2][c]);
+    }
+    return ellipsoid;
+}
+
+std::vector<glm::dvec3> ErrorEllipsoid::outline(double sigma, int segments) const {
+    const glm::dvec3 a = axes[0] * sigma;
+    const glm::dvec3 b = axes[1] * sigma;
+    const glm::dvec3 c = axes[2] * sigma;
+    const int quarter = std::max(1, segments / 4);
+
+    std::vector<glm::dvec3> points;
+    points.reserve(3 * segments + 2 * quarter);
+    appendArc(points, center, a, b, 0.0, 2.0 * kPi, segments);
+    appendArc(points, center, a, c, 0.0, 2.0 * kPi, segments);
+    appendArc(points, center, a, b, 0.0, 0.5 * kPi, quarter);
+    appendArc(points, center, b, c, 0.0, 2.0 * kPi, segments);
+    // Back along the first section; closing the loop returns to the start
+    appendArc(points, center, a, b, 0.5 * kPi, 0.0, quarter);
+    return points;
+}
@@ -0,0 +1,70 @@
+#include "core/encke.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Stumpff functions C(z) and S(z), with series near z = 0
+double stumpffC(double z) {
+    if (z > 1e-6) return (1.0 - std::cos(std::sqrt(z))) / z;
+    if (z < -1e-6) return (std::cosh(std::sqrt(-z)) - 1.0) / -z;
+    return 0.5 - z / 24.0 + z * z / 720.0;
+}
+
+double stumpffS(double z) {
+    if (z > 1e-6) {
+        double s = std::sqrt(z);
+        return (s - std::sin(s)) / (s * s * s);
+    }
+    if (z < -1e-6) {
+        double s = std::sqrt(-z);
+        return (std::sinh(s) - s) / (s * s * s);
+    }
+    return 1.0 / 6.0 - z / 120.0 + z * z / 5040.0;
+}
+
+}  // namespace
+
+PhaseState keplerPropagate(const PhaseState& s, double mu, double dt) {
+    const glm::dvec3& r0v = s.position;
+    const glm::dvec3& v0v = s.velocity;
+    double r0 = glm::length(r0v);
+    if (dt == 0.0 || r0 <= 0.0 || mu <= 0.0) {
+        return s;
+    }
+
+    double sqrtMu = std::sqrt(mu);
+    double vr0 = glm::dot(r0v, v0v) / r0;
+    double alpha = 2.0 / r0 - glm::dot(v0v, v0v) / mu;   // 1 / a
+
+    // Newton iteration on the universal anomaly chi
+    double chi = (alpha > 1e-12) ? sqrtMu * alpha * dt : sqrtMu * dt / r0;
+    const double sigma0 = r0 * vr0 / sqrtMu;
+    for (int i = 0; i < 50; ++i) {
+        double z = alpha * chi * chi;
+        double c = stumpffC(z);
+        double sz = stumpffS(z);
+        double chi2 = chi * chi;
+        double F = sigma0 * chi2 * c + (1.0 - alpha * r0) * chi2 * chi * sz + r0 * chi - sqrtMu * dt;
+        double dF = sigma0 * chi * (1.0 - z * sz) + (1.0 - alpha * r0) * chi2 * c + r0;
+        double step = F / dF;
+        chi -= step;
+        if (std::abs(step) <= 1e-13 * std::max(1.0, std::abs(chi))) break;
+    }
+
+    double z = alpha * chi * chi;
+    double c = stumpffC(z);
+    double sz = stumpffS(z);
+    double chi2 = chi * chi;
+
+    // Lagrange coefficients
+    double f = 1.0 - chi2 / r0 * c;
+    double g = dt - chi2 * chi / sqrtMu * sz;
+    glm::dvec3 r = f * r0v + g * v0v;
+    double rLen = glm::length(r);
+    double fDot = sqrtMu / (rLen * r0) * (z * sz - 1.0) * chi;
+    double gDot = 1.0 - chi2 / rLen * c;
+
+    return PhaseState{r, fDot * r0v + gDot * v0v};
+}
@@ -0,0 +1,149 @@
+#include "core/encounter.h"
+#include "core/encke.h"
+#include "core/root_finding.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+// ============================================================
+// ConicEphemeris implementation
+// ============================================================
+
+ConicEphemeris::ConicEphemeris(const BodyTree& tree, double G) {
+    assign(tree, G);
+}
+
+void ConicEphemeris::assign(const BodyTree& tree, double G) {
+    entries_.resize(tree.size());
+    for (int i = 0; i < static_cast<int>(tree.size()); ++i) {
+        const BodyNode& node = tree.node(i);
+        Entry& entry = entries_[i];
+        entry.name = node.body->name;
+        entry.parent = node.parent;
+        entry.local = PhaseState{node.localPosition, node.localVelocity};
+        entry.mu = node.parent >= 0 ? G * tree.body(node.parent).mass : 0.0;
+        entry.soiRadius = node.soiRadius;
+    }
+}
+
+PhaseState ConicEphemeris::state(int index, double dt) const {
+    const Entry& entry = entries_[index];
+    if (entry.parent < 0) {
+        return PhaseState{entry.local.position + entry.local.velocity * dt, entry.local.velocity};
+    }
+    PhaseState parent = state(entry.parent, dt);
+    PhaseState local = keplerPropagate(entry.local, entry.mu, dt);
+    return PhaseState{parent.position + local.position, parent.velocity + local.velocity};
+}
+
+void ConicEphemeris::states(double dt, std::vector<PhaseState>& out) const {
+    out.resize(entries_.size());
+    for (size_t i = 0; i < entries_.size(); ++i) {
+        const Entry& entry = entries_[i];
+        if (entry.parent < 0) {
+            out[i] = PhaseState{entry.local.position + entry.local.velocity * dt, entry.local.velocity};
+            continue;
+        }
+        // Parents come first, so theirs is already in place
+        PhaseState local = keplerPropagate(entry.local, entry.mu, dt);
+        out[i] = PhaseState{out[entry.parent].position + local.position, out[entry.parent].velocity + local.velocity};
+    }
+}
+
+// ============================================================
+// EncounterFinder implementation
+// ============================================================
+
+EncounterFinder::EncounterFinder(double timeTolerance, int samplesPerArc)
+    : timeTolerance_(timeTolerance), samplesPerArc_(std::max(1, samplesPerArc)) {}
+
+void EncounterFinder::reset(const std::vector<EventState>& samples, const ConicEphemeris& ephemeris) {
+    samples_ = samples;
+    ephemeris_ = ephemeris;
+    encounters_.clear();
+    next_ = 0;
+    refined_ = 0;
+    if (!samples_.empty()) {
+        ephemeris_.states(samples_.front().time, bodyStart_);
+    }
+}
+
+bool EncounterFinder::update(double budgetSeconds) {
+    using Clock = std::chrono::steady_clock;
+    const auto start = Clock::now();
+
+    while (!finished()) {
+        DenseStep arc(samples_[next_], samples_[next_ + 1]);
+        ephemeris_.states(arc.endTime(), bodyEnd_);
+
+        size_t found = encounters_.size();
+        for (int body = 0; body < static_cast<int>(ephemeris_.size()); ++body) {
+            if (ephemeris_.parentOf(body) >= 0) {
+                searchArc(arc, body, bodyStart_[body], bodyEnd_[body]);
+            }
+        }
+        // Several bodies can have their minimum inside one arc
+        std::sort(encounters_.begin() + found, encounters_.end(),
+                  [](const Encounter& a, const Encounter& b) { return a.time < b.time; });
+
+        bodyStart_.swap(bodyEnd_);
+        ++next_;
+        if (budgetSeconds > 0.0
+            && std::chrono::duration<double>(Clock::now() - start).count() >= budgetSeconds) {
+            break;
+        }
+    }
+    return finished();
+}
+
+void EncounterFinder::searchArc(const DenseStep& arc, int body, const PhaseState& start, const PhaseState& end) {
+    const double radius = ephemeris_.soiRadius(body);
+    const double h = arc.endTime() - arc.startTime();
+    if (h <= 0.0) {
+        return;
+    }
+
+    // Relative motion as a cubic: its Bezier control points enclose the arc
+    const glm::dvec3 d0 = arc.start().position - start.position;
+    const glm::dvec3 d1 = arc.end().position - end.position;
+    const glm::dvec3 w0 = arc.start().velocity - start.velocity;
+    const glm::dvec3 w1 = arc.end().velocity - end.velocity;
+    const glm::dvec3 control[4] = {d0, d0 + w0 * (h / 3.0), d1 - w1 * (h / 3.0), d1};
+    const glm::dvec3 center = 0.25 * (control[0] + control[1] + control[2] + control[3]);
+    double spread = 0.0;
+    for (const glm::dvec3& p : control) {
+        spread = std::max(spread, glm::length(p - center));
+    }
+    // The body's own arc is only approximately a cubic: allow a little slack
+    if (glm::length(center) - 1.05 * spread > radius) {
+        return;
+    }
+    ++refined_;
+
+    // Range rate: negative while closing, positive while opening
+    auto rangeRate = [&](double t) {
+        EventState rocket = arc.interpolate(t);
+        PhaseState target = ephemeris_.state(body, t);
+        return glm::dot(rocket.position - target.position, rocket.velocity - target.velocity);
+    };
+
+    double a = arc.startTime();
+    double ga = glm::dot(d0, w0);
+    for (int k = 1; k <= samplesPerArc_; ++k) {
+        double b = k == samplesPerArc_ ? arc.endTime() : arc.startTime() + h * k / samplesPerArc_;
+        double gb = k == samplesPerArc_ ? glm::dot(d1, w1) : rangeRate(b);
+        if (ga < 0.0 && gb >= 0.0) {
+            RootResult root = RootFinder::brent(rangeRate, a, b, ga, gb, timeTolerance_);
+            EventState rocket = arc.interpolate(root.root);
+            PhaseState target = ephemeris_.state(body, root.root);
+            double distance = glm::length(rocket.position - target.position);
+            if (distance <= radius) {
+                encounters_.push_back({ephemeris_.name(body), root.root, distance,
+                                       glm::length(rocket.velocity - target.velocity)});
+            }
+        }
+        a = b;
+        ga = gb;
+    }
+}
@@ -0,0 +1,132 @@
+#include "core/event_detector.h"
+#include "core/root_finding.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+// ============================================================
+// DenseStep implementation
+// ============================================================
+
+DenseStep::DenseStep(const EventState& start, const EventState& end)
+    : start_(start), end_(end) {}
+
+EventState DenseStep::interpolate(double t) const {
+    const double h = end_.time - start_.time;
+    if (h <= 0.0) {
+        return end_;
+    }
+
+    double s = std::clamp((t - start_.time) / h, 0.0, 1.0);
+    double s2 = s * s;
+    double s3 = s2 * s;
+
+    // Cubic Hermite basis functions and their derivatives
+    double h00 = 2.0 * s3 - 3.0 * s2 + 1.0;
+    double h10 = s3 - 2.0 * s2 + s;
+    double h01 = -2.0 * s3 + 3.0 * s2;
+    double h11 = s3 - s2;
+
+    double d00 = 6.0 * s2 - 6.0 * s;
+    double d10 = 3.0 * s2 - 4.0 * s + 1.0;
+    double d01 = -6.0 * s2 + 6.0 * s;
+    double d11 = 3.0 * s2 - 2.0 * s;
+
+    EventState state;
+    state.time = start_.time + s * h;
+    state.position = h00 * start_.position + (h10 * h) * start_.velocity
+                   + h01 * end_.position + (h11 * h) * end_.velocity;
+    state.velocity = (d00 / h) * start_.position + d10 * start_.velocity
+                   + (d01 / h) * end_.position + d11 * end_.velocity;
+    state.mass = start_.mass + s * (end_.mass - start_.mass);
+    state.fuel = start_.fuel + s * (end_.fuel - start_.fuel);
+    state.burnTime = start_.burnTime + s * (end_.burnTime - start_.burnTime);
+    return state;
+}
+
+// ============================================================
+// EventDetector implementation
+// ============================================================
+
+EventDetector::EventDetector(double timeTolerance, int samplesPerStep)
+    : timeTolerance_(timeTolerance), samplesPerStep_(std::max(1, samplesPerStep)) {}
+
+size_t EventDetector::add(EventSpec spec) {
+    events_.push_back(std::move(spec));
+    return events_.size() - 1;
+}
+
+bool EventDetector::crosses(double g0, double g1, EventDirection direction) {
+    // A crossing must leave a strictly signed value: g0 == 0 means the
+    // event was handled at the start of this step and must not fire again.
+    bool rising = g0 < 0.0 && g1 >= 0.0;
+    bool falling = g0 > 0.0 && g1 <= 0.0;
+    switch (direction) {
+        case EventDirection::Rising:  return rising;
+        case EventDirection::Falling: return falling;
+        case EventDirection::Any:
+        default:                      return rising || falling;
+    }
+}
+
+std::optional<EventHit> EventDetector::findFirst(const DenseStep& step) const {
+    if (events_.empty() || step.endTime() <= step.startTime()) {
+        return std::nullopt;
+    }
+
+    const double t0 = step.startTime();
+    const double h = step.endTime() - t0;
+
+    // g values at the left edge of the current sub-interval, per event; on
+    // the stack, as this runs every step, unless there are unusually many
+    std::array<double, kInlineEvents> inlineG{};
+    std::vector<double> heapG;
+    double* gLeft = inlineG.data();
+    if (events_.size() > inlineG.size()) {
+        heapG.assign(events_.size(), 0.0);
+        gLeft = heapG.data();
+    }
+    for (size_t i = 0; i < events_.size(); ++i) {
+        if (events_[i].enabled) {
+            gLeft[i] = events_[i].function(step.start());
+        }
+    }
+
+    for (int k = 1; k <= samplesPerStep_; ++k) {
+        double a = t0 + h * static_cast<double>(k - 1) / samplesPerStep_;
+        double b = (k == samplesPerStep_) ? step.endTime() : t0 + h * static_cast<double>(k) / samplesPerStep_;
+        EventState right = (k == samplesPerStep_) ? step.end() : step.interpolate(b);
+
+        std::optional<EventHit> best;
+        for (size_t i = 0; i < events_.size(); ++i) {
+            if (!events_[i].enabled) continue;
+
+            double ga = gLeft[i];
+            double gb = events_[i].function(right);
+            gLeft[i] = gb;
+
+            if (!crosses(ga, gb, events_[i].direction)) continue;
+
+            const auto& fn = events_[i].function;
+            auto g = [&](double t) { return fn(step.interpolate(t)); };
+            RootResult root = RootFinder::brent(g, a, b, ga, gb, timeTolerance_);
+
+            double tEvent = std::clamp(root.after, a, b);
+            if (!best || tEvent < best->state.time) {
+                EventHit hit;
+                hit.index = i;
+                hit.rising = ga < 0.0;
+                hit.state = step.interpolate(tEvent);
+                hit.state.time = tEvent;
+                best = hit;
+            }
+        }
+
+        if (best) {
+            return best;
+        }
+    }
+
+    return std::nullopt;
+}
@@ -1,5 +1,38 @@
 #include "core/flight_plan.h"
 
+#include <algorithm>
+#include <cmath>
+
+// ============================================================
+// GuidanceProfile implementation
+// ============================================================
+
+GuidanceProfile::GuidanceProfile(GuidanceVariable variable, std::vector<Point> points, double heading)
+    : variable_(variable), cosHeading_(std::cos(heading)), sinHeading_(std::sin(heading)) {
+    if (points.empty()) {
+        throw FlightPlanError("Guidance profile needs at least one point");
+    }
+    std::sort(points.begin(), points.end(), [](const Point& a, const Point& b) { return a.key < b.key; });
+    for (size_t i = 1; i < points.size(); ++i) {
+        if (points[i].key == points[i - 1].key) {
+            throw FlightPlanError("Guidance profile has two points at " + std::to_string(points[i].key));
+        }
+    }
+
+    keys_.reserve(points.size());
+    pitch_.reserve(points.size());
+    thrust_.reserve(points.size());
+    for (const auto& point : points) {
+        keys_.push_back(point.key);
+        pitch_.push_back(point.pitch);
+        thrust_.push_back(point.thrust);
+    }
+}
+
+// ============================================================
+// FlightPlan implementation
+// ============================================================
+
 FlightPlan::FlightPlan(std::string filename) {
     std::ifstream file(filename);
     if (!file.is_open()) {
@@ -22,7 +55,7 @@ void FlightPlan::parseFlightPlan(const nlohmann::json& json) {
     if (json.contains("flight_plan") && json["flight_plan"].is_array()) {
         const auto& flight_plan = json["flight_plan"];
         for (const auto& stage_json : flight_plan) {
-            FlightStage stage;
+            FlightStage stage{};
 
             // parse condition
             if (stage_json.contains("condition")) {
@@ -49,21 +82,78 @@ void FlightPlan::parseFlightPlan(const nlohmann::json& json) {
             stages.push_back(stage);
         }
     }
+
+    // Guidance profiles: [key, pitch (deg), thrust (N)] points versus one variable
+    if (json.contains("guidance") && json["guidance"].is_array()) {
+        for (const auto& profile_json : json["guidance"]) {
+            std::string variable = profile_json.value("variable", "altitude");
+            GuidanceVariable key;
+            if (variable == "altitude") {
+                key = GuidanceVariable::Altitude;
+            } else if (variable == "time") {
+                key = GuidanceVariable::Time;
+            } else if (variable == "speed") {
+                key = GuidanceVariable::Speed;
+            } else {
+                throw FlightPlanError("Unknown guidance variable: " + variable);
+            }
+
+            std::vector<GuidanceProfile::Point> points;
+            if (profile_json.contains("points")) {
+                for (const auto& point : profile_json["points"]) {
+                    if (!point.is_array() || point.size() != 3) {
+                        throw FlightPlanError("Guidance points must be [key, pitch_deg, thrust] triples");
+                    }
+                    points.push_back({point[0].get<double>(), glm::radians(point[1].get<double>()),
+                                      point[2].get<double>()});
+                }
+            }
+            guidance.emplace_back(key, std::move(points), glm::radians(profile_json.value("heading_deg", 0.0)));
+        }
+    }
+
+    buildIndex();
 }
 
-std::optional<FlightAction> FlightPlan::getAction(double altitude, double speed) const {
+void FlightPlan::buildIndex() {
+    bounds.clear();
     for (const auto& stage : stages) {
-        if (stage.condition.isSatisfied(altitude, speed)) {
-            return stage.action;
+        for (double a : {stage.condition.altitude_min, stage.condition.altitude_max}) {
+            if (a) bounds.push_back(a);
+        }
+    }
+    std::sort(bounds.begin(), bounds.end());
+    bounds.erase(std::unique(bounds.begin(), bounds.end()), bounds.end());
+
+    auto boundSlot = [this](double a) {
+        return 2 * static_cast<size_t>(std::lower_bound(bounds.begin(), bounds.end(), a) - bounds.begin()) + 1;
+    };
+
+    slots.assign(2 * bounds.size() + 1, {});
+    for (size_t i = 0; i < stages.size(); ++i) {
+        const auto& condition = stages[i].condition;
+        // Unset bounds (0) leave the range open on that side
+        size_t first = condition.altitude_min ? boundSlot(condition.altitude_min) : 0;
+        size_t last = condition.altitude_max ? boundSlot(condition.altitude_max) : slots.size() - 1;
+        for (size_t k = first; k <= last && k < slots.size(); ++k) {
+            slots[k].push_back(i);
         }
     }
-    return std::nullopt;
 }
 
-void FlightPlan::addStage(const FlightStage& stage) { \
+void FlightPlan::addStage(const FlightStage& stage) {
     stages.push_back(stage);
+    buildIndex();
+}
+
+void FlightPlan::addGuidance(const GuidanceProfile& profile) {
+    guidance.push_back(profile);
 }
 
 const std::vector<FlightStage>& FlightPlan::getStages() const { 
     return stages;
 }
+
+const std::vector<GuidanceProfile>& FlightPlan::getGuidance() const {
+    return guidance;
+}
@@ -0,0 +1,78 @@
+#include "core/flight_recorder.h"
+
+namespace {
+
+const char* const kStateSuffixes[] = {".x", ".y", ".z", ".vx", ".vy", ".vz"};
+
+void appendState(std::vector<TelemetryColumn>& columns, const std::string& prefix) {
+    for (const char* suffix : kStateSuffixes) {
+        columns.push_back({prefix + suffix, TelemetryType::Float64});
+    }
+}
+
+double* putState(double* out, const glm::dvec3& position, const glm::dvec3& velocity) {
+    *out++ = position.x;
+    *out++ = position.y;
+    *out++ = position.z;
+    *out++ = velocity.x;
+    *out++ = velocity.y;
+    *out++ = velocity.z;
+    return out;
+}
+
+}  // namespace
+
+FlightRecorder::FlightRecorder(const std::string& path, const std::vector<std::string>& bodies, double interval,
+                               bool compress)
+    : path_(path), writer_(path, schema(bodies), TelemetryWriter::Options{1024, compress}),
+      bodyCount_(bodies.size()), interval_(interval), row_(writer_.columns().size(), 0.0) {}
+
+std::vector<TelemetryColumn> FlightRecorder::schema(const std::vector<std::string>& bodies) {
+    std::vector<TelemetryColumn> columns = {{"time", TelemetryType::Float64}};
+    for (const auto& name : bodies) {
+        appendState(columns, name);
+    }
+    appendState(columns, "rocket");
+    for (const char* name : {"rocket.mass", "rocket.fuel", "rocket.thrust", "rocket.dx", "rocket.dy", "rocket.dz"}) {
+        columns.push_back({name, TelemetryType::Float64});
+    }
+    columns.push_back({"rocket.stage", TelemetryType::UInt32});
+    columns.push_back({"rocket.flags", TelemetryType::UInt32});
+    return columns;
+}
+
+bool FlightRecorder::record(const SimulationSnapshot& state) {
+    if (started_ && state.time < nextTime_) {
+        return false;
+    }
+    started_ = true;
+    nextTime_ += interval_;
+    // Catch up rather than write a burst of rows after a long step
+    if (nextTime_ <= state.time) {
+        nextTime_ = state.time + interval_;
+    }
+
+    double* out = row_.data();
+    *out++ = state.time;
+    for (size_t i = 0; i < bodyCount_; ++i) {
+        // A body missing from the snapshot records as zeros
+        if (i < state.bodies.size()) {
+            out = putState(out, state.bodies[i].position, state.bodies[i].velocity);
+        } else {
+            out = putState(out, glm::dvec3(0.0), glm::dvec3(0.0));
+        }
+    }
+    const RocketSnapshot& rocket = state.rocket;
+    out = putState(out, rocket.position, rocket.velocity);
+    *out++ = rocket.mass;
+    *out++ = rocket.fuelMass;
+    *out++ = rocket.thrust;
+    *out++ = rocket.thrustDirection.x;
+    *out++ = rocket.thrustDirection.y;
+    *out++ = rocket.thrustDirection.z;
+    *out++ = static_cast<double>(rocket.stage);
+    *out++ = static_cast<double>((rocket.launched ? kLaunched : 0u) | (rocket.crashed ? kCrashed : 0u));
+
+    writer_.append(row_.data());
+    return true;
+}
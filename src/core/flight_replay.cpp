@@ -0,0 +1,164 @@
+#include "core/flight_replay.h"
+#include "core/flight_recorder.h"
+
+#include <algorithm>
+
+namespace {
+
+// Cubic Hermite between two states `dt` apart, at s in [0, 1]
+void hermite(const glm::dvec3& p0, const glm::dvec3& v0, const glm::dvec3& p1, const glm::dvec3& v1,
+             double dt, double s, glm::dvec3& position, glm::dvec3& velocity) {
+    if (!(dt > 0.0)) {
+        position = p0;
+        velocity = v0;
+        return;
+    }
+    const double s2 = s * s;
+    const double s3 = s2 * s;
+    position = (2.0 * s3 - 3.0 * s2 + 1.0) * p0 + ((s3 - 2.0 * s2 + s) * dt) * v0
+             + (-2.0 * s3 + 3.0 * s2) * p1 + ((s3 - s2) * dt) * v1;
+    velocity = ((6.0 * s2 - 6.0 * s) / dt) * (p0 - p1)
+             + (3.0 * s2 - 4.0 * s + 1.0) * v0 + (3.0 * s2 - 2.0 * s) * v1;
+}
+
+}  // namespace
+
+FlightReplay::FlightReplay(const std::string& path, const SimulationSnapshot& layout)
+    : reader_(path), frame_(layout) {
+    if (reader_.chunks().empty()) {
+        throw TelemetryError("Telemetry file holds no rows: " + path);
+    }
+    startTime_ = reader_.chunks().front().firstTime;
+    endTime_ = reader_.chunks().back().lastTime;
+    time_ = startTime_;
+
+    // Nothing in a recording feeds these
+    frame_.rocket.prediction.reset();
+    frame_.encounters.clear();
+    frame_.encounterSearchFinished = true;
+    frame_.frameAllocations = 0;
+
+    bodyColumns_.reserve(frame_.bodies.size());
+    for (const BodySnapshot& body : frame_.bodies) {
+        bodyColumns_.push_back(reader_.columnIndex(body.name + ".x"));
+    }
+    rocketColumn_ = reader_.columnIndex("rocket.x");
+    massColumn_ = reader_.columnIndex("rocket.mass");
+    fuelColumn_ = reader_.columnIndex("rocket.fuel");
+    thrustColumn_ = reader_.columnIndex("rocket.thrust");
+    directionColumn_ = reader_.columnIndex("rocket.dx");
+    stageColumn_ = reader_.columnIndex("rocket.stage");
+    flagsColumn_ = reader_.columnIndex("rocket.flags");
+}
+
+void FlightReplay::advance(double wallSeconds) {
+    if (!playing_) {
+        return;
+    }
+    moveTo(time_ + wallSeconds * speed_);
+    // Stop at either end rather than sit there playing
+    if ((speed_ > 0.0 && time_ >= endTime_) || (speed_ < 0.0 && time_ <= startTime_)) {
+        playing_ = false;
+    }
+}
+
+void FlightReplay::seek(double time) {
+    moveTo(time);
+    ++seeks_;
+}
+
+const FlightReplay::DecodedChunk& FlightReplay::chunk(size_t index) {
+    DecodedChunk* slot = &cache_[0];
+    for (auto& entry : cache_) {
+        if (entry.index == index) {
+            entry.used = ++useCount_;
+            return entry;
+        }
+        if (entry.used < slot->used) {
+            slot = &entry;
+        }
+    }
+    // Decoded into the least recently used slot, reusing its storage
+    reader_.readChunk(index, slot->values);
+    slot->index = index;
+    slot->rows = reader_.chunks()[index].rows;
+    slot->used = ++useCount_;
+    return *slot;
+}
+
+const SimulationSnapshot& FlightReplay::at(double time) {
+    time = std::max(startTime_, std::min(time, endTime_));
+
+    // The row at or before `time`, and the one after it, possibly in the next chunk
+    const size_t index = reader_.findChunk(time);
+    const DecodedChunk& first = chunk(index);
+    const double* times = first.values.data();
+    const size_t after = static_cast<size_t>(std::upper_bound(times, times + first.rows, time) - times);
+    const size_t row = after > 0 ? after - 1 : 0;
+
+    const DecodedChunk* second = &first;
+    size_t nextRow = row + 1;
+    if (nextRow >= first.rows) {
+        if (index + 1 < reader_.chunks().size()) {
+            second = &chunk(index + 1);
+            nextRow = 0;
+        } else {
+            nextRow = row;
+        }
+    }
+
+    auto value0 = [&](int column) { return first.values[static_cast<size_t>(column) * first.rows + row]; };
+    auto value1 = [&](int column) { return second->values[static_cast<size_t>(column) * second->rows + nextRow]; };
+    auto vector0 = [&](int column) { return glm::dvec3(value0(column), value0(column + 1), value0(column + 2)); };
+    auto vector1 = [&](int column) { return glm::dvec3(value1(column), value1(column + 1), value1(column + 2)); };
+
+    const double t0 = value0(0);
+    const double dt = value1(0) - t0;
+    const double s = dt > 0.0 ? std::max(0.0, std::min((time - t0) / dt, 1.0)) : 0.0;
+    auto linear = [&](int column) { return value0(column) + s * (value1(column) - value0(column)); };
+    // Columns .x .y .z .vx .vy .vz from `column`
+    auto state = [&](int column, glm::dvec3& position, glm::dvec3& velocity) {
+        hermite(vector0(column), vector0(column + 3), vector1(column), vector1(column + 3), dt, s, position, velocity);
+    };
+
+    frame_.sequence = ++sequence_;
+    frame_.seeks = seeks_;
+    frame_.time = time;
+    frame_.timeScale = static_cast<float>(speed_);
+    for (size_t i = 0; i < frame_.bodies.size(); ++i) {
+        if (bodyColumns_[i] >= 0) {
+            state(bodyColumns_[i], frame_.bodies[i].position, frame_.bodies[i].velocity);
+        }
+    }
+
+    RocketSnapshot& rocket = frame_.rocket;
+    rocket.time = static_cast<float>(time);
+    if (rocketColumn_ >= 0) {
+        state(rocketColumn_, rocket.position, rocket.velocity);
+    }
+    if (massColumn_ >= 0) {
+        rocket.mass = linear(massColumn_);
+    }
+    if (fuelColumn_ >= 0) {
+        rocket.fuelMass = linear(fuelColumn_);
+    }
+    if (thrustColumn_ >= 0) {
+        rocket.thrust = linear(thrustColumn_);
+    }
+    if (directionColumn_ >= 0) {
+        rocket.thrustDirection = vector0(directionColumn_);
+    }
+    if (stageColumn_ >= 0) {
+        const uint32_t stage = static_cast<uint32_t>(value0(stageColumn_));
+        if (stage != rocket.stage || rocket.stageName.empty()) {
+            rocket.stageName = stage < stageNames_.size() ? stageNames_[stage] : "Stage " + std::to_string(stage + 1);
+        }
+        rocket.stage = stage;
+    }
+    if (flagsColumn_ >= 0) {
+        const uint32_t flags = static_cast<uint32_t>(value0(flagsColumn_));
+        rocket.launched = (flags & FlightRecorder::kLaunched) != 0;
+        rocket.crashed = (flags & FlightRecorder::kCrashed) != 0;
+    }
+    return frame_;
+}
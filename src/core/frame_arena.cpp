@@ -0,0 +1,58 @@
+#include "core/frame_arena.h"
+
+#include <algorithm>
+#include <cstdint>
+
+FrameArena::FrameArena(size_t initialCapacity)
+    : block_(initialCapacity > 0 ? new unsigned char[initialCapacity] : nullptr), capacity_(initialCapacity) {}
+
+void* FrameArena::alignInto(unsigned char* base, size_t size, size_t& offset, size_t bytes, size_t alignment) {
+    if (!base) {
+        return nullptr;
+    }
+    const uintptr_t address = reinterpret_cast<uintptr_t>(base) + offset;
+    const size_t padding = (alignment - address % alignment) % alignment;
+    if (offset + padding + bytes > size) {
+        return nullptr;
+    }
+    void* result = base + offset + padding;
+    offset += padding + bytes;
+    return result;
+}
+
+void* FrameArena::allocate(size_t bytes, size_t alignment) {
+    if (alignment == 0 || (alignment & (alignment - 1)) != 0) {
+        throw std::bad_alloc();
+    }
+    bytes = std::max<size_t>(bytes, 1);
+
+    void* result = overflow_.empty()
+        ? alignInto(block_.get(), capacity_, offset_, bytes, alignment)
+        : alignInto(overflow_.back().data.get(), overflow_.back().size, overflowOffset_, bytes, alignment);
+    if (!result) {
+        // Spill: at least double what the frame has had so far, so a frame
+        // that keeps growing takes few spill blocks
+        Block spill;
+        spill.size = std::max(bytes + alignment, std::max(capacity_, used_) * 2);
+        spill.data.reset(new unsigned char[spill.size]);
+        overflow_.push_back(std::move(spill));
+        overflowOffset_ = 0;
+        result = alignInto(overflow_.back().data.get(), overflow_.back().size, overflowOffset_, bytes, alignment);
+    }
+    // Count the padding too, so the block reset() sizes always fits the frame
+    used_ += bytes + alignment - 1;
+    return result;
+}
+
+void FrameArena::reset() {
+    highWater_ = std::max(highWater_, used_);
+    if (!overflow_.empty()) {
+        // One block for the whole of a frame like this one
+        overflow_.clear();
+        capacity_ = highWater_;
+        block_.reset(new unsigned char[capacity_]);
+    }
+    offset_ = 0;
+    overflowOffset_ = 0;
+    used_ = 0;
+}
@@ -0,0 +1,235 @@
+#include "core/job_system.h"
+
+#include <stdexcept>
+
+namespace {
+// Which system's worker the current thread is, and its queue
+thread_local const JobSystem* tlsSystem = nullptr;
+thread_local size_t tlsQueue = 0;
+}
+
+JobSystem::JobSystem(unsigned threads) {
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    const unsigned workers = threads - 1;
+    for (unsigned i = 0; i <= workers; ++i) {
+        queues_.push_back(std::make_unique<Queue>());
+    }
+    workers_.reserve(workers);
+    for (unsigned i = 0; i < workers; ++i) {
+        workers_.emplace_back(&JobSystem::workerLoop, this, static_cast<size_t>(i + 1));
+    }
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+        stop_ = true;
+    }
+    wake_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+size_t JobSystem::ownQueue() const {
+    return tlsSystem == this ? tlsQueue : 0;
+}
+
+void JobSystem::submit(Job job, JobCounter& counter) {
+    counter.pending_.fetch_add(1, std::memory_order_relaxed);
+    Queue& queue = *queues_[ownQueue()];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.jobs.push_back(std::move(job), &counter);
+    }
+    queued_.fetch_add(1, std::memory_order_release);
+
+    // Taking the lock orders this with a worker about to sleep, so the
+    // notification cannot slip in between its check and its wait
+    { std::lock_guard<std::mutex> lock(sleepMutex_); }
+    wake_.notify_one();
+}
+
+void JobSystem::wait(JobCounter& counter) {
+    const size_t home = ownQueue();
+    while (!counter.done()) {
+        if (!tryRun(home)) {
+            std::this_thread::yield();
+        }
+    }
+    if (counter.error_) {
+        std::exception_ptr error = counter.error_;
+        counter.error_ = nullptr;
+        std::rethrow_exception(error);
+    }
+}
+
+bool JobSystem::tryRun(size_t home) {
+    const size_t n = queues_.size();
+    for (size_t k = 0; k < n; ++k) {
+        Queue& queue = *queues_[(home + k) % n];
+        std::unique_lock<std::mutex> lock(queue.mutex);
+        if (queue.jobs.empty()) {
+            continue;
+        }
+        // Own queue from the back (LIFO), victims from the front (FIFO)
+        auto entry = k == 0 ? queue.jobs.pop_back() : queue.jobs.pop_front();
+        lock.unlock();
+        queued_.fetch_sub(1, std::memory_order_relaxed);
+        execute(entry.first, *entry.second);
+        return true;
+    }
+    return false;
+}
+
+void JobSystem::JobRing::push_back(Job job, JobCounter* counter) {
+    if (size_ == slots_.size()) {
+        // Full: unwrap into twice the slots
+        std::vector<Entry> grown(std::max<size_t>(16, slots_.size() * 2));
+        for (size_t i = 0; i < size_; ++i) {
+            grown[i] = std::move(slots_[(head_ + i) % slots_.size()]);
+        }
+        slots_.swap(grown);
+        head_ = 0;
+    }
+    slots_[(head_ + size_) % slots_.size()] = Entry(std::move(job), counter);
+    ++size_;
+}
+
+JobSystem::JobRing::Entry JobSystem::JobRing::pop_back() {
+    --size_;
+    return take((head_ + size_) % slots_.size());
+}
+
+JobSystem::JobRing::Entry JobSystem::JobRing::pop_front() {
+    const size_t slot = head_;
+    head_ = (head_ + 1) % slots_.size();
+    --size_;
+    return take(slot);
+}
+
+JobSystem::JobRing::Entry JobSystem::JobRing::take(size_t slot) {
+    Entry entry = std::move(slots_[slot]);
+    // Release what the job captured now rather than when the slot is reused
+    slots_[slot].first = nullptr;
+    return entry;
+}
+
+void JobSystem::execute(Job& job, JobCounter& counter) {
+    try {
+        job();
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(counter.errorMutex_);
+        if (!counter.error_) {
+            counter.error_ = std::current_exception();
+        }
+    }
+    // Last touch of the counter: the waiter may return as soon as it drops
+    counter.pending_.fetch_sub(1, std::memory_order_release);
+}
+
+void JobSystem::workerLoop(size_t home) {
+    tlsSystem = this;
+    tlsQueue = home;
+    while (true) {
+        if (tryRun(home)) {
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(sleepMutex_);
+        wake_.wait(lock, [this]() {
+            return stop_.load() || queued_.load(std::memory_order_acquire) > 0;
+        });
+        if (stop_ && queued_.load() == 0) {
+            return;
+        }
+    }
+}
+
+TaskGraph::TaskId TaskGraph::add(std::string name, std::function<void()> fn) {
+    tasks_.push_back(Task{std::move(name), std::move(fn), {}, 0});
+    return tasks_.size() - 1;
+}
+
+void TaskGraph::precede(TaskId before, TaskId after) {
+    if (before >= tasks_.size() || after >= tasks_.size() || before == after) {
+        throw std::invalid_argument("TaskGraph: bad dependency");
+    }
+    tasks_[before].successors.push_back(after);
+    ++tasks_[after].dependencies;
+    remainingSize_ = 0;
+}
+
+void TaskGraph::dependsOn(TaskId task, std::initializer_list<TaskId> before) {
+    for (TaskId b : before) {
+        precede(b, task);
+    }
+}
+
+std::vector<TaskGraph::TaskId> TaskGraph::order() const {
+    std::vector<int> remaining(tasks_.size());
+    std::vector<TaskId> sorted;
+    sorted.reserve(tasks_.size());
+    for (TaskId i = 0; i < tasks_.size(); ++i) {
+        remaining[i] = tasks_[i].dependencies;
+        if (remaining[i] == 0) {
+            sorted.push_back(i);
+        }
+    }
+    for (size_t k = 0; k < sorted.size(); ++k) {
+        for (TaskId next : tasks_[sorted[k]].successors) {
+            if (--remaining[next] == 0) {
+                sorted.push_back(next);
+            }
+        }
+    }
+    if (sorted.size() != tasks_.size()) {
+        throw std::logic_error("TaskGraph: dependency cycle");
+    }
+    return sorted;
+}
+
+void TaskGraph::run(JobSystem* jobs) {
+    // Sort and size once per shape, so running a built graph allocates nothing
+    if (remainingSize_ != tasks_.size()) {
+        order_ = order();   // Also rejects cycles, which would otherwise never run
+        remaining_ = std::make_unique<std::atomic<int>[]>(tasks_.size());
+        remainingSize_ = tasks_.size();
+    }
+
+    if (!jobs || jobs->workerCount() == 0) {
+        for (TaskId task : order_) {
+            tasks_[task].fn();
+        }
+        return;
+    }
+
+    for (TaskId i = 0; i < tasks_.size(); ++i) {
+        remaining_[i].store(tasks_[i].dependencies, std::memory_order_relaxed);
+    }
+
+    JobCounter counter;
+    jobs_ = jobs;
+    counter_ = &counter;
+    for (TaskId i = 0; i < tasks_.size(); ++i) {
+        if (tasks_[i].dependencies == 0) {
+            launch(i);
+        }
+    }
+    jobs->wait(counter);
+    jobs_ = nullptr;
+    counter_ = nullptr;
+}
+
+void TaskGraph::launch(TaskId task) {
+    // Small enough for std::function to keep inline
+    jobs_->submit([this, task]() {
+        tasks_[task].fn();
+        for (TaskId next : tasks_[task].successors) {
+            if (remaining_[next].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                launch(next);
+            }
+        }
+    }, *counter_);
+}
@@ -0,0 +1,45 @@
+#include "core/ks_propagator.h"
+
+#include <cmath>
+
+glm::dvec4 ksL(const glm::dvec4& u, const glm::dvec4& w) {
+    return glm::dvec4(u.x * w.x - u.y * w.y - u.z * w.z + u.w * w.w,
+                      u.y * w.x + u.x * w.y - u.w * w.z - u.z * w.w,
+                      u.z * w.x + u.w * w.y + u.x * w.z + u.y * w.w,
+                      u.w * w.x - u.z * w.y + u.y * w.z - u.x * w.w);
+}
+
+glm::dvec4 ksLT(const glm::dvec4& u, const glm::dvec4& w) {
+    return glm::dvec4( u.x * w.x + u.y * w.y + u.z * w.z + u.w * w.w,
+                      -u.y * w.x + u.x * w.y + u.w * w.z - u.z * w.w,
+                      -u.z * w.x - u.w * w.y + u.x * w.z + u.y * w.w,
+                       u.w * w.x - u.z * w.y + u.y * w.z - u.x * w.w);
+}
+
+KsPropagator::State KsPropagator::toKs(const PhaseState& s) const {
+    const glm::dvec3& x = s.position;
+    double r = glm::length(x);
+
+    // One of the (one-parameter family of) u with L(u) u = x; pick the
+    // branch that avoids dividing by a small number
+    glm::dvec4 u;
+    if (x.x >= 0.0) {
+        double u1 = std::sqrt(0.5 * (r + x.x));
+        u = glm::dvec4(u1, x.y / (2.0 * u1), x.z / (2.0 * u1), 0.0);
+    } else {
+        double u2 = std::sqrt(0.5 * (r - x.x));
+        u = glm::dvec4(x.y / (2.0 * u2), u2, 0.0, x.z / (2.0 * u2));
+    }
+
+    State k;
+    k.u = u;
+    k.w = 0.5 * ksLT(u, glm::dvec4(s.velocity, 0.0));
+    k.energy = 0.5 * glm::dot(s.velocity, s.velocity) - mu_ / r;
+    k.time = 0.0;
+    return k;
+}
+
+PhaseState KsPropagator::fromKs(const State& k) const {
+    double r = glm::dot(k.u, k.u);
+    return PhaseState{glm::dvec3(ksL(k.u, k.u)), glm::dvec3(ksL(k.u, k.w) * (2.0 / r))};
+}
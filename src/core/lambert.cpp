@@ -0,0 +1,184 @@
+#include "core/lambert.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+constexpr double kTolerance = 1e-11;
+constexpr int kMaxIterations = 20;
+
+double computeY(double x, double lambda) {
+    return std::sqrt(std::max(0.0, 1.0 - lambda * lambda * (1.0 - x * x)));
+}
+
+// Gauss hypergeometric 2F1(3, 1; 5/2; z), the near-parabolic series
+double hypergeometric(double z) {
+    double sum = 1.0;
+    double term = 1.0;
+    for (int i = 0; i < 200; ++i) {
+        term *= (3.0 + i) * (1.0 + i) / (2.5 + i) * z / (i + 1.0);
+        double next = sum + term;
+        if (next == sum) break;
+        sum = next;
+    }
+    return sum;
+}
+
+// Non-dimensional time of flight T(x) for M complete revolutions
+double timeOfFlight(double x, double y, double lambda, int revolutions) {
+    if (revolutions == 0 && x > std::sqrt(0.6) && x < std::sqrt(1.4)) {
+        // Battin's series: the general expression loses precision near x = 1
+        double eta = y - lambda * x;
+        double s1 = 0.5 * (1.0 - lambda - x * eta);
+        double q = 4.0 / 3.0 * hypergeometric(s1);
+        return 0.5 * (eta * eta * eta * q + 4.0 * lambda * eta);
+    }
+    double psi;
+    if (x < 1.0) {
+        psi = std::acos(std::clamp(x * y + lambda * (1.0 - x * x), -1.0, 1.0));
+    } else {
+        psi = std::asinh((y - x * lambda) * std::sqrt(x * x - 1.0));
+    }
+    double oneMinusX2 = 1.0 - x * x;
+    return ((psi + revolutions * kPi) / std::sqrt(std::abs(oneMinusX2)) - x + lambda * y) / oneMinusX2;
+}
+
+// First three derivatives of T(x)
+void timeDerivatives(double x, double y, double t, double lambda, double& d1, double& d2, double& d3) {
+    double oneMinusX2 = 1.0 - x * x;
+    double l2 = lambda * lambda;
+    double l3 = l2 * lambda;
+    d1 = (3.0 * t * x - 2.0 + 2.0 * l3 * x / y) / oneMinusX2;
+    d2 = (3.0 * t + 5.0 * x * d1 + 2.0 * (1.0 - l2) * l3 / (y * y * y)) / oneMinusX2;
+    d3 = (7.0 * x * d2 + 8.0 * d1 - 6.0 * (1.0 - l2) * l2 * l3 * x / (y * y * y * y * y)) / oneMinusX2;
+}
+
+// x of the minimum time of flight for M >= 1 revolutions (Halley on T'(x) = 0)
+bool minimumTimeOfFlight(double lambda, int revolutions, double& tMin) {
+    double x = 0.1;
+    for (int i = 0; i < kMaxIterations; ++i) {
+        double y = computeY(x, lambda);
+        double t = timeOfFlight(x, y, lambda, revolutions);
+        double d1, d2, d3;
+        timeDerivatives(x, y, t, lambda, d1, d2, d3);
+        double denominator = 2.0 * d2 * d2 - d1 * d3;
+        if (d2 == 0.0 || denominator == 0.0) return false;
+        double next = x - 2.0 * d1 * d2 / denominator;
+        if (!(next > -1.0 && next < 1.0)) return false;
+        bool done = std::abs(next - x) < kTolerance;
+        x = next;
+        if (done) {
+            tMin = timeOfFlight(x, computeY(x, lambda), lambda, revolutions);
+            return true;
+        }
+    }
+    return false;
+}
+
+// Householder iteration on T(x) = target from x0
+bool solveX(double x0, double target, double lambda, int revolutions, double& x) {
+    x = x0;
+    for (int i = 0; i < kMaxIterations; ++i) {
+        double y = computeY(x, lambda);
+        double t = timeOfFlight(x, y, lambda, revolutions);
+        double f = t - target;
+        double d1, d2, d3;
+        timeDerivatives(x, y, t, lambda, d1, d2, d3);
+        double denominator = d1 * (d1 * d1 - f * d2) + d3 * f * f / 6.0;
+        if (denominator == 0.0) return false;
+        double next = x - f * (d1 * d1 - 0.5 * f * d2) / denominator;
+        if (!std::isfinite(next) || next <= -1.0 || (revolutions > 0 && next >= 1.0)) return false;
+        bool done = std::abs(next - x) < kTolerance;
+        x = next;
+        if (done) return true;
+    }
+    return false;
+}
+
+}  // namespace
+
+std::vector<LambertSolution> solveLambert(const glm::dvec3& r1, const glm::dvec3& r2, double tof, double mu,
+                                          const glm::dvec3& pole, int maxRevolutions) {
+    std::vector<LambertSolution> solutions;
+    double r1n = glm::length(r1);
+    double r2n = glm::length(r2);
+    double cn = glm::length(r2 - r1);
+    if (tof <= 0.0 || mu <= 0.0 || r1n <= 0.0 || r2n <= 0.0 || cn <= 0.0) {
+        return solutions;
+    }
+
+    double s = 0.5 * (r1n + r2n + cn);
+    glm::dvec3 ir1 = r1 / r1n;
+    glm::dvec3 ir2 = r2 / r2n;
+    glm::dvec3 ih = glm::cross(ir1, ir2);
+    double hn = glm::length(ih);
+    if (hn < 1e-12) {
+        // Collinear: the pole picks the transfer plane
+        ih = pole - glm::dot(pole, ir1) * ir1;
+        hn = glm::length(ih);
+        if (hn <= 0.0) return solutions;
+    }
+    ih /= hn;
+
+    double lambda = std::sqrt(std::max(0.0, 1.0 - std::min(1.0, cn / s)));
+    glm::dvec3 it1, it2;
+    if (glm::dot(ih, pole) < 0.0) {
+        // Prograde about the pole means the long way round
+        lambda = -lambda;
+        it1 = glm::cross(ir1, ih);
+        it2 = glm::cross(ir2, ih);
+    } else {
+        it1 = glm::cross(ih, ir1);
+        it2 = glm::cross(ih, ir2);
+    }
+
+    const double target = std::sqrt(2.0 * mu / (s * s * s)) * tof;
+    const double gamma = std::sqrt(0.5 * mu * s);
+    const double rho = (r1n - r2n) / cn;
+    const double sigma = std::sqrt(std::max(0.0, 1.0 - rho * rho));
+
+    auto addSolution = [&](double x, int revolutions, bool lowPath) {
+        double y = computeY(x, lambda);
+        double vr1 = gamma * ((lambda * y - x) - rho * (lambda * y + x)) / r1n;
+        double vr2 = -gamma * ((lambda * y - x) + rho * (lambda * y + x)) / r2n;
+        double vt = gamma * sigma * (y + lambda * x);
+        solutions.push_back({vr1 * ir1 + (vt / r1n) * it1, vr2 * ir2 + (vt / r2n) * it2, revolutions, lowPath});
+    };
+
+    // Zero revolutions: T(x) is monotonic, start from Izzo's piecewise guess
+    const double t00 = std::acos(lambda) + lambda * std::sqrt(1.0 - lambda * lambda);
+    const double t1 = 2.0 / 3.0 * (1.0 - lambda * lambda * lambda);
+    double x0;
+    if (target >= t00) {
+        x0 = std::pow(t00 / target, 2.0 / 3.0) - 1.0;
+    } else if (target < t1) {
+        x0 = 2.5 * t1 / target * (t1 - target) / (1.0 - std::pow(lambda, 5.0)) + 1.0;
+    } else {
+        x0 = std::exp(std::log(2.0) * std::log(target / t00) / std::log(t1 / t00)) - 1.0;
+    }
+    double x;
+    if (solveX(x0, target, lambda, 0, x)) {
+        addSolution(x, 0, true);
+    }
+
+    // M revolutions: two branches on either side of the minimum time of flight
+    int feasible = std::min(maxRevolutions, static_cast<int>(std::floor(target / kPi)));
+    for (int m = 1; m <= feasible; ++m) {
+        double tMin;
+        if (!minimumTimeOfFlight(lambda, m, tMin) || target < tMin) break;
+
+        double left = std::pow((m * kPi + kPi) / (8.0 * target), 2.0 / 3.0);
+        double right = std::pow(8.0 * target / (m * kPi), 2.0 / 3.0);
+        double xLeft = (left - 1.0) / (left + 1.0);
+        double xRight = (right - 1.0) / (right + 1.0);
+        if (solveX(std::max(xLeft, xRight), target, lambda, m, x)) {
+            addSolution(x, m, true);
+        }
+        if (solveX(std::min(xLeft, xRight), target, lambda, m, x)) {
+            addSolution(x, m, false);
+        }
+    }
+    return solutions;
+}
@@ -1,4 +1,5 @@
 #include "core/octree.h"
+#include "core/reduction.h"
 #include <algorithm>
 #include <cmath>
 #include <limits>
@@ -7,7 +8,21 @@
 // OctreeNode implementation
 // ============================================================
 
-OctreeNode::OctreeNode(const OctreeBounds& bounds) : bounds_(bounds) {}
+OctreeNode::OctreeNode(const OctreeBounds& bounds, OctreeNodePool* pool) : bounds_(bounds), pool_(pool) {}
+
+OctreeNode::~OctreeNode() = default;
+
+void OctreeNode::reset(const OctreeBounds& bounds, int depth, OctreeNodePool* pool) {
+    bounds_ = bounds;
+    totalMass_ = 0.0;
+    centerOfMass_ = glm::dvec3(0.0);
+    bodyCount_ = 0;
+    hasBody_ = false;
+    isInternal_ = false;
+    children_ = nullptr;
+    pool_ = pool;
+    depth_ = depth;
+}
 
 int OctreeNode::getOctant(const glm::dvec3& position) const {
     int octant = 0;
@@ -18,10 +33,13 @@ int OctreeNode::getOctant(const glm::dvec3& position) const {
 }
 
 void OctreeNode::subdivide() {
+    if (!pool_) {
+        ownedPool_ = std::make_unique<OctreeNodePool>();
+        pool_ = ownedPool_.get();
+    }
+    children_ = pool_->acquireOctants();
     for (int i = 0; i < 8; ++i) {
-        OctreeBounds childBounds = bounds_.getChildBounds(i);
-        children_[i] = std::make_unique<OctreeNode>(childBounds);
-        children_[i]->setDepth(depth_ + 1);
+        children_[i].reset(bounds_.getChildBounds(i), depth_ + 1, pool_);
     }
     isInternal_ = true;
 }
@@ -66,96 +84,88 @@ void OctreeNode::insert(const OctreeBody& body) {
         
         // Re-insert the existing body into the appropriate child
         int existingOctant = getOctant(existingBody.position);
-        children_[existingOctant]->insert(existingBody);
+        children_[existingOctant].insert(existingBody);
     }
     
     // Insert new body into appropriate child
     int octant = getOctant(body.position);
-    children_[octant]->insert(body);
+    children_[octant].insert(body);
 }
 
-glm::dvec3 OctreeNode::computeAcceleration(const glm::dvec3& position, double theta,
-                                            double G, double softening) const {
-    if (bodyCount_ == 0) {
-        return glm::dvec3(0.0);
-    }
-    
-    glm::dvec3 delta = centerOfMass_ - position;
-    double distSq = glm::dot(delta, delta);
-    double dist = std::sqrt(distSq);
-    
-    // Skip if the query position is at the center of mass (self-interaction)
-    if (dist < softening) {
-        // For leaf nodes with one body, this means we're computing force on ourselves
-        if (isLeaf()) {
-            return glm::dvec3(0.0);
+void OctreeNode::insertAll(const std::vector<OctreeBody>& bodies, JobSystem& jobs,
+                           std::array<OctreeNodePool, 8>& octantPools) {
+    if (bodies.size() < 2) {
+        for (const auto& body : bodies) {
+            insert(body);
         }
-        // For internal nodes, recurse into children to handle properly
-        if (isInternal_) {
-            glm::dvec3 acc(0.0);
-            for (const auto& child : children_) {
-                if (child) {
-                    acc += child->computeAcceleration(position, theta, G, softening);
-                }
-            }
-            return acc;
-        }
-        return glm::dvec3(0.0);
+        return;
     }
-    
-    // Barnes-Hut criterion: s/d < theta
-    // where s = side length of the node, d = distance to center of mass
-    double nodeSize = bounds_.halfSize * 2.0;
-    
-    if (isLeaf() || (nodeSize / dist < theta)) {
-        // Treat this node as a single body with aggregate mass
-        // a = G * M / r^3 * delta
-        double distCubed = distSq * dist;
-        double factor = G * totalMass_ / distCubed;
-        return factor * delta;
+
+    // What the first two inserts and the rest would do to this node
+    std::array<std::vector<const OctreeBody*>, 8> octants;
+    for (const auto& body : bodies) {
+        updateMassProperties(body);
+        octants[getOctant(body.position)].push_back(&body);
     }
-    
-    // Node is too close / too large: recurse into children
-    glm::dvec3 acc(0.0);
-    for (const auto& child : children_) {
-        if (child) {
-            acc += child->computeAcceleration(position, theta, G, softening);
-        }
+    subdivide();
+    for (size_t octant = 0; octant < octants.size(); ++octant) {
+        children_[octant].pool_ = &octantPools[octant];
     }
-    return acc;
+
+    jobs.parallelFor(0, octants.size(), 1, [&](size_t first, size_t last) {
+        for (size_t octant = first; octant < last; ++octant) {
+            for (const OctreeBody* body : octants[octant]) {
+                children_[octant].insert(*body);
+            }
+        }
+    });
 }
 
 int OctreeNode::getNodeCount() const {
     int count = 1;  // Count this node
     if (isInternal_) {
-        for (const auto& child : children_) {
-            if (child) {
-                count += child->getNodeCount();
-            }
+        for (int i = 0; i < 8; ++i) {
+            count += children_[i].getNodeCount();
         }
     }
     return count;
 }
 
+// ============================================================
+// OctreeNodePool implementation
+// ============================================================
+
+OctreeNode* OctreeNodePool::acquireOctants() {
+    if (used_ == blocks_.size()) {
+        blocks_.push_back(std::make_unique<std::array<OctreeNode, 8>>());
+    }
+    return blocks_[used_++]->data();
+}
+
 // ============================================================
 // Octree implementation
 // ============================================================
 
 Octree::Octree(float theta) : theta_(theta) {}
 
-OctreeBounds Octree::computeBounds(const std::vector<OctreeBody>& bodies) const {
+OctreeBounds Octree::computeBounds(const std::vector<OctreeBody>& bodies, JobSystem* jobs) const {
     if (bodies.empty()) {
         return OctreeBounds(glm::dvec3(0.0), 1.0);
     }
     
     // Find the bounding box of all bodies
-    glm::dvec3 minPos(std::numeric_limits<double>::max());
-    glm::dvec3 maxPos(std::numeric_limits<double>::lowest());
-    
-    for (const auto& body : bodies) {
-        minPos = glm::min(minPos, body.position);
-        maxPos = glm::max(maxPos, body.position);
-    }
+    using Box = std::pair<glm::dvec3, glm::dvec3>;
+    const Box empty(glm::dvec3(std::numeric_limits<double>::max()), glm::dvec3(std::numeric_limits<double>::lowest()));
+    Box box = deterministicReduce(jobs, bodies.size(), kParallelBuildMin, empty,
+        [&](Box& partial, size_t i) {
+            partial.first = glm::min(partial.first, bodies[i].position);
+            partial.second = glm::max(partial.second, bodies[i].position);
+        },
+        [](const Box& a, const Box& b) {
+            return Box(glm::min(a.first, b.first), glm::max(a.second, b.second));
+        });
+    glm::dvec3 minPos = box.first;
+    glm::dvec3 maxPos = box.second;
     
     // Create a cube that contains all bodies
     glm::dvec3 center = (minPos + maxPos) * 0.5;
@@ -173,33 +183,41 @@ OctreeBounds Octree::computeBounds(const std::vector<OctreeBody>& bodies) const
     return OctreeBounds(center, halfSize);
 }
 
-void Octree::build(const std::vector<OctreeBody>& bodies) {
+void Octree::build(const std::vector<OctreeBody>& bodies, JobSystem* jobs) {
     if (bodies.empty()) {
-        root_ = nullptr;
+        built_ = false;
         return;
     }
+    if (bodies.size() < kParallelBuildMin) {
+        jobs = nullptr;
+    }
     
     // Compute bounding box
-    OctreeBounds bounds = computeBounds(bodies);
+    OctreeBounds bounds = computeBounds(bodies, jobs);
     
-    // Create root and insert all bodies
-    root_ = std::make_unique<OctreeNode>(bounds);
-    for (const auto& body : bodies) {
-        root_->insert(body);
+    // Reset the root over the retained node storage and insert all bodies
+    pool_.reset();
+    for (auto& pool : octantPools_) {
+        pool.reset();
     }
-}
-
-glm::dvec3 Octree::computeAcceleration(const glm::dvec3& position, double G) const {
     if (!root_) {
-        return glm::dvec3(0.0);
+        root_ = std::make_unique<OctreeNode>();
+    }
+    root_->reset(bounds, 0, &pool_);
+    built_ = true;
+    if (jobs) {
+        root_->insertAll(bodies, *jobs, octantPools_);
+        return;
+    }
+    for (const auto& body : bodies) {
+        root_->insert(body);
     }
-    return root_->computeAcceleration(position, theta_, G);
 }
 
 int Octree::getNodeCount() const {
-    return root_ ? root_->getNodeCount() : 0;
+    return built_ ? root_->getNodeCount() : 0;
 }
 
 int Octree::getBodyCount() const {
-    return root_ ? root_->getBodyCount() : 0;
+    return built_ ? root_->getBodyCount() : 0;
 }
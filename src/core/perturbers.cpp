@@ -0,0 +1,69 @@
+#include "core/perturbers.h"
+
+#include <algorithm>
+#include <limits>
+
+PerturberSet::PerturberSet(double tolerance, double refreshInterval, double driftFraction)
+    : tolerance_(tolerance), refreshInterval_(refreshInterval), driftFraction_(driftFraction) {}
+
+bool PerturberSet::needsRefresh(const glm::dvec3& position, double time, const BODY_MAP& bodies) const {
+    if (!valid_ || &bodies != bodies_ || bodies.size() != bodyCount_) return true;
+    if (time < refreshTime_ || time - refreshTime_ >= refreshInterval_) return true;
+    if (!covers(position)) return true;
+
+    // The same map object may have been refilled; near bodies are held by pointer
+    for (size_t i = 0; i < near_.size(); ++i) {
+        auto it = bodies.find(nearNames_[i]);
+        if (it == bodies.end() || it->second.get() != near_[i].body) return true;
+    }
+    return false;
+}
+
+void PerturberSet::refresh(const glm::dvec3& position, double time, const BODY_MAP& bodies, const Body* self, double G) {
+    near_.clear();
+    nearNames_.clear();
+    farNames_.clear();
+    farAcceleration_ = glm::dvec3(0.0);
+    farTidal_ = glm::dmat3(0.0);
+
+    // Point-mass acceleration magnitude of each body at the vehicle
+    candidates_.clear();
+    double strongest = 0.0;
+    for (const auto& [name, body] : bodies) {
+        if (body.get() == self) continue;
+        glm::dvec3 delta = position - body->position;
+        double r2 = glm::dot(delta, delta);
+        double gm = G * body->mass;
+        double accel = r2 > 1e-12 ? gm / r2 : std::numeric_limits<double>::infinity();
+        candidates_.push_back({&name, body.get(), gm, accel});
+        strongest = std::max(strongest, accel);
+    }
+
+    double closestFar = std::numeric_limits<double>::infinity();
+    for (const auto& c : candidates_) {
+        if (c.accel >= tolerance_ * strongest) {
+            near_.push_back({c.body, c.gm});
+            nearNames_.push_back(*c.name);
+            continue;
+        }
+
+        // Far body: fold its acceleration and gravity gradient at the anchor
+        glm::dvec3 d = position - c.body->position;
+        double r = glm::length(d);
+        glm::dvec3 u = d / r;
+        double k = c.gm / (r * r * r);
+        farAcceleration_ -= k * d;
+        // Tidal tensor GM/r^3 (3 u u^T - I), symmetric so column order does not matter
+        farTidal_ += k * (3.0 * glm::outerProduct(u, u) - glm::dmat3(1.0));
+
+        farNames_.push_back(*c.name);
+        closestFar = std::min(closestFar, r);
+    }
+
+    anchor_ = position;
+    maxDrift_ = std::isinf(closestFar) ? std::numeric_limits<double>::max() : driftFraction_ * closestFar;
+    refreshTime_ = time;
+    bodies_ = &bodies;
+    bodyCount_ = bodies.size();
+    valid_ = true;
+}
@@ -0,0 +1,48 @@
+#include "core/physics_thread.h"
+#include "core/simulation_core.h"
+
+#include <algorithm>
+#include <chrono>
+
+PhysicsThread::PhysicsThread(SimulationCore& simulation, double rate)
+    : simulation_(simulation), period_(1.0 / std::max(1.0, rate)) {}
+
+PhysicsThread::~PhysicsThread() {
+    stop();
+}
+
+void PhysicsThread::start() {
+    if (running_.exchange(true)) {
+        return;
+    }
+    thread_ = std::thread(&PhysicsThread::run, this);
+}
+
+void PhysicsThread::stop() {
+    running_ = false;
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void PhysicsThread::run() {
+    using Clock = std::chrono::steady_clock;
+    const auto period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(period_));
+
+    auto last = Clock::now();
+    auto next = last + period;
+    while (running_.load(std::memory_order_relaxed)) {
+        auto now = Clock::now();
+        float deltaTime = std::chrono::duration<float>(now - last).count();
+        last = now;
+        simulation_.update(deltaTime);
+
+        // Fixed cadence; after an overrun, restart it rather than catching up
+        if (Clock::now() < next) {
+            std::this_thread::sleep_until(next);
+            next += period;
+        } else {
+            next = Clock::now() + period;
+        }
+    }
+}
@@ -0,0 +1,96 @@
+#include "core/porkchop.h"
+#include "core/encke.h"
+#include "core/lambert.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <optional>
+
+namespace {
+
+double sampleTime(double start, double end, size_t steps, size_t index) {
+    return steps > 1 ? start + (end - start) * static_cast<double>(index) / static_cast<double>(steps - 1) : start;
+}
+
+}  // namespace
+
+// ============================================================
+// Porkchop implementation
+// ============================================================
+
+Porkchop::Porkchop(const PorkchopRequest& request)
+    : request_(request),
+      deltaV_(request.departureSteps * request.arrivalSteps, std::numeric_limits<float>::quiet_NaN()) {}
+
+double Porkchop::departureTime(size_t i) const {
+    return sampleTime(request_.departureStart, request_.departureEnd, request_.departureSteps, i);
+}
+
+double Porkchop::arrivalTime(size_t j) const {
+    return sampleTime(request_.arrivalStart, request_.arrivalEnd, request_.arrivalSteps, j);
+}
+
+bool Porkchop::best(size_t& i, size_t& j) const {
+    float lowest = std::numeric_limits<float>::infinity();
+    for (size_t k = 0; k < deltaV_.size(); ++k) {
+        if (deltaV_[k] < lowest) {
+            lowest = deltaV_[k];
+            i = k % request_.departureSteps;
+            j = k / request_.departureSteps;
+        }
+    }
+    return std::isfinite(lowest);
+}
+
+Porkchop computePorkchop(const PhaseState& departure, const PhaseState& arrival, double mu,
+                         const PorkchopRequest& request) {
+    Porkchop grid(request);
+    const size_t columns = request.departureSteps;
+    const size_t rows = request.arrivalSteps;
+    if (columns == 0 || rows == 0) {
+        return grid;
+    }
+
+    // Ephemeris per column and per row, not per cell
+    std::vector<PhaseState> departures(columns);
+    std::vector<PhaseState> arrivals(rows);
+    for (size_t i = 0; i < columns; ++i) {
+        departures[i] = keplerPropagate(departure, mu, grid.departureTime(i));
+    }
+    for (size_t j = 0; j < rows; ++j) {
+        arrivals[j] = keplerPropagate(arrival, mu, grid.arrivalTime(j));
+    }
+
+    // Transfers run prograde with the departure body's orbit
+    const glm::dvec3 pole = glm::cross(departure.position, departure.velocity);
+
+    auto fillRow = [&](size_t j) {
+        const PhaseState& to = arrivals[j];
+        for (size_t i = 0; i < columns; ++i) {
+            double tof = grid.arrivalTime(j) - grid.departureTime(i);
+            if (tof <= 0.0) continue;
+            const PhaseState& from = departures[i];
+            double cheapest = std::numeric_limits<double>::infinity();
+            for (const LambertSolution& s : solveLambert(from.position, to.position, tof, mu, pole, request.maxRevolutions)) {
+                double cost = glm::length(s.departureVelocity - from.velocity) + glm::length(s.arrivalVelocity - to.velocity);
+                cheapest = std::min(cheapest, cost);
+            }
+            if (std::isfinite(cheapest)) {
+                grid.deltaV_[j * columns + i] = static_cast<float>(cheapest);
+            }
+        }
+    };
+
+    // Rows in small chunks: the infeasible corner of the grid (arrival
+    // before departure) makes rows uneven, and idle workers steal the rest
+    std::optional<JobSystem> local;
+    JobSystem* jobs = request.jobs;
+    if (!jobs) {
+        jobs = &local.emplace(request.threads);
+    }
+    jobs->parallelFor(0, rows, 1, [&](size_t first, size_t last) {
+        for (size_t j = first; j < last; ++j) fillRow(j);
+    });
+    return grid;
+}
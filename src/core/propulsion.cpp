@@ -0,0 +1,50 @@
+#include "core/propulsion.h"
+
+
+// ============================================================
+// PerformanceCurve implementation
+// ============================================================
+
+PerformanceCurve::PerformanceCurve(std::vector<std::pair<double, double>> points)
+    : points_(std::move(points)) {
+    for (size_t i = 1; i < points_.size(); ++i) {
+        if (points_[i].first <= points_[i - 1].first) {
+            throw ConfigError("Performance curve samples must be strictly increasing");
+        }
+    }
+}
+
+// ============================================================
+// PropulsionStage implementation
+// ============================================================
+
+PropulsionStage::PropulsionStage(const RocketStageConfig& config)
+    : name_(config.name), dryMass_(config.dry_mass), propellantMass_(config.propellant_mass),
+      thrust_(config.thrust_curve), isp_(config.isp_curve) {
+    if (dryMass_ < 0.0 || propellantMass_ < 0.0) {
+        throw ConfigError("Stage '" + name_ + "': masses must be non-negative");
+    }
+    if (isp_.empty()) {
+        throw ConfigError("Stage '" + name_ + "': needs an isp or isp_curve");
+    }
+    for (const auto& [pressure, isp] : config.isp_curve) {
+        if (isp <= 0.0) {
+            throw ConfigError("Stage '" + name_ + "': specific impulse must be positive");
+        }
+    }
+    for (const auto& [t, thrust] : config.thrust_curve) {
+        if (thrust < 0.0) {
+            throw ConfigError("Stage '" + name_ + "': thrust must be non-negative");
+        }
+    }
+    vacuumIsp_ = isp_.at(0.0);
+}
+
+PropulsionStage PropulsionStage::constant(double propellantMass, double exhaustVelocity) {
+    PropulsionStage stage;
+    stage.name_ = "main";
+    stage.propellantMass_ = propellantMass;
+    stage.vacuumIsp_ = exhaustVelocity / kStandardGravity;
+    stage.isp_ = PerformanceCurve({{0.0, stage.vacuumIsp_}});
+    return stage;
+}
@@ -1,73 +1,278 @@
 #include "core/rocket.h"
+#include "core/force_model.h"
 #include "logging/spdlog_logger.h"
+#include <algorithm>
+#include <atomic>
 #include <vector>
 #include <cmath>
 
 #include <iostream>
 
+namespace {
+
+// Local frame at `radial` from Earth's center (Y radially outward, X/Z
+// tangential) to world space
+template <typename Vec, typename Dir>
+Vec localToWorld(const Vec& radial, const Dir& localDir) {
+    using std::abs;
+    auto r = length(radial);
+    if (r < 1e-6) {
+        return Vec(localDir);  // Degenerate: rocket at Earth center
+    }
+
+    Vec up = radial / r;  // Local Y: radially outward
+
+    // Choose a reference vector that's not parallel to up for cross product
+    glm::dvec3 ref = (abs(dot(up, glm::dvec3(0, 0, 1))) < 0.99)
+                   ? glm::dvec3(0, 0, 1) : glm::dvec3(1, 0, 0);
+
+    Vec east = normalize(cross(ref, up));  // Local X: tangential
+    Vec north = cross(up, east);           // Local Z: completes frame
+
+    // Transform: world_dir = east * localDir.x + up * localDir.y + north * localDir.z
+    return east * localDir.x + up * localDir.y + north * localDir.z;
+}
+
+/**
+ * Stage engine steered by the flight plan's guidance profiles, which are
+ * evaluated at every RK stage instead of once per frame.
+ */
+template <typename Vec>
+struct BasicGuidedEngine {
+    using Scalar = typename Vec::value_type;
+
+    BasicStageEngine<Vec> engine;
+    const FlightPlan* plan;
+    glm::dvec3 earth;
+    double earthRadius;
+    double missionTime;     // Time since launch at the start of the step (s)
+    GuidanceShift<Scalar> shift = {};
+
+    BasicEngineOutput<Vec> operator()(const Vec& pos, const Vec& vel, const Scalar& t) const {
+        Vec radial = pos - earth;
+        auto action = plan->template getAction<Vec>(length(radial) - earthRadius, length(vel), missionTime + t, shift);
+        if (!action) {
+            return engine(pos, vel, t);
+        }
+        return engine.output(pos, t, action->thrust, localToWorld(radial, action->direction));
+    }
+};
+using GuidedEngine = BasicGuidedEngine<glm::dvec3>;
+
+}  // namespace
+
 Rocket::Rocket(const Config& config, std::shared_ptr<ILogger> logger, const FlightPlan& plan)
      : flightPlan(plan), fuel_mass(config.rocket_fuel_mass),
-        thrust(config.rocket_thrust), exhaust_velocity(config.rocket_exhaust_velocity),
+        thrust(config.rocket_thrust),
         earthPosition_(0.0),  // Will be updated from simulation
         Body(config, logger, "Rocket", config.rocket_mass, config.rocket_initial_position, config.rocket_initial_velocity) {
     if (!logger_) {
         throw std::runtime_error("[Rocket] Logger is null");
     }
+    setupAtmospheres();
+    setupStages();
+    perturbers_ = PerturberSet(config_.physics_perturber_tolerance, config_.physics_perturber_refresh_interval);
+}
+
+void Rocket::setBodyTree(const BodyTree* tree) {
+    bodyTree_ = tree;
+    earthIndex_ = tree ? tree->indexOf("earth") : BodyTree::kNone;
+    moonIndex_ = tree ? tree->indexOf("moon") : BodyTree::kNone;
+}
+
+void Rocket::setupAtmospheres() {
+    atmospheres_.clear();
+    atmospheres_.push_back({"earth", config_.physics_earth_radius,
+                            AtmosphereTable::us76(config_.physics_atmosphere_resolution,
+                                                  config_.physics_atmosphere_ceiling)});
+    for (const auto& planet : config_.planets) {
+        if (planet.name == "earth" || planet.atmosphere.empty()) continue;
+        atmospheres_.push_back({planet.name, planet.radius,
+                                AtmosphereTable::fromProfile(planet.atmosphere, config_.physics_atmosphere_resolution)});
+    }
+
+    dragTable_ = config_.physics_drag_mach_table.empty()
+               ? DragTable::constant(config_.physics_drag_coefficient)
+               : DragTable::fromPoints(config_.physics_drag_mach_table);
+}
+
+const Rocket::AtmosphereBody* Rocket::atmosphereNear(const glm::dvec3& stepPosition, const glm::dvec3& stepVelocity, double h,
+                                                     const BODY_MAP& bodies, glm::dvec3& center, glm::dvec3& centerVelocity) const {
+    for (const auto& atmosphere : atmospheres_) {
+        center = earthPosition_;
+        centerVelocity = glm::dvec3(0.0);
+        double mass = config_.physics_earth_mass;
+        auto it = bodies.find(atmosphere.name);
+        if (it != bodies.end()) {
+            center = it->second->position;
+            centerVelocity = it->second->velocity;
+            mass = it->second->mass;
+        } else if (atmosphere.name != "earth") {
+            continue;
+        }
+
+        // Lowest altitude over the step: the closest approach of the straight
+        // path, less how far the body's gravity there can pull it down in h
+        glm::dvec3 r = stepPosition - center;
+        glm::dvec3 v = stepVelocity - centerVelocity;
+        double vv = glm::dot(v, v);
+        double t = vv > 0.0 ? std::clamp(-glm::dot(r, v) / vv, 0.0, h) : 0.0;
+        double closest = glm::length(r + v * t);
+        double lowest = closest - atmosphere.radius;
+        if (h > 0.0 && lowest >= atmosphere.table.ceiling()) {
+            lowest -= 0.5 * config_.physics_gravity_constant * mass / (closest * closest) * h * h;
+        }
+        if (lowest < atmosphere.table.ceiling()) {
+            return &atmosphere;
+        }
+    }
+    return nullptr;
+}
+
+void Rocket::setupStages() {
+    stages_.clear();
+    activeStage_ = 0;
+    stageBurnTime_ = 0.0;
+    if (config_.rocket_stages.empty()) {
+        stages_.push_back(PropulsionStage::constant(config_.rocket_fuel_mass, config_.rocket_exhaust_velocity));
+        return;
+    }
+
+    double stack = 0.0;
+    for (const auto& stage : config_.rocket_stages) {
+        stages_.emplace_back(stage);
+        stack += stage.dry_mass + stage.propellant_mass;
+    }
+    if (stack > mass) {
+        throw ConfigError("[Rocket] Stages weigh " + std::to_string(stack) +
+                          " kg, more than the liftoff mass " + std::to_string(mass) + " kg");
+    }
+    fuel_mass = stages_.front().propellantMass();
+}
+
+bool Rocket::separateStage(size_t& stage, double& currentMass, double& currentFuel, double& burnTime) const {
+    if (stage + 1 >= stages_.size()) {
+        return false;
+    }
+    currentMass -= stages_[stage].dryMass() + std::max(0.0, currentFuel);
+    ++stage;
+    currentFuel = stages_[stage].propellantMass();
+    burnTime = 0.0;
+    return true;
+}
+
+StageEngine Rocket::stageEngine(size_t stage, double burnTime, const glm::dvec3& stepPosition, const glm::dvec3& stepVelocity,
+                                double h, const BODY_MAP& bodies) const {
+    // Back-pressure from the atmosphere drag uses, vacuum outside it
+    glm::dvec3 center(0.0), centerVelocity(0.0);
+    const AtmosphereBody* atmosphere = atmosphereNear(stepPosition, stepVelocity, h, bodies, center, centerVelocity);
+    return StageEngine{&stages_[stage], localToWorldDirection(thrustDirection), thrust, burnTime,
+                       atmosphere ? &atmosphere->table : nullptr, center,
+                       atmosphere ? atmosphere->radius : 0.0};
 }
 
 void Rocket::init() {
     thrustDirection = glm::dvec3(0.0, 1.0, 0.0); // Thrust direction (upward)
+    setupEvents();
+}
 
-    // Rocket 3D pyramid vertices (in rendering units: km)
-    // Made larger so it's visible at typical camera distances (100-500 km)
-    // Pyramid with tip pointing in +Y direction (forward)
-    // Center the pyramid so rotation works correctly around origin
-    const float baseSize = 10.0f;  // Base width/depth: 20 km (±10 km)
-    const float height = 50.0f;    // Height: 50 km
-    const float tipY = height * 0.75f;   // Tip at 3/4 height above center
-    const float baseY = -height * 0.25f; // Base at 1/4 height below center
-    
-    std::vector<GLfloat> vertices = {
-        // Tip of the pyramid (forward direction)
-        0.0f, tipY, 0.0f,                 // 0: Tip
-        
-        // Base vertices (square)
-        -baseSize, baseY, -baseSize,      // 1: Back-left
-        baseSize, baseY, -baseSize,       // 2: Back-right
-        baseSize, baseY, baseSize,        // 3: Front-right
-        -baseSize, baseY, baseSize        // 4: Front-left
-    };
-    
-    // Indices for 4 triangular faces + 2 triangles for base
-    std::vector<GLuint> indices = {
-        // Side faces (4 triangles from tip to base edges)
-        0, 4, 3,  // Front face
-        0, 3, 2,  // Right face
-        0, 2, 1,  // Back face
-        0, 1, 4,  // Left face
-        
-        // Base (2 triangles to close the bottom)
-        1, 2, 3,
-        1, 3, 4
-    };
-    
-    if(!renderObject)
-        renderObject = std::make_unique<RenderObject>(vertices, indices);
+void Rocket::setupEvents() {
+    // Event functions capture `this`, which is why Rocket is neither
+    // copied nor moved; init() rebuilds them.
+    events_ = EventDetector(config_.simulation_event_tolerance);
+    predictionEvents_ = EventDetector(config_.simulation_event_tolerance);
+
+    auto impact = [this](const EventState& s) { return altitudeAt(s.position); };
+    impactEvent_ = events_.add({"impact", impact, EventDirection::Falling});
+    predictionEvents_.add({"impact", impact, EventDirection::Falling});
 
-    if(!trajectory_)
-        trajectory_ = TrajectoryFactory::createRocketTrajectory(config_, logger_);
-    trajectory_->init();
+    fuelEvent_ = events_.add({"fuel_depleted",
+        [](const EventState& s) { return s.fuel; }, EventDirection::Falling});
 
-    if(!prediction_)
-        prediction_ = TrajectoryFactory::createRocketPredictionTrajectory(config_, logger_);
-    prediction_->init();
+    moonSoiEvent_ = events_.add({"moon_soi",
+        [this](const EventState& s) {
+            if (moonSoiRadius_ <= 0.0) return 1.0;  // No Moon: never crosses
+            return glm::length(s.position - moonPosition_) - moonSoiRadius_;
+        }, EventDirection::Any});
+
+    // Radial velocity relative to Earth: rising through zero at periapsis,
+    // falling through zero at apoapsis
+    apsisEvent_ = events_.add({"apsis",
+        [this](const EventState& s) { return glm::dot(s.position - earthPosition_, s.velocity); },
+        EventDirection::Any});
+
+    // One event per distinct flight-plan boundary, so stage switches happen
+    // exactly where the plan says instead of at the next frame boundary.
+    firstFlightPlanEvent_ = events_.size();
+    std::vector<double> altitudes, speeds;
+    for (const auto& stage : flightPlan.getStages()) {
+        for (double a : {stage.condition.altitude_min, stage.condition.altitude_max}) {
+            if (a && std::find(altitudes.begin(), altitudes.end(), a) == altitudes.end()) altitudes.push_back(a);
+        }
+        for (double v : {stage.condition.speed_min, stage.condition.speed_max}) {
+            if (v && std::find(speeds.begin(), speeds.end(), v) == speeds.end()) speeds.push_back(v);
+        }
+    }
+    for (double a : altitudes) {
+        events_.add({"plan_altitude_" + std::to_string(a),
+            [this, a](const EventState& s) { return altitudeAt(s.position) - a; }, EventDirection::Any});
+    }
+    for (double v : speeds) {
+        events_.add({"plan_speed_" + std::to_string(v),
+            [v](const EventState& s) { return glm::length(s.velocity) - v; }, EventDirection::Any});
+    }
 }
 
 void Rocket::update(float deltaTime, const BODY_MAP& bodies, const Octree* octree) {
+    prepareStep(deltaTime, bodies);
+    updatePrediction(deltaTime, bodies, octree);
+    completeStep(deltaTime, bodies, octree);
+}
+
+const Body* Rocket::earthBody(const BODY_MAP& bodies) const {
+    if (bodyTree_) {
+        return earthIndex_ != BodyTree::kNone ? &bodyTree_->body(earthIndex_) : nullptr;
+    }
+    auto it = bodies.find("earth");
+    return it != bodies.end() ? it->second.get() : nullptr;
+}
+
+void Rocket::prepareStep(float deltaTime, const BODY_MAP& bodies) {
     // Update Earth position for altitude calculations
     glm::dvec3 previousEarthPosition = earthPosition_;
-    if (bodies.find("earth") != bodies.end()) {
-        earthPosition_ = bodies.at("earth")->position;
+    const Body* earth = earthBody(bodies);
+    if (earth) {
+        earthPosition_ = earth->position;
+    }
+
+    // Moon sphere of influence for the SOI event (a * (m/M)^(2/5)), cached by the tree
+    moonSoiRadius_ = 0.0;
+    if (bodyTree_) {
+        if (moonIndex_ != BodyTree::kNone && bodyTree_->parentOf(moonIndex_) == earthIndex_) {
+            moonPosition_ = bodyTree_->body(moonIndex_).position;
+            moonSoiRadius_ = bodyTree_->soiRadius(moonIndex_);
+        }
+    } else if (auto moon = bodies.find("moon"); moon != bodies.end() && earth) {
+        moonPosition_ = moon->second->position;
+        double earthMoonDist = glm::length(moonPosition_ - earthPosition_);
+        moonSoiRadius_ = earthMoonDist * std::pow(moon->second->mass / earth->mass, 0.4);
+    }
+
+    // Reference body for Encke propagation: innermost SOI from the tree, else Earth
+    const Body* central = earth;
+    if (bodyTree_ && !bodyTree_->empty()) {
+        central = &bodyTree_->body(bodyTree_->dominantBody(position));
+    }
+    centralMu_ = central ? config_.physics_gravity_constant * central->mass : 0.0;
+    if (central) {
+        centralPosition_ = central->position;
+        centralVelocity_ = central->velocity;
+    }
+
+    // Reclassify gravity perturbers when stale or when the rocket has moved away
+    perturberClock_ += deltaTime;
+    if (config_.physics_perturber_tolerance > 0.0 && perturbers_.needsRefresh(position, perturberClock_, bodies)) {
+        perturbers_.refresh(position, perturberClock_, bodies, this, config_.physics_gravity_constant);
     }
     
     if (!launched) {
@@ -77,55 +282,88 @@ void Rocket::update(float deltaTime, const BODY_MAP& bodies, const Octree* octre
         position += earthDelta;
         
         // Also update velocity to match Earth's orbital velocity
-        if (bodies.find("earth") != bodies.end()) {
-            velocity = bodies.at("earth")->velocity;
-        }
-        
-        // Still update prediction trajectory even when not launched
-        // This allows user to see predicted path before launch
-        if (prediction_ && deltaTime > 0.0f) {
-            predictionTimer_ += deltaTime;
-            if (predictionTimer_ >= predictionUpdateInterval_) {
-                predictTrajectory(config_.simulation_prediction_duration, config_.simulation_prediction_step, bodies, octree);
-                predictionTimer_ = 0.0f;
-            }
+        if (earth) {
+            velocity = earth->velocity;
         }
         return;
     }
     
     time += deltaTime;
-    
-    if (trajectory_ && deltaTime > 0.0f) {
-        LOG_DEBUG(logger_, "Rocket", "Trajectory trajectory_ update");
-        trajectory_->update(offsetPosition(position), deltaTime);
-        
-        // Update prediction less frequently to improve performance
-        predictionTimer_ += deltaTime;
-        if (predictionTimer_ >= predictionUpdateInterval_) {
-            predictTrajectory(config_.simulation_prediction_duration, config_.simulation_prediction_step, bodies, octree);
-            predictionTimer_ = 0.0f;
+}
+
+void Rocket::updatePrediction(float deltaTime, const BODY_MAP& bodies, const Octree* octree) {
+    // Before launch this lets the user see the predicted path; the flown
+    // trajectory itself is recorded by the renderer from the snapshots
+    if (config_.simulation_prediction_duration <= 0.0f || deltaTime <= 0.0f) {
+        return;
+    }
+    // Update prediction less frequently to improve performance
+    predictionTimer_ += deltaTime;
+    if (predictionTimer_ >= predictionUpdateInterval_) {
+        predictTrajectory(config_.simulation_prediction_duration, config_.simulation_prediction_step, bodies, octree);
+        predictionTimer_ = 0.0f;
+    }
+}
+
+void Rocket::completeStep(float deltaTime, const BODY_MAP& bodies, const Octree* octree) {
+    if (!launched) {
+        return;
+    }
+
+    // Integrate the frame, splitting the step at every located event.
+    // Each trial step is scanned with dense output; on a crossing the
+    // step is redone from the same start to exactly the event time.
+    const double frameDt = static_cast<double>(deltaTime);
+    const double epoch = static_cast<double>(time) - frameDt;   // Mission time at the frame start
+    double t = 0.0;
+    int eventCount = 0;
+    std::optional<size_t> suppressed;  // Event just handled, off for kEventRefireWindow
+    while (launched && t < frameDt) {
+        // Right after an event, step only across its refire window; the event
+        // is back on for the rest of the frame, so a later crossing is found
+        double h = frameDt - t;
+        if (suppressed) h = std::min(h, kEventRefireWindow);
+        const bool last = h >= frameDt - t;
+        EventState start = currentEventState(t);
+        EventState end = integrateStep(start, h, epoch, bodies, octree);
+
+        std::optional<EventHit> hit;
+        if (eventCount < kMaxEventsPerFrame) {
+            if (suppressed) events_.setEnabled(*suppressed, false);
+            hit = events_.findFirst(DenseStep(start, end));
+            if (suppressed) events_.setEnabled(*suppressed, true);
         }
+        if (!hit) {
+            applyEventState(end);
+            if (last) break;
+            t = end.time;
+            suppressed.reset();
+            continue;
+        }
+
+        EventState atEvent = integrateStep(start, hit->state.time - start.time, epoch, bodies, octree);
+        applyEventState(atEvent);
+        t = atEvent.time;
+        ++eventCount;
+        handleEvent(*hit, epoch, bodies);
+
+        // The re-integrated state can sit a hair before the crossing found on
+        // the interpolant; keep the same event from firing again right away.
+        suppressed = hit->index;
     }
-    
-    Body current = *this;
-    double currentMass = mass;
-    Body newState = updateStateRK4(current, static_cast<double>(deltaTime), currentMass, fuel_mass, bodies, octree);
-    position = newState.position;
-    velocity = newState.velocity;
-    mass = currentMass;
-    
+
     // Calculate altitude relative to Earth (not Sun) in heliocentric coordinates
     glm::dvec3 relativeToEarth = position - earthPosition_;
-    double distanceFromEarthCenter = glm::length(relativeToEarth);
-    double altitude = distanceFromEarthCenter - config_.physics_earth_radius;
+    double altitude = altitudeAt(position);
     if (altitude < 0.0) {
-        // Crashed into Earth: clamp position to surface, match Earth velocity
-        LOG_INFO(logger_, "Rocket", "Crashed into Earth at altitude " + std::to_string(altitude));
+        // Started below the surface (the impact event handles in-flight crashes):
+        // clamp position to surface, match Earth velocity
+        LOG_INFOF(logger_, "Rocket", "Crashed into Earth at altitude {}", altitude);
         glm::dvec3 dirFromEarth = glm::normalize(relativeToEarth);
         position = earthPosition_ + dirFromEarth * config_.physics_earth_radius;
         // Match Earth orbital velocity so the rocket stays on the surface
-        if (bodies.find("earth") != bodies.end()) {
-            velocity = bodies.at("earth")->velocity;
+        if (const Body* earth = earthBody(bodies)) {
+            velocity = earth->velocity;
         } else {
             velocity = glm::dvec3(0.0);
         }
@@ -134,7 +372,7 @@ void Rocket::update(float deltaTime, const BODY_MAP& bodies, const Octree* octre
         predictionDirty_ = true;
     }
     
-    auto action = flightPlan.getAction(altitude, glm::length(velocity));
+    auto action = flightPlan.getAction(altitude, glm::length(velocity), time);
     if (action) {
         thrust = action->thrust;
         thrustDirection = action->direction;
@@ -142,84 +380,148 @@ void Rocket::update(float deltaTime, const BODY_MAP& bodies, const Octree* octre
     }
 }
 
-void Rocket::render(const Shader& shader) const {
-    render(shader, glm::dvec3(0.0));
+double Rocket::altitudeAt(const glm::dvec3& pos) const {
+    return glm::length(pos - earthPosition_) - config_.physics_earth_radius;
 }
 
-void Rocket::render(const Shader& shader, const glm::dvec3& renderOrigin) const {
-    // Calculate rotation matrix to align rocket with velocity direction
-    glm::mat4 model = glm::mat4(1.0f);
-    
-    // Calculate velocity direction in rendering coordinate system
-    // Use numerical differentiation: direction = d(offsetPosition)/dt
-    // which is approximately (offsetPosition(pos + vel*dt) - offsetPosition(pos)) / dt
-    glm::vec3 direction;
-    if (glm::length(velocity) > 0.1) {
-        // Small time step for numerical derivative
-        const double dt = 0.01;  // 10ms
-        
-        // Current render position (relative to renderOrigin)
-        glm::vec3 currentRenderPos = glm::vec3((position - renderOrigin) * static_cast<double>(config_.simulation_rendering_scale));
-        
-        // Future position in physics coordinates
-        glm::dvec3 futurePhysicsPos = position + velocity * dt;
-        
-        // Future render position (relative to renderOrigin)
-        glm::vec3 futureRenderPos = glm::vec3((futurePhysicsPos - renderOrigin) * static_cast<double>(config_.simulation_rendering_scale));
-        
-        // Velocity direction in render coordinates
-        glm::vec3 renderVelocity = futureRenderPos - currentRenderPos;
-        
-        if (glm::length(renderVelocity) > 0.0001f) {
-            direction = glm::normalize(renderVelocity);
+EventState Rocket::currentEventState(double t) const {
+    EventState state;
+    state.time = t;
+    state.position = position;
+    state.velocity = velocity;
+    state.mass = mass;
+    state.fuel = fuel_mass;
+    state.burnTime = stageBurnTime_;
+    return state;
+}
+
+EventState Rocket::integrateStep(const EventState& start, double h, double epoch, const BODY_MAP& bodies, const Octree* octree) const {
+    Body state;
+    state.position = start.position;
+    state.velocity = start.velocity;
+    double stepMass = start.mass;
+    double stepFuel = start.fuel;
+    double stepBurnTime = start.burnTime;
+    Body next = updateStateRK4(state, h, stepMass, stepFuel, stepBurnTime, activeStage_, bodies, octree, start.time, epoch);
+
+    EventState end;
+    end.time = start.time + h;
+    end.position = next.position;
+    end.velocity = next.velocity;
+    // Unclamped fuel so the depletion crossing is found inside the step
+    end.mass = stepMass;
+    end.fuel = stepFuel;
+    end.burnTime = stepBurnTime;
+    return end;
+}
+
+void Rocket::applyEventState(const EventState& state) {
+    position = state.position;
+    velocity = state.velocity;
+    // A step past burnout overdraws the propellant; give the excess back
+    mass = state.mass + std::max(0.0, -state.fuel);
+    fuel_mass = std::max(0.0, state.fuel);
+    stageBurnTime_ = state.burnTime;
+}
+
+void Rocket::handleEvent(const EventHit& hit, double epoch, const BODY_MAP& bodies) {
+    if (hit.index == impactEvent_) {
+        // Land exactly on the surface and stay there with Earth
+        glm::dvec3 earthVelocity(0.0);
+        if (bodyTree_) {
+            if (earthIndex_ != BodyTree::kNone) earthVelocity = bodyTree_->body(earthIndex_).velocity;
+        } else if (auto earth = bodies.find("earth"); earth != bodies.end()) {
+            earthVelocity = earth->second->velocity;
+        }
+        LOG_INFOF(logger_, "Rocket", "Impact with Earth at {} m/s", glm::length(velocity - earthVelocity));
+        glm::dvec3 relativeToEarth = position - earthPosition_;
+        double r = glm::length(relativeToEarth);
+        if (r > 0.0) {
+            position = earthPosition_ + relativeToEarth * (config_.physics_earth_radius / r);
+        }
+        velocity = earthVelocity;
+        launched = false;
+        crashed_ = true;
+        predictionDirty_ = true;
+    } else if (hit.index == fuelEvent_) {
+        const size_t spent = activeStage_;
+        if (separateStage(activeStage_, mass, fuel_mass, stageBurnTime_)) {
+            LOG_INFOF(logger_, "Rocket", "Stage '{}' separated, '{}' ignited", stages_[spent].name(), stages_[activeStage_].name());
         } else {
-            direction = glm::vec3(0.0f, 1.0f, 0.0f);  // Default upward
+            fuel_mass = 0.0;
+            LOG_INFO(logger_, "Rocket", "Fuel depleted, engine cut off");
         }
-    } else {
-        // When stationary, point upward (in rendering Y direction)
-        direction = glm::vec3(0.0f, 1.0f, 0.0f);
-    }
-    
-    // Default forward direction is +Y (the pyramid tip points in +Y)
-    glm::vec3 defaultForward = glm::vec3(0.0f, 1.0f, 0.0f);
-    
-    // Calculate rotation from default forward to actual direction
-    float dotProduct = glm::dot(defaultForward, direction);
-    
-    // Build rotation matrix first
-    glm::mat4 rotation = glm::mat4(1.0f);
-    if (dotProduct < -0.999f) {
-        // Nearly opposite direction: rotate 180 degrees around any perpendicular axis
-        glm::vec3 rotAxis = glm::vec3(1.0f, 0.0f, 0.0f);  // Use X axis
-        rotation = glm::rotate(glm::mat4(1.0f), glm::pi<float>(), rotAxis);
-    } else if (dotProduct < 0.999f) {
-        // General case: calculate rotation axis and angle
-        glm::vec3 rotAxis = glm::cross(defaultForward, direction);
-        float rotAxisLen = glm::length(rotAxis);
-        if (rotAxisLen > 0.0001f) {
-            rotAxis = glm::normalize(rotAxis);
-            float angle = acos(glm::clamp(dotProduct, -1.0f, 1.0f));
-            rotation = glm::rotate(glm::mat4(1.0f), angle, rotAxis);
+        predictionDirty_ = true;
+    } else if (hit.index == moonSoiEvent_) {
+        LOG_INFO(logger_, "Rocket", hit.rising ? "Left lunar sphere of influence" : "Entered lunar sphere of influence");
+    } else if (hit.index == apsisEvent_) {
+        LOG_DEBUGF(logger_, "Rocket", "{} at altitude {}", hit.rising ? "Periapsis" : "Apoapsis", altitudeAt(position));
+    } else if (hit.index >= firstFlightPlanEvent_) {
+        // Flight-plan boundary: switch stage at the exact crossing state
+        auto action = flightPlan.getAction(altitudeAt(position), glm::length(velocity), epoch + hit.state.time);
+        if (action) {
+            thrust = action->thrust;
+            thrustDirection = action->direction;
+            predictionDirty_ = true;
         }
+        LOG_DEBUGF(logger_, "Rocket", "Flight plan boundary: {}", events_.get(hit.index).name);
     }
-    // If dotProduct >= 0.999f, no rotation needed (already aligned)
-    
-    // Apply transformations: first rotate (around origin), then translate
-    // Position is computed relative to renderOrigin for float precision
-    glm::vec3 relativePos = glm::vec3((position - renderOrigin) * static_cast<double>(config_.simulation_rendering_scale));
-    model = glm::translate(model, relativePos);
-    model = model * rotation;
-    
-    shader.setMat4("model", model);
-    shader.setVec4("color", glm::vec4(0.8f, 0.8f, 0.8f, 1.0f));
-    if (renderObject) 
-        renderObject->render();
+}
+
+void Rocket::fillSnapshot(RocketSnapshot& state) const {
+    state.position = position;
+    state.velocity = velocity;
+    state.thrustDirection = getThrustDirection();
+    state.mass = mass;
+    state.fuelMass = fuel_mass;
+    state.thrust = thrust;
+    state.exhaustVelocity = getExhaustVelocity();
+    state.stageName = getStageName();
+    state.stage = static_cast<uint32_t>(activeStage_);
+    state.time = time;
+    state.launched = launched;
+    state.crashed = crashed_;
+    state.prediction = publishedPrediction_;
+}
+
+void Rocket::saveState(RocketCheckpoint& state) const {
+    state.position = position;
+    state.velocity = velocity;
+    state.thrustDirection = thrustDirection;
+    state.earthPosition = earthPosition_;
+    state.mass = mass;
+    state.fuelMass = fuel_mass;
+    state.thrust = thrust;
+    state.stageBurnTime = stageBurnTime_;
+    state.perturberClock = perturberClock_;
+    state.time = time;
+    state.stage = static_cast<uint32_t>(activeStage_);
+    state.launched = launched;
+    state.crashed = crashed_;
+}
 
-    // Render trajectory (delegated to RenderObject)
-    trajectory_->render(shader);
+void Rocket::restoreState(const RocketCheckpoint& state) {
+    if (state.stage >= stages_.size()) {
+        throw CheckpointError("Checkpoint is on stage " + std::to_string(state.stage + 1) + " of a rocket with " +
+                              std::to_string(stages_.size()));
+    }
+    position = state.position;
+    velocity = state.velocity;
+    thrustDirection = state.thrustDirection;
+    earthPosition_ = state.earthPosition;
+    mass = state.mass;
+    fuel_mass = state.fuelMass;
+    thrust = state.thrust;
+    stageBurnTime_ = state.stageBurnTime;
+    perturberClock_ = state.perturberClock;
+    time = state.time;
+    activeStage_ = state.stage;
+    launched = state.launched;
+    crashed_ = state.crashed;
 
-    // Render prediction trajectory (delegated to RenderObject)
-    prediction_->render(shader);
+    // Predict from the restored state on the next step
+    predictionDirty_ = true;
+    predictionTimer_ = predictionUpdateInterval_;
 }
 
 void Rocket::toggleLaunch() {
@@ -275,7 +577,24 @@ double Rocket::getThrust() const {
 }
 
 double Rocket::getExhaustVelocity() const { 
-    return exhaust_velocity; 
+    return stages_[activeStage_].vacuumIsp() * kStandardGravity;
+}
+
+const std::string& Rocket::getStageName() const {
+    return stages_[activeStage_].name();
+}
+
+std::vector<std::string> Rocket::getStageNames() const {
+    std::vector<std::string> names;
+    names.reserve(stages_.size());
+    for (const auto& stage : stages_) {
+        names.push_back(stage.name());
+    }
+    return names;
+}
+
+const std::vector<ErrorEllipsoid>& Rocket::getPredictionUncertainty() const {
+    return predictionUncertainty_;
 }
 
 glm::dvec3 Rocket::getThrustDirection() const {
@@ -289,70 +608,76 @@ void Rocket::setThrustDirection(const glm::dvec3& direction) {
     }
 }
 
-// For unit tests
-void Rocket::setRender(std::unique_ptr<IRenderObject> render) {
-    renderObject = std::move(render);
-}
+// private
 
-void Rocket::setTrajectoryRender(std::unique_ptr<IRenderObject> trajectory, std::unique_ptr<IRenderObject> prediction) {
-    if (!trajectory_) {
-        trajectory_ = TrajectoryFactory::createRocketTrajectory(config_, logger_);
-    }
-    trajectory_->setRenderObject(std::move(trajectory));
+template <typename Fn>
+auto Rocket::withForceModel(const glm::dvec3& stepPosition, const glm::dvec3& stepVelocity, double h, double currentMass, const BODY_MAP& bodies, const Octree* octree, Fn&& fn, bool engine) const {
+    const double G = config_.physics_gravity_constant;
+
+    auto withJ2 = [&](auto... terms) {
+        if (config_.physics_earth_j2 != 0.0) {
+            forces::J2Gravity j2{earthPosition_, glm::dvec3(0.0, 1.0, 0.0),
+                                 G * config_.physics_earth_mass, config_.physics_earth_j2,
+                                 config_.physics_earth_radius};
+            return fn(makeForceModel(terms..., j2));
+        }
+        return fn(makeForceModel(terms...));
+    };
 
-    if (!prediction_) {
-        prediction_ = TrajectoryFactory::createRocketTrajectory(config_, logger_);
+    auto withDrag = [&](auto... terms) {
+        // Atmospheric drag from the first body whose atmosphere is within reach this step
+        glm::dvec3 center(0.0), centerVelocity(0.0);
+        if (const AtmosphereBody* atmosphere = atmosphereNear(stepPosition, stepVelocity, h, bodies, center, centerVelocity)) {
+            forces::TabulatedDrag drag{&atmosphere->table, &dragTable_, center, centerVelocity,
+                                       atmosphere->radius, config_.physics_cross_section_area};
+            return withJ2(terms..., drag);
+        }
+        return withJ2(terms...);
+    };
+
+    auto withThrust = [&](auto... gravity) {
+        // Thrust at the start of the step: the local-frame direction is resolved
+        // to world space once per step
+        if (engine && fuel_mass > 0.0 && currentMass > 0.0) {
+            forces::Thrust force{stageEngine(activeStage_, stageBurnTime_, stepPosition, stepVelocity, h, bodies)(stepPosition, stepVelocity, 0.0).force};
+            return withDrag(gravity..., force);
+        }
+        return withDrag(gravity...);
+    };
+
+    // Gravity: the culled perturber set when it is valid for this step, else
+    // all bodies through the Barnes-Hut octree if available, else direct summation
+    if (config_.physics_perturber_tolerance > 0.0 && perturbers_.boundTo(bodies) && perturbers_.covers(stepPosition)) {
+        return withThrust(forces::PerturberGravity{&perturbers_});
     }
-    prediction_->setRenderObject(std::move(prediction));
+    if (octree) {
+        return withThrust(forces::OctreeGravity{octree, G});
+    }
+    return withThrust(forces::DirectGravity{&bodies, this, G});
 }
 
-// private
+template <typename Fn>
+auto Rocket::withPerturbation(const PhaseState& relative, double h, double currentMass, const BODY_MAP& bodies, const Octree* octree, Fn&& fn) const {
+    // The force model sees the bodies where they were at the start of the frame,
+    // so it is evaluated at the central-body-relative position. Its central
+    // point-mass term is removed again: the propagator accounts for it exactly.
+    return withForceModel(centralPosition_ + relative.position, centralVelocity_ + relative.velocity, h, currentMass, bodies, octree, [&](const auto& model) {
+        auto perturbation = [&](const glm::dvec3& r, const glm::dvec3& v, double m) {
+            double rn = glm::length(r);
+            return model(centralPosition_ + r, centralVelocity_ + v, m) + (centralMu_ / (rn * rn * rn)) * r;
+        };
+        return fn(perturbation);
+    }, false);
+}
 
 glm::dvec3 Rocket::computeAccelerationRK4(double currentMass, const BODY_MAP& bodies, const Octree* octree) const {
-    // This version uses the rocket's current position/velocity (for real-time update)
     return computeAccelerationAt(position, velocity, currentMass, bodies, octree);
 }
 
 glm::dvec3 Rocket::computeAccelerationAt(const glm::dvec3& pos, const glm::dvec3& vel, double currentMass, const BODY_MAP& bodies, const Octree* octree) const {
-    glm::dvec3 acc(0.0);
-    
-    // Gravity from all bodies: use Barnes-Hut octree if available, else direct summation
-    if (octree) {
-        acc = octree->computeAcceleration(pos, config_.physics_gravity_constant);
-    } else {
-        for (const auto& [name, body] : bodies) {
-            if (body.get() != this) {
-                glm::dvec3 delta = pos - body->position;
-                double r = glm::length(delta);
-                if (r > 1e-6) {
-                    acc -= (config_.physics_gravity_constant * body->mass / (r * r * r)) * delta;
-                }
-            }
-        }
-    }
-    
-    // Thrust: convert local-frame thrustDirection to world-space
-    if (fuel_mass > 0.0 && currentMass > 0.0) {
-        glm::dvec3 worldThrust = localToWorldDirection(thrustDirection);
-        acc += (thrust / currentMass) * worldThrust;
-    }
-    
-    // Atmospheric drag (relative to Earth)
-    glm::dvec3 relativeToEarth = pos - earthPosition_;
-    double distFromEarthCenter = glm::length(relativeToEarth);
-    double altitude = distFromEarthCenter - config_.physics_earth_radius;
-    if (altitude > 0.0 && altitude < 100000.0) {
-        double rho = config_.physics_air_density * std::exp(-altitude / config_.physics_scale_height);
-        double v_magnitude = glm::length(vel);
-        if (v_magnitude > 0.0) {
-            glm::dvec3 v_unit = vel / v_magnitude;
-            double drag_force = 0.5 * rho * config_.physics_drag_coefficient * config_.physics_cross_section_area * v_magnitude * v_magnitude;
-            acc -= drag_force * v_unit / currentMass;
-        }
-    }
-    
-    LOG_DEBUG(logger_, "Rocket", "Acc=" + glm::to_string(glm::vec3(acc)) + ", Fuel=" + std::to_string(fuel_mass));
-    return acc;
+    return withForceModel(pos, vel, 0.0, currentMass, bodies, octree, [&](const auto& model) {
+        return model(pos, vel, currentMass);
+    });
 }
 
 glm::vec3 Rocket::offsetPosition() const {
@@ -367,27 +692,8 @@ glm::vec3 Rocket::offsetPosition(const glm::dvec3& inputPosition) const {
 }
 
 glm::dvec3 Rocket::localToWorldDirection(const glm::dvec3& localDir) const {
-    // Build a local coordinate frame at the rocket's position relative to Earth.
-    // Local Y = radially outward from Earth center (the "up" direction at launch site)
-    // Local X = arbitrary tangential direction (eastward-like)
-    // Local Z = completes the right-handed frame
-    glm::dvec3 radial = position - earthPosition_;
-    double r = glm::length(radial);
-    if (r < 1e-6) {
-        return localDir;  // Degenerate: rocket at Earth center
-    }
-    
-    glm::dvec3 up = radial / r;  // Local Y: radially outward
-    
-    // Choose a reference vector that's not parallel to up for cross product
-    glm::dvec3 ref = (std::abs(glm::dot(up, glm::dvec3(0, 0, 1))) < 0.99)
-                   ? glm::dvec3(0, 0, 1) : glm::dvec3(1, 0, 0);
-    
-    glm::dvec3 east = glm::normalize(glm::cross(ref, up));  // Local X: tangential
-    glm::dvec3 north = glm::cross(up, east);                 // Local Z: completes frame
-    
-    // Transform: world_dir = east * localDir.x + up * localDir.y + north * localDir.z
-    return east * localDir.x + up * localDir.y + north * localDir.z;
+    // Local frame at the rocket's position relative to Earth
+    return localToWorld(position - earthPosition_, localDir);
 }
 
 bool Rocket::needsPredictionUpdate() const {
@@ -411,6 +717,21 @@ bool Rocket::needsPredictionUpdate() const {
         || dThrust > thrustEps || dFuel > fuelEps;
 }
 
+std::shared_ptr<PredictionSnapshot> Rocket::recyclePrediction() {
+    // Only the pool holding one means every snapshot has let go of it; the
+    // fence orders the last reader's release before it is rewritten
+    for (auto& prediction : predictionPool_) {
+        if (prediction.use_count() == 1) {
+            std::atomic_thread_fence(std::memory_order_acquire);
+            prediction->points.clear();
+            prediction->uncertainty.clear();
+            return prediction;
+        }
+    }
+    predictionPool_.push_back(std::make_shared<PredictionSnapshot>());
+    return predictionPool_.back();
+}
+
 void Rocket::predictTrajectory(float duration, float step, const BODY_MAP& bodies, const Octree* octree) {
     LOG_DEBUG(logger_, "Rocket", "predictTrajectory");
 
@@ -427,31 +748,53 @@ void Rocket::predictTrajectory(float duration, float step, const BODY_MAP& bodie
     lastPredFuelMass_ = fuel_mass;
     predictionDirty_  = false;
 
-    // Reset prediction trajectory before recalculating
-    prediction_->reset();
+    // Published as a whole at the end; the render side swaps it in
+    std::shared_ptr<PredictionSnapshot> published = recyclePrediction();
     
+    const double epoch = static_cast<double>(time);   // Mission time at predTime 0
     Body state = *this;
     double predMass = mass;
     double predFuel = fuel_mass;
+    double predBurnTime = stageBurnTime_;
+    size_t predStage = activeStage_;
     float predTime = 0.0f;
     
     // Adaptive step control parameters
     const int maxPoints = 500;  // Limit total points for performance
+    published->points.reserve(maxPoints + 1);   // And the impact point
     int pointCount = 0;
     
     // Skip factor: only add every Nth point to trajectory for rendering
     // This allows fine physics simulation while keeping render points low
     const float renderInterval = std::max(step, duration / maxPoints);
+    published->renderInterval = renderInterval;
     float timeSinceLastRender = 0.0f;
+
+    EnckePropagator encke;
+    bool enckeActive = false;
+
+    // Linearized uncertainty: the state transition matrix from the start of the
+    // prediction, and an error ellipsoid at every ellipsoidEvery-th render point
+    const bool covariance = config_.simulation_covariance && config_.simulation_covariance_ellipsoids > 0;
+    Matrix6 stm = identityMatrix6();
+    const Matrix6 initialCovariance = diagonalCovariance(config_.simulation_covariance_position_sigma,
+                                                         config_.simulation_covariance_velocity_sigma);
+    const int expectedPoints = std::min(maxPoints, static_cast<int>(std::ceil(duration / renderInterval)));
+    const int ellipsoidEvery = std::max(1, expectedPoints / static_cast<int>(config_.simulation_covariance_ellipsoids));
+    predictionUncertainty_.clear();
+    predictionSamples_.clear();
+    ++predictionRevision_;
     
     // Calculate prediction points
     while (predTime < duration && pointCount < maxPoints) {
         // Only add point at render intervals
         if (timeSinceLastRender >= renderInterval || predTime == 0.0f) {
-            glm::vec3 scaledPos = offsetPosition(state.position);
-            // Pass renderInterval as deltaTime to ensure point is added
-            // (must be >= sampleInterval in Trajectory config)
-            prediction_->update(scaledPos, renderInterval);
+            published->points.push_back(offsetPosition(state.position));
+            if (covariance && pointCount % ellipsoidEvery == 0
+                && predictionUncertainty_.size() < config_.simulation_covariance_ellipsoids) {
+                predictionUncertainty_.push_back(ErrorEllipsoid::fromCovariance(
+                    state.position, propagateCovariance(stm, initialCovariance)));
+            }
             pointCount++;
             timeSinceLastRender = 0.0f;
         }
@@ -479,54 +822,260 @@ void Rocket::predictTrajectory(float duration, float step, const BODY_MAP& bodie
         }
         
         // Use actual bodies for gravity calculation in prediction
-        state = updateStateRK4(state, adaptiveStep, predMass, predFuel, bodies, octree);
+        EventState start{predTime, state.position, state.velocity, predMass, predFuel, predBurnTime};
+        glm::dvec3 center = centralPosition_ + centralVelocity_ * static_cast<double>(predTime);
+        PhaseState relative{state.position - center, state.velocity - centralVelocity_};
+        const bool burning = burnsDuring(state, adaptiveStep, predFuel, thrust, epoch + predTime);
+        if (!burning && !usesKs(relative, adaptiveStep, predFuel) && usesEncke(predFuel)) {
+            // Coasting: keep one reference conic across steps (rectified as needed)
+            // and take longer steps, since only the small deviation is integrated
+            adaptiveStep *= config_.simulation_encke_step_scale;
+            if (!enckeActive) {
+                encke = EnckePropagator(centralMu_, config_.simulation_encke_rectify_ratio);
+                encke.rectify(relative);
+                enckeActive = true;
+            }
+            if (covariance) {
+                // The matrix keeps to the Cowell step the Encke step was scaled up from
+                const int substeps = std::max(1, static_cast<int>(std::ceil(config_.simulation_encke_step_scale)));
+                stm = multiply(stepTransition(PhaseState{state.position, state.velocity}, adaptiveStep, substeps,
+                                              predMass, bodies, octree), stm);
+            }
+            enckeStep(encke, predMass, adaptiveStep, bodies, octree);
+            PhaseState relative = encke.state();
+            state.position = center + centralVelocity_ * static_cast<double>(adaptiveStep) + relative.position;
+            state.velocity = centralVelocity_ + relative.velocity;
+        } else {
+            // Burning (Cowell) or regularized (KS) steps
+            enckeActive = false;
+            if (burning) {
+                // Mass is integrated through the burn, which holds up at longer steps
+                adaptiveStep *= config_.simulation_burn_step_scale;
+            }
+            state = updateStateRK4(state, adaptiveStep, predMass, predFuel, predBurnTime, predStage, bodies, octree, predTime,
+                                   epoch, covariance ? &stm : nullptr);
+            if (burning && predFuel <= 0.0) {
+                // Burnout: return the overdrawn propellant and stage at the step boundary
+                predMass -= predFuel;
+                predFuel = 0.0;
+                separateStage(predStage, predMass, predFuel, predBurnTime);
+            }
+        }
+        EventState end{predTime + adaptiveStep, state.position, state.velocity, predMass, predFuel, predBurnTime};
+        if (predictionSamples_.empty()) {
+            predictionSamples_.push_back(start);
+        }
+
+        // End the prediction exactly at the impact point instead of one step underground
+        if (auto impact = predictionEvents_.findFirst(DenseStep(start, end))) {
+            published->points.push_back(offsetPosition(impact->state.position));
+            predictionSamples_.push_back(impact->state);
+            break;
+        }
+        predictionSamples_.push_back(end);
         predTime += adaptiveStep;
         timeSinceLastRender += adaptiveStep;
     }
+
+    published->revision = predictionRevision_;
+    published->uncertainty = predictionUncertainty_;
+    publishedPrediction_ = std::move(published);
 }
 
-Body Rocket::updateStateRK4(const Body& state, double deltaTime, double& currentMass, double& currentFuel, const BODY_MAP& bodies, const Octree* octree) const {
-    double fuel_consumption_rate = thrust / exhaust_velocity;
-    double delta_fuel = fuel_consumption_rate * deltaTime;
-    
-    // RK4 integration using correct intermediate positions and velocities
-    Body k1, k2, k3, k4;
-    
-    // k1: acceleration at current state
-    k1.velocity = computeAccelerationAt(state.position, state.velocity, currentMass, bodies, octree);
-    k1.position = state.velocity;
-    
-    // k2: acceleration at midpoint using k1
-    Body mid1;
-    mid1.position = state.position + k1.position * (deltaTime / 2.0);
-    mid1.velocity = state.velocity + k1.velocity * (deltaTime / 2.0);
-    k2.velocity = computeAccelerationAt(mid1.position, mid1.velocity, currentMass, bodies, octree);
-    k2.position = mid1.velocity;
-    
-    // k3: acceleration at midpoint using k2
-    Body mid2;
-    mid2.position = state.position + k2.position * (deltaTime / 2.0);
-    mid2.velocity = state.velocity + k2.velocity * (deltaTime / 2.0);
-    k3.velocity = computeAccelerationAt(mid2.position, mid2.velocity, currentMass, bodies, octree);
-    k3.position = mid2.velocity;
-    
-    // k4: acceleration at endpoint using k3
-    Body end;
-    end.position = state.position + k3.position * deltaTime;
-    end.velocity = state.velocity + k3.velocity * deltaTime;
-    k4.velocity = computeAccelerationAt(end.position, end.velocity, currentMass, bodies, octree);
-    k4.position = end.velocity;
-    
-    // Combine the four estimates
+bool Rocket::burnsDuring(const Body& state, double h, double currentFuel, double commanded, double missionTime) const {
+    if (!(currentFuel > 0.0)) {
+        return false;
+    }
+    if (commanded > 0.0) {
+        return true;
+    }
+    if (!flightPlan.hasGuidance()) {
+        return false;
+    }
+    const double altitude = altitudeAt(state.position);
+    const double speed = glm::length(state.velocity);
+    for (double t : {missionTime, missionTime + h}) {
+        auto action = flightPlan.getAction(altitude, speed, t);
+        if (action && action->thrust > 0.0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool Rocket::usesKs(const PhaseState& relative, double h, double currentFuel) const {
+    if (!config_.simulation_ks || centralMu_ <= 0.0 || !isCoasting(currentFuel)) {
+        return false;
+    }
+    double r = glm::length(relative.position);
+    if (r <= 0.0) {
+        return false;
+    }
+
+    // Close approach: the step covers a sizeable fraction of the distance to the body
+    if (glm::length(relative.velocity) * h > config_.simulation_ks_step_fraction * r) {
+        return true;
+    }
+
+    // Highly eccentric or hyperbolic orbit around the central body
+    const glm::dvec3& v = relative.velocity;
+    glm::dvec3 e = ((glm::dot(v, v) - centralMu_ / r) * relative.position
+                    - glm::dot(relative.position, v) * v) / centralMu_;
+    return glm::length(e) >= config_.simulation_ks_eccentricity;
+}
+
+void Rocket::enckeStep(EnckePropagator& encke, double currentMass, double h, const BODY_MAP& bodies, const Octree* octree) const {
+    withPerturbation(encke.state(), h, currentMass, bodies, octree, [&](const auto& perturbation) {
+        encke.step(perturbation, currentMass, h);
+        return 0;
+    });
+}
+
+Body Rocket::updateStateRK4(const Body& state, double deltaTime, double& currentMass, double& currentFuel, double& burnTime, size_t stage, const BODY_MAP& bodies, const Octree* octree, double startTime, double epoch, Matrix6* stm) const {
+    // Coasting steps run relative to the central body, which moves uniformly over the frame
+    glm::dvec3 center = centralPosition_ + centralVelocity_ * startTime;
+    PhaseState relative{state.position - center, state.velocity - centralVelocity_};
+    const bool burning = burnsDuring(state, deltaTime, currentFuel, thrust, epoch + startTime);
+    const bool regularized = !burning && usesKs(relative, deltaTime, currentFuel);
+    const bool encke = !burning && !regularized && usesEncke(currentFuel);
+    if (stm && (burning || encke)) {
+        // The Cowell coast below carries the matrix in its own step and KS in
+        // each of its steps. Prediction burns are burn_step_scale Cowell steps
+        // long, which the burn integrator holds up over but the matrix does not.
+        const int substeps = burning ? std::max(1, static_cast<int>(std::ceil(config_.simulation_burn_step_scale))) : 1;
+        *stm = multiply(stepTransition(PhaseState{state.position, state.velocity}, deltaTime, substeps,
+                                       currentMass, bodies, octree), *stm);
+    }
+    if (regularized || encke) {
+        PhaseState next;
+        if (regularized) {
+            KsPropagator ks(centralMu_, config_.simulation_ks_anomaly_step);
+            next = withPerturbation(relative, deltaTime, currentMass, bodies, octree, [&](const auto& perturbation) {
+                if (!stm) {
+                    return ks.propagate(relative, deltaTime, perturbation, currentMass);
+                }
+                // The matrix follows the KS steps, short near periapsis, from the state each starts at
+                double elapsed = 0.0;
+                return ks.propagate(relative, deltaTime, perturbation, currentMass, [&](const PhaseState& from, double h) {
+                    PhaseState at{center + centralVelocity_ * elapsed + from.position, centralVelocity_ + from.velocity};
+                    *stm = multiply(stepTransition(at, h, 1, currentMass, bodies, octree), *stm);
+                    elapsed += h;
+                });
+            });
+        } else {
+            // A fresh conic per step
+            EnckePropagator encke(centralMu_, config_.simulation_encke_rectify_ratio);
+            encke.rectify(relative);
+            enckeStep(encke, currentMass, deltaTime, bodies, octree);
+            next = encke.state();
+        }
+
+        // No fuel is burned while coasting
+        Body newState;
+        newState.position = center + centralVelocity_ * deltaTime + next.position;
+        newState.velocity = centralVelocity_ + next.velocity;
+        return newState;
+    }
+
     Body newState;
-    newState.position = state.position + (k1.position + 2.0 * k2.position + 2.0 * k3.position + k4.position) * (deltaTime / 6.0);
-    newState.velocity = state.velocity + (k1.velocity + 2.0 * k2.velocity + 2.0 * k3.velocity + k4.velocity) * (deltaTime / 6.0);
-    
-    // Update fuel consumption
-    if (currentFuel > 0.0) {
-        currentFuel = std::max(0.0, currentFuel - delta_fuel);
-        currentMass = currentMass - delta_fuel;
+    if (burning) {
+        // Burn: mass is a state variable, so the thrust acceleration grows
+        // within the step as propellant drains and follows the thrust curve
+        StageEngine engine = stageEngine(stage, burnTime, state.position, state.velocity, deltaTime, bodies);
+        auto burn = [&](const auto& propulsion) {
+            return withForceModel(state.position, state.velocity, deltaTime, currentMass, bodies, octree, [&](const auto& model) {
+                return rk4BurnStep(model, propulsion, BurnState{state.position, state.velocity, currentMass}, deltaTime);
+            }, false);
+        };
+        BurnState next = flightPlan.hasGuidance()
+            ? burn(GuidedEngine{engine, &flightPlan, earthPosition_, config_.physics_earth_radius, epoch + startTime})
+            : burn(engine);
+        newState.position = next.position;
+        newState.velocity = next.velocity;
+        currentFuel -= currentMass - next.mass;
+        currentMass = next.mass;
+        burnTime += deltaTime;
+        return newState;
     }
-    
+
+    // RK4 integration using correct intermediate positions and velocities
+    PhaseState next = withForceModel(state.position, state.velocity, deltaTime, currentMass, bodies, octree, [&](const auto& model) {
+        if (stm) {
+            Matrix6 phi = identityMatrix6();
+            PhaseState out = rk4StmStep(model, PhaseState{state.position, state.velocity}, currentMass, deltaTime, phi);
+            *stm = multiply(phi, *stm);
+            return out;
+        }
+        return rk4Step(model, PhaseState{state.position, state.velocity}, currentMass, deltaTime);
+    }, false);
+    newState.position = next.position;
+    newState.velocity = next.velocity;
     return newState;
-}
\ No newline at end of file
+}
+
+Matrix6 Rocket::stepTransition(const PhaseState& state, double h, int substeps, double currentMass, const BODY_MAP& bodies, const Octree* octree) const {
+    // Cowell steps of the variational equations over the same interval, also
+    // where the state itself is advanced by Encke, KS or the burn integrator
+    const double dt = h / substeps;
+    Matrix6 phi = identityMatrix6();
+    PhaseState at = state;
+    for (int i = 0; i < substeps; ++i) {
+        at = withForceModel(at.position, at.velocity, dt, currentMass, bodies, octree, [&](const auto& model) {
+            return rk4StmStep(model, at, currentMass, dt, phi);
+        }, false);
+    }
+    return phi;
+}
+Rocket::GuidanceGradient Rocket::guidanceSensitivity(float deltaTime, int frames, const BODY_MAP& bodies,
+                                                     const Octree* octree) const {
+    using Vec = DualVec3<2>;
+    using Scalar = Vec::value_type;
+    const GuidanceShift<Scalar> shift{Scalar::variable(0.0, kGuidancePitch), Scalar::variable(0.0, kGuidanceThrust)};
+    const double h = static_cast<double>(deltaTime);
+
+    GuidanceGradient s{Vec(position), Vec(velocity), Scalar(mass)};
+    Scalar commanded = thrust;          // The flight plan's last action, as completeStep() holds it
+    Vec direction(thrustDirection);
+    double fuel = fuel_mass;
+    double burnTime = stageBurnTime_;
+    float clock = time;                 // Mission time, kept in float like update()
+    for (int frame = 0; frame < frames; ++frame) {
+        clock += deltaTime;
+        const double epoch = static_cast<double>(clock) - h;
+        Body start;
+        start.position = s.position.value();
+        start.velocity = s.velocity.value();
+
+        if (burnsDuring(start, h, fuel, commanded.value, epoch)) {
+            // The burn of updateStateRK4(), its direction resolved from the dual state
+            StageEngine nominal = stageEngine(activeStage_, burnTime, start.position, start.velocity, h, bodies);
+            BasicStageEngine<Vec> engine{nominal.stage, localToWorld(s.position - earthPosition_, direction), commanded,
+                                         burnTime, nominal.atmosphere, nominal.center, nominal.surfaceRadius};
+            auto burn = [&](const auto& propulsion) {
+                return withForceModel(start.position, start.velocity, h, s.mass.value, bodies, octree, [&](const auto& model) {
+                    return rk4BurnStep(model, propulsion, s, Scalar(h));
+                }, false);
+            };
+            const Scalar before = s.mass;
+            s = flightPlan.hasGuidance()
+                ? burn(BasicGuidedEngine<Vec>{engine, &flightPlan, earthPosition_, config_.physics_earth_radius, epoch, shift})
+                : burn(engine);
+            fuel -= (before - s.mass).value;
+            burnTime += h;
+        } else {
+            BasicPhaseState<Vec> next = withForceModel(start.position, start.velocity, h, s.mass.value, bodies, octree, [&](const auto& model) {
+                return rk4Step(model, BasicPhaseState<Vec>{s.position, s.velocity}, s.mass, Scalar(h));
+            }, false);
+            s.position = next.position;
+            s.velocity = next.velocity;
+        }
+
+        auto action = flightPlan.getAction<Vec>(length(s.position - earthPosition_) - config_.physics_earth_radius,
+                                                length(s.velocity), static_cast<double>(clock), shift);
+        if (action) {
+            commanded = action->thrust;
+            direction = action->direction;
+        }
+    }
+    return s;
+}
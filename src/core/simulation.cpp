@@ -1,4 +1,5 @@
 #include "core/simulation.h"
+#include "rendering/trajectory_factory.h"
 #include <GLFW/glfw3.h>
 #include <iostream>
 #include <vector>
@@ -8,76 +9,31 @@
  * which can be replaced with a custom logger if needed.
  */
 Simulation::Simulation(Camera &camera) 
-    : config(Config()), logger_(std::make_shared<SpdlogLogger>()), rocket(config, logger_, FlightPlan(config.flight_plan_path)), 
-        camera(camera), moonPos(0.0, 384400000.0, 0.0) {
+    : Simulation(Config(), std::make_shared<SpdlogLogger>(), camera) {
 }
 
-Simulation::Simulation(Config& config, std::shared_ptr<ILogger> logger, Camera& camera) : 
-        config(config), rocket(config, logger, FlightPlan(config.flight_plan_path)), 
-        logger_(logger), camera(camera), timeScale(1.0f), moonPos(0.0, 384400000.0, 0.0) {
-    if (!logger_) {
-        throw std::runtime_error("Logger is null");
-    }
-    logger_->set_level((LogLevel)config.logger_level);
+Simulation::Simulation(const Config& config, std::shared_ptr<ILogger> logger, Camera& camera) : 
+        core_(config, logger), config(core_.getConfig()), camera(camera),
+        rocketRenderer_(core_.getConfig(), logger), logger_(logger) {
 }
 
 Simulation::~Simulation() = default;
 
 void Simulation::init() {
-    LOG_DEBUG(logger_, "Simulation", "Initializing simulation...");
-    
-    // Sun at origin (heliocentric coordinate system)
-    bodies["sun"] = std::make_unique<Body>(config, logger_, "sun", config.physics_sun_mass, glm::dvec3(0.0), glm::dvec3(0.0));
-    
-    // Initialize all planets from config data
-    // Earth and Moon have special handling; other planets use the generic loop
-    const auto* earthCfg = config.getPlanet("earth");
-    glm::dvec3 earthPos = glm::dvec3(earthCfg->orbit_radius, 0.0, 0.0);
-    glm::dvec3 earthVel = glm::dvec3(0.0, 0.0, earthCfg->orbital_velocity);
-    
+    core_.init();
+    const BODY_MAP& bodies = core_.getBodies();
+
+    // Orbit trails: planets, then Earth and the Moon
     for (const auto& planet : config.planets) {
         if (planet.name == "earth" || planet.name == "moon") continue;
-        
-        glm::dvec3 pos = glm::dvec3(planet.orbit_radius, 0.0, 0.0);
-        glm::dvec3 vel = glm::dvec3(0.0, 0.0, planet.orbital_velocity);
-        bodies[planet.name] = std::make_unique<Body>(config, logger_, planet.name, planet.mass, pos, vel);
-        bodies[planet.name]->setTrajectory(TrajectoryFactory::createPlanetOrbit(
+        renderers_[planet.name].setTrajectory(TrajectoryFactory::createPlanetOrbit(
             config, logger_, planet.orbit_radius, planet.orbit_color, planet.orbital_inclination
         ));
     }
-    
-    // Earth
-    bodies["earth"] = std::make_unique<Body>(config, logger_, "earth", config.physics_earth_mass, earthPos, earthVel);
-    bodies["earth"]->setTrajectory(TrajectoryFactory::createEarthTrajectory(config, logger_));
-    
-    // Moon orbiting Earth with ~5.145° orbital inclination relative to the ecliptic
-    const float lunarInclination = glm::radians(5.145f);
-    
-    // Moon position in the inclined orbital plane
-    double moonDistLocal_z = config.physics_moon_distance;
-    double moonPosY = moonDistLocal_z * std::sin(lunarInclination);
-    double moonPosZ = moonDistLocal_z * std::cos(lunarInclination);
-    glm::dvec3 moonPos = earthPos + glm::dvec3(0.0, moonPosY, moonPosZ);
-    
-    // Moon velocity: orbital velocity (~1022 m/s) perpendicular to position in the inclined plane
-    const double moonOrbitalSpeed = 1022.0;
-    glm::dvec3 moonVelRelative = glm::dvec3(-moonOrbitalSpeed, 0.0, 0.0);
-    glm::dvec3 moonVel = earthVel + moonVelRelative;
-    
-    bodies["moon"] = std::make_unique<Body>(config, logger_, "moon", config.physics_moon_mass, moonPos, moonVel);
-    bodies["moon"]->setTrajectory(TrajectoryFactory::createMoonTrajectory(config, logger_));
+    renderers_["earth"].setTrajectory(TrajectoryFactory::createEarthTrajectory(config, logger_));
+    renderers_["moon"].setTrajectory(TrajectoryFactory::createMoonTrajectory(config, logger_));
 
-    if (!bodies["sun"] || !bodies["earth"] || !bodies["moon"]) {
-        LOG_ERROR(logger_, "Simulation", "Failed to initialize celestial bodies!");
-        return;
-    }
-    
-    // Update rocket initial position relative to Earth
-    rocket.setPosition(earthPos + glm::dvec3(0.0, config.physics_earth_radius, 0.0));
-    rocket.setVelocity(earthVel); // Rocket starts with Earth's orbital velocity
-    rocket.setEarthPosition(earthPos);  // Set Earth position for altitude calculations
-
-    rocket.init();
+    rocketRenderer_.init();
 
     // Generate Earth's sphere
     
@@ -115,7 +71,7 @@ void Simulation::init() {
     }
     
     try {
-        bodies["earth"]->renderer.setSphereRenderObject(std::make_unique<RenderObject>(earthVertices, earthIndices));
+        renderers_["earth"].setSphereRenderObject(std::make_unique<RenderObject>(earthVertices, earthIndices));
         LOG_INFO(logger_, "Simulation", "Earth sphere created: vertices=" + 
                  std::to_string(earthVertices.size()) + ", indices=" + std::to_string(earthIndices.size()));
     } catch (const std::exception& e) {
@@ -136,7 +92,7 @@ void Simulation::init() {
     }
     
     try {
-        bodies["moon"]->renderer.setSphereRenderObject(std::make_unique<RenderObject>(moonVertices, earthIndices));
+        renderers_["moon"].setSphereRenderObject(std::make_unique<RenderObject>(moonVertices, earthIndices));
         LOG_INFO(logger_, "Simulation", "Moon sphere created: vertices=" + 
                  std::to_string(moonVertices.size()) + ", indices=" + std::to_string(earthIndices.size()));
     } catch (const std::exception& e) {
@@ -154,7 +110,7 @@ void Simulation::init() {
     }
     
     try {
-        bodies["sun"]->renderer.setSphereRenderObject(std::make_unique<RenderObject>(sunVertices, earthIndices));
+        renderers_["sun"].setSphereRenderObject(std::make_unique<RenderObject>(sunVertices, earthIndices));
         LOG_INFO(logger_, "Simulation", "Sun sphere created: vertices=" + 
                  std::to_string(sunVertices.size()) + ", indices=" + std::to_string(earthIndices.size()));
     } catch (const std::exception& e) {
@@ -172,7 +128,7 @@ void Simulation::init() {
             vertices.push_back(earthVertices[i + 2] * scale);
         }
         try {
-            bodies[name]->renderer.setSphereRenderObject(std::make_unique<RenderObject>(vertices, earthIndices));
+            renderers_[name].setSphereRenderObject(std::make_unique<RenderObject>(vertices, earthIndices));
             LOG_INFO(logger_, "Simulation", name + " sphere created");
         } catch (const std::exception& e) {
             LOG_ERROR(logger_, "Simulation", "Error creating " + name + " sphere: " + std::string(e.what()));
@@ -188,7 +144,8 @@ void Simulation::init() {
     // Verify all bodies have render objects
     LOG_INFO(logger_, "Simulation", "=== Render Object Status ===");
     for (const auto& [name, body] : bodies) {
-        bool hasRender = body->renderer.hasSphere();
+        auto it = renderers_.find(name);
+        bool hasRender = it != renderers_.end() && it->second.hasSphere();
         if (hasRender) {
             LOG_INFO(logger_, "Simulation", name + ": sphere OK");
         } else {
@@ -206,57 +163,130 @@ void Simulation::init() {
     LOG_INFO(logger_, "Simulation", "Map objects initialized");
 }
 
-void Simulation::update(float deltaTime) {
-    static float elapsed_time = 0.0f;
-    elapsed_time += deltaTime * timeScale;
-    double dt = static_cast<double>(deltaTime * timeScale);
-    
-    // Build Barnes-Hut octree once per frame for O(n log n) gravity
-    buildOctree();
-    
-    // Step 1: Update all celestial bodies (Velocity Verlet)
-    std::vector<std::pair<std::string, glm::dvec3>> current_accs;
-    for (const auto& [name, body] : bodies) {
-        glm::dvec3 acc = computeBodyAcceleration(*body, bodies);
-        current_accs.emplace_back(name, acc);
+void Simulation::syncRender(const SimulationSnapshot& state) {
+    // The first snapshot after a restore brings the camera and trails back with it
+    if (state.restores != restoresSeen_) {
+        restoresSeen_ = state.restores;
+        restoreView(state);
+    }
+    // A replay seek jumps the clock: the trails start over where it landed
+    if (state.seeks != seeksSeen_) {
+        seeksSeen_ = state.seeks;
+        restoreTrails(nullptr, state);
+    }
+
+    // Orbit trails sample the published positions on the simulation clock
+    float elapsed = static_cast<float>(state.time - renderedTime_);
+    renderedTime_ = state.time;
+    if (elapsed > 0.0f) {
+        const double scale = static_cast<double>(config.simulation_rendering_scale);
+        for (const BodySnapshot& body : state.bodies) {
+            auto it = renderers_.find(body.name);
+            if (it != renderers_.end()) {
+                it->second.updateTrajectory(body.position, scale, elapsed);
+            }
+        }
     }
-    
-    // Update positions
-    for (const auto& [name, body] : bodies) {
-        body->position += body->velocity * dt + 0.5 * current_accs[std::distance(bodies.begin(), bodies.find(name))].second * dt * dt;
+    rocketRenderer_.syncRender(state.rocket);
+}
+
+void Simulation::saveCheckpoint(const std::string& path) {
+    core_.postCheckpoint(path, captureView());
+    LOG_INFO(logger_, "Simulation", "Saving checkpoint to " + path);
+}
+
+bool Simulation::restoreCheckpoint(const std::string& path) {
+    std::shared_ptr<const Checkpoint> state;
+    try {
+        state = std::make_shared<const Checkpoint>(readCheckpoint(path));
+    } catch (const CheckpointError& e) {
+        LOG_ERROR(logger_, "Simulation", std::string("Checkpoint not restored: ") + e.what());
+        return false;
     }
-    
-    // Rebuild octree after position update for accurate new accelerations
-    buildOctree();
-    
-    // Calculate new accelerations and update velocities
-    for (auto& [name, body] : bodies) {
-        glm::dvec3 new_acc = computeBodyAcceleration(*body, bodies);
-        
-        body->velocity += 0.5 * (current_accs[std::distance(bodies.begin(), bodies.find(name))].second + new_acc) * dt;
-        
-        // Check for NaN
-        if (std::isnan(body->position.x) || std::isnan(body->velocity.x)) {
-            LOG_ERROR(logger_, "Simulation", "NaN detected in " + name + ": Pos=" + 
-                      glm::to_string(glm::vec3(body->position)) + ", Vel=" + glm::to_string(glm::vec3(body->velocity)));
+
+    // Whether it fits is checked on the physics thread; the view waits for the restore to show
+    restoring_ = state;
+    core_.postRestore(std::move(state));
+    return true;
+}
+
+CheckpointView Simulation::captureView() const {
+    CheckpointView view;
+    CameraCheckpoint& saved = view.camera;
+    saved.mode = static_cast<uint32_t>(camera.mode);
+    saved.position = camera.position;
+    saved.target = camera.target;
+    saved.fixedTarget = camera.fixedTarget;
+    saved.pitch = camera.pitch;
+    saved.yaw = camera.yaw;
+    saved.distance = camera.distance;
+    saved.focusBodyName = camera.focusBodyName;
+
+    // Precomputed orbits are rebuilt from the configuration; only sampled trails are saved
+    for (const auto& [name, renderer] : renderers_) {
+        const Trajectory* trajectory = renderer.getTrajectory();
+        if (trajectory && !trajectory->isStatic()) {
+            view.trails.push_back({name, trajectory->getSampleTimer(), trajectory->getHistory()});
         }
-        
-        // Update trajectory for bodies that have one (scale position for rendering)
-        body->update(dt);
     }
-    
-    rocket.update(dt, bodies, &octree_);
-    
-    double moon_radius = glm::length(bodies["moon"]->position);
-    LOG_ORBIT(logger_, "Moon", elapsed_time, glm::vec3(bodies["moon"]->position), static_cast<float>(moon_radius), glm::vec3(bodies["moon"]->velocity));
-    LOG_DEBUG(logger_, "Simulation", "Rocket: Pos=" + glm::to_string(glm::vec3(rocket.getPosition())));
+    TrailCheckpoint rocketTrail;
+    rocketRenderer_.saveTrail(rocketTrail);
+    view.trails.push_back(std::move(rocketTrail));
+    return view;
+}
+
+void Simulation::restoreView(const SimulationSnapshot& state) {
+    const CheckpointView* view = restoring_ && restoring_->view ? &*restoring_->view : nullptr;
+    if (view) {
+        const CameraCheckpoint& saved = view->camera;
+        camera.position = saved.position;
+        camera.target = saved.target;
+        camera.fixedTarget = saved.fixedTarget;
+        camera.pitch = saved.pitch;
+        camera.yaw = saved.yaw;
+        camera.distance = saved.distance;
+        camera.focusBodyName = saved.focusBodyName;
+        if (saved.mode <= static_cast<uint32_t>(Camera::Mode::FocusBody)) {
+            camera.setMode(static_cast<Camera::Mode>(saved.mode));
+        }
+    }
+    restoreTrails(view, state);
+    restoring_.reset();
+}
+
+void Simulation::restoreTrails(const CheckpointView* view, const SimulationSnapshot& state) {
+    auto find = [view](const std::string& name) -> const TrailCheckpoint* {
+        if (view) {
+            for (const TrailCheckpoint& trail : view->trails) {
+                if (trail.name == name) {
+                    return &trail;
+                }
+            }
+        }
+        return nullptr;
+    };
+
+    // A trail the checkpoint does not have starts over rather than jump to the restored state
+    for (auto& [name, renderer] : renderers_) {
+        Trajectory* trajectory = renderer.getTrajectory();
+        if (!trajectory || trajectory->isStatic()) {
+            continue;
+        }
+        if (const TrailCheckpoint* trail = find(name)) {
+            trajectory->restoreHistory(trail->points, trail->sampleTimer);
+        } else {
+            trajectory->restoreHistory({}, 0.0f);
+        }
+    }
+    rocketRenderer_.restoreTrail(find("rocket"), state.rocket.time);
+    renderedTime_ = state.time;
 }
 
 void Simulation::updateCameraPosition() const {
     // TODO: Follow the rocket
 }
 
-void Simulation::render(const Shader& shader) const {
+void Simulation::render(const Shader& shader, const SimulationSnapshot& state) const {
     int width, height;
     glfwGetWindowSize(glfwGetCurrentContext(), &width, &height);
     float sceneHeight = height * 0.8f;
@@ -276,30 +306,37 @@ void Simulation::render(const Shader& shader) const {
     // This keeps float values small and precise.
     // ---------------------------------------------------------------
 
+    // Positions come from the snapshot only; the physics thread never
+    // touches the renderers
+    auto positionOf = [&](const std::string& name) -> glm::dvec3 {
+        const BodySnapshot* body = state.find(name);
+        return body ? body->position : glm::dvec3(0.0);
+    };
+
     // Determine renderOrigin based on camera mode (in physics coords, meters)
     if (camera.mode == Camera::Mode::Locked || camera.mode == Camera::Mode::Free) {
-        renderOrigin_ = rocket.getPosition();
+        renderOrigin_ = state.rocket.position;
     } else if (camera.mode == Camera::Mode::FixedEarth) {
-        if (bodies.find("earth") != bodies.end())
-            renderOrigin_ = bodies.at("earth")->position;
+        if (renderers_.find("earth") != renderers_.end())
+            renderOrigin_ = positionOf("earth");
         else
             renderOrigin_ = glm::dvec3(0.0);
     } else if (camera.mode == Camera::Mode::FixedMoon) {
-        if (bodies.find("moon") != bodies.end())
-            renderOrigin_ = bodies.at("moon")->position;
+        if (renderers_.find("moon") != renderers_.end())
+            renderOrigin_ = positionOf("moon");
         else
             renderOrigin_ = glm::dvec3(0.0);
     } else if (camera.mode == Camera::Mode::Overview) {
-        if (bodies.find("earth") != bodies.end() && bodies.find("moon") != bodies.end())
-            renderOrigin_ = (bodies.at("earth")->position + bodies.at("moon")->position) * 0.5;
+        if (renderers_.find("earth") != renderers_.end() && renderers_.find("moon") != renderers_.end())
+            renderOrigin_ = (positionOf("earth") + positionOf("moon")) * 0.5;
         else
             renderOrigin_ = glm::dvec3(0.0);
     } else if (camera.mode == Camera::Mode::SolarSystem || camera.mode == Camera::Mode::FullSolarSystem) {
         renderOrigin_ = glm::dvec3(0.0);  // Sun is at origin — no rebasing needed
     } else if (camera.mode == Camera::Mode::FocusBody) {
         const std::string& bodyName = camera.focusBodyName;
-        if (!bodyName.empty() && bodies.find(bodyName) != bodies.end())
-            renderOrigin_ = bodies.at(bodyName)->position;
+        if (!bodyName.empty() && renderers_.find(bodyName) != renderers_.end())
+            renderOrigin_ = positionOf(bodyName);
         else
             renderOrigin_ = glm::dvec3(0.0);
     } else {
@@ -314,26 +351,26 @@ void Simulation::render(const Shader& shader) const {
     glm::vec3 target = glm::vec3(0.0f);
 
     // Update Earth position for camera (used in Locked mode to calculate radial direction)
-    if (bodies.find("earth") != bodies.end()) {
-        camera.setEarthPosition(toRender(bodies.at("earth")->position));
+    if (renderers_.find("earth") != renderers_.end()) {
+        camera.setEarthPosition(toRender(positionOf("earth")));
     }
     
     // Update camera target based on mode (all positions are origin-relative)
     if (camera.mode == Camera::Mode::Locked || camera.mode == Camera::Mode::Free) {
-        target = toRender(rocket.getPosition());
+        target = toRender(state.rocket.position);
     } else if (camera.mode == Camera::Mode::FixedEarth) {
-        if (bodies.find("earth") != bodies.end()) {
-            target = toRender(bodies.at("earth")->position);
+        if (renderers_.find("earth") != renderers_.end()) {
+            target = toRender(positionOf("earth"));
             camera.setFixedTarget(target);
         }
     } else if (camera.mode == Camera::Mode::FixedMoon) {
-        if (bodies.find("moon") != bodies.end()) {
-            target = toRender(bodies.at("moon")->position);
+        if (renderers_.find("moon") != renderers_.end()) {
+            target = toRender(positionOf("moon"));
             camera.setFixedTarget(target);
         }
     } else if (camera.mode == Camera::Mode::Overview) {
-        if (bodies.find("earth") != bodies.end() && bodies.find("moon") != bodies.end()) {
-            glm::dvec3 midpoint = (bodies.at("earth")->position + bodies.at("moon")->position) * 0.5;
+        if (renderers_.find("earth") != renderers_.end() && renderers_.find("moon") != renderers_.end()) {
+            glm::dvec3 midpoint = (positionOf("earth") + positionOf("moon")) * 0.5;
             target = toRender(midpoint);
             camera.setFixedTarget(target);
         }
@@ -345,8 +382,8 @@ void Simulation::render(const Shader& shader) const {
         camera.setFixedTarget(target);
     } else if (camera.mode == Camera::Mode::FocusBody) {
         const std::string& bodyName = camera.focusBodyName;
-        if (!bodyName.empty() && bodies.find(bodyName) != bodies.end()) {
-            target = toRender(bodies.at(bodyName)->position);
+        if (!bodyName.empty() && renderers_.find(bodyName) != renderers_.end()) {
+            target = toRender(positionOf(bodyName));
             camera.setFixedTarget(target);
         }
     }
@@ -375,60 +412,62 @@ void Simulation::render(const Shader& shader) const {
     shader.setMat4("projection", projection);
     
     // Render the Sun (orange)
-    if (bodies.find("sun") != bodies.end() && bodies.at("sun")->renderer.hasSphere()) {
-        glm::mat4 sunModel = glm::translate(glm::mat4(1.0f), toRender(bodies.at("sun")->position));
+    if (renderers_.find("sun") != renderers_.end() && renderers_.at("sun").hasSphere()) {
+        glm::mat4 sunModel = glm::translate(glm::mat4(1.0f), toRender(positionOf("sun")));
         sunModel = glm::scale(sunModel, glm::vec3(scalef, scalef, scalef));
         shader.setMat4("model", sunModel);
         shader.setVec4("color", glm::vec4(1.0f, 0.5f, 0.0f, 1.0f)); // Orange
-        bodies.at("sun")->renderer.renderSphere();
+        renderers_.at("sun").renderSphere();
     }
     
     // Render Earth's orbit (only visible in solar system view)
-    if (bodies.find("earth") != bodies.end()) {
-        bodies.at("earth")->render(shader);
+    if (renderers_.find("earth") != renderers_.end()) {
+        renderers_.at("earth").renderTrajectory(shader);
     }
 
     // Render the Earth (blue)
-    if (bodies.find("earth") != bodies.end() && bodies.at("earth")->renderer.hasSphere()) {
-        glm::mat4 earthModel = glm::translate(glm::mat4(1.0f), toRender(bodies.at("earth")->position));
+    if (renderers_.find("earth") != renderers_.end() && renderers_.at("earth").hasSphere()) {
+        glm::mat4 earthModel = glm::translate(glm::mat4(1.0f), toRender(positionOf("earth")));
         earthModel = glm::scale(earthModel, glm::vec3(scalef, scalef, scalef));
         shader.setMat4("model", earthModel);
         shader.setVec4("color", glm::vec4(0.0f, 0.0f, 1.0f, 1.0f)); // Blue
-        bodies.at("earth")->renderer.renderSphere();
+        renderers_.at("earth").renderSphere();
     } else {
         LOG_ERROR(logger_, "Simulation", "Earth is null or has no sphere!");
     }
 
-    rocket.render(shader, renderOrigin_);
+    rocketRenderer_.render(shader, renderOrigin_, state.rocket);
 
     // Render the Moon (gray)
-    if (bodies.find("moon") != bodies.end() && bodies.at("moon")->renderer.hasSphere()) {
-        glm::mat4 moonModel = glm::translate(glm::mat4(1.0f), toRender(bodies.at("moon")->position));
+    if (renderers_.find("moon") != renderers_.end() && renderers_.at("moon").hasSphere()) {
+        glm::mat4 moonModel = glm::translate(glm::mat4(1.0f), toRender(positionOf("moon")));
         moonModel = glm::scale(moonModel, glm::vec3(scalef, scalef, scalef));
         shader.setMat4("model", moonModel);
         shader.setVec4("color", glm::vec4(0.7f, 0.7f, 0.7f, 1.0f)); // Gray
-        bodies.at("moon")->renderer.renderSphere();
+        renderers_.at("moon").renderSphere();
         
-        // Render Moon's orbit centered on Earth's position (origin-relative)
-        glm::vec3 earthCenter = toRender(bodies.at("earth")->position);
-        bodies.at("moon")->render(shader, earthCenter);
+        // Render Moon's orbit centered on its parent's position (origin-relative)
+        const BodySnapshot* moon = state.find("moon");
+        glm::vec3 parentCenter = moon && moon->parent >= 0 ? toRender(state.bodies[moon->parent].position)
+                                                           : glm::vec3(0.0f);
+        renderers_.at("moon").renderTrajectory(shader, parentCenter);
     } else {
         LOG_ERROR(logger_, "Simulation", "Moon is null or has no sphere!");
     }
     
     // Helper lambda to render a planet with its orbit
     auto renderPlanet = [&](const std::string& name, const glm::vec4& color) {
-        if (bodies.find(name) != bodies.end()) {
-            auto& body = bodies.at(name);
+        if (renderers_.find(name) != renderers_.end()) {
+            const BodyRenderer& renderer = renderers_.at(name);
             // Render orbit
-            body->render(shader);
+            renderer.renderTrajectory(shader);
             // Render planet sphere
-            if (body->renderer.hasSphere()) {
-                glm::mat4 model = glm::translate(glm::mat4(1.0f), toRender(body->position));
+            if (renderer.hasSphere()) {
+                glm::mat4 model = glm::translate(glm::mat4(1.0f), toRender(positionOf(name)));
                 model = glm::scale(model, glm::vec3(scalef, scalef, scalef));
                 shader.setMat4("model", model);
                 shader.setVec4("color", color);
-                body->renderer.renderSphere();
+                renderer.renderSphere();
             }
         }
     };
@@ -443,8 +482,8 @@ void Simulation::render(const Shader& shader) const {
     renderPlanet("neptune", glm::vec4(0.2f, 0.3f, 0.8f, 1.0f));    // Deep blue
     
     // Render Saturn's rings (after Saturn's sphere, with proper blending)
-    if (saturnRings_ && bodies.find("saturn") != bodies.end()) {
-        glm::mat4 saturnModel = glm::translate(glm::mat4(1.0f), toRender(bodies.at("saturn")->position));
+    if (saturnRings_ && renderers_.find("saturn") != renderers_.end()) {
+        glm::mat4 saturnModel = glm::translate(glm::mat4(1.0f), toRender(positionOf("saturn")));
         saturnRings_->render(saturnModel, view, projection, scalef);
         // Restore main shader after ring rendering
         shader.use();
@@ -456,34 +495,6 @@ void Simulation::render(const Shader& shader) const {
     }
 }
 
-void Simulation::setTimeScale(float ts) { 
-    timeScale = std::max(ts, 0.1f); 
-    LOG_INFO(logger_, "Simulation", "Time scale set to " + std::to_string(ts));
-}
-
-void Simulation::adjustTimeScale(float delta) { 
-    // Support much higher time scales for testing orbital mechanics
-    // Use multiplicative scaling for large values
-    if (delta > 0) {
-        // Increasing: multiply by 1.5 when above 100, otherwise add delta
-        if (timeScale >= 100.0f) {
-            timeScale *= 1.5f;
-        } else {
-            timeScale += delta;
-        }
-    } else {
-        // Decreasing: divide by 1.5 when above 100, otherwise subtract delta
-        if (timeScale > 100.0f) {
-            timeScale /= 1.5f;
-        } else {
-            timeScale += delta;
-        }
-    }
-    // Clamp to reasonable range: 0.1x to 1,000,000x (for testing year-long orbits)
-    timeScale = std::max(0.1f, std::min(timeScale, 1000000.0f));
-    LOG_INFO(logger_, "Simulation", "Time scale adjusted to " + std::to_string(timeScale));
-}
-
 void Simulation::adjustCameraDistance(float delta) { 
     camera.zoom(delta);
     LOG_INFO(logger_, "Simulation", "Camera distance adjusted to " + std::to_string(camera.distance));
@@ -498,76 +509,34 @@ void Simulation::adjustCameraRotation(float deltaPitch, float deltaYaw) {
 void Simulation::adjustCameraMode(Camera::Mode mode) {
     camera.setMode(mode);
     
-    // Scale factor for rendering (meters to km)
-    const double scale = static_cast<double>(config.simulation_rendering_scale);
-
-    // Update renderOrigin FIRST so that toRender() uses the correct origin
-    // for the new mode (not the stale origin from the previous mode).
+    // render() rebases every frame on the mode's target (the Earth, the Moon,
+    // their midpoint or the Sun), so fixed targets sit at the render origin
     switch (mode) {
-        case Camera::Mode::Locked:
-        case Camera::Mode::Free:
-            renderOrigin_ = rocket.getPosition();
-            break;
         case Camera::Mode::FixedEarth:
-            if (bodies.find("earth") != bodies.end())
-                renderOrigin_ = bodies.at("earth")->position;
-            break;
-        case Camera::Mode::FixedMoon:
-            if (bodies.find("moon") != bodies.end())
-                renderOrigin_ = bodies.at("moon")->position;
-            break;
-        case Camera::Mode::Overview:
-            if (bodies.find("earth") != bodies.end() && bodies.find("moon") != bodies.end())
-                renderOrigin_ = (bodies.at("earth")->position + bodies.at("moon")->position) * 0.5;
-            break;
-        case Camera::Mode::SolarSystem:
-        case Camera::Mode::FullSolarSystem:
-            renderOrigin_ = glm::dvec3(0.0);
-            break;
-        case Camera::Mode::FocusBody: {
-            const std::string& bodyName = camera.focusBodyName;
-            if (!bodyName.empty() && bodies.find(bodyName) != bodies.end())
-                renderOrigin_ = bodies.at(bodyName)->position;
-            break;
-        }
-    }
-
-    // Helper: convert physics position to origin-relative render position
-    auto toRender = [&](const glm::dvec3& physPos) -> glm::vec3 {
-        return glm::vec3((physPos - renderOrigin_) * scale);
-    };
-    
-    // Set appropriate target and distance based on mode
-    // Distances are loaded from config for easy customization
-    switch (mode) {
-        case Camera::Mode::FixedEarth:
-            if (bodies.find("earth") != bodies.end()) {
-                camera.setFixedTarget(toRender(bodies.at("earth")->position));
-            }
+            camera.setFixedTarget(glm::vec3(0.0f));
             camera.distance = config.camera_distance_earth;
             break;
         case Camera::Mode::FixedMoon:
-            if (bodies.find("moon") != bodies.end()) {
-                camera.setFixedTarget(toRender(bodies.at("moon")->position));
+            if (renderers_.find("moon") != renderers_.end()) {
+                camera.setFixedTarget(glm::vec3(0.0f));
                 camera.distance = config.camera_distance_moon;
             }
             break;
         case Camera::Mode::Overview:
             // Midpoint between Earth and Moon
-            if (bodies.find("earth") != bodies.end() && bodies.find("moon") != bodies.end()) {
-                glm::dvec3 midpoint = (bodies.at("earth")->position + bodies.at("moon")->position) * 0.5;
-                camera.setFixedTarget(toRender(midpoint));
+            if (renderers_.find("earth") != renderers_.end() && renderers_.find("moon") != renderers_.end()) {
+                camera.setFixedTarget(glm::vec3(0.0f));
                 camera.distance = config.camera_distance_overview;
             }
             break;
         case Camera::Mode::SolarSystem:
             // Sun at origin, view inner solar system (up to Mars)
-            camera.setFixedTarget(toRender(glm::dvec3(0.0)));
+            camera.setFixedTarget(glm::vec3(0.0f));
             camera.distance = config.camera_distance_solar_system;
             break;
         case Camera::Mode::FullSolarSystem:
             // Sun at origin, view entire solar system including Neptune (~30 AU)
-            camera.setFixedTarget(toRender(glm::dvec3(0.0)));
+            camera.setFixedTarget(glm::vec3(0.0f));
             camera.distance = config.camera_distance_full_solar;
             break;
         case Camera::Mode::Locked:
@@ -590,7 +559,6 @@ void Simulation::adjustCameraTarget(const glm::vec3& target) {
 
 void Simulation::focusOnBody(const std::string& bodyName) {
     const float scale = config.simulation_rendering_scale;
-    const double scaled = static_cast<double>(scale);
     
     if (bodyName == "rocket") {
         // Switch to Locked mode for rocket
@@ -600,17 +568,14 @@ void Simulation::focusOnBody(const std::string& bodyName) {
     }
     
     // Find the body
-    auto it = bodies.find(bodyName);
-    if (it == bodies.end()) {
+    auto it = renderers_.find(bodyName);
+    if (it == renderers_.end()) {
         LOG_WARN(logger_, "Simulation", "Body not found: " + bodyName);
         return;
     }
     
-    // Update renderOrigin to the focused body's position for float precision
-    renderOrigin_ = it->second->position;
-
-    // Body position relative to renderOrigin (will be near zero)
-    glm::vec3 bodyPos = glm::vec3((it->second->position - renderOrigin_) * scaled);
+    // render() rebases on the focused body, so it sits at the render origin
+    glm::vec3 bodyPos(0.0f);
     
     // Get body radius from config (in meters, convert to km for rendering)
     float bodyRadiusKm = 0.0f;
@@ -670,62 +635,10 @@ void Simulation::focusOnBody(const std::string& bodyName) {
              std::to_string(viewDistance) + " km)");
 }
 
-void Simulation::buildOctree() {
-    std::vector<OctreeBody> octreeBodies;
-    octreeBodies.reserve(bodies.size());
-    for (const auto& [name, body] : bodies) {
-        octreeBodies.emplace_back(body->position, body->mass, name);
-    }
-    octree_.build(octreeBodies);
-}
-
-glm::dvec3 Simulation::computeBodyAcceleration(const Body& body, const BODY_MAP& bodies) const {
-    // Use direct summation for celestial bodies (only ~10 bodies, O(n²) is trivial).
-    // Barnes-Hut octree is reserved for rocket gravity calculations where the
-    // number of gravitational sources justifies the O(n log n) approach.
-    //
-    // Direct summation avoids a subtle octree aliasing bug: when two bodies
-    // share similar coordinates (e.g., Earth and Moon have identical X values),
-    // internal node center-of-mass can land extremely close to one body,
-    // producing a near-zero denominator and catastrophic force blow-up.
-    glm::dvec3 acc(0.0);
-    for (const auto& [name, other] : bodies) {
-        if (&(*other) == &body) continue;  // Skip self
-        glm::dvec3 delta = other->position - body.position;
-        double distSq = glm::dot(delta, delta);
-        double dist = std::sqrt(distSq);
-        if (dist < 1.0) continue;  // Softening: skip if < 1 meter
-        double distCubed = distSq * dist;
-        acc += (config.physics_gravity_constant * other->mass / distCubed) * delta;
-    }
-    return acc;
-}
-
-float Simulation::getTimeScale() const { 
-    return timeScale; 
-}
-
-Rocket& Simulation::getRocket() { 
-    return rocket; 
-}
-
 Camera& Simulation::getCamera() {
     return camera;
 }
 
-glm::dvec3 Simulation::getMoonPos() const {
-    // Return real-time moon position from physics bodies (dvec3)
-    auto it = bodies.find("moon");
-    if (it != bodies.end()) {
-        return it->second->position;
-    }
-    return moonPos;  // Fallback to initial value
-}
-
-const BODY_MAP& Simulation::getBodies() const {
-    return bodies;
-}
-
 float Simulation::getRenderScale() const {
     return config.simulation_rendering_scale;
 }
@@ -749,4 +662,4 @@ void Simulation::getRenderMatrices(int width, int height, glm::mat4& projection,
     
     projection = glm::perspective(glm::radians(45.0f), (float)width / sceneHeight, nearPlane, farPlane);
     view = camera.getViewMatrix();
-}
\ No newline at end of file
+}
@@ -0,0 +1,531 @@
+#include "core/simulation_core.h"
+#include "core/alloc_counter.h"
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+SimulationCore::SimulationCore(const Config& config, std::shared_ptr<ILogger> logger)
+    : config(config), logger_(logger), rocket(this->config, logger, FlightPlan(config.flight_plan_path)),
+      moonPos(0.0, 384400000.0, 0.0), checkpoints_(logger) {
+    if (!logger_) {
+        throw std::runtime_error("Logger is null");
+    }
+    logger_->set_level((LogLevel)config.logger_level);
+}
+
+SimulationCore::~SimulationCore() {
+    stopRecording();
+}
+
+void SimulationCore::init() {
+    LOG_DEBUG(logger_, "Simulation", "Initializing simulation...");
+    
+    // Sun at origin (heliocentric coordinate system)
+    bodies["sun"] = std::make_unique<Body>(config, logger_, "sun", config.physics_sun_mass, glm::dvec3(0.0), glm::dvec3(0.0));
+    
+    // Initialize all planets from config data
+    // Earth and Moon have special handling; other planets use the generic loop
+    const auto* earthCfg = config.getPlanet("earth");
+    glm::dvec3 earthPos = glm::dvec3(earthCfg->orbit_radius, 0.0, 0.0);
+    glm::dvec3 earthVel = glm::dvec3(0.0, 0.0, earthCfg->orbital_velocity);
+    
+    for (const auto& planet : config.planets) {
+        if (planet.name == "earth" || planet.name == "moon") continue;
+        
+        glm::dvec3 pos = glm::dvec3(planet.orbit_radius, 0.0, 0.0);
+        glm::dvec3 vel = glm::dvec3(0.0, 0.0, planet.orbital_velocity);
+        bodies[planet.name] = std::make_unique<Body>(config, logger_, planet.name, planet.mass, pos, vel);
+    }
+    
+    // Earth
+    bodies["earth"] = std::make_unique<Body>(config, logger_, "earth", config.physics_earth_mass, earthPos, earthVel);
+    
+    // Moon orbiting Earth with ~5.145° orbital inclination relative to the ecliptic
+    const float lunarInclination = glm::radians(5.145f);
+    
+    // Moon position in the inclined orbital plane
+    double moonDistLocal_z = config.physics_moon_distance;
+    double moonPosY = moonDistLocal_z * std::sin(lunarInclination);
+    double moonPosZ = moonDistLocal_z * std::cos(lunarInclination);
+    glm::dvec3 moonPos = earthPos + glm::dvec3(0.0, moonPosY, moonPosZ);
+    
+    // Moon velocity: orbital velocity (~1022 m/s) perpendicular to position in the inclined plane
+    const double moonOrbitalSpeed = 1022.0;
+    glm::dvec3 moonVelRelative = glm::dvec3(-moonOrbitalSpeed, 0.0, 0.0);
+    glm::dvec3 moonVel = earthVel + moonVelRelative;
+    
+    bodies["moon"] = std::make_unique<Body>(config, logger_, "moon", config.physics_moon_mass, moonPos, moonVel);
+
+    if (!bodies["sun"] || !bodies["earth"] || !bodies["moon"]) {
+        LOG_ERROR(logger_, "Simulation", "Failed to initialize celestial bodies!");
+        return;
+    }
+
+    // Body hierarchy: planets under their configured parent, the Moon under Earth
+    std::unordered_map<std::string, std::string> parents = {{"moon", "earth"}};
+    for (const auto& planet : config.planets) {
+        if (planet.name == "moon") continue;
+        parents[planet.name] = planet.parent;
+    }
+    bodyTree_.build(bodies, parents);
+    rocket.setBodyTree(&bodyTree_);
+    
+    // Update rocket initial position relative to Earth
+    rocket.setPosition(earthPos + glm::dvec3(0.0, config.physics_earth_radius, 0.0));
+    rocket.setVelocity(earthVel); // Rocket starts with Earth's orbital velocity
+    rocket.setEarthPosition(earthPos);  // Set Earth position for altitude calculations
+
+    rocket.init();
+
+    // Something to read before the first physics step
+    publishSnapshot();
+
+    if (config.telemetry_enabled) {
+        try {
+            startRecording(config.telemetry_path);
+        } catch (const TelemetryError& e) {
+            LOG_ERROR(logger_, "Simulation", std::string("Telemetry disabled: ") + e.what());
+        }
+    }
+}
+
+void SimulationCore::update(float deltaTime) {
+    const uint64_t allocationsBefore = AllocationCounter::count();
+    frameArena_.reset();
+    applyCommands();
+
+    double dt = static_cast<double>(deltaTime * timeScale);
+    time_ += dt;
+
+    if (frame_.empty()) {
+        buildFrameGraph();
+    }
+    frameDt_ = dt;
+    frame_.run(jobs_);
+
+    frameAllocations_ = AllocationCounter::count() - allocationsBefore;
+}
+
+void SimulationCore::buildFrameGraph() {
+    // The octree and the tree's parent-relative state both follow from the
+    // new body positions and are independent of each other. The rocket's
+    // stages then run in order; the encounter search over a fresh prediction
+    // overlaps its integration, and the bodies are staged into the next
+    // snapshot alongside the whole rocket chain.
+    auto stepBodiesTask = frame_.add("bodies", [this]() { stepBodies(frameDt_); });
+    auto treeTask = frame_.add("body tree", [this]() {
+        if (!config.simulation_block_timesteps) {
+            bodyTree_.syncFromWorld();
+        }
+        bodyTree_.refreshSoi();
+    });
+    auto octreeTask = frame_.add("octree", [this]() { buildOctree(); });
+    auto prepareTask = frame_.add("rocket environment", [this]() {
+        rocket.prepareStep(static_cast<float>(frameDt_), bodies);
+    });
+    auto predictionTask = frame_.add("prediction", [this]() {
+        rocket.updatePrediction(static_cast<float>(frameDt_), bodies, &octree_);
+    });
+    auto rocketTask = frame_.add("rocket step", [this]() {
+        rocket.completeStep(static_cast<float>(frameDt_), bodies, &octree_);
+    });
+    auto encounterTask = frame_.add("encounters", [this]() { updateEncounters(); });
+    auto stageBodiesTask = frame_.add("stage bodies", [this]() { stageBodies(snapshots_.back()); });
+    auto publishTask = frame_.add("publish", [this]() {
+        stageRocket(snapshots_.back());
+        if (recorder_) {
+            recorder_->record(snapshots_.back());
+        }
+        snapshots_.publish();
+    });
+
+    frame_.dependsOn(treeTask, {stepBodiesTask});
+    frame_.dependsOn(octreeTask, {stepBodiesTask});
+    frame_.dependsOn(prepareTask, {treeTask});
+    frame_.dependsOn(predictionTask, {prepareTask, octreeTask});
+    frame_.dependsOn(rocketTask, {predictionTask});
+    frame_.dependsOn(encounterTask, {predictionTask});
+    frame_.dependsOn(stageBodiesTask, {treeTask});
+    frame_.dependsOn(publishTask, {rocketTask, encounterTask, stageBodiesTask});
+}
+
+void SimulationCore::stepBodies(double dt) {
+    if (!config.simulation_block_timesteps) {
+        updateBodiesVerlet(dt);
+        return;
+    }
+
+    // Each body steps at its own power-of-two rate; the integrator keeps
+    // its own timeline and writes the state at the frame time back
+    if (!blockIntegrator_.isInitialized()) {
+        blockIntegrator_ = BlockIntegrator(config.physics_gravity_constant, config.simulation_block_max_step,
+                                           config.simulation_block_eta, config.simulation_block_max_level);
+        blockIntegrator_.reset(bodyTree_);
+    }
+    blockIntegrator_.advance(dt);
+
+    for (auto& [name, body] : bodies) {
+        if (std::isnan(body->position.x) || std::isnan(body->velocity.x)) {
+            LOG_ERROR(logger_, "Simulation", "NaN detected in " + name + ": Pos=" + 
+                      glm::to_string(glm::vec3(body->position)) + ", Vel=" + glm::to_string(glm::vec3(body->velocity)));
+        }
+    }
+}
+
+bool SimulationCore::post(const SimulationCommand& command) {
+    if (!commands_.push(command)) {
+        LOG_WARN(logger_, "Simulation", "Command queue full, input dropped");
+        return false;
+    }
+    return true;
+}
+
+void SimulationCore::applyCommands() {
+    if (checkpointRequests_.load(std::memory_order_acquire)) {
+        applyCheckpointRequests();
+    }
+    SimulationCommand command;
+    while (commands_.pop(command)) {
+        switch (command.type) {
+            case SimulationCommand::Type::ToggleLaunch:
+                rocket.toggleLaunch();
+                break;
+            case SimulationCommand::Type::RotateThrust: {
+                glm::dmat4 rotation = glm::rotate(glm::dmat4(1.0), command.value, glm::dvec3(0.0, 0.0, 1.0));
+                rocket.setThrustDirection(glm::dvec3(rotation * glm::dvec4(rocket.getThrustDirection(), 0.0)));
+                break;
+            }
+            case SimulationCommand::Type::SetTimeScale:
+                setTimeScale(static_cast<float>(command.value));
+                break;
+            case SimulationCommand::Type::AdjustTimeScale:
+                adjustTimeScale(static_cast<float>(command.value));
+                break;
+        }
+    }
+}
+
+void SimulationCore::publishSnapshot() {
+    SimulationSnapshot& state = snapshots_.back();
+    stageBodies(state);
+    stageRocket(state);
+    if (recorder_) {
+        recorder_->record(state);
+    }
+    snapshots_.publish();
+}
+
+void SimulationCore::startRecording(const std::string& path) {
+    openRecorder(path);
+    recordingPath_ = path;
+    recorder_->record(latestSnapshot());
+}
+
+void SimulationCore::openRecorder(const std::string& path) {
+    stopRecording();
+    std::vector<std::string> names;
+    names.reserve(bodyTree_.size());
+    for (size_t i = 0; i < bodyTree_.size(); ++i) {
+        names.push_back(bodyTree_.body(static_cast<int>(i)).name);
+    }
+    recorder_ = std::make_unique<FlightRecorder>(path, names, config.telemetry_interval, config.telemetry_compress);
+    LOG_INFOF(logger_, "Simulation", "Recording telemetry of {} bodies to {}", names.size(), path);
+}
+
+void SimulationCore::stopRecording() {
+    if (!recorder_) {
+        return;
+    }
+    recorder_->close();
+    if (recorder_->failed()) {
+        LOG_ERRORF(logger_, "Simulation", "Telemetry write to {} failed; the file is incomplete", recorder_->path());
+    } else {
+        LOG_INFOF(logger_, "Simulation", "Recorded {} telemetry rows to {}", recorder_->rows(), recorder_->path());
+    }
+    recorder_.reset();
+}
+
+Checkpoint SimulationCore::captureCheckpoint() const {
+    Checkpoint state;
+    state.time = time_;
+    state.timeScale = timeScale;
+    state.bodies.reserve(bodyTree_.size());
+    for (size_t i = 0; i < bodyTree_.size(); ++i) {
+        const Body& body = bodyTree_.body(static_cast<int>(i));
+        state.bodies.push_back({body.name, body.mass, body.position, body.velocity});
+    }
+    rocket.saveState(state.rocket);
+    return state;
+}
+
+void SimulationCore::saveCheckpoint(const std::string& path, std::optional<CheckpointView> view) {
+    Checkpoint state = captureCheckpoint();
+    state.view = std::move(view);
+    checkpoints_.save(path, std::move(state));
+}
+
+void SimulationCore::checkCheckpoint(const Checkpoint& state) const {
+    if (state.bodies.size() != bodyTree_.size()) {
+        throw CheckpointError("Checkpoint has " + std::to_string(state.bodies.size()) + " bodies, the simulation " +
+                              std::to_string(bodyTree_.size()));
+    }
+    for (const BodyCheckpoint& body : state.bodies) {
+        if (bodyTree_.indexOf(body.name) == BodyTree::kNone) {
+            throw CheckpointError("Checkpoint body " + body.name + " is not in the simulation");
+        }
+    }
+    const size_t stages = rocket.getStageNames().size();
+    if (state.rocket.stage >= stages) {
+        throw CheckpointError("Checkpoint is on stage " + std::to_string(state.rocket.stage + 1) +
+                              " of a rocket with " + std::to_string(stages));
+    }
+}
+
+void SimulationCore::restoreCheckpoint(const Checkpoint& state) {
+    checkCheckpoint(state);
+    rocket.restoreState(state.rocket);
+    for (const BodyCheckpoint& saved : state.bodies) {
+        Body& body = *bodies.at(saved.name);
+        body.mass = saved.mass;
+        body.position = saved.position;
+        body.velocity = saved.velocity;
+    }
+    bodyTree_.syncFromWorld();
+    bodyTree_.refreshSoi();
+    // The multi-rate integrator's blocks start over synchronized at the restored state
+    if (blockIntegrator_.isInitialized()) {
+        blockIntegrator_.reset(bodyTree_);
+    }
+    time_ = state.time;
+    timeScale = state.timeScale;
+    ++restores_;
+    if (recorder_) {
+        try {
+            openRecorder(recordingPath_ + "." + std::to_string(restores_));
+        } catch (const TelemetryError& e) {
+            LOG_ERROR(logger_, "Simulation", std::string("Telemetry stopped at the restore: ") + e.what());
+        }
+    }
+    publishSnapshot();
+    LOG_INFOF(logger_, "Simulation", "Restored checkpoint at t={:.1f} s", time_);
+}
+
+void SimulationCore::restoreCheckpoint(const std::string& path) {
+    restoreCheckpoint(readCheckpoint(path));
+}
+
+void SimulationCore::postCheckpoint(const std::string& path, std::optional<CheckpointView> view) {
+    std::lock_guard<std::mutex> lock(checkpointMutex_);
+    saveRequests_.emplace_back(path, std::move(view));
+    checkpointRequests_.store(true, std::memory_order_release);
+}
+
+void SimulationCore::postRestore(std::shared_ptr<const Checkpoint> state) {
+    std::lock_guard<std::mutex> lock(checkpointMutex_);
+    restoreRequest_ = std::move(state);
+    checkpointRequests_.store(true, std::memory_order_release);
+}
+
+void SimulationCore::applyCheckpointRequests() {
+    std::vector<std::pair<std::string, std::optional<CheckpointView>>> saves;
+    std::shared_ptr<const Checkpoint> restore;
+    {
+        std::lock_guard<std::mutex> lock(checkpointMutex_);
+        saves.swap(saveRequests_);
+        restore.swap(restoreRequest_);
+        checkpointRequests_.store(false, std::memory_order_relaxed);
+    }
+    // Saves first: they were asked for of the state before the restore
+    for (auto& [path, view] : saves) {
+        saveCheckpoint(path, std::move(view));
+    }
+    if (restore) {
+        try {
+            restoreCheckpoint(*restore);
+        } catch (const CheckpointError& e) {
+            LOG_ERROR(logger_, "Simulation", std::string("Checkpoint not restored: ") + e.what());
+        }
+    }
+}
+
+void SimulationCore::stageBodies(SimulationSnapshot& state) const {
+    state.time = time_;
+    state.timeScale = timeScale;
+    state.restores = restores_;
+
+    state.bodies.resize(bodyTree_.size());
+    for (size_t i = 0; i < bodyTree_.size(); ++i) {
+        const Body& body = bodyTree_.body(static_cast<int>(i));
+        BodySnapshot& out = state.bodies[i];
+        out.name = body.name;
+        out.parent = bodyTree_.parentOf(static_cast<int>(i));
+        out.mass = body.mass;
+        out.soiRadius = bodyTree_.soiRadius(static_cast<int>(i));
+        out.position = body.position;
+        out.velocity = body.velocity;
+    }
+}
+
+void SimulationCore::stageRocket(SimulationSnapshot& state) {
+    state.sequence = ++published_;
+    rocket.fillSnapshot(state.rocket);
+    state.encounters = encounterFinder_.encounters();
+    state.encounterSearchFinished = encounterFinder_.finished();
+    state.frameAllocations = frameAllocations_;
+}
+
+const SimulationSnapshot& SimulationCore::latestSnapshot() {
+    return snapshots_.read();
+}
+
+void SimulationCore::updateEncounters() {
+    if (!config.simulation_encounters) {
+        return;
+    }
+    // A new prediction starts over against the bodies as they are now,
+    // which is also the epoch of the prediction's clock
+    if (rocket.getPredictionRevision() != encounterRevision_) {
+        encounterRevision_ = rocket.getPredictionRevision();
+        encounterEphemeris_.assign(bodyTree_, config.physics_gravity_constant);
+        encounterFinder_.reset(rocket.getPredictionSamples(), encounterEphemeris_);
+    }
+    if (!encounterFinder_.finished()) {
+        encounterFinder_.update(config.simulation_encounter_budget_ms * 1e-3);
+    }
+}
+
+void SimulationCore::setTimeScale(float ts) { 
+    timeScale = std::max(ts, 0.1f); 
+    LOG_INFO(logger_, "Simulation", "Time scale set to " + std::to_string(ts));
+}
+
+void SimulationCore::adjustTimeScale(float delta) { 
+    // Support much higher time scales for testing orbital mechanics
+    // Use multiplicative scaling for large values
+    if (delta > 0) {
+        // Increasing: multiply by 1.5 when above 100, otherwise add delta
+        if (timeScale >= 100.0f) {
+            timeScale *= 1.5f;
+        } else {
+            timeScale += delta;
+        }
+    } else {
+        // Decreasing: divide by 1.5 when above 100, otherwise subtract delta
+        if (timeScale > 100.0f) {
+            timeScale /= 1.5f;
+        } else {
+            timeScale += delta;
+        }
+    }
+    // Clamp to reasonable range: 0.1x to 1,000,000x (for testing year-long orbits)
+    timeScale = std::max(0.1f, std::min(timeScale, 1000000.0f));
+    LOG_INFO(logger_, "Simulation", "Time scale adjusted to " + std::to_string(timeScale));
+}
+
+void SimulationCore::updateBodiesVerlet(double dt) {
+    // The octree is built from the final positions by its own frame stage;
+    // body-body gravity is summed directly (see computeBodyAcceleration)
+    ArenaVector<Body*> list{ArenaAllocator<Body*>(frameArena_)};
+    list.reserve(bodies.size());
+    for (auto& [name, body] : bodies) {
+        list.push_back(body.get());
+    }
+
+    // Each acceleration is an O(n) sum; with a large body set they are
+    // spread over the job system, a small one stays on this thread. Every
+    // sum still runs over the bodies in map order on a single thread, so
+    // the result is the same bits for any thread count.
+    constexpr size_t kBodyGrain = 64;
+    auto computeAccelerations = [&](ArenaVector<glm::dvec3>& out) {
+        out.resize(list.size());
+        auto range = [&](size_t first, size_t last) {
+            for (size_t i = first; i < last; ++i) {
+                out[i] = computeBodyAcceleration(*list[i], bodies);
+            }
+        };
+        if (jobs_) {
+            jobs_->parallelFor(0, list.size(), kBodyGrain, range);
+        } else {
+            range(0, list.size());
+        }
+    };
+
+    // Step 1: Update all celestial bodies (Velocity Verlet)
+    ArenaVector<glm::dvec3> current_accs{ArenaAllocator<glm::dvec3>(frameArena_)};
+    computeAccelerations(current_accs);
+    
+    // Update positions
+    for (size_t i = 0; i < list.size(); ++i) {
+        list[i]->position += list[i]->velocity * dt + 0.5 * current_accs[i] * dt * dt;
+    }
+    
+    // Calculate new accelerations and update velocities
+    ArenaVector<glm::dvec3> new_accs{ArenaAllocator<glm::dvec3>(frameArena_)};
+    computeAccelerations(new_accs);
+    for (size_t i = 0; i < list.size(); ++i) {
+        Body& body = *list[i];
+        body.velocity += 0.5 * (current_accs[i] + new_accs[i]) * dt;
+        
+        // Check for NaN
+        if (std::isnan(body.position.x) || std::isnan(body.velocity.x)) {
+            LOG_ERROR(logger_, "Simulation", "NaN detected in " + body.name + ": Pos=" + 
+                      glm::to_string(glm::vec3(body.position)) + ", Vel=" + glm::to_string(glm::vec3(body.velocity)));
+        }
+    }
+}
+
+void SimulationCore::buildOctree() {
+    // Overwrite in place so the names keep their storage from frame to frame
+    octreeBodies_.resize(bodies.size());
+    size_t i = 0;
+    for (const auto& [name, body] : bodies) {
+        OctreeBody& out = octreeBodies_[i++];
+        out.position = body->position;
+        out.mass = body->mass;
+        out.name = name;
+    }
+    octree_.build(octreeBodies_, jobs_);
+}
+
+glm::dvec3 SimulationCore::computeBodyAcceleration(const Body& body, const BODY_MAP& bodies) const {
+    // Use direct summation for celestial bodies (only ~10 bodies, O(n²) is trivial).
+    // Barnes-Hut octree is reserved for rocket gravity calculations where the
+    // number of gravitational sources justifies the O(n log n) approach.
+    //
+    // Direct summation avoids a subtle octree aliasing bug: when two bodies
+    // share similar coordinates (e.g., Earth and Moon have identical X values),
+    // internal node center-of-mass can land extremely close to one body,
+    // producing a near-zero denominator and catastrophic force blow-up.
+    glm::dvec3 acc(0.0);
+    for (const auto& [name, other] : bodies) {
+        if (&(*other) == &body) continue;  // Skip self
+        glm::dvec3 delta = other->position - body.position;
+        double distSq = glm::dot(delta, delta);
+        double dist = std::sqrt(distSq);
+        if (dist < 1.0) continue;  // Softening: skip if < 1 meter
+        double distCubed = distSq * dist;
+        acc += (config.physics_gravity_constant * other->mass / distCubed) * delta;
+    }
+    return acc;
+}
+
+float SimulationCore::getTimeScale() const { 
+    return timeScale; 
+}
+
+Rocket& SimulationCore::getRocket() { 
+    return rocket; 
+}
+
+glm::dvec3 SimulationCore::getMoonPos() const {
+    // Return real-time moon position from physics bodies (dvec3)
+    auto it = bodies.find("moon");
+    if (it != bodies.end()) {
+        return it->second->position;
+    }
+    return moonPos;  // Fallback to initial value
+}
+
+const BODY_MAP& SimulationCore::getBodies() const {
+    return bodies;
+}
@@ -0,0 +1,41 @@
+#include "core/snapshot.h"
+
+#include <limits>
+
+int SimulationSnapshot::indexOf(const std::string& name) const {
+    for (size_t i = 0; i < bodies.size(); ++i) {
+        if (bodies[i].name == name) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+const BodySnapshot* SimulationSnapshot::find(const std::string& name) const {
+    int index = indexOf(name);
+    return index < 0 ? nullptr : &bodies[index];
+}
+
+int SimulationSnapshot::dominantBody(const glm::dvec3& worldPosition) const {
+    if (bodies.empty()) {
+        return -1;
+    }
+
+    int current = 0;
+    while (true) {
+        int next = -1;
+        double closest = std::numeric_limits<double>::max();
+        for (size_t c = 0; c < bodies.size(); ++c) {
+            if (bodies[c].parent != current) continue;
+            double d = glm::length(worldPosition - bodies[c].position);
+            if (d < bodies[c].soiRadius && d < closest) {
+                closest = d;
+                next = static_cast<int>(c);
+            }
+        }
+        if (next < 0) {
+            return current;
+        }
+        current = next;
+    }
+}
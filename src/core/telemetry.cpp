@@ -0,0 +1,557 @@
+#include "core/telemetry.h"
+
+#include <algorithm>
+#include <cstring>
+#include <ostream>
+
+namespace {
+
+// File layout (see telemetry.h):
+//   header   magic, u32 version, u32 columns, per column u8 type + u16 name length + name
+//   chunk    ChunkHeader, payload
+//   index    u32 kIndexMagic, u32 count, count x IndexEntry
+//   trailer  u64 index offset, kEndMagic
+constexpr char kFileMagic[8] = {'R', 'S', 'I', 'M', 'T', 'L', 'M', '\0'};
+constexpr char kEndMagic[8] = {'R', 'S', 'I', 'M', 'E', 'N', 'D', '\0'};
+constexpr uint32_t kChunkMagic = 0x4B4E4843;   // "CHNK"
+constexpr uint32_t kIndexMagic = 0x58444E49;   // "INDX"
+
+enum Encoding : uint32_t {
+    kRaw = 0,
+    kPacked = 1
+};
+
+struct ChunkHeader {
+    uint32_t magic;
+    uint32_t rows;
+    uint32_t encoding;
+    uint32_t reserved;
+    uint64_t storedSize;     // Payload bytes after the header
+    double firstTime;
+    double lastTime;
+};
+static_assert(sizeof(ChunkHeader) == 40, "ChunkHeader is written as is");
+
+struct IndexEntry {
+    uint64_t offset;
+    uint32_t rows;
+    uint32_t reserved;
+    double firstTime;
+    double lastTime;
+};
+static_assert(sizeof(IndexEntry) == 32, "IndexEntry is written as is");
+
+constexpr size_t kTrailerSize = sizeof(uint64_t) + sizeof(kEndMagic);
+
+// Run-length packing: a control byte c < 128 is followed by c + 1 literal
+// bytes; c >= 128 by one byte repeated (c - 128) + kMinRun times
+constexpr size_t kMinRun = 3;
+constexpr size_t kMaxRun = 127 + kMinRun;
+constexpr size_t kMaxLiteral = 128;
+
+void pack(const uint8_t* in, size_t size, std::vector<uint8_t>& out) {
+    size_t i = 0;
+    size_t literalStart = 0;
+    auto flushLiteral = [&](size_t end) {
+        while (literalStart < end) {
+            const size_t n = std::min(end - literalStart, kMaxLiteral);
+            out.push_back(static_cast<uint8_t>(n - 1));
+            out.insert(out.end(), in + literalStart, in + literalStart + n);
+            literalStart += n;
+        }
+    };
+    while (i < size) {
+        size_t run = 1;
+        while (i + run < size && run < kMaxRun && in[i + run] == in[i]) {
+            ++run;
+        }
+        if (run >= kMinRun) {
+            flushLiteral(i);
+            out.push_back(static_cast<uint8_t>(128 + run - kMinRun));
+            out.push_back(in[i]);
+            i += run;
+            literalStart = i;
+        } else {
+            i += run;
+        }
+    }
+    flushLiteral(size);
+}
+
+void unpack(const uint8_t* in, size_t size, std::vector<uint8_t>& out, size_t expected) {
+    out.clear();
+    out.reserve(expected);
+    size_t i = 0;
+    while (i < size) {
+        const uint8_t control = in[i++];
+        if (control < 128) {
+            const size_t n = static_cast<size_t>(control) + 1;
+            if (i + n > size || out.size() + n > expected) {
+                throw TelemetryError("Telemetry chunk is corrupt: literal run overflows");
+            }
+            out.insert(out.end(), in + i, in + i + n);
+            i += n;
+        } else {
+            const size_t n = static_cast<size_t>(control - 128) + kMinRun;
+            if (i >= size || out.size() + n > expected) {
+                throw TelemetryError("Telemetry chunk is corrupt: repeat run overflows");
+            }
+            out.insert(out.end(), n, in[i++]);
+        }
+    }
+    if (out.size() != expected) {
+        throw TelemetryError("Telemetry chunk is corrupt: payload is short");
+    }
+}
+
+size_t rowWidth(const std::vector<TelemetryColumn>& columns) {
+    size_t width = 0;
+    for (const auto& column : columns) {
+        width += telemetry::widthOf(column.type);
+    }
+    return width;
+}
+
+uint64_t bitsOf(double value) {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+double doubleOf(uint64_t bits) {
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+}  // namespace
+
+namespace telemetry {
+
+size_t widthOf(TelemetryType type) {
+    return type == TelemetryType::UInt32 ? 4 : 8;
+}
+
+void encodeChunk(const std::vector<TelemetryColumn>& columns, const uint64_t* values, size_t stride, size_t rows,
+                 bool compress, std::vector<uint8_t>& out) {
+    out.clear();
+    const size_t size = rowWidth(columns) * rows;
+
+    // Column by column; when compressing, each value is XORed with the one
+    // before it and its bytes spread over `width` planes of `rows` bytes
+    std::vector<uint8_t> planes(size);
+    size_t base = 0;
+    for (size_t c = 0; c < columns.size(); ++c) {
+        const size_t width = widthOf(columns[c].type);
+        const uint64_t* column = values + c * stride;
+        uint64_t previous = 0;
+        for (size_t r = 0; r < rows; ++r) {
+            uint64_t word = column[r];
+            if (compress) {
+                const uint64_t delta = word ^ previous;
+                previous = word;
+                for (size_t b = 0; b < width; ++b) {
+                    planes[base + b * rows + r] = static_cast<uint8_t>(delta >> (8 * b));
+                }
+            } else {
+                for (size_t b = 0; b < width; ++b) {
+                    planes[base + r * width + b] = static_cast<uint8_t>(word >> (8 * b));
+                }
+            }
+        }
+        base += width * rows;
+    }
+
+    if (compress) {
+        out.reserve(size / 2);
+        pack(planes.data(), planes.size(), out);
+    } else {
+        out.swap(planes);
+    }
+}
+
+void decodeChunk(const std::vector<TelemetryColumn>& columns, const uint8_t* data, size_t size,
+                 bool compressed, size_t rows, std::vector<uint64_t>& values) {
+    const size_t expected = rowWidth(columns) * rows;
+    std::vector<uint8_t> planes;
+    if (compressed) {
+        unpack(data, size, planes, expected);
+        data = planes.data();
+    } else if (size != expected) {
+        throw TelemetryError("Telemetry chunk is corrupt: raw payload has the wrong size");
+    }
+
+    values.assign(columns.size() * rows, 0);
+    size_t base = 0;
+    for (size_t c = 0; c < columns.size(); ++c) {
+        const size_t width = widthOf(columns[c].type);
+        uint64_t* column = values.data() + c * rows;
+        uint64_t previous = 0;
+        for (size_t r = 0; r < rows; ++r) {
+            uint64_t word = 0;
+            for (size_t b = 0; b < width; ++b) {
+                const size_t at = compressed ? base + b * rows + r : base + r * width + b;
+                word |= static_cast<uint64_t>(data[at]) << (8 * b);
+            }
+            if (compressed) {
+                word ^= previous;
+                previous = word;
+            }
+            column[r] = word;
+        }
+        base += width * rows;
+    }
+}
+
+}  // namespace telemetry
+
+// ============================================================
+// TelemetryWriter
+// ============================================================
+
+TelemetryWriter::TelemetryWriter(const std::string& path, std::vector<TelemetryColumn> columns, const Options& options)
+    : columns_(std::move(columns)), options_(options) {
+    if (columns_.empty() || columns_[0].name != "time" || columns_[0].type != TelemetryType::Float64) {
+        throw TelemetryError("Telemetry schema must start with a Float64 \"time\" column");
+    }
+    if (options_.rowsPerChunk == 0) {
+        throw TelemetryError("Telemetry chunks need at least one row");
+    }
+    for (const auto& column : columns_) {
+        if (column.name.empty() || column.name.size() > 0xFFFF) {
+            throw TelemetryError("Telemetry column names must be 1 to 65535 bytes");
+        }
+    }
+
+    file_ = std::fopen(path.c_str(), "wb");
+    if (!file_) {
+        throw TelemetryError("Failed to create telemetry file: " + path);
+    }
+
+    writeBytes(kFileMagic, sizeof(kFileMagic));
+    const uint32_t version = telemetry::kVersion;
+    const uint32_t count = static_cast<uint32_t>(columns_.size());
+    writeBytes(&version, sizeof(version));
+    writeBytes(&count, sizeof(count));
+    for (const auto& column : columns_) {
+        const uint8_t type = static_cast<uint8_t>(column.type);
+        const uint16_t length = static_cast<uint16_t>(column.name.size());
+        writeBytes(&type, sizeof(type));
+        writeBytes(&length, sizeof(length));
+        writeBytes(column.name.data(), column.name.size());
+    }
+    if (failed_) {
+        std::fclose(file_);
+        file_ = nullptr;
+        throw TelemetryError("Failed to write telemetry header: " + path);
+    }
+
+    filling_.resize(columns_.size() * options_.rowsPerChunk);
+    writing_.resize(filling_.size());
+    worker_ = std::thread([this]() { run(); });
+}
+
+TelemetryWriter::~TelemetryWriter() {
+    close();
+}
+
+void TelemetryWriter::append(const double* values) {
+    const size_t stride = options_.rowsPerChunk;
+    for (size_t c = 0; c < columns_.size(); ++c) {
+        filling_[c * stride + fillingRows_] = columns_[c].type == TelemetryType::UInt32
+            ? static_cast<uint64_t>(static_cast<uint32_t>(values[c]))
+            : bitsOf(values[c]);
+    }
+    ++rows_;
+    if (++fillingRows_ == stride) {
+        handOff();
+    }
+}
+
+void TelemetryWriter::handOff() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    written_.wait(lock, [this]() { return !writePending_; });
+    filling_.swap(writing_);
+    writingRows_ = fillingRows_;
+    fillingRows_ = 0;
+    writePending_ = true;
+    lock.unlock();
+    ready_.notify_one();
+}
+
+void TelemetryWriter::close() {
+    if (!worker_.joinable()) {
+        return;
+    }
+    if (fillingRows_ > 0) {
+        handOff();
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    ready_.notify_one();
+    worker_.join();
+
+    writeIndex();
+    std::fclose(file_);
+    file_ = nullptr;
+}
+
+void TelemetryWriter::run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        ready_.wait(lock, [this]() { return writePending_ || stop_; });
+        if (writePending_) {
+            // writing_ is ours until writePending_ is cleared
+            lock.unlock();
+            writeChunk(writing_, writingRows_);
+            lock.lock();
+            writePending_ = false;
+            written_.notify_all();
+        } else {
+            break;
+        }
+    }
+}
+
+void TelemetryWriter::writeChunk(const std::vector<uint64_t>& values, size_t rows) {
+    telemetry::encodeChunk(columns_, values.data(), options_.rowsPerChunk, rows, options_.compress, encoded_);
+
+    ChunkHeader header{};
+    header.magic = kChunkMagic;
+    header.rows = static_cast<uint32_t>(rows);
+    header.encoding = options_.compress ? kPacked : kRaw;
+    header.storedSize = encoded_.size();
+    header.firstTime = doubleOf(values[0]);
+    header.lastTime = doubleOf(values[rows - 1]);
+
+    TelemetryChunkInfo info;
+    info.offset = offset_;
+    info.rows = header.rows;
+    info.firstTime = header.firstTime;
+    info.lastTime = header.lastTime;
+
+    writeBytes(&header, sizeof(header));
+    writeBytes(encoded_.data(), encoded_.size());
+    // Complete chunks reach the file even if the process dies before close()
+    std::fflush(file_);
+    if (!failed_) {
+        index_.push_back(info);
+    }
+}
+
+void TelemetryWriter::writeIndex() {
+    const uint64_t indexOffset = offset_;
+    const uint32_t magic = kIndexMagic;
+    const uint32_t count = static_cast<uint32_t>(index_.size());
+    writeBytes(&magic, sizeof(magic));
+    writeBytes(&count, sizeof(count));
+    for (const auto& info : index_) {
+        IndexEntry entry{info.offset, info.rows, 0, info.firstTime, info.lastTime};
+        writeBytes(&entry, sizeof(entry));
+    }
+    writeBytes(&indexOffset, sizeof(indexOffset));
+    writeBytes(kEndMagic, sizeof(kEndMagic));
+}
+
+void TelemetryWriter::writeBytes(const void* data, size_t size) {
+    if (failed_ || size == 0) {
+        return;
+    }
+    if (std::fwrite(data, 1, size, file_) != size) {
+        failed_ = true;
+        return;
+    }
+    offset_ += size;
+}
+
+// ============================================================
+// TelemetryReader
+// ============================================================
+
+TelemetryReader::TelemetryReader(const std::string& path) {
+    try {
+        file_ = MappedFile(path);
+    } catch (const std::runtime_error& e) {
+        throw TelemetryError(std::string("Failed to open telemetry file: ") + e.what());
+    }
+
+    char magic[sizeof(kFileMagic)];
+    uint32_t version = 0;
+    uint32_t count = 0;
+    uint64_t at = 0;
+    auto read = [&](void* out, size_t size) {
+        readAt(at, out, size);
+        at += size;
+    };
+    read(magic, sizeof(magic));
+    if (std::memcmp(magic, kFileMagic, sizeof(magic)) != 0) {
+        throw TelemetryError("Not a telemetry file: " + path);
+    }
+    read(&version, sizeof(version));
+    read(&count, sizeof(count));
+    if (version != telemetry::kVersion) {
+        throw TelemetryError("Unsupported telemetry version in " + path);
+    }
+    if (count > file_.size() / 4) {   // A column takes at least four bytes
+        throw TelemetryError("Telemetry schema is corrupt in " + path);
+    }
+
+    columns_.resize(count);
+    for (auto& column : columns_) {
+        uint8_t type = 0;
+        uint16_t length = 0;
+        read(&type, sizeof(type));
+        read(&length, sizeof(length));
+        if (type > static_cast<uint8_t>(TelemetryType::UInt32)) {
+            throw TelemetryError("Telemetry schema is corrupt in " + path);
+        }
+        column.type = static_cast<TelemetryType>(type);
+        column.name.resize(length);
+        read(&column.name[0], length);
+    }
+    if (columns_.empty() || columns_[0].name != "time") {
+        throw TelemetryError("Telemetry schema is corrupt in " + path);
+    }
+
+    indexed_ = readIndex();
+    if (!indexed_) {
+        scanChunks(at);
+    }
+    for (const auto& chunk : chunks_) {
+        rowCount_ += chunk.rows;
+    }
+}
+
+void TelemetryReader::readAt(uint64_t offset, void* data, size_t size) const {
+    if (offset > file_.size() || size > file_.size() - offset) {
+        throw TelemetryError("Telemetry file is truncated");
+    }
+    if (size > 0) {
+        std::memcpy(data, file_.data() + offset, size);
+    }
+}
+
+bool TelemetryReader::readIndex() {
+    const uint64_t fileSize = file_.size();
+    if (fileSize < kTrailerSize) {
+        return false;
+    }
+    uint64_t indexOffset = 0;
+    char magic[sizeof(kEndMagic)];
+    readAt(fileSize - kTrailerSize, &indexOffset, sizeof(indexOffset));
+    readAt(fileSize - sizeof(kEndMagic), magic, sizeof(magic));
+    if (std::memcmp(magic, kEndMagic, sizeof(magic)) != 0 || indexOffset + 8 > fileSize - kTrailerSize) {
+        return false;
+    }
+
+    uint32_t header[2];
+    readAt(indexOffset, header, sizeof(header));
+    if (header[0] != kIndexMagic ||
+        indexOffset + sizeof(header) + uint64_t(header[1]) * sizeof(IndexEntry) != fileSize - kTrailerSize) {
+        return false;
+    }
+    chunks_.resize(header[1]);
+    uint64_t at = indexOffset + sizeof(header);
+    for (auto& chunk : chunks_) {
+        IndexEntry entry;
+        readAt(at, &entry, sizeof(entry));
+        at += sizeof(entry);
+        chunk.offset = entry.offset;
+        chunk.rows = entry.rows;
+        chunk.firstTime = entry.firstTime;
+        chunk.lastTime = entry.lastTime;
+    }
+    return true;
+}
+
+void TelemetryReader::scanChunks(uint64_t offset) {
+    // Take every chunk that is whole; a crash leaves at most a torn last one
+    const uint64_t fileSize = file_.size();
+    chunks_.clear();
+    while (offset + sizeof(ChunkHeader) <= fileSize) {
+        ChunkHeader header;
+        readAt(offset, &header, sizeof(header));
+        if (header.magic != kChunkMagic || header.rows == 0 ||
+            header.storedSize > fileSize - offset - sizeof(ChunkHeader)) {
+            break;
+        }
+        chunks_.push_back({offset, header.rows, header.firstTime, header.lastTime});
+        offset += sizeof(ChunkHeader) + header.storedSize;
+    }
+}
+
+int TelemetryReader::columnIndex(const std::string& name) const {
+    for (size_t i = 0; i < columns_.size(); ++i) {
+        if (columns_[i].name == name) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+size_t TelemetryReader::findChunk(double time) const {
+    // Last chunk starting at or before `time`; chunks are in time order
+    auto it = std::upper_bound(chunks_.begin(), chunks_.end(), time,
+                               [](double t, const TelemetryChunkInfo& chunk) { return t < chunk.firstTime; });
+    return it == chunks_.begin() ? 0 : static_cast<size_t>(it - chunks_.begin()) - 1;
+}
+
+void TelemetryReader::readChunk(size_t chunk, std::vector<double>& values) const {
+    if (chunk >= chunks_.size()) {
+        throw TelemetryError("Telemetry chunk index out of range");
+    }
+    const TelemetryChunkInfo& info = chunks_[chunk];
+    ChunkHeader header;
+    readAt(info.offset, &header, sizeof(header));
+    const uint64_t payload = info.offset + sizeof(ChunkHeader);
+    if (header.magic != kChunkMagic || header.rows != info.rows || header.storedSize > file_.size() - payload) {
+        throw TelemetryError("Telemetry chunk header is corrupt");
+    }
+
+    // Decoded straight out of the mapping
+    std::vector<uint64_t>& words = words_;
+    telemetry::decodeChunk(columns_, file_.data() + payload, header.storedSize, header.encoding == kPacked,
+                           header.rows, words);
+    values.resize(words.size());
+    for (size_t c = 0; c < columns_.size(); ++c) {
+        const bool integer = columns_[c].type == TelemetryType::UInt32;
+        for (size_t r = 0; r < header.rows; ++r) {
+            const uint64_t word = words[c * header.rows + r];
+            values[c * header.rows + r] = integer ? static_cast<double>(word) : doubleOf(word);
+        }
+    }
+}
+
+namespace telemetry {
+
+void exportCsv(const TelemetryReader& reader, std::ostream& out) {
+    const std::vector<TelemetryColumn>& columns = reader.columns();
+    for (size_t c = 0; c < columns.size(); ++c) {
+        out << (c > 0 ? "," : "") << columns[c].name;
+    }
+    out << '\n';
+
+    const auto precision = out.precision(17);
+    std::vector<double> values;
+    for (size_t chunk = 0; chunk < reader.chunks().size(); ++chunk) {
+        reader.readChunk(chunk, values);
+        const size_t rows = reader.chunks()[chunk].rows;
+        for (size_t r = 0; r < rows; ++r) {
+            for (size_t c = 0; c < columns.size(); ++c) {
+                const double value = values[c * rows + r];
+                out << (c > 0 ? "," : "");
+                if (columns[c].type == TelemetryType::UInt32) {
+                    out << static_cast<uint32_t>(value);
+                } else {
+                    out << value;
+                }
+            }
+            out << '\n';
+        }
+    }
+    out.precision(precision);
+}
+
+}  // namespace telemetry
@@ -0,0 +1,130 @@
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "app/config.h"
+#include "app/headless_runner.h"
+#include "core/job_system.h"
+#include "core/telemetry.h"
+#include "logging/async_logger.h"
+#include "logging/spdlog_logger.h"
+
+namespace {
+
+void usage(const char* program) {
+    std::cerr << "Usage: " << program << " [options]\n"
+              << "  --config PATH      Configuration file (default etc/config.json)\n"
+              << "  --plan PATH        Flight plan, overrides the configuration's\n"
+              << "  --duration SEC     Simulated seconds to run (default 600)\n"
+              << "  --step SEC         Simulated seconds per physics step (default 0.05)\n"
+              << "  --telemetry PATH   Record binary telemetry of every body and the rocket to PATH\n"
+              << "  --interval SEC     Simulated seconds between telemetry rows (default 1)\n"
+              << "  --csv PATH         Also convert the recorded telemetry to CSV at PATH\n"
+              << "  --restore PATH     Start from the checkpoint at PATH\n"
+              << "  --checkpoint PATH  Save a checkpoint to PATH at the end of the run\n"
+              << "  --threads N        Job system threads, 0 for all cores (default: configuration)\n"
+              << "  --no-launch        Leave the rocket on the pad\n";
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    std::string configPath = "etc/config.json";
+    std::string planPath;
+    std::string csvPath;
+    long threads = -1;
+    HeadlessOptions options;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            const std::string arg = argv[i];
+            auto value = [&]() -> std::string {
+                if (i + 1 >= argc) {
+                    throw std::invalid_argument("Missing value for " + arg);
+                }
+                return argv[++i];
+            };
+            if (arg == "--config") {
+                configPath = value();
+            } else if (arg == "--plan") {
+                planPath = value();
+            } else if (arg == "--duration") {
+                options.duration = std::stod(value());
+            } else if (arg == "--step") {
+                options.step = std::stod(value());
+            } else if (arg == "--telemetry") {
+                options.telemetryPath = value();
+            } else if (arg == "--csv") {
+                csvPath = value();
+            } else if (arg == "--restore") {
+                options.restorePath = value();
+            } else if (arg == "--checkpoint") {
+                options.checkpointPath = value();
+            } else if (arg == "--interval") {
+                options.telemetryInterval = std::stod(value());
+            } else if (arg == "--threads") {
+                threads = std::stol(value());
+            } else if (arg == "--no-launch") {
+                options.launch = false;
+            } else if (arg == "--help" || arg == "-h") {
+                usage(argv[0]);
+                return 0;
+            } else {
+                throw std::invalid_argument("Unknown option " + arg);
+            }
+        }
+        if (!csvPath.empty() && options.telemetryPath.empty()) {
+            throw std::invalid_argument("--csv converts the --telemetry recording; give both");
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        usage(argv[0]);
+        return 2;
+    }
+
+    try {
+        Config config;
+        config.loadFromFile(configPath);
+        if (!planPath.empty()) {
+            config.flight_plan_path = planPath;
+        }
+        std::shared_ptr<ILogger> logger = std::make_shared<SpdlogLogger>();
+        if (config.logger_async) {
+            logger = std::make_shared<AsyncLogger>(logger, config.logger_block_when_full
+                ? AsyncLogger::Overflow::Block : AsyncLogger::Overflow::Drop);
+        }
+        JobSystem jobs(threads >= 0 ? static_cast<unsigned>(threads) : config.simulation_job_threads);
+
+        HeadlessRunner runner(config, logger, options);
+        runner.setJobSystem(&jobs);
+        HeadlessResult result = runner.run();
+        if (!csvPath.empty()) {
+            std::ofstream csv(csvPath);
+            if (!csv) {
+                throw std::runtime_error("Failed to open CSV file: " + csvPath);
+            }
+            telemetry::exportCsv(TelemetryReader(options.telemetryPath), csv);
+        }
+
+        std::cout << "Simulated " << result.simulatedTime << " s in " << result.steps << " steps, "
+                  << result.wallTime << " s wall (" << result.simulatedTime / std::max(result.wallTime, 1e-9)
+                  << "x real time) on " << jobs.concurrency() << " threads";
+        if (!options.telemetryPath.empty()) {
+            std::cout << ", " << result.telemetryRows << " telemetry rows recorded to " << options.telemetryPath;
+        }
+        if (result.crashed) {
+            std::cout << ", rocket crashed";
+        }
+        if (!options.checkpointPath.empty()) {
+            std::cout << ", checkpoint saved to " << options.checkpointPath;
+        }
+        std::cout << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,121 @@
+#include "logging/async_logger.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+AsyncLogger::AsyncLogger(std::shared_ptr<ILogger> sink, Overflow overflow)
+    : sink_(std::move(sink)), overflow_(overflow), queue_(std::make_unique<MpscQueue<Record, kQueueCapacity>>()) {
+    if (!sink_) {
+        throw std::invalid_argument("AsyncLogger: sink cannot be null");
+    }
+    worker_ = std::thread([this]() { run(); });
+}
+
+AsyncLogger::~AsyncLogger() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    wake_.notify_one();
+    worker_.join();
+}
+
+void AsyncLogger::copyText(char* out, uint16_t& length, size_t capacity, const std::string& text) {
+    size_t n = std::min(text.size(), capacity);
+    if (n < text.size()) {
+        truncated_.fetch_add(1, std::memory_order_relaxed);
+    }
+    std::memcpy(out, text.data(), n);
+    length = static_cast<uint16_t>(n);
+}
+
+template <typename Fill>
+void AsyncLogger::enqueue(Fill&& fill) {
+    while (true) {
+        const uint64_t written = written_.load(std::memory_order_acquire);
+        if (queue_->emplace(fill)) {
+            break;
+        }
+        if (overflow_ == Overflow::Drop || stop_.load(std::memory_order_relaxed)) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        // Block: wait for the background thread to write some out
+        std::unique_lock<std::mutex> lock(mutex_);
+        progress_.wait(lock, [&]() {
+            return written_.load(std::memory_order_acquire) != written || stop_.load(std::memory_order_relaxed);
+        });
+    }
+
+    // Wake the background thread only if it went to sleep. Pairs with the
+    // fence in run(): either it sees the record or this sees the flag.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (sleeping_.load(std::memory_order_relaxed)) {
+        { std::lock_guard<std::mutex> lock(mutex_); }
+        wake_.notify_one();
+    }
+}
+
+void AsyncLogger::log(LogLevel level, const std::string& module, const std::string& message) {
+    enqueue([&](Record& record) {
+        record.level = level;
+        copyText(record.module, record.moduleLength, kModuleLength, module);
+        copyText(record.message, record.messageLength, kMessageLength, message);
+    });
+}
+
+void AsyncLogger::set_level(LogLevel level) {
+    setThreshold(level);
+    sink_->set_level(level);
+}
+
+void AsyncLogger::flush() {
+    // Records are written in queue order, so everything queued before the
+    // call is out once the background thread has passed where the queue ended
+    const uint64_t target = queue_->claimed();
+    std::unique_lock<std::mutex> lock(mutex_);
+    progress_.wait(lock, [&]() { return written_.load(std::memory_order_acquire) >= target; });
+}
+
+size_t AsyncLogger::drain() {
+    Record record;
+    size_t count = 0;
+    while (queue_->pop(record)) {
+        sink_->log(record.level, std::string(record.module, record.moduleLength),
+                   std::string(record.message, record.messageLength));
+        written_.fetch_add(1, std::memory_order_release);
+        ++count;
+    }
+    return count;
+}
+
+void AsyncLogger::notifyProgress() {
+    // Through the mutex, so a waiter between its check and its wait is not missed
+    { std::lock_guard<std::mutex> lock(mutex_); }
+    progress_.notify_all();
+}
+
+void AsyncLogger::run() {
+    while (true) {
+        if (drain() > 0) {
+            notifyProgress();
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (stop_) {
+            break;
+        }
+        // Sleep until a producer or the destructor wakes us. The second look
+        // catches a record published before the flag went up.
+        sleeping_.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!queue_->readable()) {
+            wake_.wait(lock);
+        }
+        sleeping_.store(false, std::memory_order_relaxed);
+    }
+    // Producers that raced the stop flag
+    drain();
+    notifyProgress();
+}
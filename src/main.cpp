@@ -1,17 +1,38 @@
 #include <iostream>
+#include <string>
 
 #include "app/app.h"
 #include "app/config.h"
+#include "logging/async_logger.h"
 #include "logging/spdlog_logger.h"
 
 
-int main() {
+int main(int argc, char** argv) {
     try {
+        // --replay PATH plays a telemetry recording back instead of flying
+        std::string replayPath;
+        for (int i = 1; i < argc; ++i) {
+            const std::string arg = argv[i];
+            if (arg == "--replay" && i + 1 < argc) {
+                replayPath = argv[++i];
+            } else {
+                std::cerr << "Usage: " << argv[0] << " [--replay PATH]" << std::endl;
+                return -1;
+            }
+        }
+
         Config config;
         config.loadFromFile("etc/config.json");
-        auto logger = std::make_shared<SpdlogLogger>();
+        if (!replayPath.empty()) {
+            config.telemetry_enabled = false;   // Never record over the file being played
+        }
+        std::shared_ptr<ILogger> logger = std::make_shared<SpdlogLogger>();
+        if (config.logger_async) {
+            logger = std::make_shared<AsyncLogger>(logger, config.logger_block_when_full
+                ? AsyncLogger::Overflow::Block : AsyncLogger::Overflow::Drop);
+        }
         auto camera = Camera(config);
-        App app("Rocket Simulation", 800, 600, config, logger, camera);
+        App app("Rocket Simulation", 800, 600, config, logger, camera, replayPath);
         app.run();
     } catch (const std::exception& e) {
         std::cerr << "Error: " << e.what() << std::endl;
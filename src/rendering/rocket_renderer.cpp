@@ -0,0 +1,236 @@
+#include "rendering/rocket_renderer.h"
+#include "rendering/trajectory_factory.h"
+
+#include <glm/ext.hpp>
+#include <algorithm>
+#include <cmath>
+
+RocketRenderer::RocketRenderer(const Config& config, std::shared_ptr<ILogger> logger)
+    : config_(config), logger_(std::move(logger)) {}
+
+void RocketRenderer::init() {
+    // Rocket 3D pyramid vertices (in rendering units: km)
+    // Made larger so it's visible at typical camera distances (100-500 km)
+    // Pyramid with tip pointing in +Y direction (forward)
+    // Center the pyramid so rotation works correctly around origin
+    const float baseSize = 10.0f;  // Base width/depth: 20 km (±10 km)
+    const float height = 50.0f;    // Height: 50 km
+    const float tipY = height * 0.75f;   // Tip at 3/4 height above center
+    const float baseY = -height * 0.25f; // Base at 1/4 height below center
+    
+    std::vector<GLfloat> vertices = {
+        // Tip of the pyramid (forward direction)
+        0.0f, tipY, 0.0f,                 // 0: Tip
+        
+        // Base vertices (square)
+        -baseSize, baseY, -baseSize,      // 1: Back-left
+        baseSize, baseY, -baseSize,       // 2: Back-right
+        baseSize, baseY, baseSize,        // 3: Front-right
+        -baseSize, baseY, baseSize        // 4: Front-left
+    };
+    
+    // Indices for 4 triangular faces + 2 triangles for base
+    std::vector<GLuint> indices = {
+        // Side faces (4 triangles from tip to base edges)
+        0, 4, 3,  // Front face
+        0, 3, 2,  // Right face
+        0, 2, 1,  // Back face
+        0, 1, 4,  // Left face
+        
+        // Base (2 triangles to close the bottom)
+        1, 2, 3,
+        1, 3, 4
+    };
+    
+    if (!renderObject_)
+        renderObject_ = std::make_unique<RenderObject>(vertices, indices);
+
+    if(!trajectory_)
+        trajectory_ = TrajectoryFactory::createRocketTrajectory(config_, logger_);
+    trajectory_->init();
+
+    if(!prediction_)
+        prediction_ = TrajectoryFactory::createRocketPredictionTrajectory(config_, logger_);
+    prediction_->init();
+}
+
+void RocketRenderer::syncRender(const RocketSnapshot& state) {
+    // Flown path: sampled at the published states, on the rocket's clock
+    float elapsed = state.time - renderedTime_;
+    renderedTime_ = state.time;
+    if (trajectory_ && state.launched && elapsed > 0.0f) {
+        trajectory_->update(toRender(state.position), elapsed);
+    }
+
+    // A new prediction replaces the drawn one
+    const PredictionSnapshot* prediction = state.prediction.get();
+    if (!prediction || prediction->revision == renderedPrediction_) {
+        return;
+    }
+    renderedPrediction_ = prediction->revision;
+    if (prediction_) {
+        prediction_->reset();
+        for (const glm::vec3& point : prediction->points) {
+            // Pass renderInterval as deltaTime to ensure point is added
+            // (must be >= sampleInterval in Trajectory config)
+            prediction_->update(point, prediction->renderInterval);
+        }
+    }
+    if (!prediction->uncertainty.empty() || !uncertainty_.empty()) {
+        updateUncertaintyOutlines(prediction->uncertainty);
+    }
+}
+
+void RocketRenderer::saveTrail(TrailCheckpoint& trail) const {
+    trail.name = "rocket";
+    if (trajectory_) {
+        trail.sampleTimer = trajectory_->getSampleTimer();
+        trail.points = trajectory_->getHistory();
+    }
+}
+
+void RocketRenderer::restoreTrail(const TrailCheckpoint* trail, float rocketTime) {
+    if (trajectory_) {
+        if (trail) {
+            trajectory_->restoreHistory(trail->points, trail->sampleTimer);
+        } else {
+            trajectory_->restoreHistory({}, 0.0f);
+        }
+    }
+    renderedTime_ = rocketTime;
+}
+
+void RocketRenderer::render(const Shader& shader, const glm::dvec3& renderOrigin, const RocketSnapshot& state) const {
+
+    // Calculate rotation matrix to align rocket with velocity direction
+    glm::mat4 model = glm::mat4(1.0f);
+    
+    // Calculate velocity direction in rendering coordinate system
+    // Use numerical differentiation: direction = d(toRender)/dt
+    // which is approximately (toRender(pos + vel*dt) - toRender(pos)) / dt
+    glm::vec3 direction;
+    if (glm::length(state.velocity) > 0.1) {
+        // Small time step for numerical derivative
+        const double dt = 0.01;  // 10ms
+        
+        // Current render position (relative to renderOrigin)
+        glm::vec3 currentRenderPos = glm::vec3((state.position - renderOrigin) * static_cast<double>(config_.simulation_rendering_scale));
+        
+        // Future position in physics coordinates
+        glm::dvec3 futurePhysicsPos = state.position + state.velocity * dt;
+        
+        // Future render position (relative to renderOrigin)
+        glm::vec3 futureRenderPos = glm::vec3((futurePhysicsPos - renderOrigin) * static_cast<double>(config_.simulation_rendering_scale));
+        
+        // Velocity direction in render coordinates
+        glm::vec3 renderVelocity = futureRenderPos - currentRenderPos;
+        
+        if (glm::length(renderVelocity) > 0.0001f) {
+            direction = glm::normalize(renderVelocity);
+        } else {
+            direction = glm::vec3(0.0f, 1.0f, 0.0f);  // Default upward
+        }
+    } else {
+        // When stationary, point upward (in rendering Y direction)
+        direction = glm::vec3(0.0f, 1.0f, 0.0f);
+    }
+    
+    // Default forward direction is +Y (the pyramid tip points in +Y)
+    glm::vec3 defaultForward = glm::vec3(0.0f, 1.0f, 0.0f);
+    
+    // Calculate rotation from default forward to actual direction
+    float dotProduct = glm::dot(defaultForward, direction);
+    
+    // Build rotation matrix first
+    glm::mat4 rotation = glm::mat4(1.0f);
+    if (dotProduct < -0.999f) {
+        // Nearly opposite direction: rotate 180 degrees around any perpendicular axis
+        glm::vec3 rotAxis = glm::vec3(1.0f, 0.0f, 0.0f);  // Use X axis
+        rotation = glm::rotate(glm::mat4(1.0f), glm::pi<float>(), rotAxis);
+    } else if (dotProduct < 0.999f) {
+        // General case: calculate rotation axis and angle
+        glm::vec3 rotAxis = glm::cross(defaultForward, direction);
+        float rotAxisLen = glm::length(rotAxis);
+        if (rotAxisLen > 0.0001f) {
+            rotAxis = glm::normalize(rotAxis);
+            float angle = acos(glm::clamp(dotProduct, -1.0f, 1.0f));
+            rotation = glm::rotate(glm::mat4(1.0f), angle, rotAxis);
+        }
+    }
+    // If dotProduct >= 0.999f, no rotation needed (already aligned)
+    
+    // Apply transformations: first rotate (around origin), then translate
+    // Position is computed relative to renderOrigin for float precision
+    glm::vec3 relativePos = glm::vec3((state.position - renderOrigin) * static_cast<double>(config_.simulation_rendering_scale));
+    model = glm::translate(model, relativePos);
+    model = model * rotation;
+    
+    shader.setMat4("model", model);
+    shader.setVec4("color", glm::vec4(0.8f, 0.8f, 0.8f, 1.0f));
+    if (renderObject_) 
+        renderObject_->render();
+
+    // Render trajectory (delegated to RenderObject)
+    if (trajectory_)
+        trajectory_->render(shader);
+
+    // Render prediction trajectory (delegated to RenderObject)
+    if (prediction_)
+        prediction_->render(shader);
+
+    // Error ellipsoids along the prediction
+    for (const auto& outline : uncertainty_) {
+        outline->render(shader);
+    }
+}
+
+// For unit tests
+void RocketRenderer::setRender(std::unique_ptr<IRenderObject> render) {
+    renderObject_ = std::move(render);
+}
+
+void RocketRenderer::setTrajectoryRender(std::unique_ptr<IRenderObject> trajectory, std::unique_ptr<IRenderObject> prediction) {
+    if (!trajectory_) {
+        trajectory_ = TrajectoryFactory::createRocketTrajectory(config_, logger_);
+    }
+    trajectory_->setRenderObject(std::move(trajectory));
+
+    if (!prediction_) {
+        prediction_ = TrajectoryFactory::createRocketTrajectory(config_, logger_);
+    }
+    prediction_->setRenderObject(std::move(prediction));
+}
+
+// private
+
+glm::vec3 RocketRenderer::toRender(const glm::dvec3& position) const {
+    // In heliocentric coordinate system, just scale the position
+    return glm::vec3(position * static_cast<double>(config_.simulation_rendering_scale));
+}
+
+void RocketRenderer::updateUncertaintyOutlines(const std::vector<ErrorEllipsoid>& ellipsoids) {
+    constexpr double kSigmas[2] = {1.0, 3.0};
+    constexpr int kSegments = 32;
+    const size_t pointsPerOutline = 3 * kSegments + 2 * (kSegments / 4);
+
+    uncertainty_.resize(std::min(uncertainty_.size(), 2 * ellipsoids.size()));
+    for (size_t i = 0; i < ellipsoids.size(); ++i) {
+        for (int k = 0; k < 2; ++k) {
+            size_t slot = 2 * i + k;
+            if (slot == uncertainty_.size()) {
+                glm::vec4 color = config_.trajectory_covariance_color;
+                if (kSigmas[k] > 1.0) {
+                    color.a *= 0.5f;
+                }
+                uncertainty_.push_back(TrajectoryFactory::createCustomTrajectory(
+                    config_, logger_, pointsPerOutline, 0.0f, color, Trajectory::RenderMode::LineLoop));
+            }
+            std::vector<glm::vec3> points;
+            points.reserve(pointsPerOutline);
+            for (const glm::dvec3& p : ellipsoids[i].outline(kSigmas[k], kSegments)) {
+                points.push_back(toRender(p));
+            }
+            uncertainty_[slot]->setPoints(std::move(points));
+        }
+    }
+}
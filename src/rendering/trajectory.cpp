@@ -1,6 +1,7 @@
 #include "rendering/trajectory.h"
 #include <GL/glew.h>
 #include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
 
 Trajectory::Trajectory(const Config& config)
     : config_(config), head_(0), count_(0), sampleTimer_(0.0f) {
@@ -96,6 +97,21 @@ void Trajectory::markDirty(size_t index) {
     }
 }
 
+void Trajectory::uploadRange(size_t first, size_t count) {
+    // Staging is kept between flushes, so a steady trail uploads without allocating
+    staging_.resize(count * 3);
+    for (size_t i = 0; i < count; ++i) {
+        const auto& p = points_[first + i];
+        staging_[i * 3 + 0] = p.x;
+        staging_[i * 3 + 1] = p.y;
+        staging_[i * 3 + 2] = p.z;
+    }
+    renderObject_->updateBuffer(
+        static_cast<GLintptr>(first * 3 * sizeof(GLfloat)),
+        static_cast<GLsizei>(staging_.size() * sizeof(GLfloat)),
+        staging_.data());
+}
+
 void Trajectory::flushToGPU() {
     if (!dirty_ || !renderObject_) {
         return;
@@ -103,50 +119,17 @@ void Trajectory::flushToGPU() {
 
     if (!dirtyWrapped_) {
         // Contiguous region: single upload
-        size_t startOffset = dirtyStart_ * 3 * sizeof(GLfloat);
-        size_t count = dirtyEnd_ - dirtyStart_;
-        std::vector<GLfloat> buffer(count * 3);
-        for (size_t i = 0; i < count; ++i) {
-            const auto& p = points_[dirtyStart_ + i];
-            buffer[i * 3 + 0] = p.x;
-            buffer[i * 3 + 1] = p.y;
-            buffer[i * 3 + 2] = p.z;
-        }
-        renderObject_->updateBuffer(
-            static_cast<GLintptr>(startOffset),
-            static_cast<GLsizei>(buffer.size() * sizeof(GLfloat)),
-            buffer.data());
+        uploadRange(dirtyStart_, dirtyEnd_ - dirtyStart_);
     } else {
         // Wrapped region: two uploads (tail portion + head portion)
         // Part 1: from dirtyStart_ to end of buffer
         size_t tailCount = config_.maxPoints - dirtyStart_;
         if (tailCount > 0) {
-            size_t startOffset = dirtyStart_ * 3 * sizeof(GLfloat);
-            std::vector<GLfloat> buffer(tailCount * 3);
-            for (size_t i = 0; i < tailCount; ++i) {
-                const auto& p = points_[dirtyStart_ + i];
-                buffer[i * 3 + 0] = p.x;
-                buffer[i * 3 + 1] = p.y;
-                buffer[i * 3 + 2] = p.z;
-            }
-            renderObject_->updateBuffer(
-                static_cast<GLintptr>(startOffset),
-                static_cast<GLsizei>(buffer.size() * sizeof(GLfloat)),
-                buffer.data());
+            uploadRange(dirtyStart_, tailCount);
         }
         // Part 2: from 0 to dirtyEnd_
         if (dirtyEnd_ > 0) {
-            std::vector<GLfloat> buffer(dirtyEnd_ * 3);
-            for (size_t i = 0; i < dirtyEnd_; ++i) {
-                const auto& p = points_[i];
-                buffer[i * 3 + 0] = p.x;
-                buffer[i * 3 + 1] = p.y;
-                buffer[i * 3 + 2] = p.z;
-            }
-            renderObject_->updateBuffer(
-                0,
-                static_cast<GLsizei>(buffer.size() * sizeof(GLfloat)),
-                buffer.data());
+            uploadRange(0, dirtyEnd_);
         }
     }
 
@@ -162,7 +145,6 @@ void Trajectory::render(const Shader& shader) const {
 }
 
 void Trajectory::render(const Shader& shader, const glm::vec3& center) const {
-    LOG_DEBUG(logger_, "Trajectory", "render");
     if (count_ == 0) {
         return;
     }
@@ -239,4 +221,32 @@ void Trajectory::setPoints(std::vector<glm::vec3> points) {
     count_ = points_.size();
     updateRenderObject();
     LOG_INFO(logger_, "Trajectory", "setPoints: head_=" + std::to_string(head_) + ", count_=" + std::to_string(count_));
-}
\ No newline at end of file
+}
+
+std::vector<glm::vec3> Trajectory::getHistory() const {
+    std::vector<glm::vec3> history;
+    if (points_.size() != config_.maxPoints) {
+        return history;   // Not initialized
+    }
+    history.reserve(count_);
+    const size_t first = (head_ + config_.maxPoints - count_) % config_.maxPoints;
+    for (size_t i = 0; i < count_; ++i) {
+        history.push_back(points_[(first + i) % config_.maxPoints]);
+    }
+    return history;
+}
+
+void Trajectory::restoreHistory(const std::vector<glm::vec3>& points, float sampleTimer) {
+    const size_t keep = std::min(points.size(), config_.maxPoints);
+    points_.assign(config_.maxPoints, glm::vec3(0.0f));
+    std::copy(points.end() - static_cast<std::ptrdiff_t>(keep), points.end(), points_.begin());
+    head_ = keep % config_.maxPoints;
+    count_ = keep;
+    sampleTimer_ = sampleTimer;
+
+    // The whole ring goes up on the next render
+    dirty_ = true;
+    dirtyStart_ = 0;
+    dirtyEnd_ = config_.maxPoints;
+    dirtyWrapped_ = false;
+}
@@ -1,9 +1,12 @@
 #include "ui/input_handler.h"
 #include "core/simulation.h"
+#include "ui/replay_panel.h"
+
+#include <algorithm>
 
 InputHandler::InputHandler(GLFWwindow* win, Simulation& sim, const Config& config) 
     : window(win), simulation(sim), rotationSpeed(config.rocket_rotation_speed), 
-      directionCooldown(config.rocket_direction_cooldown), lastX(400.0f), lastY(300.0f), 
+      directionCooldown(config.rocket_direction_cooldown), checkpointPath(config.checkpoint_path), lastX(400.0f), lastY(300.0f), 
       firstMouse(true), mouseSensitivity(0.1f) {
     glfwSetWindowUserPointer(window, this);
     glfwSetCursorPosCallback(window, [](GLFWwindow* w, double xpos, double ypos) {
@@ -29,18 +32,38 @@ void InputHandler::process(Simulation& sim) {
     if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS) {
         glfwSetWindowShouldClose(window, true);
     }
+    // Replay: Space plays/pauses, Q/E double/halve the playback speed, R resets it to 1x.
+    // Nothing is posted to the simulation, whose physics is not running
+    if (replay_) {
+        if (isKeyPressedWithCooldown(GLFW_KEY_SPACE, 0.2)) {
+            if (!replay_->playing() && replay_->time() >= replay_->endTime()) {
+                replay_->seek(replay_->startTime());
+            }
+            replay_->setPlaying(!replay_->playing());
+        }
+        if (isKeyPressedWithCooldown(GLFW_KEY_Q, 0.2)) {
+            replay_->setSpeed(std::min(replay_->speed() * 2.0, ReplayPanel::kMaxSpeed));
+        }
+        if (isKeyPressedWithCooldown(GLFW_KEY_E, 0.2)) {
+            replay_->setSpeed(std::max(replay_->speed() * 0.5, ReplayPanel::kMinSpeed));
+        }
+        if (isKeyPressedWithCooldown(GLFW_KEY_R, 0.2)) {
+            replay_->setSpeed(1.0);
+        }
+    }
+
     // Time scale controls: Q/E for fine adjustment, Shift+Q/E for coarse adjustment
     bool shiftPressed = (glfwGetKey(window, GLFW_KEY_LEFT_SHIFT) == GLFW_PRESS || 
                          glfwGetKey(window, GLFW_KEY_RIGHT_SHIFT) == GLFW_PRESS);
-    if (isKeyPressedWithCooldown(GLFW_KEY_Q, 0.05)) {
-        sim.adjustTimeScale(shiftPressed ? 10.0f : 0.1f);  // Coarse or fine adjustment
+    if (!replay_ && isKeyPressedWithCooldown(GLFW_KEY_Q, 0.05)) {
+        sim.post({SimulationCommand::Type::AdjustTimeScale, shiftPressed ? 10.0 : 0.1});  // Coarse or fine adjustment
     }
-    if (isKeyPressedWithCooldown(GLFW_KEY_E, 0.05)) {
-        sim.adjustTimeScale(shiftPressed ? -10.0f : -0.1f);  // Coarse or fine adjustment
+    if (!replay_ && isKeyPressedWithCooldown(GLFW_KEY_E, 0.05)) {
+        sim.post({SimulationCommand::Type::AdjustTimeScale, shiftPressed ? -10.0 : -0.1});  // Coarse or fine adjustment
     }
     // R - Reset time scale to 1.0
-    if (isKeyPressedWithCooldown(GLFW_KEY_R, 0.2)) {
-        sim.setTimeScale(1.0f);
+    if (!replay_ && isKeyPressedWithCooldown(GLFW_KEY_R, 0.2)) {
+        sim.post({SimulationCommand::Type::SetTimeScale, 1.0});
     }
     if (isKeyPressedWithCooldown(GLFW_KEY_W, 0.01)) {
         sim.adjustCameraDistance(-100.0f);
@@ -48,31 +71,25 @@ void InputHandler::process(Simulation& sim) {
     if (isKeyPressedWithCooldown(GLFW_KEY_S, 0.01)) {
         sim.adjustCameraDistance(100.0f);
     }
-    if (isKeyPressedWithCooldown(GLFW_KEY_SPACE, 0.2)) {
-        sim.getRocket().toggleLaunch();
+    if (!replay_ && isKeyPressedWithCooldown(GLFW_KEY_SPACE, 0.2)) {
+        sim.post({SimulationCommand::Type::ToggleLaunch});
     }
     
-    if (isKeyPressedWithCooldown(GLFW_KEY_A, directionCooldown)) {
-        Rocket& rocket = sim.getRocket();
-        glm::dvec3 currentDir = rocket.getThrustDirection();
-        glm::dmat4 rotation = glm::rotate(
-            glm::dmat4(1.0),
-            glm::radians(rotationSpeed * directionCooldown),
-            glm::dvec3(0.0, 0.0, 1.0)
-        );        
-        glm::dvec3 newDir = glm::dvec3(rotation * glm::dvec4(currentDir, 0.0));
-        rocket.setThrustDirection(newDir);
-    }
-    if (isKeyPressedWithCooldown(GLFW_KEY_D, directionCooldown)) {
-        Rocket& rocket = sim.getRocket();
-        glm::dvec3 currentDir = rocket.getThrustDirection();
-        glm::dmat4 rotation = glm::rotate(
-            glm::dmat4(1.0),
-            glm::radians(-rotationSpeed * directionCooldown),
-            glm::dvec3(0.0, 0.0, 1.0)
-        );
-        glm::dvec3 newDir = glm::dvec3(rotation * glm::dvec4(currentDir, 0.0));
-        rocket.setThrustDirection(newDir);
+    // Thrust direction is rotated on the physics side, from its current value
+    if (!replay_ && isKeyPressedWithCooldown(GLFW_KEY_A, directionCooldown)) {
+        sim.post({SimulationCommand::Type::RotateThrust, glm::radians(rotationSpeed * directionCooldown)});
+    }
+
+    if (!replay_ && isKeyPressedWithCooldown(GLFW_KEY_D, directionCooldown)) {
+        sim.post({SimulationCommand::Type::RotateThrust, glm::radians(-rotationSpeed * directionCooldown)});
+    }
+
+    // F5 - Save a checkpoint, F9 - Restore it
+    if (!replay_ && isKeyPressedWithCooldown(GLFW_KEY_F5, 0.5)) {
+        sim.saveCheckpoint(checkpointPath);
+    }
+    if (!replay_ && isKeyPressedWithCooldown(GLFW_KEY_F9, 0.5)) {
+        sim.restoreCheckpoint(checkpointPath);
     }
 
     // Camera mode switching
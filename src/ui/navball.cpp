@@ -306,7 +306,7 @@ float NavBall::angleBetween(const glm::vec3& a, const glm::vec3& b) const {
     return glm::degrees(std::acos(cosAngle));
 }
 
-void NavBall::render(const Rocket& rocket, const glm::vec3& earthPos,
+void NavBall::render(const RocketSnapshot& rocket, const glm::vec3& earthPos,
                       float panelX, float panelY, float size) {
     ImGui::SetNextWindowPos(ImVec2(panelX, panelY), ImGuiCond_Always);
     ImGui::SetNextWindowSize(ImVec2(size + 60, size + 140), ImGuiCond_Always);
@@ -317,9 +317,9 @@ void NavBall::render(const Rocket& rocket, const glm::vec3& earthPos,
     ImGui::Begin("NavBall", nullptr, flags);
     
     // Get rocket data (convert dvec3 to vec3 for rendering)
-    glm::vec3 position = glm::vec3(rocket.getPosition());
-    glm::vec3 velocity = glm::vec3(rocket.getVelocity());
-    glm::vec3 thrustDir = glm::vec3(rocket.getThrustDirection());
+    glm::vec3 position = glm::vec3(rocket.position);
+    glm::vec3 velocity = glm::vec3(rocket.velocity);
+    glm::vec3 thrustDir = glm::vec3(rocket.thrustDirection);
     
     // Calculate orbital reference frame
     OrbitalFrame frame = calculateOrbitalFrame(position, velocity, earthPos);
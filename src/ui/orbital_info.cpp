@@ -1,11 +1,9 @@
 #include "ui/orbital_info.h"
-#include "core/body.h"
 
 #include <algorithm>
 #include <cmath>
 
-void OrbitalInfo::render(const Rocket& rocket, const BODY_MAP& bodies,
-                          float panelX, float panelY) {
+void OrbitalInfo::render(const SimulationSnapshot& state, float panelX, float panelY) {
     ImGui::SetNextWindowPos(ImVec2(panelX, panelY), ImGuiCond_Always);
     ImGui::SetNextWindowSize(ImVec2(220.0f, 400.0f), ImGuiCond_Always);
     
@@ -15,19 +13,20 @@ void OrbitalInfo::render(const Rocket& rocket, const BODY_MAP& bodies,
     ImGui::Begin("Orbital Info", nullptr, flags);
     
     // Get rocket state (already in double precision)
-    glm::dvec3 rocketPos = rocket.getPosition();
-    glm::dvec3 rocketVel = rocket.getVelocity();
+    glm::dvec3 rocketPos = state.rocket.position;
+    glm::dvec3 rocketVel = state.rocket.velocity;
     
-    // Find the dominant body (the one we're orbiting)
-    std::string dominantBodyName = findDominantBody(rocketPos, bodies);
+    // Find the dominant body (innermost sphere of influence)
+    int dominant = state.dominantBody(rocketPos);
     
-    if (dominantBodyName.empty() || bodies.find(dominantBodyName) == bodies.end()) {
+    if (dominant < 0) {
         ImGui::Text("No reference body found");
         ImGui::End();
         return;
     }
     
-    const auto& centralBody = bodies.at(dominantBodyName);
+    const BodySnapshot* centralBody = &state.bodies[dominant];
+    const std::string& dominantBodyName = centralBody->name;
     glm::dvec3 centralPos = centralBody->position;
     
     // Calculate position and velocity relative to central body
@@ -151,64 +150,6 @@ void OrbitalInfo::render(const Rocket& rocket, const BODY_MAP& bodies,
     ImGui::End();
 }
 
-std::string OrbitalInfo::findDominantBody(const glm::dvec3& position, const BODY_MAP& bodies) const {
-    // Simple sphere of influence check
-    // SOI ≈ a * (m/M)^(2/5) where a is semi-major axis, m is body mass, M is parent mass
-    
-    std::string dominant = "";
-    double minInfluence = std::numeric_limits<double>::max();
-    
-    // First, check if we're in any moon's SOI
-    if (bodies.find("moon") != bodies.end() && bodies.find("earth") != bodies.end()) {
-        const auto& moon = bodies.at("moon");
-        const auto& earth = bodies.at("earth");
-        
-        double moonDist = glm::length(position - moon->position);
-        double earthMoonDist = glm::length(moon->position - earth->position);
-        
-        // Moon's SOI relative to Earth
-        double moonSOI = earthMoonDist * std::pow(moon->mass / earth->mass, 0.4);
-        
-        if (moonDist < moonSOI) {
-            return "moon";
-        }
-    }
-    
-    // Check planets' SOI relative to Sun
-    if (bodies.find("sun") != bodies.end()) {
-        const auto& sun = bodies.at("sun");
-        
-        std::vector<std::string> planets = {"mercury", "venus", "earth", "mars", 
-                                             "jupiter", "saturn", "uranus", "neptune"};
-        
-        for (const auto& planetName : planets) {
-            if (bodies.find(planetName) == bodies.end()) continue;
-            
-            const auto& planet = bodies.at(planetName);
-            double planetDist = glm::length(position - planet->position);
-            double sunPlanetDist = glm::length(planet->position - sun->position);
-            
-            // Planet's SOI relative to Sun
-            double planetSOI = sunPlanetDist * std::pow(planet->mass / sun->mass, 0.4);
-            
-            if (planetDist < planetSOI && planetDist < minInfluence) {
-                minInfluence = planetDist;
-                dominant = planetName;
-            }
-        }
-        
-        // If not in any planet's SOI, use Sun
-        if (dominant.empty()) {
-            dominant = "sun";
-        }
-    } else {
-        // Fallback: use Earth
-        dominant = "earth";
-    }
-    
-    return dominant;
-}
-
 void OrbitalInfo::renderElement(const char* label, const std::string& value, ImU32 color) const {
     ImGui::TextColored(ImVec4(0.7f, 0.7f, 0.7f, 1.0f), "%s:", label);
     ImGui::SameLine();
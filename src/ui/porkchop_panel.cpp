@@ -0,0 +1,233 @@
+#include "ui/porkchop_panel.h"
+#include "core/body.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <thread>
+
+namespace {
+
+const double kDay = 86400.0;
+const float kContourStep = 1000.0f;   // Contour lines every km/s
+
+// Blue (cheap) to red (expensive)
+ImVec4 heatColor(float t) {
+    t = std::clamp(t, 0.0f, 1.0f);
+    return ImVec4(std::clamp(2.0f * t, 0.0f, 1.0f),
+                  1.0f - std::abs(2.0f * t - 1.0f),
+                  std::clamp(2.0f - 2.0f * t, 0.0f, 1.0f) * (1.0f - t * 0.5f),
+                  1.0f);
+}
+
+}  // namespace
+
+PorkchopPanel::~PorkchopPanel() {
+    if (pending_.valid()) {
+        pending_.wait();
+    }
+    if (texture_) {
+        glDeleteTextures(1, &texture_);
+    }
+}
+
+void PorkchopPanel::render(const SimulationSnapshot& state, float panelX, float panelY) {
+    ImGui::SetNextWindowPos(ImVec2(panelX, panelY), ImGuiCond_FirstUseEver);
+    ImGui::SetNextWindowSize(ImVec2(420.0f, 620.0f), ImGuiCond_FirstUseEver);
+    ImGui::SetNextWindowCollapsed(true, ImGuiCond_FirstUseEver);
+
+    collect();
+    if (!ImGui::Begin("Transfer Planner")) {
+        ImGui::End();
+        return;
+    }
+    if (state.bodies.empty()) {
+        ImGui::Text("No bodies");
+        ImGui::End();
+        return;
+    }
+
+    // Transfers between the children of the root body
+    auto bodyCombo = [&](const char* label, int& selected) {
+        if (selected >= static_cast<int>(state.bodies.size())) {
+            selected = -1;
+        }
+        const char* preview = selected >= 0 ? state.bodies[selected].name.c_str() : "-";
+        if (ImGui::BeginCombo(label, preview)) {
+            for (int i = 0; i < static_cast<int>(state.bodies.size()); ++i) {
+                if (state.bodies[i].parent != 0) continue;
+                if (ImGui::Selectable(state.bodies[i].name.c_str(), i == selected)) {
+                    selected = i;
+                }
+            }
+            ImGui::EndCombo();
+        }
+    };
+    bodyCombo("From", departureBody_);
+    bodyCombo("To", arrivalBody_);
+    ImGui::DragFloat2("Departure (days)", departureWindow_, 1.0f, 0.0f, 10000.0f, "%.0f");
+    ImGui::DragFloat2("Arrival (days)", arrivalWindow_, 1.0f, 0.0f, 20000.0f, "%.0f");
+    ImGui::SliderInt("Grid", &gridSize_, 50, 500);
+    ImGui::SliderInt("Revolutions", &maxRevolutions_, 0, 3);
+
+    const bool computing = pending_.valid();
+    bool ready = !computing && departureBody_ >= 0 && arrivalBody_ >= 0 && departureBody_ != arrivalBody_
+              && departureWindow_[1] > departureWindow_[0] && arrivalWindow_[1] > arrivalWindow_[0];
+    if (!ready) {
+        ImGui::BeginDisabled();
+    }
+    if (ImGui::Button("Compute")) {
+        compute(state);
+    }
+    if (!ready) {
+        ImGui::EndDisabled();
+    }
+
+    if (computing) {
+        ImGui::SameLine();
+        ImGui::TextDisabled("Computing...");
+    } else if (texture_) {
+        ImGui::SameLine();
+        ImGui::Text("%s (%.0f ms)", gridLabel_.c_str(), computeSeconds_ * 1000.0);
+        renderPlot();
+    }
+    ImGui::End();
+}
+
+void PorkchopPanel::compute(const SimulationSnapshot& state) {
+    const double G = config_ ? config_->physics_gravity_constant : 6.674e-11;
+    const BodySnapshot& root = state.bodies[0];
+    const double mu = G * root.mass;
+
+    // Current states relative to the root: the epoch is now
+    const BodySnapshot& from = state.bodies[departureBody_];
+    const BodySnapshot& to = state.bodies[arrivalBody_];
+
+    PorkchopRequest request;
+    request.departureStart = departureWindow_[0] * kDay;
+    request.departureEnd = departureWindow_[1] * kDay;
+    request.arrivalStart = arrivalWindow_[0] * kDay;
+    request.arrivalEnd = arrivalWindow_[1] * kDay;
+    request.departureSteps = static_cast<size_t>(gridSize_);
+    request.arrivalSteps = static_cast<size_t>(gridSize_);
+    request.maxRevolutions = maxRevolutions_;
+    // A pool of its own (request.jobs stays null): a sweep takes seconds,
+    // and the shared pool's waiters would run its rows inside a physics
+    // frame. Half the hardware threads leave the physics and render room.
+    request.threads = std::max(1u, std::thread::hardware_concurrency() / 2);
+
+    PhaseState departure{from.position - root.position, from.velocity - root.velocity};
+    PhaseState arrival{to.position - root.position, to.velocity - root.velocity};
+    std::string label = from.name + " -> " + to.name;
+    pending_ = std::async(std::launch::async, [departure, arrival, mu, request, label]() {
+        auto start = std::chrono::steady_clock::now();
+        Sweep sweep;
+        sweep.grid = computePorkchop(departure, arrival, mu, request);
+        sweep.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        sweep.label = label;
+        return sweep;
+    });
+}
+
+void PorkchopPanel::collect() {
+    if (!pending_.valid() || pending_.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+        return;
+    }
+    Sweep sweep = pending_.get();
+    grid_ = std::move(sweep.grid);
+    gridLabel_ = std::move(sweep.label);
+    computeSeconds_ = sweep.seconds;
+    uploadTexture();
+}
+
+void PorkchopPanel::uploadTexture() {
+    const size_t columns = grid_.departureSteps();
+    const size_t rows = grid_.arrivalSteps();
+
+    // Colour scale from the cheapest cell to three times its cost
+    size_t bi = 0, bj = 0;
+    if (grid_.best(bi, bj)) {
+        minDeltaV_ = grid_.deltaV(bi, bj);
+        maxDeltaV_ = 3.0f * minDeltaV_;
+    } else {
+        minDeltaV_ = maxDeltaV_ = 0.0f;
+    }
+
+    std::vector<unsigned char> pixels(columns * rows * 4, 0);
+    for (size_t j = 0; j < rows; ++j) {
+        // Later arrivals at the top of the image
+        unsigned char* row = &pixels[(rows - 1 - j) * columns * 4];
+        for (size_t i = 0; i < columns; ++i) {
+            float dv = grid_.deltaV(i, j);
+            unsigned char* p = row + i * 4;
+            if (std::isnan(dv)) {
+                continue;   // Transparent where there is no transfer
+            }
+            ImVec4 color = maxDeltaV_ > minDeltaV_
+                ? heatColor((dv - minDeltaV_) / (maxDeltaV_ - minDeltaV_)) : heatColor(0.0f);
+            // Darken a thin band at each contour level
+            float phase = std::fmod(dv, kContourStep) / kContourStep;
+            float shade = (phase < 0.06f && dv < maxDeltaV_) ? 0.35f : 1.0f;
+            if (dv > maxDeltaV_) shade = 0.5f;
+            p[0] = static_cast<unsigned char>(color.x * shade * 255.0f);
+            p[1] = static_cast<unsigned char>(color.y * shade * 255.0f);
+            p[2] = static_cast<unsigned char>(color.z * shade * 255.0f);
+            p[3] = 255;
+        }
+    }
+
+    if (!texture_) {
+        glGenTextures(1, &texture_);
+    }
+    glBindTexture(GL_TEXTURE_2D, texture_);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, static_cast<GLsizei>(columns), static_cast<GLsizei>(rows), 0,
+                 GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+void PorkchopPanel::renderPlot() {
+    const size_t columns = grid_.departureSteps();
+    const size_t rows = grid_.arrivalSteps();
+    if (columns == 0 || rows == 0) return;
+
+    float side = std::min(ImGui::GetContentRegionAvail().x, 400.0f);
+    ImVec2 origin = ImGui::GetCursorScreenPos();
+    ImGui::Image((ImTextureID)(intptr_t)texture_, ImVec2(side, side));
+
+    // Cell under the mouse
+    if (ImGui::IsItemHovered()) {
+        ImVec2 mouse = ImGui::GetMousePos();
+        float u = std::clamp((mouse.x - origin.x) / side, 0.0f, 1.0f);
+        float v = std::clamp((mouse.y - origin.y) / side, 0.0f, 1.0f);
+        size_t i = std::min(columns - 1, static_cast<size_t>(u * columns));
+        size_t j = std::min(rows - 1, static_cast<size_t>((1.0f - v) * rows));
+        float dv = grid_.deltaV(i, j);
+        double depart = grid_.departureTime(i) / kDay;
+        double arrive = grid_.arrivalTime(j) / kDay;
+        ImGui::BeginTooltip();
+        ImGui::Text("Depart: day %.0f", depart);
+        ImGui::Text("Arrive: day %.0f (%.0f days)", arrive, arrive - depart);
+        if (std::isnan(dv)) {
+            ImGui::TextDisabled("No transfer");
+        } else {
+            ImGui::Text("Delta-v: %.2f km/s", dv / 1000.0f);
+        }
+        ImGui::EndTooltip();
+    }
+
+    ImGui::TextDisabled("Departure (x) vs arrival (y); contours every %.0f km/s", kContourStep / 1000.0f);
+    size_t bi = 0, bj = 0;
+    if (grid_.best(bi, bj)) {
+        ImGui::TextColored(ImVec4(0.4f, 1.0f, 0.4f, 1.0f), "Best: %.2f km/s", grid_.deltaV(bi, bj) / 1000.0f);
+        ImGui::Text("Depart day %.0f, arrive day %.0f",
+                    grid_.departureTime(bi) / kDay, grid_.arrivalTime(bj) / kDay);
+    } else {
+        ImGui::TextColored(ImVec4(1.0f, 0.3f, 0.3f, 1.0f), "No transfer in this window");
+    }
+}
@@ -0,0 +1,71 @@
+#include "ui/replay_panel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+namespace {
+
+// "T+2d 03:04:05.6"
+void formatTime(double seconds, char* out, size_t size) {
+    const double whole = std::floor(seconds);
+    const long total = static_cast<long>(whole);
+    const long days = total / 86400;
+    const int hours = static_cast<int>(total / 3600 % 24);
+    const int minutes = static_cast<int>(total / 60 % 60);
+    const double rest = static_cast<double>(total % 60) + (seconds - whole);
+    if (days > 0) {
+        std::snprintf(out, size, "T+%ldd %02d:%02d:%04.1f", days, hours, minutes, rest);
+    } else {
+        std::snprintf(out, size, "T+%02d:%02d:%04.1f", hours, minutes, rest);
+    }
+}
+
+}  // namespace
+
+void ReplayPanel::render(float panelX, float panelY, float panelWidth) {
+    if (!replay_) {
+        return;
+    }
+    ImGui::SetNextWindowPos(ImVec2(panelX, panelY), ImGuiCond_Always);
+    ImGui::SetNextWindowSize(ImVec2(panelWidth, 0.0f), ImGuiCond_Always);
+    ImGuiWindowFlags windowFlags = ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoMove |
+                                   ImGuiWindowFlags_NoCollapse;
+    ImGui::Begin("Replay", nullptr, windowFlags);
+
+    if (ImGui::Button(replay_->playing() ? "Pause" : "Play")) {
+        // Play from the start again once the end was reached
+        if (!replay_->playing() && replay_->time() >= replay_->endTime()) {
+            replay_->seek(replay_->startTime());
+        }
+        replay_->setPlaying(!replay_->playing());
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("<<")) {
+        replay_->setSpeed(std::max(replay_->speed() * 0.5, kMinSpeed));
+    }
+    ImGui::SameLine();
+    if (ImGui::Button(">>")) {
+        replay_->setSpeed(std::min(replay_->speed() * 2.0, kMaxSpeed));
+    }
+    ImGui::SameLine();
+    ImGui::Text("%gx", replay_->speed());
+    ImGui::SameLine();
+    ImGui::TextDisabled("(Space: play/pause, Q/E: speed, R: 1x)");
+
+    char label[48];
+    formatTime(replay_->time() - replay_->startTime(), label, sizeof(label));
+    double time = replay_->time();
+    const double start = replay_->startTime();
+    const double end = replay_->endTime();
+    ImGui::SetNextItemWidth(-1.0f);
+    if (ImGui::SliderScalar("##time", ImGuiDataType_Double, &time, &start, &end, label)) {
+        replay_->seek(time);
+    }
+
+    const TelemetryReader& reader = replay_->reader();
+    formatTime(end - start, label, sizeof(label));
+    ImGui::TextDisabled("%llu rows in %zu chunks, %s%s", static_cast<unsigned long long>(reader.rowCount()),
+                        reader.chunks().size(), label, reader.hasIndex() ? "" : " (no index: file cut short)");
+    ImGui::End();
+}
@@ -1,12 +1,15 @@
 #include "ui/ui.h"
 #include "core/simulation.h"
+#include "core/alloc_counter.h"
 #include <glm/gtx/string_cast.hpp>
 #include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
 #include <map>
 
 UI::UI(GLFWwindow* win, Simulation& sim) 
     : window_(win), map_(sim), simulation_(sim), fpsCounter_(FPSCounter()), lastTime_(0.0f),
-      selectedBody_("rocket"), orbitalInfo_(sim.getConfig()) {
+      selectedBody_("rocket"), orbitalInfo_(sim.getConfig()),
+      porkchop_(sim.getConfig()) {
     IMGUI_CHECKVERSION();
     ImGui::CreateContext();
     ImGui_ImplGlfw_InitForOpenGL(window_, true);
@@ -15,7 +18,7 @@ UI::UI(GLFWwindow* win, Simulation& sim)
 
 UI::~UI() = default;
 
-void UI::render(float timeScale, const Rocket& rocket, const Camera& camera, int width, int height) {
+void UI::render(const SimulationSnapshot& state, const Camera& camera, int width, int height) {
     ImGui_ImplOpenGL3_NewFrame();
     ImGui_ImplGlfw_NewFrame();
     ImGui::NewFrame();
@@ -26,6 +29,9 @@ void UI::render(float timeScale, const Rocket& rocket, const Camera& camera, int
     ImGui::SetNextWindowSize(ImVec2(width - 20, height * 0.2f - 20));
     ImGui::Begin("Simulation Info", nullptr, ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoMove);
     
+    const RocketSnapshot& rocket = state.rocket;
+    const float timeScale = state.timeScale;
+
     // Format time scale with appropriate suffix for large values
     if (timeScale >= 86400.0f) {
         ImGui::Text("Time Scale: %.1f days/s", timeScale / 86400.0f);
@@ -38,19 +44,24 @@ void UI::render(float timeScale, const Rocket& rocket, const Camera& camera, int
     }
     ImGui::SameLine();
     ImGui::TextDisabled("(Q/E: adjust, Shift+Q/E: fast, R: reset)");
-    ImGui::Text("Mass: %.1f kg", rocket.getMass());
-    ImGui::Text("Fuel Mass: %.1f kg", rocket.getFuelMass());
-    ImGui::Text("Thrust: %.1f N", rocket.getThrust());
-    ImGui::Text("Exhaust Velocity: %.1f m/s", rocket.getExhaustVelocity());
-    ImGui::Text("Position (Geocentric): %s", glm::to_string(glm::vec3(rocket.getPosition())).c_str());
-    ImGui::Text("Velocity: %s", glm::to_string(glm::vec3(rocket.getVelocity())).c_str());
-    ImGui::Text("Thrust Direction: %s", glm::to_string(glm::vec3(rocket.getThrustDirection())).c_str());
-    ImGui::Text("Altitude: %.1f m", glm::length(rocket.getPosition()) - 6371000.0);
-    ImGui::Text("Time: %.1f s", rocket.getTime());
-    ImGui::Text("Launched: %s", rocket.isLaunched() ? "Yes" : "No");
-    if (rocket.isCrashed()) {
+    ImGui::Text("Mass: %.1f kg", rocket.mass);
+    ImGui::Text("Stage: %s", rocket.stageName.c_str());
+    ImGui::Text("Fuel Mass: %.1f kg", rocket.fuelMass);
+    ImGui::Text("Thrust: %.1f N", rocket.thrust);
+    ImGui::Text("Exhaust Velocity: %.1f m/s", rocket.exhaustVelocity);
+    ImGui::Text("Position (Geocentric): %s", glm::to_string(glm::vec3(rocket.position)).c_str());
+    ImGui::Text("Velocity: %s", glm::to_string(glm::vec3(rocket.velocity)).c_str());
+    ImGui::Text("Thrust Direction: %s", glm::to_string(glm::vec3(rocket.thrustDirection)).c_str());
+    ImGui::Text("Altitude: %.1f m", glm::length(rocket.position) - 6371000.0);
+    ImGui::Text("Time: %.1f s", rocket.time);
+    ImGui::Text("Launched: %s", rocket.launched ? "Yes" : "No");
+    if (rocket.crashed) {
         ImGui::TextColored(ImVec4(1.0f, 0.2f, 0.2f, 1.0f), "*** CRASHED ***");
     }
+    if (AllocationCounter::enabled()) {
+        // Process-wide: with physics on its own thread this includes the render thread's
+        ImGui::Text("Heap Allocations/Step: %llu", static_cast<unsigned long long>(state.frameAllocations));
+    }
     ImGui::End();
 
     // Thumbnail (top-left corner) - Hidden
@@ -68,10 +79,9 @@ void UI::render(float timeScale, const Rocket& rocket, const Camera& camera, int
         float navBallY = sceneHeight - navBallSize - 160;
         
         // Get Earth position for reference frame (convert to vec3 for rendering)
-        const auto& bodies = simulation_.getBodies();
         glm::vec3 earthPos(0.0f);
-        if (bodies.find("earth") != bodies.end()) {
-            earthPos = glm::vec3(bodies.at("earth")->position);
+        if (const BodySnapshot* earth = state.find("earth")) {
+            earthPos = glm::vec3(earth->position);
         }
         
         navBall_.render(rocket, earthPos, navBallX, navBallY, navBallSize);
@@ -79,13 +89,23 @@ void UI::render(float timeScale, const Rocket& rocket, const Camera& camera, int
     
     // Render Orbital Info panel (positioned below Camera Control, which is now at y=10, height=230)
     if (showOrbitalInfo_) {
-        const auto& bodies = simulation_.getBodies();
-        orbitalInfo_.render(rocket, bodies, 10.0f, 250.0f);
+        orbitalInfo_.render(state, 10.0f, 250.0f);
+        renderEncounters(state, 10.0f, 660.0f);
+    }
+    
+    // Render Transfer Planner (starts collapsed, right of Orbital Info)
+    if (showPorkchop_) {
+        porkchop_.render(state, 240.0f, 250.0f);
+    }
+
+    // Replay timeline (top, between Camera Control and the FPS display)
+    if (replayPanel_.active()) {
+        replayPanel_.render(240.0f, 10.0f, std::max(width - 240.0f - 200.0f, 300.0f));
     }
     
     // Render planet labels (must be called after NewFrame and before Render)
     if (hasPendingLabelRender_) {
-        renderPlanetLabelsInternal(camera, pendingProjection_, pendingView_, 
+        renderPlanetLabelsInternal(state, camera, pendingProjection_, pendingView_, 
                                    pendingScale_, width, height);
     }
 
@@ -144,6 +164,30 @@ void UI::renderCameraMode(const Camera& camera, int width, int height) {
     ImGui::End();
 }
 
+void UI::renderEncounters(const SimulationSnapshot& state, float panelX, float panelY) {
+    const auto& encounters = state.encounters;
+    if (encounters.empty()) {
+        return;
+    }
+
+    ImGui::SetNextWindowPos(ImVec2(panelX, panelY), ImGuiCond_Always);
+    ImGui::SetNextWindowSize(ImVec2(220.0f, 0.0f), ImGuiCond_Always);
+    ImGuiWindowFlags windowFlags = ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoMove |
+                                   ImGuiWindowFlags_NoCollapse;
+    ImGui::Begin("Encounters", nullptr, windowFlags);
+    for (const Encounter& e : encounters) {
+        int minutes = static_cast<int>(e.time / 60.0);
+        ImGui::TextColored(ImVec4(0.4f, 0.8f, 1.0f, 1.0f), "%s", e.body.c_str());
+        ImGui::SameLine();
+        ImGui::Text("T+%dh%02dm", minutes / 60, minutes % 60);
+        ImGui::Text("  %.0f km at %.2f km/s", e.distance / 1000.0, e.relativeSpeed / 1000.0);
+    }
+    if (!state.encounterSearchFinished) {
+        ImGui::TextDisabled("Searching...");
+    }
+    ImGui::End();
+}
+
 void UI::renderBodySelector(const Camera& camera, int width, int height) {
     // Position on the right side of the screen, below FPS display
     float panelWidth = 180.0f;
@@ -285,9 +329,8 @@ void UI::renderPlanetLabels(const Camera& camera, const glm::mat4& projection, c
     }
 }
 
-void UI::renderPlanetLabelsInternal(const Camera& camera, const glm::mat4& projection, const glm::mat4& view,
-                                     float scale, int width, int height) {
-    const auto& bodies = simulation_.getBodies();
+void UI::renderPlanetLabelsInternal(const SimulationSnapshot& state, const Camera& camera, const glm::mat4& projection,
+                                     const glm::mat4& view, float scale, int width, int height) {
     
     // Define planet display names and colors
     std::map<std::string, std::pair<std::string, ImVec4>> planetInfo = {
@@ -323,10 +366,10 @@ void UI::renderPlanetLabelsInternal(const Camera& camera, const glm::mat4& proje
     ImDrawList* drawList = ImGui::GetForegroundDrawList();
     
     for (const auto& name : planetsToLabel) {
-        auto it = bodies.find(name);
-        if (it == bodies.end()) continue;
+        const BodySnapshot* body = state.find(name);
+        if (!body) continue;
         
-        glm::vec3 worldPos = glm::vec3((it->second->position - simulation_.getRenderOrigin()) * static_cast<double>(scale));
+        glm::vec3 worldPos = glm::vec3((body->position - simulation_.getRenderOrigin()) * static_cast<double>(scale));
         glm::vec2 screenPos = worldToScreen(worldPos, projection, view, width, height);
         
         // Check if on screen
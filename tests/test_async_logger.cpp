@@ -0,0 +1,132 @@
+#include "logging/async_logger.h"
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Sink that records what reaches it, optionally slowly
+class RecordingSink : public ILogger {
+public:
+    explicit RecordingSink(std::chrono::microseconds delay = std::chrono::microseconds(0)) : delay_(delay) {}
+
+    void log(LogLevel, const std::string& module, const std::string& message) override {
+        std::this_thread::sleep_for(delay_);
+        std::lock_guard<std::mutex> lock(mutex_);
+        messages_.push_back(module + ": " + message);
+    }
+    void set_level(LogLevel level) override { setThreshold(level); }
+
+    std::vector<std::string> messages() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return messages_;
+    }
+
+private:
+    std::chrono::microseconds delay_;
+    std::mutex mutex_;
+    std::vector<std::string> messages_;
+};
+
+}  // namespace
+
+TEST(AsyncLoggerTest, RecordsReachTheSinkInOrder) {
+    auto sink = std::make_shared<RecordingSink>();
+    AsyncLogger logger(sink);
+    logger.log(LogLevel::INFO, "Rocket", "first");
+    logger.log(LogLevel::DEBUG, "Moon", "second");
+    logger.log(LogLevel::WARN, "Rocket", "third");
+    logger.flush();
+
+    std::vector<std::string> expected = {"Rocket: first", "Moon: second", "Rocket: third"};
+    EXPECT_EQ(sink->messages(), expected);
+    EXPECT_EQ(logger.written(), 3u);
+    EXPECT_EQ(logger.dropped(), 0u);
+}
+
+TEST(AsyncLoggerTest, ManyThreadsLoseNothingWhenBlocking) {
+    auto sink = std::make_shared<RecordingSink>();
+    const int threads = 4;
+    const int perThread = 3000;   // Together more than the queue holds
+    {
+        AsyncLogger logger(sink, AsyncLogger::Overflow::Block);
+        std::vector<std::thread> producers;
+        for (int t = 0; t < threads; ++t) {
+            producers.emplace_back([&logger, t] {
+                for (int i = 0; i < perThread; ++i) {
+                    logger.log(LogLevel::INFO, "T" + std::to_string(t), std::to_string(i));
+                }
+            });
+        }
+        for (auto& p : producers) {
+            p.join();
+        }
+        EXPECT_EQ(logger.dropped(), 0u);
+    }   // The destructor writes out the rest
+    EXPECT_EQ(sink->messages().size(), static_cast<size_t>(threads * perThread));
+}
+
+TEST(AsyncLoggerTest, FlushWaitsForEveryEarlierRecord) {
+    // Other threads keep the queue busy while each one checks its own record
+    auto sink = std::make_shared<RecordingSink>();
+    AsyncLogger logger(sink, AsyncLogger::Overflow::Block);
+    std::vector<std::thread> producers;
+    std::vector<int> missing(4, 0);
+    for (int t = 0; t < 4; ++t) {
+        producers.emplace_back([&, t] {
+            const std::string module = "T" + std::to_string(t);
+            for (int i = 0; i < 200; ++i) {
+                logger.log(LogLevel::INFO, module, std::to_string(i));
+                logger.flush();
+                std::vector<std::string> seen = sink->messages();
+                if (std::find(seen.rbegin(), seen.rend(), module + ": " + std::to_string(i)) == seen.rend()) {
+                    ++missing[t];
+                }
+            }
+        });
+    }
+    for (auto& p : producers) {
+        p.join();
+    }
+    EXPECT_EQ(missing, std::vector<int>(4, 0));
+}
+
+TEST(AsyncLoggerTest, DropPolicyCountsWhatItDrops) {
+    // A sink far slower than the producer fills the queue
+    auto sink = std::make_shared<RecordingSink>(std::chrono::microseconds(200));
+    AsyncLogger logger(sink, AsyncLogger::Overflow::Drop);
+    const int total = static_cast<int>(AsyncLogger::kQueueCapacity) * 2;
+    for (int i = 0; i < total; ++i) {
+        logger.log(LogLevel::INFO, "Burst", "x");
+    }
+    logger.flush();
+
+    EXPECT_GT(logger.dropped(), 0u);
+    EXPECT_EQ(logger.written() + logger.dropped(), static_cast<uint64_t>(total));
+    EXPECT_EQ(sink->messages().size(), logger.written());
+}
+
+TEST(AsyncLoggerTest, LongMessagesAreCutShort) {
+    auto sink = std::make_shared<RecordingSink>();
+    AsyncLogger logger(sink);
+    logger.log(LogLevel::INFO, "M", std::string(AsyncLogger::kMessageLength + 50, 'a'));
+    logger.flush();
+
+    ASSERT_EQ(sink->messages().size(), 1u);
+    EXPECT_EQ(sink->messages()[0], "M: " + std::string(AsyncLogger::kMessageLength, 'a'));
+    EXPECT_EQ(logger.truncated(), 1u);
+}
+
+TEST(AsyncLoggerTest, LevelIsForwardedToTheSink) {
+    auto sink = std::make_shared<RecordingSink>();
+    AsyncLogger logger(sink);
+    logger.set_level(LogLevel::ERROR);
+    EXPECT_FALSE(logger.enabled(LogLevel::WARN));
+    EXPECT_FALSE(sink->enabled(LogLevel::WARN));
+    EXPECT_TRUE(logger.enabled(LogLevel::ERROR));
+}
@@ -0,0 +1,156 @@
+#include "core/atmosphere.h"
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <fstream>
+#include <vector>
+
+// ============================================================
+// AtmosphereTable Tests
+// ============================================================
+
+TEST(AtmosphereTest, Us76ReferenceValues) {
+    AtmosphereTable table = AtmosphereTable::us76();
+
+    // Reference densities (kg/m^3) from the published US76 tables (geometric altitude)
+    EXPECT_NEAR(table.density(0.0), 1.2250, 1e-4);
+    EXPECT_NEAR(table.density(11000.0) / 0.36480, 1.0, 2e-3);
+    EXPECT_NEAR(table.density(20000.0) / 0.088910, 1.0, 2e-3);
+    EXPECT_NEAR(table.density(50000.0) / 1.0269e-3, 1.0, 5e-3);
+    EXPECT_NEAR(table.density(80000.0) / 1.846e-5, 1.0, 1e-2);
+
+    EXPECT_NEAR(table.speedOfSound(0.0), 340.29, 0.05);
+    EXPECT_NEAR(table.speedOfSound(15000.0), 295.07, 0.05);
+
+    // Reference pressures (Pa)
+    EXPECT_NEAR(table.pressure(0.0), 101325.0, 1e-6);
+    EXPECT_NEAR(table.pressure(11000.0) / 22699.9, 1.0, 2e-3);
+    EXPECT_NEAR(table.pressure(50000.0) / 79.779, 1.0, 5e-3);
+    EXPECT_DOUBLE_EQ(table.pressure(150000.0), 0.0);
+}
+
+TEST(AtmosphereTest, ZeroAboveCeilingAndClampedBelowSurface) {
+    AtmosphereTable table = AtmosphereTable::us76(100.0, 100000.0);
+    EXPECT_DOUBLE_EQ(table.density(100000.0), 0.0);
+    EXPECT_DOUBLE_EQ(table.density(250000.0), 0.0);
+    EXPECT_DOUBLE_EQ(table.density(-500.0), table.density(0.0));
+    EXPECT_GT(table.density(99999.0), 0.0);
+}
+
+TEST(AtmosphereTest, InterpolationCloseToExponential) {
+    // Within the first layer density is smooth; grid interpolation should
+    // be far below the model error of the old exponential atmosphere
+    AtmosphereTable table = AtmosphereTable::us76(100.0);
+    for (double h = 50.0; h < 10000.0; h += 977.0) {
+        double lo = table.density(std::floor(h / 100.0) * 100.0);
+        double hi = table.density(std::ceil(h / 100.0) * 100.0);
+        double logInterp = lo * std::pow(hi / lo, (h - std::floor(h / 100.0) * 100.0) / 100.0);
+        EXPECT_NEAR(table.density(h) / logInterp, 1.0, 1e-4);
+    }
+}
+
+TEST(AtmosphereTest, BatchMatchesScalar) {
+    AtmosphereTable table = AtmosphereTable::us76();
+    std::vector<double> altitudes = {-10.0, 0.0, 1234.5, 11000.0, 47350.0, 99999.9, 100000.0, 3e5};
+    std::vector<double> density(altitudes.size());
+    std::vector<double> sound(altitudes.size());
+
+    table.sample(altitudes.data(), density.data(), sound.data(), altitudes.size());
+    for (size_t i = 0; i < altitudes.size(); ++i) {
+        EXPECT_DOUBLE_EQ(density[i], table.density(altitudes[i])) << "altitude " << altitudes[i];
+        EXPECT_DOUBLE_EQ(sound[i], table.speedOfSound(altitudes[i])) << "altitude " << altitudes[i];
+    }
+}
+
+TEST(AtmosphereTest, ProfileIsLogInterpolated) {
+    AtmosphereProfile profile;
+    profile.altitudes = {0.0, 10000.0, 20000.0};
+    profile.densities = {0.02, 0.02 * std::exp(-1.0), 0.02 * std::exp(-2.0)};
+    profile.temperatures = {210.0, 200.0, 190.0};
+    profile.gas_constant = 188.9;
+    profile.gamma = 1.29;
+
+    AtmosphereTable table = AtmosphereTable::fromProfile(profile);
+    EXPECT_DOUBLE_EQ(table.ceiling(), 20000.0);
+    // An exponential profile is reproduced between the sparse samples
+    EXPECT_NEAR(table.density(5000.0), 0.02 * std::exp(-0.5), 1e-9);
+    EXPECT_NEAR(table.density(15000.0), 0.02 * std::exp(-1.5), 1e-9);
+    EXPECT_NEAR(table.speedOfSound(0.0), std::sqrt(1.29 * 188.9 * 210.0), 1e-9);
+}
+
+TEST(AtmosphereTest, MalformedProfileThrows) {
+    AtmosphereProfile profile;
+    profile.altitudes = {0.0};
+    profile.densities = {1.0};
+    profile.temperatures = {300.0};
+    EXPECT_THROW(AtmosphereTable::fromProfile(profile), ConfigError);
+
+    profile.altitudes = {0.0, 0.0};
+    profile.densities = {1.0, 0.5};
+    profile.temperatures = {300.0, 290.0};
+    EXPECT_THROW(AtmosphereTable::fromProfile(profile), ConfigError);
+
+    profile.altitudes = {0.0, 1000.0};
+    profile.densities = {1.0, 0.0};
+    EXPECT_THROW(AtmosphereTable::fromProfile(profile), ConfigError);
+}
+
+// ============================================================
+// DragTable Tests
+// ============================================================
+
+TEST(DragTableTest, ConstantAndInterpolated) {
+    DragTable constant = DragTable::constant(0.3);
+    EXPECT_DOUBLE_EQ(constant.at(0.0), 0.3);
+    EXPECT_DOUBLE_EQ(constant.at(7.5), 0.3);
+
+    DragTable table = DragTable::fromPoints({{0.0, 0.3}, {1.0, 0.5}, {2.0, 0.4}});
+    EXPECT_NEAR(table.at(0.5), 0.4, 1e-12);
+    EXPECT_NEAR(table.at(1.0), 0.5, 1e-12);
+    EXPECT_NEAR(table.at(1.5), 0.45, 1e-12);
+    EXPECT_NEAR(table.at(10.0), 0.4, 1e-12);  // Held beyond the last point
+
+    std::vector<double> mach = {0.0, 0.25, 1.0, 1.75, 5.0};
+    std::vector<double> cd(mach.size());
+    table.sample(mach.data(), cd.data(), mach.size());
+    for (size_t i = 0; i < mach.size(); ++i) {
+        EXPECT_DOUBLE_EQ(cd[i], table.at(mach[i]));
+    }
+}
+
+TEST(DragTableTest, UnsortedPointsThrow) {
+    EXPECT_THROW(DragTable::fromPoints({{1.0, 0.3}, {0.5, 0.4}}), ConfigError);
+    EXPECT_THROW(DragTable::fromPoints({}), ConfigError);
+}
+
+TEST(AtmosphereTest, ConfigLoadsProfilesAndMachTable) {
+    std::ofstream file("./var/test_atmosphere_config.json");
+    file << R"({
+        "physics": {
+            "drag_mach_table": [[0.0, 0.3], [1.0, 0.5]],
+            "planets": {
+                "mars": {
+                    "atmosphere": {
+                        "altitudes": [0.0, 50000.0],
+                        "densities": [0.02, 0.0002],
+                        "temperatures": [210.0, 160.0],
+                        "gas_constant": 188.9,
+                        "gamma": 1.29
+                    }
+                }
+            }
+        }
+    })";
+    file.close();
+
+    Config config;
+    config.loadFromFile("./var/test_atmosphere_config.json");
+    ASSERT_EQ(config.physics_drag_mach_table.size(), 2u);
+    EXPECT_DOUBLE_EQ(config.physics_drag_mach_table[1].second, 0.5);
+
+    const auto* mars = config.getPlanet("mars");
+    ASSERT_NE(mars, nullptr);
+    ASSERT_EQ(mars->atmosphere.altitudes.size(), 2u);
+    EXPECT_DOUBLE_EQ(mars->atmosphere.gamma, 1.29);
+    EXPECT_TRUE(config.getPlanet("venus")->atmosphere.empty());
+}
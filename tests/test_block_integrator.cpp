@@ -0,0 +1,155 @@
+#include "core/block_integrator.h"
+
+#include <gtest/gtest.h>
+#include <glm/glm.hpp>
+#include <cmath>
+#include <memory>
+
+namespace {
+
+const double G = 6.674e-11;
+const double kAu = 1.496e11;
+const double kSunMass = 1.989e30;
+const double kEarthMass = 5.972e24;
+const double kMoonMass = 7.342e22;
+const double kNeptuneMass = 1.024e26;
+
+void addBody(BODY_MAP& bodies, const std::string& name, double mass,
+             const glm::dvec3& pos, const glm::dvec3& vel) {
+    bodies[name] = std::make_unique<Body>();
+    bodies[name]->name = name;
+    bodies[name]->mass = mass;
+    bodies[name]->position = pos;
+    bodies[name]->velocity = vel;
+}
+
+// Sun, Earth, Moon and Neptune on circular orbits
+void makeSystem(BODY_MAP& bodies) {
+    double vEarth = std::sqrt(G * kSunMass / kAu);
+    double vMoon = std::sqrt(G * kEarthMass / 3.844e8);
+    double rNeptune = 30.07 * kAu;
+    addBody(bodies, "sun", kSunMass, glm::dvec3(0.0), glm::dvec3(0.0));
+    addBody(bodies, "earth", kEarthMass, glm::dvec3(kAu, 0.0, 0.0), glm::dvec3(0.0, 0.0, vEarth));
+    addBody(bodies, "moon", kMoonMass, glm::dvec3(kAu + 3.844e8, 0.0, 0.0), glm::dvec3(0.0, 0.0, vEarth + vMoon));
+    addBody(bodies, "neptune", kNeptuneMass, glm::dvec3(-rNeptune, 0.0, 0.0),
+            glm::dvec3(0.0, 0.0, -std::sqrt(G * kSunMass / rNeptune)));
+}
+
+const std::unordered_map<std::string, std::string> kParents = {
+    {"earth", "sun"}, {"moon", "earth"}, {"neptune", "sun"}};
+
+double totalEnergy(const BODY_MAP& bodies) {
+    double kinetic = 0.0, potential = 0.0;
+    for (auto a = bodies.begin(); a != bodies.end(); ++a) {
+        kinetic += 0.5 * a->second->mass * glm::dot(a->second->velocity, a->second->velocity);
+        for (auto b = std::next(a); b != bodies.end(); ++b) {
+            double r = glm::length(a->second->position - b->second->position);
+            potential -= G * a->second->mass * b->second->mass / r;
+        }
+    }
+    return kinetic + potential;
+}
+
+}  // namespace
+
+TEST(BlockIntegratorTest, AssignsLevelsFromDynamicalTimescale) {
+    BODY_MAP bodies;
+    makeSystem(bodies);
+    BodyTree tree;
+    tree.build(bodies, kParents);
+    BlockIntegrator integrator(G, 345600.0, 0.005, 16);
+    integrator.reset(tree);
+
+    EXPECT_EQ(integrator.levelOf("neptune"), 0);
+    EXPECT_EQ(integrator.levelOf("moon"), integrator.levelOf("earth"));
+    EXPECT_GE(integrator.levelOf("moon"), 7);
+    EXPECT_LT(integrator.levelOf("sun"), integrator.levelOf("moon"));
+    EXPECT_EQ(integrator.levelOf("pluto"), -1);
+}
+
+TEST(BlockIntegratorTest, SlowBodiesEvaluatedLessOften) {
+    BODY_MAP bodies;
+    makeSystem(bodies);
+    BodyTree tree;
+    tree.build(bodies, kParents);
+    BlockIntegrator integrator(G, 345600.0, 0.005, 16);
+    integrator.reset(tree);
+
+    const int blocks = 4;
+    integrator.advance(blocks * 345600.0);
+
+    // A single-rate scheme at the Moon's step evaluates every body on every tick
+    size_t moonSteps = static_cast<size_t>(blocks) << integrator.levelOf("moon");
+    size_t uniform = moonSteps * bodies.size();
+    EXPECT_LT(integrator.forceEvaluations(), uniform * 3 / 4);
+    EXPECT_GE(integrator.forceEvaluations(), 2 * moonSteps);
+}
+
+TEST(BlockIntegratorTest, ResultIndependentOfFrameLength) {
+    BODY_MAP once, frames;
+    makeSystem(once);
+    makeSystem(frames);
+    BodyTree onceTree, framesTree;
+    onceTree.build(once, kParents);
+    framesTree.build(frames, kParents);
+    BlockIntegrator a(G, 345600.0, 0.005, 16);
+    BlockIntegrator b(G, 345600.0, 0.005, 16);
+    a.reset(onceTree);
+    b.reset(framesTree);
+
+    const double total = 2.5 * 345600.0;
+    a.advance(total);
+    double elapsed = 0.0;
+    for (int i = 0; elapsed < total; ++i) {
+        double step = std::min(total - elapsed, 500.0 + 37.0 * (i % 11));
+        b.advance(step);
+        elapsed += step;
+    }
+
+    for (const auto& [name, body] : once) {
+        EXPECT_NEAR(glm::length(body->position - frames[name]->position), 0.0, 1e-2) << name;
+        EXPECT_NEAR(glm::length(body->velocity - frames[name]->velocity), 0.0, 1e-8) << name;
+    }
+}
+
+TEST(BlockIntegratorTest, ConservesEnergyOverAYear) {
+    BODY_MAP bodies;
+    makeSystem(bodies);
+    double initial = totalEnergy(bodies);
+    double earthMoon = glm::length(bodies["moon"]->position - bodies["earth"]->position);
+
+    BodyTree tree;
+    tree.build(bodies, kParents);
+    BlockIntegrator integrator(G, 345600.0, 0.005, 16);
+    integrator.reset(tree);
+    for (int day = 0; day < 365; ++day) {
+        integrator.advance(86400.0);
+    }
+
+    EXPECT_NEAR(totalEnergy(bodies) / initial, 1.0, 1e-5);
+    EXPECT_NEAR(glm::length(bodies["earth"]->position) / kAu, 1.0, 2e-2);
+    EXPECT_NEAR(glm::length(bodies["moon"]->position - bodies["earth"]->position) / earthMoon, 1.0, 5e-2);
+}
+
+TEST(BlockIntegratorTest, PresentsEarthOnItsArcMidStep) {
+    BODY_MAP coarse, fine;
+    makeSystem(coarse);
+    makeSystem(fine);
+    BodyTree coarseTree, fineTree;
+    coarseTree.build(coarse, kParents);
+    fineTree.build(fine, kParents);
+    BlockIntegrator a(G, 345600.0, 0.005, 16);
+    BlockIntegrator b(G, 345600.0, 0.005 / 64.0, 16);
+    a.reset(coarseTree);
+    b.reset(fineTree);
+    ASSERT_GE(b.levelOf("earth"), a.levelOf("earth") + 6);
+
+    // Halfway through Earth's second step, where a chord at the half-kicked
+    // velocity sags the most (~1.3 km at the default 1350 s step)
+    const double earthStep = 345600.0 / static_cast<double>(1L << a.levelOf("earth"));
+    a.advance(1.5 * earthStep);
+    b.advance(1.5 * earthStep);
+
+    EXPECT_LT(glm::length(coarse["earth"]->position - fine["earth"]->position), 10.0);
+    EXPECT_LT(glm::length(coarse["moon"]->position - fine["moon"]->position), 10.0);
+}
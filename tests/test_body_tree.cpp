@@ -0,0 +1,87 @@
+#include "core/body_tree.h"
+
+#include <gtest/gtest.h>
+#include <glm/glm.hpp>
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+
+namespace {
+
+void addBody(BODY_MAP& bodies, const std::string& name, double mass,
+             const glm::dvec3& pos, const glm::dvec3& vel = glm::dvec3(0.0)) {
+    bodies[name] = std::make_unique<Body>();
+    bodies[name]->name = name;
+    bodies[name]->mass = mass;
+    bodies[name]->position = pos;
+    bodies[name]->velocity = vel;
+}
+
+class BodyTreeTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        earth = glm::dvec3(1.496e11, 0.0, 0.0);
+        moon = earth + glm::dvec3(0.0, 0.0, 3.844e8);
+        addBody(bodies, "sun", 1.989e30, glm::dvec3(0.0));
+        addBody(bodies, "earth", 5.972e24, earth, glm::dvec3(0.0, 0.0, 29780.0));
+        addBody(bodies, "moon", 7.342e22, moon, glm::dvec3(-1022.0, 0.0, 29780.0));
+        addBody(bodies, "mars", 6.4171e23, glm::dvec3(-2.279e11, 0.0, 0.0));
+        tree.build(bodies, {{"earth", "sun"}, {"moon", "earth"}, {"mars", "sun"}});
+    }
+
+    BODY_MAP bodies;
+    BodyTree tree;
+    glm::dvec3 earth, moon;
+};
+
+}  // namespace
+
+TEST_F(BodyTreeTest, ParentsPrecedeChildren) {
+    ASSERT_EQ(tree.size(), 4u);
+    EXPECT_EQ(tree.root(), tree.indexOf("sun"));
+    EXPECT_EQ(tree.parentOf(tree.indexOf("moon")), tree.indexOf("earth"));
+    EXPECT_EQ(tree.parentOf(tree.indexOf("earth")), tree.indexOf("sun"));
+    EXPECT_EQ(tree.parentOf(tree.root()), BodyTree::kNone);
+    EXPECT_EQ(tree.indexOf("pluto"), BodyTree::kNone);
+    EXPECT_EQ(tree.parentOf(tree.indexOf("pluto")), BodyTree::kNone);
+    for (size_t i = 0; i < tree.size(); ++i) {
+        EXPECT_LT(tree.parentOf(static_cast<int>(i)), static_cast<int>(i));
+    }
+}
+
+TEST_F(BodyTreeTest, LocalStateIsParentRelative) {
+    int m = tree.indexOf("moon");
+    EXPECT_EQ(tree.node(m).localPosition, glm::dvec3(0.0, 0.0, 3.844e8));
+    EXPECT_EQ(tree.node(m).localVelocity, glm::dvec3(-1022.0, 0.0, 0.0));
+    EXPECT_EQ(tree.worldPosition(m), moon);
+
+    // Moving the Moon locally updates only its world state
+    tree.setLocalState(m, glm::dvec3(3.844e8, 0.0, 0.0), glm::dvec3(0.0, 0.0, 1022.0));
+    tree.updateWorld();
+    EXPECT_EQ(bodies["moon"]->position, earth + glm::dvec3(3.844e8, 0.0, 0.0));
+    EXPECT_EQ(bodies["earth"]->position, earth);
+}
+
+TEST_F(BodyTreeTest, CachesSphereOfInfluence) {
+    int m = tree.indexOf("moon");
+    double expected = 3.844e8 * std::pow(7.342e22 / 5.972e24, 0.4);
+    EXPECT_NEAR(tree.soiRadius(m), expected, 1.0);
+    EXPECT_TRUE(std::isinf(tree.soiRadius(tree.root())));
+}
+
+TEST_F(BodyTreeTest, DominantBodyDescendsHierarchy) {
+    EXPECT_EQ(tree.dominantBody(earth + glm::dvec3(7.0e6, 0.0, 0.0)), tree.indexOf("earth"));
+    EXPECT_EQ(tree.dominantBody(moon + glm::dvec3(0.0, 2.0e6, 0.0)), tree.indexOf("moon"));
+    EXPECT_EQ(tree.dominantBody(glm::dvec3(-2.279e11, 1.0e8, 0.0)), tree.indexOf("mars"));
+    EXPECT_EQ(tree.dominantBody(glm::dvec3(0.0, 5.0e10, 0.0)), tree.root());
+}
+
+TEST(BodyTreeBuildTest, RejectsBadHierarchies) {
+    BODY_MAP bodies;
+    addBody(bodies, "sun", 1.0, glm::dvec3(0.0));
+    addBody(bodies, "earth", 1.0, glm::dvec3(1.0, 0.0, 0.0));
+    BodyTree tree;
+    EXPECT_THROW(tree.build(bodies, {{"earth", "vulcan"}}), std::invalid_argument);
+    EXPECT_THROW(tree.build(bodies, {}), std::invalid_argument);
+    EXPECT_THROW(tree.build(bodies, {{"earth", "sun"}, {"sun", "earth"}}), std::invalid_argument);
+}
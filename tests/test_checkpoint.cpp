@@ -0,0 +1,163 @@
+#include "core/checkpoint.h"
+#include "logging/logger.h"
+#include "test.h"
+
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+Checkpoint sample(bool withView) {
+    Checkpoint state;
+    state.time = 86400.25;
+    state.timeScale = 1000.0f;
+    state.bodies.push_back({"sun", 1.989e30, glm::dvec3(0.0), glm::dvec3(0.0)});
+    state.bodies.push_back({"earth", 5.972e24, glm::dvec3(1.496e11, 0.0, 1.0e9), glm::dvec3(-200.0, 0.0, 29780.0)});
+
+    RocketCheckpoint& rocket = state.rocket;
+    rocket.position = glm::dvec3(1.496e11, 6.771e6, 1.0e9);
+    rocket.velocity = glm::dvec3(7660.0, 1.5, 29780.0);
+    rocket.thrustDirection = glm::dvec3(0.6, 0.8, 0.0);
+    rocket.earthPosition = glm::dvec3(1.496e11, 0.0, 1.0e9);
+    rocket.mass = 12000.0;
+    rocket.fuelMass = 850.5;
+    rocket.thrust = 2.0e5;
+    rocket.stageBurnTime = 42.0;
+    rocket.perturberClock = 86400.0;
+    rocket.time = 1234.5f;
+    rocket.stage = 1;
+    rocket.launched = true;
+
+    if (withView) {
+        CheckpointView view;
+        view.camera.mode = 7;
+        view.camera.position = glm::vec3(1.0f, 2.0f, 3.0f);
+        view.camera.pitch = 30.0f;
+        view.camera.distance = 5e5f;
+        view.camera.focusBodyName = "mars";
+        TrailCheckpoint trail;
+        trail.name = "rocket";
+        trail.sampleTimer = 0.25f;
+        for (int i = 0; i < 1000; ++i) {
+            trail.points.push_back(glm::vec3(static_cast<float>(i), 2.0f * i, -1.0f * i));
+        }
+        view.trails.push_back(std::move(trail));
+        view.trails.push_back({"moon", 0.0f, {}});
+        state.view = std::move(view);
+    }
+    return state;
+}
+
+void expectSame(const Checkpoint& a, const Checkpoint& b) {
+    EXPECT_EQ(a.time, b.time);
+    EXPECT_EQ(a.timeScale, b.timeScale);
+    ASSERT_EQ(a.bodies.size(), b.bodies.size());
+    for (size_t i = 0; i < a.bodies.size(); ++i) {
+        EXPECT_EQ(a.bodies[i].name, b.bodies[i].name);
+        EXPECT_EQ(a.bodies[i].mass, b.bodies[i].mass);
+        EXPECT_EQ(a.bodies[i].position, b.bodies[i].position);
+        EXPECT_EQ(a.bodies[i].velocity, b.bodies[i].velocity);
+    }
+    EXPECT_EQ(a.rocket.position, b.rocket.position);
+    EXPECT_EQ(a.rocket.velocity, b.rocket.velocity);
+    EXPECT_EQ(a.rocket.thrustDirection, b.rocket.thrustDirection);
+    EXPECT_EQ(a.rocket.earthPosition, b.rocket.earthPosition);
+    EXPECT_EQ(a.rocket.mass, b.rocket.mass);
+    EXPECT_EQ(a.rocket.fuelMass, b.rocket.fuelMass);
+    EXPECT_EQ(a.rocket.thrust, b.rocket.thrust);
+    EXPECT_EQ(a.rocket.stageBurnTime, b.rocket.stageBurnTime);
+    EXPECT_EQ(a.rocket.perturberClock, b.rocket.perturberClock);
+    EXPECT_EQ(a.rocket.time, b.rocket.time);
+    EXPECT_EQ(a.rocket.stage, b.rocket.stage);
+    EXPECT_EQ(a.rocket.launched, b.rocket.launched);
+    EXPECT_EQ(a.rocket.crashed, b.rocket.crashed);
+
+    ASSERT_EQ(a.view.has_value(), b.view.has_value());
+    if (a.view) {
+        EXPECT_EQ(a.view->camera.mode, b.view->camera.mode);
+        EXPECT_EQ(a.view->camera.position, b.view->camera.position);
+        EXPECT_EQ(a.view->camera.pitch, b.view->camera.pitch);
+        EXPECT_EQ(a.view->camera.distance, b.view->camera.distance);
+        EXPECT_EQ(a.view->camera.focusBodyName, b.view->camera.focusBodyName);
+        ASSERT_EQ(a.view->trails.size(), b.view->trails.size());
+        for (size_t i = 0; i < a.view->trails.size(); ++i) {
+            EXPECT_EQ(a.view->trails[i].name, b.view->trails[i].name);
+            EXPECT_EQ(a.view->trails[i].sampleTimer, b.view->trails[i].sampleTimer);
+            EXPECT_EQ(a.view->trails[i].points, b.view->trails[i].points);
+        }
+    }
+}
+
+}  // namespace
+
+class CheckpointTest : public ::testing::Test {
+protected:
+    std::string path;
+
+    void SetUp() override {
+        path = ::testing::TempDir() + "rocketsim_checkpoint.rsc";
+    }
+
+    void TearDown() override {
+        std::remove(path.c_str());
+    }
+};
+
+TEST_F(CheckpointTest, RoundTripsEveryField) {
+    for (bool withView : {false, true}) {
+        const Checkpoint state = sample(withView);
+        std::vector<uint8_t> data;
+        checkpoint::encode(state, data);
+        expectSame(state, checkpoint::decode(data.data(), data.size()));
+    }
+}
+
+TEST_F(CheckpointTest, RefusesOtherVersionsAndDamagedData) {
+    std::vector<uint8_t> data;
+    checkpoint::encode(sample(true), data);
+
+    // Cut short anywhere, including inside the header
+    for (size_t size : {size_t{0}, size_t{7}, size_t{20}, data.size() / 2, data.size() - 1}) {
+        EXPECT_THROW(checkpoint::decode(data.data(), size), CheckpointError) << size;
+    }
+
+    std::vector<uint8_t> other = data;
+    other[8] = static_cast<uint8_t>(checkpoint::kVersion + 1);   // Version follows the 8-byte magic
+    EXPECT_THROW(checkpoint::decode(other.data(), other.size()), CheckpointError);
+
+    other = data;
+    other[0] = 'X';
+    EXPECT_THROW(checkpoint::decode(other.data(), other.size()), CheckpointError);
+}
+
+TEST_F(CheckpointTest, WritesAndMapsAFile) {
+    const Checkpoint state = sample(true);
+    writeCheckpoint(path, state);
+    expectSame(state, readCheckpoint(path));
+
+    // The temporary file is renamed over the target, not left beside it
+    std::ifstream temporary(path + ".tmp");
+    EXPECT_FALSE(temporary.good());
+
+    EXPECT_THROW(readCheckpoint(path + ".missing"), CheckpointError);
+}
+
+TEST_F(CheckpointTest, WriterSavesInTheBackground) {
+    CheckpointWriter writer(std::make_shared<NullLogger>());
+    Checkpoint state = sample(false);
+    writer.save(path, state);
+    state.time += 60.0;
+    writer.save(path, state);   // The later save wins
+    writer.flush();
+
+    EXPECT_EQ(writer.saved(), 2u);
+    EXPECT_EQ(writer.failed(), 0u);
+    EXPECT_EQ(readCheckpoint(path).time, state.time);
+
+    writer.save(::testing::TempDir() + "rocketsim_checkpoint.rsc/not_a_directory.rsc", state);
+    writer.flush();
+    EXPECT_EQ(writer.failed(), 1u);
+}
@@ -117,4 +117,45 @@ TEST(ConfigTest, CameraParameters) {
     EXPECT_EQ(config.camera_target.x, 400000.0f);
     EXPECT_EQ(config.camera_target.y, 500000.0f);
     EXPECT_EQ(config.camera_target.z, 600000.0f);
-}
\ No newline at end of file
+}
+
+TEST(ConfigTest, RocketStages) {
+    Config config;
+    EXPECT_TRUE(config.rocket_stages.empty());
+
+    std::ofstream file("./var/test_stages_config.json");
+    file << R"({
+        "rocket": {
+            "stages": [
+                {
+                    "name": "booster",
+                    "dry_mass": 20000.0,
+                    "propellant_mass": 300000.0,
+                    "thrust_curve": [[0.0, 6000000.0], [100.0, 4000000.0]],
+                    "isp_curve": [[0.0, 310.0], [101325.0, 280.0]]
+                },
+                {
+                    "dry_mass": 4000.0,
+                    "propellant_mass": 50000.0,
+                    "thrust": 900000.0,
+                    "isp": 345.0
+                }
+            ]
+        }
+    })";
+    file.close();
+
+    config.loadFromFile("./var/test_stages_config.json");
+    ASSERT_EQ(config.rocket_stages.size(), 2u);
+    EXPECT_EQ(config.rocket_stages[0].name, "booster");
+    EXPECT_DOUBLE_EQ(config.rocket_stages[0].dry_mass, 20000.0);
+    ASSERT_EQ(config.rocket_stages[0].thrust_curve.size(), 2u);
+    EXPECT_DOUBLE_EQ(config.rocket_stages[0].thrust_curve[1].second, 4000000.0);
+    EXPECT_DOUBLE_EQ(config.rocket_stages[0].isp_curve[1].first, 101325.0);
+
+    // Scalars are one-point curves; unnamed stages are numbered
+    EXPECT_EQ(config.rocket_stages[1].name, "stage 2");
+    ASSERT_EQ(config.rocket_stages[1].thrust_curve.size(), 1u);
+    EXPECT_DOUBLE_EQ(config.rocket_stages[1].thrust_curve[0].second, 900000.0);
+    EXPECT_DOUBLE_EQ(config.rocket_stages[1].isp_curve[0].second, 345.0);
+}
@@ -0,0 +1,128 @@
+#include "core/covariance.h"
+
+#include <gtest/gtest.h>
+#include <glm/glm.hpp>
+#include <cmath>
+
+namespace {
+
+const double kMu = 3.986004418e14;    // Earth
+const double kPi = 3.14159265358979323846;
+
+struct PointMass {
+    glm::dvec3 operator()(const glm::dvec3& r, const glm::dvec3&, double) const {
+        double rn = glm::length(r);
+        return -(kMu / (rn * rn * rn)) * r;
+    }
+};
+
+PhaseState propagate(const PhaseState& s, int steps, double h) {
+    PhaseState out = s;
+    for (int i = 0; i < steps; ++i) {
+        out = rk4Step(PointMass{}, out, 1.0, h);
+    }
+    return out;
+}
+
+}  // namespace
+
+// ============================================================
+// State transition matrix Tests
+// ============================================================
+
+TEST(CovarianceTest, StateMatchesRk4Step) {
+    PhaseState s{glm::dvec3(7.0e6, 0.0, 0.0), glm::dvec3(0.0, 7546.0, 0.0)};
+    Matrix6 phi = identityMatrix6();
+    PhaseState withStm = rk4StmStep(PointMass{}, s, 1.0, 30.0, phi);
+    PhaseState plain = rk4Step(PointMass{}, s, 1.0, 30.0);
+    EXPECT_EQ(withStm.position, plain.position);
+    EXPECT_EQ(withStm.velocity, plain.velocity);
+}
+
+TEST(CovarianceTest, StmMapsSmallDeviations) {
+    // A quarter of a slightly eccentric orbit; Phi applied to an initial
+    // offset must match flying the offset trajectory
+    PhaseState s{glm::dvec3(7.0e6, 0.0, 5.0e5), glm::dvec3(0.0, 7700.0, 300.0)};
+    const int steps = 150;
+    const double h = 10.0;
+
+    Matrix6 phi = identityMatrix6();
+    PhaseState nominal = s;
+    for (int i = 0; i < steps; ++i) {
+        nominal = rk4StmStep(PointMass{}, nominal, 1.0, h, phi);
+    }
+
+    const double dx[6] = {50.0, -30.0, 20.0, 0.05, 0.02, -0.04};
+    PhaseState offset{s.position + glm::dvec3(dx[0], dx[1], dx[2]), s.velocity + glm::dvec3(dx[3], dx[4], dx[5])};
+    PhaseState flown = propagate(offset, steps, h);
+
+    glm::dvec3 dr = flown.position - nominal.position;
+    glm::dvec3 dv = flown.velocity - nominal.velocity;
+    for (int i = 0; i < 3; ++i) {
+        double linearR = 0.0, linearV = 0.0;
+        for (int j = 0; j < 6; ++j) {
+            linearR += phi[i][j] * dx[j];
+            linearV += phi[3 + i][j] * dx[j];
+        }
+        EXPECT_NEAR(linearR, dr[i], 0.05) << "position component " << i;
+        EXPECT_NEAR(linearV, dv[i], 5e-5) << "velocity component " << i;
+    }
+}
+
+TEST(CovarianceTest, UncertaintyGrowsAlongTrack) {
+    // Over one circular orbit velocity errors smear mostly along track
+    PhaseState s{glm::dvec3(7.0e6, 0.0, 0.0), glm::dvec3(0.0, std::sqrt(kMu / 7.0e6), 0.0)};
+    Matrix6 phi = identityMatrix6();
+    for (int i = 0; i < 580; ++i) {
+        s = rk4StmStep(PointMass{}, s, 1.0, 10.0, phi);
+    }
+    Matrix6 p0 = diagonalCovariance(10.0, 0.1);
+    ErrorEllipsoid ellipsoid = ErrorEllipsoid::fromCovariance(s.position, propagateCovariance(phi, p0));
+
+    glm::dvec3 alongTrack = glm::normalize(s.velocity);
+    EXPECT_GT(glm::length(ellipsoid.axes[0]), 50.0);
+    EXPECT_GT(std::abs(glm::dot(glm::normalize(ellipsoid.axes[0]), alongTrack)), 0.9);
+    EXPECT_GE(glm::length(ellipsoid.axes[0]), glm::length(ellipsoid.axes[1]));
+    EXPECT_GE(glm::length(ellipsoid.axes[1]), glm::length(ellipsoid.axes[2]));
+}
+
+// ============================================================
+// ErrorEllipsoid Tests
+// ============================================================
+
+TEST(ErrorEllipsoidTest, PrincipalAxesOfRotatedCovariance) {
+    // diag(9, 4, 1) rotated 30 degrees about z
+    const double c = std::cos(0.5235987755982988), s = std::sin(0.5235987755982988);
+    Matrix6 p{};
+    p[0][0] = 9.0 * c * c + 4.0 * s * s;
+    p[1][1] = 9.0 * s * s + 4.0 * c * c;
+    p[0][1] = p[1][0] = (9.0 - 4.0) * c * s;
+    p[2][2] = 1.0;
+
+    ErrorEllipsoid ellipsoid = ErrorEllipsoid::fromCovariance(glm::dvec3(1.0, 2.0, 3.0), p);
+    EXPECT_NEAR(glm::length(ellipsoid.axes[0]), 3.0, 1e-12);
+    EXPECT_NEAR(glm::length(ellipsoid.axes[1]), 2.0, 1e-12);
+    EXPECT_NEAR(glm::length(ellipsoid.axes[2]), 1.0, 1e-12);
+    EXPECT_NEAR(std::abs(glm::dot(ellipsoid.axes[0], glm::dvec3(c, s, 0.0))), 3.0, 1e-12);
+    EXPECT_NEAR(std::abs(ellipsoid.axes[2].z), 1.0, 1e-12);
+}
+
+TEST(ErrorEllipsoidTest, OutlineLiesOnTheSigmaSurface) {
+    ErrorEllipsoid ellipsoid;
+    ellipsoid.center = glm::dvec3(100.0, 0.0, 0.0);
+    ellipsoid.axes = {glm::dvec3(0.0, 4.0, 0.0), glm::dvec3(2.0, 0.0, 0.0), glm::dvec3(0.0, 0.0, 1.0)};
+
+    std::vector<glm::dvec3> points = ellipsoid.outline(3.0, 16);
+    EXPECT_EQ(points.size(), 3u * 16u + 2u * 4u);
+    for (const glm::dvec3& p : points) {
+        glm::dvec3 d = p - ellipsoid.center;
+        // Mahalanobis distance of every point is sigma
+        double q = (d.y * d.y) / 16.0 + (d.x * d.x) / 4.0 + d.z * d.z;
+        EXPECT_NEAR(std::sqrt(q), 3.0, 1e-12);
+    }
+    // The loop starts on the largest axis and ends one segment short of it on
+    // the largest section, so the closing segment retraces that section
+    EXPECT_NEAR(glm::length(points.front() - glm::dvec3(100.0, 12.0, 0.0)), 0.0, 1e-12);
+    glm::dvec3 last = ellipsoid.center + glm::dvec3(6.0 * std::sin(0.125 * kPi), 12.0 * std::cos(0.125 * kPi), 0.0);
+    EXPECT_NEAR(glm::length(points.back() - last), 0.0, 1e-12);
+}
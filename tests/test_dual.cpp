@@ -0,0 +1,151 @@
+#include "core/dual.h"
+#include "core/force_model.h"
+
+#include <gtest/gtest.h>
+#include <glm/glm.hpp>
+#include <cmath>
+#include <memory>
+
+namespace {
+
+const double kMu = 3.986004418e14;    // Earth
+const double kG = 6.674e-11;
+
+BODY_MAP earthOnly() {
+    BODY_MAP bodies;
+    bodies["earth"] = std::make_unique<Body>();
+    bodies["earth"]->name = "earth";
+    bodies["earth"]->mass = kMu / kG;
+    bodies["earth"]->position = glm::dvec3(0.0);
+    bodies["earth"]->velocity = glm::dvec3(0.0);
+    return bodies;
+}
+
+// Constant thrust along a pitch angle from +y toward +x, with constant exhaust velocity
+template <typename Vec>
+struct PitchedEngine {
+    typename Vec::value_type thrust;
+    typename Vec::value_type pitch;
+    double exhaustVelocity;
+
+    BasicEngineOutput<Vec> operator()(const Vec&, const Vec&, const typename Vec::value_type&) const {
+        using std::sin;
+        using std::cos;
+        Vec direction(sin(pitch), cos(pitch), typename Vec::value_type(0.0));
+        return {direction * thrust, thrust / exhaustVelocity};
+    }
+};
+
+}  // namespace
+
+// ============================================================
+// Dual Tests
+// ============================================================
+
+TEST(DualTest, ChainRuleThroughElementaryFunctions) {
+    using D = Dual<2>;
+    D x = D::variable(1.3, 0);
+    D y = D::variable(0.7, 1);
+
+    D f = sqrt(x * y) + exp(x) / y - sin(x) * cos(y) + pow(x, 1.5) - log(y) + 2.0 / x;
+    double fx = 0.5 * std::sqrt(0.7 / 1.3) + std::exp(1.3) / 0.7 - std::cos(1.3) * std::cos(0.7)
+              + 1.5 * std::sqrt(1.3) - 2.0 / (1.3 * 1.3);
+    double fy = 0.5 * std::sqrt(1.3 / 0.7) - std::exp(1.3) / (0.7 * 0.7) + std::sin(1.3) * std::sin(0.7)
+              - 1.0 / 0.7;
+
+    EXPECT_DOUBLE_EQ(f.value, std::sqrt(1.3 * 0.7) + std::exp(1.3) / 0.7 - std::sin(1.3) * std::cos(0.7)
+                              + std::pow(1.3, 1.5) - std::log(0.7) + 2.0 / 1.3);
+    EXPECT_NEAR(f.grad[0], fx, 1e-12);
+    EXPECT_NEAR(f.grad[1], fy, 1e-12);
+
+    // Constants carry no gradient; comparisons look at the value
+    D c = 3.0;
+    EXPECT_EQ(c.grad[0], 0.0);
+    EXPECT_TRUE(x > y);
+    EXPECT_TRUE(x < 2.0);
+}
+
+TEST(DualTest, VectorLengthGradient) {
+    using V = DualVec3<3>;
+    V r = V::variable(glm::dvec3(3.0, 4.0, 12.0), 0);
+    auto len = length(r - glm::dvec3(0.0, 0.0, 0.0));
+    EXPECT_DOUBLE_EQ(len.value, 13.0);
+    EXPECT_NEAR(len.grad[0], 3.0 / 13.0, 1e-15);
+    EXPECT_NEAR(len.grad[2], 12.0 / 13.0, 1e-15);
+}
+
+// ============================================================
+// Sensitivities through the integrators
+// ============================================================
+
+TEST(DualTest, Rk4GradientMatchesFiniteDifferences) {
+    // d(final position) / d(initial velocity) over a J2 orbit arc,
+    // from one dual propagation against central differences
+    BODY_MAP bodies = earthOnly();
+    auto model = makeForceModel(forces::DirectGravity{&bodies, nullptr, kG},
+                                forces::J2Gravity{glm::dvec3(0.0), glm::dvec3(0.0, 1.0, 0.0), kMu, 1.08263e-3, 6378137.0});
+
+    const glm::dvec3 r0(7.0e6, 0.0, 0.0);
+    const glm::dvec3 v0(0.0, 1000.0, 7400.0);
+    auto fly = [&](const auto& start) {
+        auto s = start;
+        for (int i = 0; i < 100; ++i) {
+            s = rk4Step(model, s, 1.0, 20.0);
+        }
+        return s;
+    };
+
+    using V = DualVec3<3>;
+    BasicPhaseState<V> dual = fly(BasicPhaseState<V>{V(r0), V::variable(v0, 0)});
+    PhaseState nominal = fly(PhaseState{r0, v0});
+    EXPECT_NEAR(glm::length(dual.position.value() - nominal.position), 0.0, 1e-6);
+
+    const double dv = 1e-3;
+    for (int j = 0; j < 3; ++j) {
+        glm::dvec3 step(0.0);
+        step[j] = dv;
+        PhaseState plus = fly(PhaseState{r0, v0 + step});
+        PhaseState minus = fly(PhaseState{r0, v0 - step});
+        glm::dvec3 fd = (plus.position - minus.position) / (2.0 * dv);
+        EXPECT_NEAR(glm::length(dual.position.derivative(j) - fd), 0.0, 1e-4 * glm::length(fd)) << "d/dv" << j;
+    }
+}
+
+TEST(DualTest, BurnSensitivityToFlightPlanParameters) {
+    // Final velocity of a burn against thrust, pitch and burn duration
+    BODY_MAP bodies = earthOnly();
+    auto gravity = makeForceModel(forces::DirectGravity{&bodies, nullptr, kG});
+    const double thrust = 2.0e5, pitch = 0.3, duration = 120.0;
+    const int steps = 24;
+
+    auto burn = [&](auto f, auto p, auto t, const auto& start) {
+        using Vec = std::decay_t<decltype(start.position)>;
+        PitchedEngine<Vec> engine{f, p, 3000.0};
+        auto s = start;
+        for (int i = 0; i < steps; ++i) {
+            s = rk4BurnStep(gravity, engine, s, t / static_cast<double>(steps));
+        }
+        return s;
+    };
+    const glm::dvec3 r0(0.0, 6.5e6, 0.0);
+    const glm::dvec3 v0(7000.0, 0.0, 0.0);
+
+    using D = Dual<3>;
+    using V = DualVec3<3>;
+    BasicBurnState<V> dual = burn(D::variable(thrust, 0), D::variable(pitch, 1), D::variable(duration, 2),
+                                  BasicBurnState<V>{V(r0), V(v0), D(20000.0)});
+
+    const double params[3] = {thrust, pitch, duration};
+    const double deltas[3] = {10.0, 1e-5, 1e-3};
+    for (int j = 0; j < 3; ++j) {
+        double plus[3] = {params[0], params[1], params[2]};
+        double minus[3] = {params[0], params[1], params[2]};
+        plus[j] += deltas[j];
+        minus[j] -= deltas[j];
+        BurnState a = burn(plus[0], plus[1], plus[2], BurnState{r0, v0, 20000.0});
+        BurnState b = burn(minus[0], minus[1], minus[2], BurnState{r0, v0, 20000.0});
+        glm::dvec3 fd = (a.velocity - b.velocity) / (2.0 * deltas[j]);
+        EXPECT_NEAR(glm::length(dual.velocity.derivative(j) - fd), 0.0, 1e-5 * glm::length(fd)) << "parameter " << j;
+        EXPECT_NEAR(dual.mass.grad[j], (a.mass - b.mass) / (2.0 * deltas[j]), 1e-6 * std::abs(dual.mass.grad[j]) + 1e-9);
+    }
+}
@@ -0,0 +1,121 @@
+#include "core/encke.h"
+
+#include <gtest/gtest.h>
+#include <glm/glm.hpp>
+#include <cmath>
+
+namespace {
+
+const double kMu = 3.986004418e14;    // Earth
+const double kRadius = 6378137.0;
+const double kJ2 = 1.08263e-3;
+const double kPi = 3.14159265358979323846;
+
+// J2 only, the perturbation Encke sees around Earth
+struct J2Only {
+    glm::dvec3 operator()(const glm::dvec3& r, const glm::dvec3&, double) const {
+        double r2 = glm::dot(r, r);
+        double rn = std::sqrt(r2);
+        double z = r.y;   // Pole along +Y
+        double k = 1.5 * kJ2 * kMu * kRadius * kRadius / (r2 * r2 * rn);
+        return k * ((5.0 * z * z / r2 - 1.0) * r - 2.0 * z * glm::dvec3(0.0, 1.0, 0.0));
+    }
+};
+
+// Point mass plus J2, for the Cowell reference
+struct FullModel {
+    glm::dvec3 operator()(const glm::dvec3& r, const glm::dvec3& v, double m) const {
+        double rn = glm::length(r);
+        return -(kMu / (rn * rn * rn)) * r + J2Only{}(r, v, m);
+    }
+};
+
+PhaseState cowell(PhaseState s, double h, double duration) {
+    for (double t = 0.0; t < duration - 0.5 * h; t += h) {
+        s = rk4Step(FullModel{}, s, 1.0, h);
+    }
+    return s;
+}
+
+// Inclined 7000 km x 9000 km orbit
+PhaseState initialOrbit() {
+    double rp = 7.0e6, ra = 9.0e6;
+    double a = 0.5 * (rp + ra);
+    double vp = std::sqrt(kMu * (2.0 / rp - 1.0 / a));
+    return PhaseState{glm::dvec3(rp, 0.0, 0.0), vp * glm::dvec3(0.0, std::sin(0.5), std::cos(0.5))};
+}
+
+}  // namespace
+
+TEST(KeplerPropagateTest, ReturnsAfterOnePeriod) {
+    PhaseState s = initialOrbit();
+    double a = 8.0e6;
+    double period = 2.0 * kPi * std::sqrt(a * a * a / kMu);
+
+    PhaseState end = keplerPropagate(s, kMu, period);
+    EXPECT_NEAR(glm::length(end.position - s.position), 0.0, 1e-3);
+    EXPECT_NEAR(glm::length(end.velocity - s.velocity), 0.0, 1e-6);
+
+    // Half a period later it is at apoapsis
+    PhaseState half = keplerPropagate(s, kMu, 0.5 * period);
+    EXPECT_NEAR(glm::length(half.position), 9.0e6, 1e-3);
+}
+
+TEST(KeplerPropagateTest, HyperbolaIsReversible) {
+    PhaseState s{glm::dvec3(7.0e6, 0.0, 0.0), glm::dvec3(0.0, 0.0, 12000.0)};
+    PhaseState out = keplerPropagate(s, kMu, 20000.0);
+    PhaseState back = keplerPropagate(out, kMu, -20000.0);
+
+    EXPECT_GT(glm::length(out.position), 1.0e8);
+    EXPECT_NEAR(glm::length(back.position - s.position), 0.0, 1e-2);
+    EXPECT_NEAR(glm::length(back.velocity - s.velocity), 0.0, 1e-8);
+
+    // Energy is conserved along the conic
+    auto energy = [](const PhaseState& p) {
+        return 0.5 * glm::dot(p.velocity, p.velocity) - kMu / glm::length(p.position);
+    };
+    EXPECT_NEAR(energy(out), energy(s), 1e-6 * std::abs(energy(s)));
+}
+
+TEST(EnckeTest, MoreAccurateThanCowellAtTheSameStep) {
+    const double duration = 6.0 * 3600.0;
+    const double h = 60.0;
+    PhaseState reference = cowell(initialOrbit(), 1.0, duration);
+    PhaseState coarse = cowell(initialOrbit(), h, duration);
+
+    EnckePropagator encke(kMu, 1e-3);
+    encke.rectify(initialOrbit());
+    for (double t = 0.0; t < duration - 0.5 * h; t += h) {
+        encke.step(J2Only{}, 1.0, h);
+    }
+
+    double cowellError = glm::length(coarse.position - reference.position);
+    double enckeError = glm::length(encke.state().position - reference.position);
+    EXPECT_LT(enckeError, 1.0);
+    EXPECT_LT(enckeError * 10.0, cowellError);
+}
+
+TEST(EnckeTest, RectifiesWhenDeviationGrows) {
+    EnckePropagator encke(kMu, 1e-4);
+    encke.rectify(initialOrbit());
+    EXPECT_EQ(encke.rectifications(), 1);
+
+    // A strong constant push drives the state off the reference conic
+    struct Push {
+        glm::dvec3 operator()(const glm::dvec3&, const glm::dvec3&, double) const { return glm::dvec3(0.0, 0.0, 1.0); }
+    };
+    for (int i = 0; i < 600; ++i) {
+        encke.step(Push{}, 1.0, 10.0);
+        EXPECT_LE(glm::length(encke.deviation().position), 1.001e-4 * glm::length(encke.state().position));
+    }
+    EXPECT_GT(encke.rectifications(), 1);
+
+    // Without a perturbation the deviation stays at zero
+    EnckePropagator free(kMu, 1e-4);
+    free.rectify(initialOrbit());
+    for (int i = 0; i < 100; ++i) {
+        free.step([](const glm::dvec3&, const glm::dvec3&, double) { return glm::dvec3(0.0); }, 1.0, 60.0);
+    }
+    EXPECT_EQ(free.rectifications(), 1);
+    EXPECT_LT(glm::length(free.deviation().position), 1e-6);
+}
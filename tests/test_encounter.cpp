@@ -0,0 +1,172 @@
+#include "core/encounter.h"
+#include "core/encke.h"
+
+#include <gtest/gtest.h>
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <cmath>
+#include <memory>
+
+namespace {
+
+const double kG = 6.674e-11;
+const double kEarthMass = 5.972e24;
+const double kDay = 86400.0;
+
+void addBody(BODY_MAP& bodies, const std::string& name, double mass,
+             const glm::dvec3& pos, const glm::dvec3& vel = glm::dvec3(0.0)) {
+    bodies[name] = std::make_unique<Body>();
+    bodies[name]->name = name;
+    bodies[name]->mass = mass;
+    bodies[name]->position = pos;
+    bodies[name]->velocity = vel;
+}
+
+class EncounterTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        glm::dvec3 earth(1.496e11, 0.0, 0.0);
+        addBody(bodies, "sun", 1.989e30, glm::dvec3(0.0));
+        addBody(bodies, "earth", kEarthMass, earth, glm::dvec3(0.0, 0.0, 29780.0));
+        addBody(bodies, "moon", 7.342e22, earth + glm::dvec3(0.0, 0.0, 3.844e8), glm::dvec3(-1022.0, 0.0, 29780.0));
+        tree.build(bodies, {{"earth", "sun"}, {"moon", "earth"}});
+        tree.refreshSoi();
+        ephemeris = ConicEphemeris(tree, kG);
+        earthIndex = tree.indexOf("earth");
+        moonIndex = tree.indexOf("moon");
+
+        // A geocentric coast that passes missDistance from the Moon at flybyTime,
+        // crossing its path at relativeSpeed
+        PhaseState moon = ephemeris.state(moonIndex, flybyTime);
+        PhaseState earthAtFlyby = ephemeris.state(earthIndex, flybyTime);
+        glm::dvec3 along = glm::normalize(moon.velocity - earthAtFlyby.velocity);
+        glm::dvec3 out = glm::normalize(moon.position - earthAtFlyby.position);
+        flyby = PhaseState{moon.position - earthAtFlyby.position + missDistance * out,
+                           moon.velocity - earthAtFlyby.velocity - relativeSpeed * along};
+    }
+
+    // Exact rocket state, world frame
+    PhaseState rocket(double t) const {
+        PhaseState local = keplerPropagate(flyby, kG * kEarthMass, t - flybyTime);
+        PhaseState earth = ephemeris.state(earthIndex, t);
+        return PhaseState{earth.position + local.position, earth.velocity + local.velocity};
+    }
+
+    std::vector<EventState> sample(double duration, double step) const {
+        std::vector<EventState> samples;
+        for (double t = 0.0; t <= duration; t += step) {
+            PhaseState s = rocket(t);
+            samples.push_back(EventState{t, s.position, s.velocity});
+        }
+        return samples;
+    }
+
+    const Encounter* find(const std::vector<Encounter>& encounters, const std::string& name) const {
+        auto it = std::find_if(encounters.begin(), encounters.end(),
+                               [&](const Encounter& e) { return e.body == name; });
+        return it == encounters.end() ? nullptr : &*it;
+    }
+
+    BODY_MAP bodies;
+    BodyTree tree;
+    ConicEphemeris ephemeris;
+    int earthIndex = -1, moonIndex = -1;
+    const double flybyTime = 3.0 * kDay;
+    const double missDistance = 5.0e6;
+    const double relativeSpeed = 800.0;
+    PhaseState flyby;
+};
+
+}  // namespace
+
+// ============================================================
+// Ephemeris Tests
+// ============================================================
+
+TEST_F(EncounterTest, EphemerisFollowsConicsAboutTheParents) {
+    const double dt = 5.0 * kDay;
+    PhaseState earth = ephemeris.state(earthIndex, dt);
+    PhaseState expected = keplerPropagate(PhaseState{bodies["earth"]->position, bodies["earth"]->velocity},
+                                          kG * 1.989e30, dt);
+    EXPECT_LT(glm::length(earth.position - expected.position), 1e-3);
+
+    std::vector<PhaseState> all;
+    ephemeris.states(dt, all);
+    ASSERT_EQ(all.size(), 3u);
+    PhaseState moon = ephemeris.state(moonIndex, dt);
+    EXPECT_EQ(all[moonIndex].position, moon.position);
+    EXPECT_NEAR(glm::length(moon.position - earth.position), 3.844e8, 5.0e7);
+}
+
+// ============================================================
+// Encounter search Tests
+// ============================================================
+
+TEST_F(EncounterTest, FindsTheLunarFlyby) {
+    EncounterFinder finder;
+    finder.reset(sample(6.0 * kDay, 120.0), ephemeris);
+    EXPECT_TRUE(finder.update(0.0));
+
+    const Encounter* moon = find(finder.encounters(), "moon");
+    ASSERT_NE(moon, nullptr);
+
+    // Reference: dense scan of the exact trajectory around the flyby
+    double bestTime = 0.0, bestDistance = 1e300;
+    for (double t = flybyTime - 3000.0; t <= flybyTime + 3000.0; t += 0.5) {
+        double d = glm::length(rocket(t).position - ephemeris.state(moonIndex, t).position);
+        if (d < bestDistance) {
+            bestDistance = d;
+            bestTime = t;
+        }
+    }
+    EXPECT_NEAR(moon->time, bestTime, 1.0);
+    EXPECT_NEAR(moon->distance, bestDistance, 1.0);
+    EXPECT_NEAR(moon->relativeSpeed, relativeSpeed, 0.05 * relativeSpeed);
+
+    // The root is not searched; every report is within the body's SOI
+    EXPECT_EQ(find(finder.encounters(), "sun"), nullptr);
+    for (const Encounter& e : finder.encounters()) {
+        EXPECT_LE(e.distance, ephemeris.soiRadius(tree.indexOf(e.body)));
+    }
+}
+
+TEST_F(EncounterTest, BoundingSpheresPruneDistantArcs) {
+    EncounterFinder finder;
+    finder.reset(sample(6.0 * kDay, 120.0), ephemeris);
+    finder.update(0.0);
+
+    // Earth's SOI holds the whole coast, the Moon's only the flyby: about
+    // one refinement per arc, never two
+    EXPECT_GT(finder.arcsRefined(), finder.arcsSearched());
+    EXPECT_LT(finder.arcsRefined(), finder.arcsSearched() * 3 / 2);
+}
+
+TEST_F(EncounterTest, IncrementalSearchMatchesOneShot) {
+    std::vector<EventState> samples = sample(6.0 * kDay, 60.0);
+    EncounterFinder whole;
+    whole.reset(samples, ephemeris);
+    whole.update(0.0);
+
+    EncounterFinder sliced;
+    sliced.reset(samples, ephemeris);
+    int calls = 0;
+    while (!sliced.update(1e-6)) {
+        ++calls;
+        ASSERT_LT(calls, 100000);
+    }
+    EXPECT_GT(calls, 1);
+
+    ASSERT_EQ(sliced.encounters().size(), whole.encounters().size());
+    for (size_t i = 0; i < whole.encounters().size(); ++i) {
+        EXPECT_EQ(sliced.encounters()[i].body, whole.encounters()[i].body);
+        EXPECT_DOUBLE_EQ(sliced.encounters()[i].time, whole.encounters()[i].time);
+    }
+}
+
+TEST_F(EncounterTest, EmptyTrajectoryIsFinished) {
+    EncounterFinder finder;
+    EXPECT_TRUE(finder.finished());
+    finder.reset({}, ephemeris);
+    EXPECT_TRUE(finder.update(1e-3));
+    EXPECT_TRUE(finder.encounters().empty());
+}
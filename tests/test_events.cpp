@@ -0,0 +1,124 @@
+#include "core/event_detector.h"
+#include "core/root_finding.h"
+
+#include <gtest/gtest.h>
+#include <glm/glm.hpp>
+#include <cmath>
+
+// ============================================================
+// RootFinder Tests
+// ============================================================
+
+TEST(RootFinderTest, BrentFindsCubicRoot) {
+    auto f = [](double x) { return x * x * x - 2.0 * x - 5.0; };
+    RootResult r = RootFinder::brent(f, 2.0, 3.0, f(2.0), f(3.0), 1e-12);
+    EXPECT_TRUE(r.converged);
+    EXPECT_NEAR(r.root, 2.0945514815423265, 1e-10);
+}
+
+TEST(RootFinderTest, IllinoisFindsCubicRoot) {
+    auto f = [](double x) { return x * x * x - 2.0 * x - 5.0; };
+    RootResult r = RootFinder::illinois(f, 2.0, 3.0, f(2.0), f(3.0), 1e-12);
+    EXPECT_TRUE(r.converged);
+    EXPECT_NEAR(r.root, 2.0945514815423265, 1e-10);
+}
+
+TEST(RootFinderTest, AfterSideHasSignOfRightEnd) {
+    auto f = [](double x) { return std::cos(x); };
+    RootResult r = RootFinder::brent(f, 0.0, 3.0, f(0.0), f(3.0), 1e-9);
+    EXPECT_LT(f(r.after), 0.0 + 1e-15);
+    EXPECT_GE(f(r.before), 0.0);
+    EXPECT_NEAR(r.after, M_PI / 2.0, 1e-8);
+}
+
+TEST(RootFinderTest, NotBracketed) {
+    auto f = [](double x) { return x * x + 1.0; };
+    RootResult r = RootFinder::brent(f, -1.0, 1.0, f(-1.0), f(1.0), 1e-9);
+    EXPECT_FALSE(r.converged);
+}
+
+// ============================================================
+// DenseStep / EventDetector Tests
+// ============================================================
+
+namespace {
+
+// Exact ballistic state under constant acceleration g along -y
+EventState ballistic(double t, double y0, double vy0, double g) {
+    EventState s;
+    s.time = t;
+    s.position = glm::dvec3(0.0, y0 + vy0 * t - 0.5 * g * t * t, 0.0);
+    s.velocity = glm::dvec3(0.0, vy0 - g * t, 0.0);
+    return s;
+}
+
+}  // namespace
+
+TEST(DenseStepTest, MatchesEndpointsAndQuadraticMotion) {
+    EventState a = ballistic(0.0, 100.0, 20.0, 9.81);
+    EventState b = ballistic(4.0, 100.0, 20.0, 9.81);
+    DenseStep step(a, b);
+
+    // Cubic Hermite reproduces quadratic motion exactly
+    for (double t : {0.0, 0.7, 2.0, 3.3, 4.0}) {
+        EventState s = step.interpolate(t);
+        EventState exact = ballistic(t, 100.0, 20.0, 9.81);
+        EXPECT_NEAR(s.position.y, exact.position.y, 1e-9);
+        EXPECT_NEAR(s.velocity.y, exact.velocity.y, 1e-9);
+    }
+}
+
+TEST(EventDetectorTest, LocatesGroundImpact) {
+    EventDetector detector(1e-9);
+    detector.add({"ground", [](const EventState& s) { return s.position.y; }, EventDirection::Falling});
+
+    EventState a = ballistic(0.0, 100.0, 20.0, 9.81);
+    EventState b = ballistic(10.0, 100.0, 20.0, 9.81);
+    auto hit = detector.findFirst(DenseStep(a, b));
+
+    ASSERT_TRUE(hit.has_value());
+    double expected = (20.0 + std::sqrt(20.0 * 20.0 + 2.0 * 9.81 * 100.0)) / 9.81;
+    EXPECT_NEAR(hit->state.time, expected, 1e-8);
+    EXPECT_FALSE(hit->rising);
+    EXPECT_LE(hit->state.position.y, 1e-6);
+}
+
+TEST(EventDetectorTest, ReportsEarliestOfSeveralEvents) {
+    EventDetector detector(1e-9);
+    detector.add({"ground", [](const EventState& s) { return s.position.y; }, EventDirection::Falling});
+    size_t apex = detector.add({"apex", [](const EventState& s) { return s.velocity.y; }, EventDirection::Falling});
+
+    EventState a = ballistic(0.0, 100.0, 20.0, 9.81);
+    EventState b = ballistic(10.0, 100.0, 20.0, 9.81);
+    auto hit = detector.findFirst(DenseStep(a, b));
+
+    ASSERT_TRUE(hit.has_value());
+    EXPECT_EQ(hit->index, apex);
+    EXPECT_NEAR(hit->state.time, 20.0 / 9.81, 1e-8);
+}
+
+TEST(EventDetectorTest, DirectionFilterAndDisabledEvents) {
+    EventDetector detector(1e-9);
+    size_t up = detector.add({"climb_through_150", [](const EventState& s) { return s.position.y - 150.0; }, EventDirection::Rising});
+
+    // Falling from 200 m through 150 m: a Rising-only event must not fire
+    EventState a = ballistic(0.0, 200.0, 0.0, 9.81);
+    EventState b = ballistic(5.0, 200.0, 0.0, 9.81);
+    EXPECT_FALSE(detector.findFirst(DenseStep(a, b)).has_value());
+
+    // Climbing through 150 m fires, unless disabled
+    EventState c = ballistic(0.0, 100.0, 50.0, 9.81);
+    EventState d = ballistic(2.0, 100.0, 50.0, 9.81);
+    EXPECT_TRUE(detector.findFirst(DenseStep(c, d)).has_value());
+    detector.setEnabled(up, false);
+    EXPECT_FALSE(detector.findFirst(DenseStep(c, d)).has_value());
+}
+
+TEST(EventDetectorTest, EventAtStepStartDoesNotRefire) {
+    EventDetector detector(1e-9);
+    detector.add({"ground", [](const EventState& s) { return s.position.y; }, EventDirection::Any});
+
+    EventState a = ballistic(0.0, 0.0, 10.0, 9.81);  // Starts exactly on the surface
+    EventState b = ballistic(1.0, 0.0, 10.0, 9.81);
+    EXPECT_FALSE(detector.findFirst(DenseStep(a, b)).has_value());
+}
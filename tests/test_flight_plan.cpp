@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 #include "core/flight_plan.h"
+#include <cmath>
 #include <fstream>
 
 TEST(FlightPlanTest, LoadFromFileInvalid) {
@@ -56,3 +57,93 @@ TEST(FlightPlanTest, DefaultConstructor) {
     FlightPlan plan;
     EXPECT_TRUE(plan.getStages().empty());
 }
+
+TEST(FlightPlanTest, IndexedLookupMatchesLinearScan) {
+    // Overlapping, open-ended and speed-limited boxes; the first match in plan order wins
+    FlightPlan plan;
+    std::vector<FlightStage> stages = {
+        {{0.0, 10000.0, 0.0, 0.0}, FlightAction(1.0)},
+        {{5000.0, 20000.0, 0.0, 300.0}, FlightAction(2.0)},
+        {{5000.0, 0.0, 0.0, 0.0}, FlightAction(3.0)},
+        {{20000.0, 20000.0, 0.0, 0.0}, FlightAction(4.0)},
+        {{0.0, 0.0, 7000.0, 8000.0}, FlightAction(5.0)},
+        {{30000.0, 10000.0, 0.0, 0.0}, FlightAction(6.0)},   // Empty range: never matches
+    };
+    for (const auto& stage : stages) {
+        plan.addStage(stage);
+    }
+
+    for (double altitude : {-100.0, 0.0, 4999.0, 5000.0, 7500.0, 10000.0, 10000.5, 19999.0, 20000.0, 25000.0, 1e6}) {
+        for (double speed : {0.0, 250.0, 300.0, 500.0, 7500.0}) {
+            std::optional<FlightAction> expected;
+            for (const auto& stage : stages) {
+                if (stage.condition.isSatisfied(altitude, speed)) {
+                    expected = stage.action;
+                    break;
+                }
+            }
+            auto action = plan.getAction(altitude, speed, 0.0);
+            ASSERT_EQ(action.has_value(), expected.has_value()) << altitude << " m, " << speed << " m/s";
+            if (expected) {
+                EXPECT_DOUBLE_EQ(action->thrust, expected->thrust) << altitude << " m, " << speed << " m/s";
+            }
+        }
+    }
+}
+
+TEST(FlightPlanTest, GuidanceProfileInterpolates) {
+    // Pitch program: vertical to 45 degrees east over the first 10 km
+    nlohmann::json j = nlohmann::json::parse(R"({
+        "guidance": [
+            {
+                "variable": "altitude",
+                "points": [[10000.0, 45.0, 1000.0], [0.0, 0.0, 2000.0]]
+            },
+            {
+                "variable": "time",
+                "heading_deg": 90.0,
+                "points": [[100.0, 90.0, 500.0], [200.0, 90.0, 0.0]]
+            }
+        ]
+    })");
+    FlightPlan plan(j);
+    ASSERT_EQ(plan.getGuidance().size(), 2u);
+    EXPECT_TRUE(plan.hasGuidance());
+
+    auto action = plan.getAction(5000.0, 0.0, 0.0);
+    ASSERT_TRUE(action.has_value());
+    double pitch = std::acos(-1.0) / 8.0;   // 22.5 degrees
+    EXPECT_NEAR(action->thrust, 1500.0, 1e-9);
+    EXPECT_NEAR(action->direction.x, std::sin(pitch), 1e-12);
+    EXPECT_NEAR(action->direction.y, std::cos(pitch), 1e-12);
+    EXPECT_NEAR(action->direction.z, 0.0, 1e-12);
+
+    // Above the altitude table the time table applies, horizontal toward +Z
+    action = plan.getAction(50000.0, 0.0, 150.0);
+    ASSERT_TRUE(action.has_value());
+    EXPECT_NEAR(action->thrust, 250.0, 1e-9);
+    EXPECT_NEAR(action->direction.z, 1.0, 1e-12);
+    EXPECT_NEAR(action->direction.y, 0.0, 1e-12);
+
+    EXPECT_FALSE(plan.getAction(50000.0, 0.0, 300.0).has_value());
+}
+
+TEST(FlightPlanTest, StagesTakePrecedenceOverGuidance) {
+    FlightPlan plan;
+    plan.addGuidance(GuidanceProfile(GuidanceVariable::Speed, {{0.0, 0.0, 100.0}, {1000.0, 0.0, 200.0}}));
+    plan.addStage({{1000.0, 2000.0, 0.0, 0.0}, FlightAction(7.0)});
+
+    EXPECT_DOUBLE_EQ(plan.getAction(1500.0, 500.0, 0.0)->thrust, 7.0);
+    EXPECT_DOUBLE_EQ(plan.getAction(3000.0, 500.0, 0.0)->thrust, 150.0);
+}
+
+TEST(FlightPlanTest, MalformedGuidanceThrows) {
+    nlohmann::json unknown = nlohmann::json::parse(R"({"guidance": [{"variable": "mach", "points": [[0, 0, 0]]}]})");
+    EXPECT_THROW(FlightPlan{unknown}, FlightPlanError);
+
+    nlohmann::json duplicate = nlohmann::json::parse(R"({"guidance": [{"points": [[0, 0, 0], [0, 10, 0]]}]})");
+    EXPECT_THROW(FlightPlan{duplicate}, FlightPlanError);
+
+    nlohmann::json pairs = nlohmann::json::parse(R"({"guidance": [{"points": [[0, 0]]}]})");
+    EXPECT_THROW(FlightPlan{pairs}, FlightPlanError);
+}
@@ -0,0 +1,134 @@
+#include "core/flight_replay.h"
+#include "core/flight_recorder.h"
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdio>
+#include <string>
+
+namespace {
+
+// Moon-like circular orbit about the origin
+constexpr double kRadius = 3.844e8;
+constexpr double kRate = 2.6617e-6;   // rad/s
+
+glm::dvec3 orbitPosition(double t) {
+    return glm::dvec3(kRadius * std::cos(kRate * t), 0.0, kRadius * std::sin(kRate * t));
+}
+
+glm::dvec3 orbitVelocity(double t) {
+    return glm::dvec3(-kRadius * kRate * std::sin(kRate * t), 0.0, kRadius * kRate * std::cos(kRate * t));
+}
+
+SimulationSnapshot layout() {
+    SimulationSnapshot state;
+    state.bodies.resize(2);
+    state.bodies[0].name = "earth";
+    state.bodies[0].mass = 5.972e24;
+    state.bodies[1].name = "moon";
+    state.bodies[1].parent = 0;
+    state.bodies[1].mass = 7.342e22;
+    state.rocket.stageName = "Booster";
+    return state;
+}
+
+}  // namespace
+
+class FlightReplayTest : public ::testing::Test {
+protected:
+    std::string path;
+
+    // One row per `interval` seconds up to `duration`; stage 1 from t >= 5000 s,
+    // launched from t >= 1000 s
+    void record(double interval, double duration) {
+        path = ::testing::TempDir() + "rocketsim_replay.rst";
+        SimulationSnapshot state = layout();
+        FlightRecorder recorder(path, {"earth", "moon"}, 0.0, true);
+        for (double t = 0.0; t <= duration + 1e-9; t += interval) {
+            state.time = t;
+            state.bodies[1].position = orbitPosition(t);
+            state.bodies[1].velocity = orbitVelocity(t);
+            state.rocket.position = glm::dvec3(t, 0.0, 0.0);
+            state.rocket.velocity = glm::dvec3(1.0, 0.0, 0.0);
+            state.rocket.mass = 1000.0 - t * 0.01;
+            state.rocket.stage = t >= 5000.0 ? 1 : 0;
+            state.rocket.launched = t >= 1000.0;
+            recorder.record(state);
+        }
+    }
+
+    void TearDown() override {
+        std::remove(path.c_str());
+    }
+};
+
+TEST_F(FlightReplayTest, InterpolatesAnOrbitBetweenRows) {
+    record(600.0, 86400.0);   // A day at one row per ten minutes
+    FlightReplay replay(path, layout());
+    EXPECT_EQ(replay.startTime(), 0.0);
+    EXPECT_EQ(replay.endTime(), 86400.0);
+
+    // Halfway between rows: a chord would cut ~120 m inside the orbit
+    const double t = 43500.0 + 300.0;
+    const BodySnapshot& moon = replay.at(t).bodies[1];
+    EXPECT_LT(glm::length(moon.position - orbitPosition(t)), 1.0);
+    EXPECT_LT(glm::length(moon.velocity - orbitVelocity(t)), 1e-3);
+    // Static data comes from the layout
+    EXPECT_EQ(moon.parent, 0);
+    EXPECT_EQ(moon.mass, 7.342e22);
+}
+
+TEST_F(FlightReplayTest, SeeksAcrossChunksAndHoldsDiscreteColumns) {
+    record(1.0, 10000.0);     // Ten chunks
+    FlightReplay replay(path, layout());
+    replay.setStageNames({"Booster", "Upper"});
+    ASSERT_GT(replay.reader().chunks().size(), 5u);
+
+    // Anywhere in any order, including across a chunk boundary
+    for (double t : {9000.5, 10.25, 1023.5, 5000.0, 4999.5, 0.0, 10000.0}) {
+        const SimulationSnapshot& state = replay.at(t);
+        EXPECT_EQ(state.time, t);
+        EXPECT_NEAR(state.rocket.position.x, t, 1e-9);
+        EXPECT_NEAR(state.rocket.mass, 1000.0 - t * 0.01, 1e-9);
+        EXPECT_EQ(state.rocket.stage, t >= 5000.0 ? 1u : 0u) << t;
+        EXPECT_EQ(state.rocket.stageName, t >= 5000.0 ? "Upper" : "Booster");
+        EXPECT_EQ(state.rocket.launched, t >= 1000.0) << t;
+    }
+    // Outside the recording clamps to its ends
+    EXPECT_EQ(replay.at(-5.0).time, 0.0);
+    EXPECT_EQ(replay.at(1e9).time, 10000.0);
+}
+
+TEST_F(FlightReplayTest, PlaybackStopsAtTheEnd) {
+    record(1.0, 100.0);
+    FlightReplay replay(path, layout());
+    replay.setSpeed(10.0);
+    replay.advance(5.0);
+    EXPECT_DOUBLE_EQ(replay.time(), 50.0);
+    EXPECT_TRUE(replay.playing());
+    replay.advance(10.0);
+    EXPECT_EQ(replay.time(), 100.0);
+    EXPECT_FALSE(replay.playing());
+
+    replay.setPlaying(false);
+    replay.seek(20.0);
+    replay.advance(1.0);
+    EXPECT_EQ(replay.time(), 20.0);
+    EXPECT_EQ(replay.current().time, 20.0);
+}
+
+TEST_F(FlightReplayTest, CountsSeeksButNotPlayback) {
+    record(1.0, 100.0);
+    FlightReplay replay(path, layout());
+    const uint64_t start = replay.current().seeks;
+    replay.advance(5.0);
+    EXPECT_EQ(replay.current().seeks, start);
+
+    // Back and forward jumps both tell the renderer to start its trails over
+    replay.seek(2.0);
+    EXPECT_EQ(replay.current().seeks, start + 1);
+    replay.seek(80.0);
+    EXPECT_EQ(replay.current().seeks, start + 2);
+    replay.advance(1.0);
+    EXPECT_EQ(replay.current().seeks, start + 2);
+}
@@ -0,0 +1,85 @@
+#include "core/force_model.h"
+
+#include <gtest/gtest.h>
+#include <glm/glm.hpp>
+#include <cmath>
+
+namespace {
+
+// Constant acceleration term for composing test models
+struct Uniform {
+    glm::dvec3 g;
+    glm::dvec3 operator()(const glm::dvec3&, const glm::dvec3&, double) const { return g; }
+};
+
+}  // namespace
+
+TEST(ForceModelTest, SumsAllTerms) {
+    auto model = makeForceModel(Uniform{glm::dvec3(1.0, 0.0, 0.0)},
+                                Uniform{glm::dvec3(0.0, 2.0, 0.0)},
+                                forces::Thrust{glm::dvec3(0.0, 0.0, 30.0)});
+    glm::dvec3 acc = model(glm::dvec3(0.0), glm::dvec3(0.0), 10.0);
+    EXPECT_DOUBLE_EQ(acc.x, 1.0);
+    EXPECT_DOUBLE_EQ(acc.y, 2.0);
+    EXPECT_DOUBLE_EQ(acc.z, 3.0);
+}
+
+TEST(ForceModelTest, DirectGravitySkipsSelf) {
+    BODY_MAP bodies;
+    bodies["earth"] = std::make_unique<Body>();
+    bodies["earth"]->mass = 5.972e24;
+    bodies["earth"]->position = glm::dvec3(0.0);
+    bodies["probe"] = std::make_unique<Body>();
+    bodies["probe"]->mass = 1e30;
+    bodies["probe"]->position = glm::dvec3(7e6, 0.0, 0.0);
+
+    forces::DirectGravity gravity{&bodies, bodies["probe"].get(), 6.674e-11};
+    glm::dvec3 acc = gravity(glm::dvec3(7e6, 0.0, 0.0), glm::dvec3(0.0), 1.0);
+    EXPECT_NEAR(acc.x, -6.674e-11 * 5.972e24 / (7e6 * 7e6), 1e-9);
+}
+
+TEST(ForceModelTest, J2EquatorAndPole) {
+    const double mu = 3.986e14, R = 6371000.0, J2 = 1.08263e-3;
+    forces::J2Gravity j2{glm::dvec3(0.0), glm::dvec3(0.0, 1.0, 0.0), mu, J2, R};
+
+    // On the equator the J2 term points inward with magnitude 1.5 J2 mu R^2 / r^4
+    double r = 7000000.0;
+    glm::dvec3 acc = j2(glm::dvec3(r, 0.0, 0.0), glm::dvec3(0.0), 1.0);
+    EXPECT_NEAR(acc.x, -1.5 * J2 * mu * R * R / std::pow(r, 4), 1e-12);
+    EXPECT_NEAR(acc.y, 0.0, 1e-15);
+
+    // Over the pole it points outward with twice that magnitude
+    glm::dvec3 accPole = j2(glm::dvec3(0.0, r, 0.0), glm::dvec3(0.0), 1.0);
+    EXPECT_NEAR(accPole.y, 3.0 * J2 * mu * R * R / std::pow(r, 4), 1e-12);
+}
+
+TEST(ForceModelTest, Rk4StepIsExactForUniformAcceleration) {
+    auto model = makeForceModel(Uniform{glm::dvec3(0.0, -9.81, 0.0)});
+    PhaseState s{glm::dvec3(0.0, 100.0, 0.0), glm::dvec3(5.0, 20.0, 0.0)};
+
+    PhaseState out = rk4Step(model, s, 1.0, 2.0);
+    EXPECT_NEAR(out.position.x, 10.0, 1e-12);
+    EXPECT_NEAR(out.position.y, 100.0 + 40.0 - 0.5 * 9.81 * 4.0, 1e-12);
+    EXPECT_NEAR(out.velocity.y, 20.0 - 9.81 * 2.0, 1e-12);
+}
+
+TEST(ForceModelTest, Rk4BurnStepFollowsRocketEquation) {
+    // 1 MN at 3000 m/s exhaust velocity burns 40 t of a 100 t vehicle in 120 s
+    struct Engine {
+        EngineOutput operator()(const glm::dvec3&, const glm::dvec3&, double) const {
+            return {glm::dvec3(0.0, 1.0e6, 0.0), 1.0e6 / 3000.0};
+        }
+    };
+    auto model = makeForceModel(Uniform{glm::dvec3(0.0)});
+    BurnState s{glm::dvec3(0.0), glm::dvec3(0.0), 100000.0};
+
+    BurnState out = rk4BurnStep(model, Engine{}, s, 120.0);
+    EXPECT_NEAR(out.mass, 60000.0, 1e-6);
+    double deltaV = 3000.0 * std::log(100000.0 / 60000.0);
+    EXPECT_NEAR(out.velocity.y, deltaV, 1e-3 * deltaV);
+
+    // Holding the mass at its start value misses by a sixth of the burn
+    PhaseState constant = rk4Step(makeForceModel(Uniform{glm::dvec3(0.0, 1.0e6 / 100000.0, 0.0)}),
+                                  PhaseState{s.position, s.velocity}, s.mass, 120.0);
+    EXPECT_GT(std::abs(constant.velocity.y - deltaV), 0.2 * deltaV);
+}
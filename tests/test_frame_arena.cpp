@@ -0,0 +1,73 @@
+#include "core/frame_arena.h"
+#include "core/alloc_counter.h"
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <numeric>
+
+TEST(FrameArenaTest, AllocationsAreAlignedAndDistinct) {
+    FrameArena arena(1024);
+    auto* a = static_cast<char*>(arena.allocate(3, 1));
+    auto* b = arena.allocateArray<double>(4);
+    auto* c = static_cast<char*>(arena.allocate(16, 64));
+
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(b) % alignof(double), 0u);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(c) % 64, 0u);
+    EXPECT_GE(reinterpret_cast<char*>(b), a + 3);
+    EXPECT_GE(c, reinterpret_cast<char*>(b + 4));
+}
+
+TEST(FrameArenaTest, ResetHandsBackTheSameMemory) {
+    FrameArena arena(1024);
+    void* first = arena.allocate(100);
+    arena.reset();
+    EXPECT_EQ(arena.used(), 0u);
+    EXPECT_EQ(arena.allocate(100), first);
+}
+
+TEST(FrameArenaTest, OverflowingFrameGrowsTheBlockAtReset) {
+    FrameArena arena(256);
+    for (int i = 0; i < 10; ++i) {
+        ASSERT_NE(arena.allocate(100), nullptr);
+    }
+    EXPECT_GT(arena.used(), 256u);
+    arena.reset();
+
+    // The next frame of the same size fits in the one block
+    EXPECT_GE(arena.capacity(), arena.highWater());
+    EXPECT_GE(arena.capacity(), 1000u);
+    for (int i = 0; i < 10; ++i) {
+        arena.allocate(100);
+    }
+    EXPECT_LE(arena.used(), arena.capacity());
+}
+
+TEST(FrameArenaTest, VectorOverTheArena) {
+    FrameArena arena(64);
+    ArenaVector<int> values{ArenaAllocator<int>(arena)};
+    for (int i = 0; i < 1000; ++i) {
+        values.push_back(i);
+    }
+    EXPECT_EQ(std::accumulate(values.begin(), values.end(), 0), 999 * 1000 / 2);
+}
+
+TEST(FrameArenaTest, SteadyFramesDoNotTouchTheHeap) {
+    if (!AllocationCounter::enabled()) {
+        GTEST_SKIP() << "Built without ROCKETSIM_COUNT_ALLOCATIONS";
+    }
+    FrameArena arena(128);
+    auto frame = [&arena]() {
+        arena.reset();
+        ArenaVector<double> scratch{ArenaAllocator<double>(arena)};
+        scratch.resize(500, 1.0);
+        return scratch.size();
+    };
+    frame();   // Spills past the initial block
+    frame();   // Whose reset replaced it with one that fits the frame
+
+    const uint64_t before = AllocationCounter::count();
+    for (int i = 0; i < 10; ++i) {
+        frame();
+    }
+    EXPECT_EQ(AllocationCounter::count() - before, 0u);
+}
@@ -0,0 +1,204 @@
+#include "app/headless_runner.h"
+#include "core/job_system.h"
+#include "core/telemetry.h"
+#include "logging/logger.h"
+#include "test.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+class HeadlessRunnerTest : public ::testing::Test {
+protected:
+    Config config;
+    std::shared_ptr<MockLogger> logger;
+
+    void SetUp() override {
+        config = Config();
+        config.simulation_prediction_duration = 0.0f;   // Physics only, keeps the run short
+        logger = std::make_shared<MockLogger>();
+        EXPECT_CALL(*logger, log(_, _, _)).Times(AtLeast(0));
+        EXPECT_CALL(*logger, set_level(_)).Times(AtLeast(0));
+    }
+};
+
+TEST_F(HeadlessRunnerTest, ShortRunRecordsFiniteTelemetry) {
+    const std::string path = ::testing::TempDir() + "rocketsim_headless.rst";
+    HeadlessOptions options;
+    options.duration = 2.0;
+    options.step = 0.1;
+    options.telemetryPath = path;
+    options.telemetryInterval = 0.5;
+    HeadlessRunner runner(config, logger, options);
+
+    HeadlessResult result = runner.run();
+
+    EXPECT_EQ(result.steps, 20u);
+    EXPECT_NEAR(result.simulatedTime, 2.0, 1e-4);
+    EXPECT_FALSE(result.crashed);
+    EXPECT_EQ(runner.getCore().getRecorder(), nullptr);   // Closed by run()
+
+    TelemetryReader reader(path);
+    std::remove(path.c_str());
+    EXPECT_TRUE(reader.hasIndex());
+    ASSERT_EQ(reader.rowCount(), result.telemetryRows);
+    EXPECT_EQ(result.telemetryRows, 5u);   // t = 0, 0.5, 1, 1.5, 2
+
+    // Every value is finite; the rocket has lifted off by the last row
+    std::vector<double> values;
+    reader.readChunk(0, values);
+    for (double value : values) {
+        EXPECT_TRUE(std::isfinite(value));
+    }
+    const size_t rows = reader.chunks()[0].rows;
+    auto at = [&](const char* column, size_t row) {
+        const int c = reader.columnIndex(column);
+        EXPECT_GE(c, 0) << column;
+        return values[static_cast<size_t>(c) * rows + row];
+    };
+    auto position = [&](const std::string& body, size_t row) {
+        return glm::dvec3(at((body + ".x").c_str(), row), at((body + ".y").c_str(), row), at((body + ".z").c_str(), row));
+    };
+    const size_t last = rows - 1;
+    EXPECT_NEAR(at("time", last), 2.0, 1e-4);
+    EXPECT_GT(glm::length(position("rocket", last) - position("earth", last)), config.physics_earth_radius);
+}
+
+TEST_F(HeadlessRunnerTest, RecordingOfARestoredRunStartsAtTheCheckpoint) {
+    const std::string checkpoint = ::testing::TempDir() + "rocketsim_headless_start.rsc";
+    const std::string path = ::testing::TempDir() + "rocketsim_headless_restored.rst";
+    HeadlessOptions options;
+    options.step = 0.1;
+    options.duration = 1.0;
+    options.checkpointPath = checkpoint;
+    HeadlessRunner first(config, logger, options);
+    first.run();
+
+    options.checkpointPath.clear();
+    options.restorePath = checkpoint;
+    options.telemetryPath = path;
+    options.telemetryInterval = 0.0;
+    HeadlessRunner second(config, logger, options);
+    HeadlessResult result = second.run();
+
+    // One file, from the restored time on; no <path>.1
+    TelemetryReader reader(path);
+    EXPECT_EQ(reader.rowCount(), 11u);
+    EXPECT_EQ(result.telemetryRows, 11u);
+    EXPECT_NEAR(reader.chunks()[0].firstTime, 1.0, 1e-4);
+    EXPECT_THROW(TelemetryReader(path + ".1"), TelemetryError);
+    std::remove(checkpoint.c_str());
+    std::remove(path.c_str());
+}
+
+TEST_F(HeadlessRunnerTest, ResultDoesNotDependOnThreads) {
+    HeadlessOptions options;
+    options.duration = 1.0;
+    options.step = 0.1;
+
+    auto finalState = [&](unsigned threads) {
+        JobSystem jobs(threads);
+        HeadlessRunner runner(config, logger, options);
+        runner.setJobSystem(&jobs);
+        runner.run();
+        return runner.getCore().getRocket().getPosition();
+    };
+    glm::dvec3 serial = finalState(1);
+    glm::dvec3 parallel = finalState(4);
+    EXPECT_EQ(serial.x, parallel.x);
+    EXPECT_EQ(serial.y, parallel.y);
+    EXPECT_EQ(serial.z, parallel.z);
+}
+
+TEST_F(HeadlessRunnerTest, ResumesFromACheckpoint) {
+    const std::string path = ::testing::TempDir() + "rocketsim_headless.rsc";
+    HeadlessOptions options;
+    options.step = 0.1;
+
+    // Straight through, and the same flight split by a checkpoint
+    options.duration = 3.0;
+    HeadlessRunner straight(config, logger, options);
+    straight.run();
+
+    options.duration = 2.0;
+    options.checkpointPath = path;
+    HeadlessRunner first(config, logger, options);
+    first.run();
+
+    options.duration = 1.0;
+    options.checkpointPath.clear();
+    options.restorePath = path;
+    HeadlessRunner second(config, logger, options);
+    HeadlessResult result = second.run();
+    std::remove(path.c_str());
+
+    EXPECT_EQ(result.steps, 10u);
+    EXPECT_NEAR(result.simulatedTime, 3.0, 1e-4);
+    Rocket& resumed = second.getCore().getRocket();
+    Rocket& expected = straight.getCore().getRocket();
+    EXPECT_TRUE(resumed.isLaunched());
+    EXPECT_NEAR(resumed.getFuelMass(), expected.getFuelMass(), 1e-6);
+    EXPECT_EQ(resumed.getStageName(), expected.getStageName());
+    EXPECT_LT(glm::length(resumed.getPosition() - expected.getPosition()), 1e-3);
+    EXPECT_LT(glm::length(resumed.getVelocity() - expected.getVelocity()), 1e-6);
+}
+
+TEST_F(HeadlessRunnerTest, RefusesACheckpointOfOtherBodies) {
+    const std::string path = ::testing::TempDir() + "rocketsim_headless_bodies.rsc";
+    SimulationCore core(config, logger);
+    core.init();
+    Checkpoint state = core.captureCheckpoint();
+    state.bodies.back().name = "vulcan";
+    writeCheckpoint(path, state);
+
+    const glm::dvec3 before = core.getRocket().getPosition();
+    EXPECT_THROW(core.restoreCheckpoint(path), CheckpointError);
+    EXPECT_EQ(core.getRocket().getPosition(), before);
+    std::remove(path.c_str());
+}
+
+TEST_F(HeadlessRunnerTest, DropsAPostedCheckpointThatDoesNotFit) {
+    SimulationCore core(config, logger);
+    core.init();
+    auto state = std::make_shared<Checkpoint>(core.captureCheckpoint());
+    state->rocket.stage = 99;
+
+    EXPECT_CALL(*logger, log(LogLevel::ERROR, "Simulation", ::testing::HasSubstr("Checkpoint not restored"))).Times(1);
+    core.postRestore(state);
+    core.update(0.1f);
+    EXPECT_EQ(core.latestSnapshot().restores, 0u);
+}
+
+TEST_F(HeadlessRunnerTest, RecordsARestoredFlightToANewFile) {
+    const std::string path = ::testing::TempDir() + "rocketsim_restored.rst";
+    config.telemetry_enabled = true;
+    config.telemetry_path = path;
+    config.telemetry_interval = 0.0;
+    SimulationCore core(config, logger);
+    core.init();
+    core.update(0.1f);
+    Checkpoint state = core.captureCheckpoint();
+    core.update(0.1f);
+    core.update(0.1f);
+    core.restoreCheckpoint(state);
+    core.update(0.1f);
+    core.stopRecording();
+
+    // Before: t = 0 .. 0.3; after the restore: t = 0.1 and 0.2, in a file of their own
+    TelemetryReader before(path);
+    TelemetryReader after(path + ".1");
+    EXPECT_EQ(before.rowCount(), 4u);
+    ASSERT_EQ(after.rowCount(), 2u);
+    EXPECT_NEAR(after.chunks()[0].firstTime, 0.1, 1e-6);
+    std::remove(path.c_str());
+    std::remove((path + ".1").c_str());
+}
+
+TEST_F(HeadlessRunnerTest, RejectsNonPositiveStep) {
+    HeadlessOptions options;
+    options.step = 0.0;
+    EXPECT_THROW(HeadlessRunner(config, logger, options), std::invalid_argument);
+}
@@ -0,0 +1,137 @@
+#include "core/job_system.h"
+#include "core/alloc_counter.h"
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+// ============================================================
+// JobSystem Tests
+// ============================================================
+
+TEST(JobSystemTest, ParallelForCoversEveryIndexOnce) {
+    for (unsigned threads : {1u, 4u}) {
+        JobSystem jobs(threads);
+        std::vector<std::atomic<int>> hits(10007);
+        jobs.parallelFor(0, hits.size(), 16, [&](size_t first, size_t last) {
+            for (size_t i = first; i < last; ++i) {
+                hits[i].fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+        for (const auto& h : hits) {
+            ASSERT_EQ(h.load(), 1);
+        }
+    }
+}
+
+TEST(JobSystemTest, NestedParallelForDoesNotDeadlock) {
+    JobSystem jobs(3);
+    std::atomic<long> sum{0};
+    jobs.parallelFor(0, 64, 1, [&](size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i) {
+            jobs.parallelFor(0, 100, 1, [&](size_t a, size_t b) {
+                sum.fetch_add(static_cast<long>(b - a), std::memory_order_relaxed);
+            });
+        }
+    });
+    EXPECT_EQ(sum.load(), 64 * 100);
+}
+
+TEST(JobSystemTest, WaitRethrowsAJobsException) {
+    JobSystem jobs(2);
+    JobCounter counter;
+    jobs.submit([]() { throw std::runtime_error("boom"); }, counter);
+    jobs.submit([]() {}, counter);
+    EXPECT_THROW(jobs.wait(counter), std::runtime_error);
+    EXPECT_TRUE(counter.done());
+}
+
+TEST(JobSystemTest, QueueReusesItsSlots) {
+    // One thread: the waiter runs its own queue newest first
+    JobSystem jobs(1);
+    std::vector<int> order;
+    order.reserve(100);
+    auto burst = [&](int count) {
+        JobCounter counter;
+        for (int i = 0; i < count; ++i) {
+            jobs.submit([&order, i]() { order.push_back(i); }, counter);
+        }
+        jobs.wait(counter);
+    };
+    burst(100);
+    ASSERT_EQ(order.size(), 100u);
+    EXPECT_EQ(order.front(), 99);
+    EXPECT_EQ(order.back(), 0);
+
+    // A second burst fits the slots the first one left behind
+    order.clear();
+    const uint64_t before = AllocationCounter::count();
+    burst(100);
+    EXPECT_EQ(AllocationCounter::count() - before, 0u);
+    EXPECT_EQ(order.front(), 99);
+}
+
+// ============================================================
+// TaskGraph Tests
+// ============================================================
+
+TEST(TaskGraphTest, TasksRunAfterTheirDependencies) {
+    JobSystem jobs(4);
+    // Diamond: a -> {b, c} -> d, run repeatedly
+    std::atomic<int> step{0};
+    int a = -1, b = -1, c = -1, d = -1;
+    TaskGraph graph;
+    auto ta = graph.add("a", [&]() { a = step++; });
+    auto tb = graph.add("b", [&]() { b = step++; });
+    auto tc = graph.add("c", [&]() { c = step++; });
+    auto td = graph.add("d", [&]() { d = step++; });
+    graph.dependsOn(tb, {ta});
+    graph.dependsOn(tc, {ta});
+    graph.dependsOn(td, {tb, tc});
+
+    for (int run = 0; run < 100; ++run) {
+        step = 0;
+        graph.run(&jobs);
+        EXPECT_EQ(a, 0);
+        EXPECT_LT(a, b);
+        EXPECT_LT(a, c);
+        EXPECT_EQ(d, 3);
+    }
+
+    // The same order without a job system
+    step = 0;
+    graph.run(nullptr);
+    EXPECT_EQ(a, 0);
+    EXPECT_EQ(d, 3);
+}
+
+TEST(TaskGraphTest, IndependentTasksOverlap) {
+    JobSystem jobs(2);
+    // Each task waits for the other to start: only completes if both run at once
+    std::atomic<int> started{0};
+    auto meet = [&]() {
+        started.fetch_add(1);
+        while (started.load() < 2) {
+            std::this_thread::yield();
+        }
+    };
+    TaskGraph graph;
+    graph.add("left", meet);
+    graph.add("right", meet);
+    graph.run(&jobs);
+    EXPECT_EQ(started.load(), 2);
+}
+
+TEST(TaskGraphTest, RejectsCycles) {
+    TaskGraph graph;
+    auto a = graph.add("a", []() {});
+    auto b = graph.add("b", []() {});
+    graph.precede(a, b);
+    graph.precede(b, a);
+    JobSystem jobs(2);
+    EXPECT_THROW(graph.run(&jobs), std::logic_error);
+    EXPECT_THROW(graph.run(nullptr), std::logic_error);
+    EXPECT_THROW(graph.precede(a, a), std::invalid_argument);
+}
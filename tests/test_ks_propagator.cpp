@@ -0,0 +1,97 @@
+#include "core/ks_propagator.h"
+#include "core/encke.h"
+
+#include <gtest/gtest.h>
+#include <glm/glm.hpp>
+#include <cmath>
+
+namespace {
+
+const double kMu = 3.986004418e14;    // Earth
+const double kPi = 3.14159265358979323846;
+
+struct NoPerturbation {
+    glm::dvec3 operator()(const glm::dvec3&, const glm::dvec3&, double) const { return glm::dvec3(0.0); }
+};
+
+struct PointMass {
+    glm::dvec3 operator()(const glm::dvec3& r, const glm::dvec3&, double) const {
+        double rn = glm::length(r);
+        return -(kMu / (rn * rn * rn)) * r;
+    }
+};
+
+// e = 0.95 transfer-like orbit with periapsis at 6700 km, inclined
+PhaseState eccentricOrbit(double& period) {
+    double rp = 6.7e6, e = 0.95;
+    double a = rp / (1.0 - e);
+    period = 2.0 * kPi * std::sqrt(a * a * a / kMu);
+    double vp = std::sqrt(kMu * (1.0 + e) / rp);
+    return PhaseState{glm::dvec3(0.0, 0.0, rp), vp * glm::dvec3(std::cos(0.3), std::sin(0.3), 0.0)};
+}
+
+}  // namespace
+
+TEST(KsPropagatorTest, RoundTripsTheKsTransform) {
+    // Almost no time elapses: essentially the transform and its inverse
+    KsPropagator ks(kMu, 0.05);
+    for (const glm::dvec3& x : {glm::dvec3(7e6, 1e6, -2e6), glm::dvec3(-7e6, 3e5, 2e6), glm::dvec3(0.0, 0.0, -7e6)}) {
+        PhaseState s{x, glm::dvec3(100.0, 7500.0, -300.0)};
+        PhaseState out = ks.propagate(s, 1e-9, NoPerturbation{}, 1.0);
+        EXPECT_NEAR(glm::length(out.position - (s.position + s.velocity * 1e-9)), 0.0, 1e-6);
+        EXPECT_NEAR(glm::length(out.velocity - s.velocity), 0.0, 1e-6);
+    }
+}
+
+TEST(KsPropagatorTest, EccentricOrbitWithFewSteps) {
+    double period;
+    PhaseState s = eccentricOrbit(period);
+    PhaseState exact = keplerPropagate(s, kMu, 1.3 * period);
+
+    KsPropagator ks(kMu, 2.0 * kPi / 200.0);
+    PhaseState out = ks.propagate(s, 1.3 * period, NoPerturbation{}, 1.0);
+    EXPECT_LT(ks.steps(), 300);
+    EXPECT_LT(glm::length(out.position - exact.position), 10.0);
+
+    // Fixed-step Cowell RK4 with the same number of steps misses periapsis entirely
+    PhaseState cowell = s;
+    double h = 1.3 * period / ks.steps();
+    for (int i = 0; i < ks.steps(); ++i) {
+        cowell = rk4Step(PointMass{}, cowell, 1.0, h);
+    }
+    EXPECT_GT(glm::length(cowell.position - exact.position), 1000.0 * glm::length(out.position - exact.position));
+}
+
+TEST(KsPropagatorTest, HyperbolicFlyby) {
+    // Inbound lunar-flyby-like hyperbola passing 2000 km from the centre
+    const double mu = 4.9048695e12;
+    double rp = 2.0e6, vinf = 1000.0;
+    double vp = std::sqrt(vinf * vinf + 2.0 * mu / rp);
+    PhaseState periapsis{glm::dvec3(rp, 0.0, 0.0), glm::dvec3(0.0, vp, 0.0)};
+    PhaseState inbound = keplerPropagate(periapsis, mu, -20000.0);
+
+    KsPropagator ks(mu, 2.0 * kPi / 200.0);
+    PhaseState out = ks.propagate(inbound, 40000.0, NoPerturbation{}, 1.0);
+    PhaseState exact = keplerPropagate(periapsis, mu, 20000.0);
+    EXPECT_LT(glm::length(out.position - exact.position), 100.0);
+    EXPECT_LT(glm::length(out.velocity - exact.velocity), 1e-2);
+}
+
+TEST(KsPropagatorTest, AppliesPerturbation) {
+    // A constant push changes the orbital energy by the work done
+    struct Push {
+        glm::dvec3 operator()(const glm::dvec3&, const glm::dvec3&, double mass) const { return glm::dvec3(0.0, 0.0, 10.0 / mass); }
+    };
+    PhaseState s{glm::dvec3(7.0e6, 0.0, 0.0), glm::dvec3(0.0, 0.0, 7546.0)};
+    KsPropagator ks(kMu, 2.0 * kPi / 400.0);
+    PhaseState out = ks.propagate(s, 300.0, Push{}, 2.0);
+
+    PhaseState reference = s;
+    for (int i = 0; i < 3000; ++i) {
+        reference = rk4Step([](const glm::dvec3& r, const glm::dvec3& v, double m) {
+            return PointMass{}(r, v, m) + glm::dvec3(0.0, 0.0, 10.0 / m);
+        }, reference, 2.0, 0.1);
+    }
+    EXPECT_LT(glm::length(out.position - reference.position), 1.0);
+    EXPECT_LT(glm::length(out.velocity - reference.velocity), 1e-3);
+}
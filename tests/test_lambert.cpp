@@ -0,0 +1,79 @@
+#include "core/lambert.h"
+#include "core/encke.h"
+
+#include <gtest/gtest.h>
+#include <glm/glm.hpp>
+#include <cmath>
+
+namespace {
+
+const double kMuSun = 1.32712440018e20;
+const double kMuEarth = 3.986004418e14;
+const double kPi = 3.14159265358979323846;
+const glm::dvec3 kPole(0.0, 0.0, 1.0);
+
+// Solve between two points of a known orbit and compare with its velocities
+void expectRecovers(const PhaseState& start, double mu, double tof, int revolutions, double tolerance) {
+    PhaseState end = keplerPropagate(start, mu, tof);
+    glm::dvec3 pole = glm::cross(start.position, start.velocity);
+    bool found = false;
+    for (const LambertSolution& s : solveLambert(start.position, end.position, tof, mu, pole, revolutions)) {
+        if (s.revolutions == revolutions && glm::length(s.departureVelocity - start.velocity) < tolerance) {
+            EXPECT_LT(glm::length(s.arrivalVelocity - end.velocity), tolerance);
+            found = true;
+        }
+    }
+    EXPECT_TRUE(found) << "no solution with " << revolutions << " revolutions matches";
+}
+
+}  // namespace
+
+// ============================================================
+// Lambert Tests
+// ============================================================
+
+TEST(LambertTest, RecoversEllipticTransfers) {
+    // Earth-like heliocentric orbit, inclined and eccentric
+    PhaseState start{glm::dvec3(1.5e11, 0.0, 0.0), glm::dvec3(0.0, 27000.0, 8000.0)};
+    expectRecovers(start, kMuSun, 100.0 * 86400.0, 0, 1e-6);
+    // Past half an orbit: the long way round
+    expectRecovers(start, kMuSun, 250.0 * 86400.0, 0, 1e-6);
+}
+
+TEST(LambertTest, RecoversHyperbolicAndNearParabolicTransfers) {
+    PhaseState hyperbolic{glm::dvec3(7.0e6, 0.0, 0.0), glm::dvec3(0.0, 12500.0, 0.0)};
+    expectRecovers(hyperbolic, kMuEarth, 3600.0, 0, 1e-6);
+
+    double vEscape = std::sqrt(2.0 * kMuEarth / 7.0e6);
+    PhaseState nearParabolic{glm::dvec3(7.0e6, 0.0, 0.0), glm::dvec3(0.0, vEscape * 0.999, 0.0)};
+    expectRecovers(nearParabolic, kMuEarth, 5000.0, 0, 1e-6);
+}
+
+TEST(LambertTest, RecoversMultiRevolutionTransfers) {
+    // 2.3 orbits of a low Earth orbit: one of the one- or two-revolution branches
+    double r = 7.0e6;
+    double period = 2.0 * kPi * std::sqrt(r * r * r / kMuEarth);
+    PhaseState start{glm::dvec3(r, 0.0, 0.0), glm::dvec3(0.0, std::sqrt(kMuEarth / r) * 1.02, 0.0)};
+    expectRecovers(start, kMuEarth, 2.3 * period, 2, 1e-5);
+
+    std::vector<LambertSolution> all = solveLambert(start.position, keplerPropagate(start, kMuEarth, 2.3 * period).position,
+                                                    2.3 * period, kMuEarth, kPole, 2);
+    EXPECT_EQ(all.size(), 5u);   // 0 revolutions, and two branches each for 1 and 2
+}
+
+TEST(LambertTest, ProgradeAboutThePole) {
+    // The same endpoints prograde about +z and about -z go opposite ways round
+    glm::dvec3 r1(1.0e11, 0.0, 0.0), r2(0.0, 1.2e11, 0.0);
+    auto up = solveLambert(r1, r2, 120.0 * 86400.0, kMuSun, kPole);
+    auto down = solveLambert(r1, r2, 120.0 * 86400.0, kMuSun, -kPole);
+    ASSERT_EQ(up.size(), 1u);
+    ASSERT_EQ(down.size(), 1u);
+    EXPECT_GT(glm::cross(r1, up[0].departureVelocity).z, 0.0);
+    EXPECT_LT(glm::cross(r1, down[0].departureVelocity).z, 0.0);
+}
+
+TEST(LambertTest, DegenerateInputsHaveNoSolution) {
+    glm::dvec3 r(1.0e11, 0.0, 0.0);
+    EXPECT_TRUE(solveLambert(r, r, 86400.0, kMuSun, kPole).empty());
+    EXPECT_TRUE(solveLambert(r, glm::dvec3(0.0, 1.0e11, 0.0), 0.0, kMuSun, kPole).empty());
+}
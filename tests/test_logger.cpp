@@ -0,0 +1,50 @@
+// These tests exercise the runtime level check, so compile every level in
+#undef ROCKETSIM_LOG_MIN_LEVEL
+#define ROCKETSIM_LOG_MIN_LEVEL 0
+#include "logging/logger.h"
+
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+namespace {
+
+class RecordingLogger : public ILogger {
+public:
+    std::vector<std::string> messages;
+
+    void log(LogLevel, const std::string& module, const std::string& message) override {
+        messages.push_back(module + ": " + message);
+    }
+    void set_level(LogLevel level) override { setThreshold(level); }
+};
+
+}  // namespace
+
+TEST(LoggerTest, DisabledLevelDoesNotEvaluateTheMessage) {
+    auto logger = std::make_shared<RecordingLogger>();
+    logger->set_level(LogLevel::WARN);
+    int built = 0;
+    auto message = [&built]() { ++built; return std::string("expensive"); };
+
+    LOG_DEBUG(logger, "Test", message());
+    LOG_INFO(logger, "Test", message());
+    EXPECT_EQ(built, 0);
+    EXPECT_TRUE(logger->messages.empty());
+
+    LOG_WARN(logger, "Test", message());
+    LOG_ERROR(logger, "Test", message());
+    EXPECT_EQ(built, 2);
+    EXPECT_EQ(logger->messages.size(), 2u);
+}
+
+TEST(LoggerTest, FormatsOnlyWhenEnabled) {
+    auto logger = std::make_shared<RecordingLogger>();
+    LOG_DEBUGF(logger, "Rocket", "{} at altitude {}", "Apoapsis", 250);
+    ASSERT_EQ(logger->messages.size(), 1u);
+    EXPECT_EQ(logger->messages[0], "Rocket: Apoapsis at altitude 250");
+
+    logger->set_level(LogLevel::ERROR);
+    LOG_INFOF(logger, "Rocket", "{}", 1);
+    EXPECT_EQ(logger->messages.size(), 1u);
+}
@@ -0,0 +1,63 @@
+#include "core/mpsc_queue.h"
+
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+// ============================================================
+// MpscQueue Tests
+// ============================================================
+
+TEST(MpscQueueTest, FifoAndBounded) {
+    MpscQueue<int, 4> queue;
+    for (int i = 1; i <= 4; ++i) {
+        EXPECT_TRUE(queue.push(i));
+    }
+    EXPECT_FALSE(queue.push(5));
+
+    int v = 0;
+    ASSERT_TRUE(queue.pop(v));
+    EXPECT_EQ(v, 1);
+    EXPECT_TRUE(queue.push(5));
+    for (int expected : {2, 3, 4, 5}) {
+        ASSERT_TRUE(queue.pop(v));
+        EXPECT_EQ(v, expected);
+    }
+    EXPECT_FALSE(queue.pop(v));
+}
+
+TEST(MpscQueueTest, ConcurrentProducersLoseNothing) {
+    MpscQueue<long, 64> queue;
+    const int producers = 4;
+    const long perProducer = 50000;
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&queue, p, perProducer] {
+            for (long i = 0; i < perProducer; ++i) {
+                // Tag each value with its producer so per-producer order can be checked
+                while (!queue.push(p * perProducer + i)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    std::vector<long> next(producers, 0);
+    long received = 0;
+    long value = 0;
+    while (received < producers * perProducer) {
+        if (!queue.pop(value)) {
+            std::this_thread::yield();
+            continue;
+        }
+        int p = static_cast<int>(value / perProducer);
+        ASSERT_EQ(value % perProducer, next[p]) << "producer " << p << " out of order";
+        ++next[p];
+        ++received;
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    EXPECT_FALSE(queue.pop(value));
+}
@@ -1,4 +1,5 @@
 #include "core/octree.h"
+#include "core/job_system.h"
 
 #include <gtest/gtest.h>
 #include <glm/glm.hpp>
@@ -511,3 +512,38 @@ TEST(OctreeEdgeTest, QueryPositionAtBodyLocation) {
     // Should point towards "other" (positive x direction)
     EXPECT_GT(acc.x, 0.0);
 }
+
+// ============================================================
+// Determinism Test: parallel builds match the serial tree bit for bit
+// ============================================================
+
+TEST(OctreeDeterminismTest, ThreadCountDoesNotChangeTheTree) {
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<double> coord(-5.0e12, 5.0e12);
+    std::uniform_real_distribution<double> logMass(15.0, 27.0);
+    std::vector<OctreeBody> bodies;
+    for (int i = 0; i < 6000; ++i) {
+        bodies.emplace_back(glm::dvec3(coord(rng), coord(rng), coord(rng) * 0.01), std::pow(10.0, logMass(rng)));
+    }
+
+    Octree serial(0.5);
+    serial.build(bodies);
+    std::vector<glm::dvec3> probes = {
+        glm::dvec3(1.496e11, 0.0, 0.0), glm::dvec3(-2.0e12, 3.0e11, 1.0e9), glm::dvec3(4.0e12, -4.0e12, 0.0)};
+
+    for (unsigned threads : {1u, 2u, 3u, 8u}) {
+        JobSystem jobs(threads);
+        Octree parallel(0.5);
+        parallel.build(bodies, &jobs);
+
+        EXPECT_EQ(parallel.getNodeCount(), serial.getNodeCount()) << threads << " threads";
+        for (const glm::dvec3& probe : probes) {
+            glm::dvec3 a = serial.computeAcceleration(probe, G);
+            glm::dvec3 b = parallel.computeAcceleration(probe, G);
+            // Exact equality: the same sums in the same order
+            EXPECT_EQ(a.x, b.x) << threads << " threads";
+            EXPECT_EQ(a.y, b.y) << threads << " threads";
+            EXPECT_EQ(a.z, b.z) << threads << " threads";
+        }
+    }
+}
@@ -0,0 +1,111 @@
+#include "core/perturbers.h"
+
+#include <gtest/gtest.h>
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <memory>
+
+namespace {
+
+const double G = 6.674e-11;
+
+void addBody(BODY_MAP& bodies, const std::string& name, double mass, const glm::dvec3& pos) {
+    bodies[name] = std::make_unique<Body>();
+    bodies[name]->name = name;
+    bodies[name]->mass = mass;
+    bodies[name]->position = pos;
+}
+
+glm::dvec3 directSum(const BODY_MAP& bodies, const glm::dvec3& pos) {
+    glm::dvec3 acc(0.0);
+    for (const auto& [name, body] : bodies) {
+        glm::dvec3 d = pos - body->position;
+        double r = glm::length(d);
+        acc -= (G * body->mass / (r * r * r)) * d;
+    }
+    return acc;
+}
+
+bool contains(const std::vector<std::string>& names, const std::string& name) {
+    return std::find(names.begin(), names.end(), name) != names.end();
+}
+
+class PerturberSetTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        const double au = 1.496e11;
+        earth = glm::dvec3(au, 0.0, 0.0);
+        addBody(bodies, "sun", 1.989e30, glm::dvec3(0.0));
+        addBody(bodies, "earth", 5.972e24, earth);
+        addBody(bodies, "moon", 7.342e22, earth + glm::dvec3(0.0, 0.0, 3.844e8));
+        addBody(bodies, "venus", 4.867e24, glm::dvec3(0.0, 0.0, 0.723 * au));
+        addBody(bodies, "jupiter", 1.898e27, glm::dvec3(-5.2 * au, 0.0, 0.0));
+        addBody(bodies, "neptune", 1.024e26, glm::dvec3(0.0, 0.0, -30.1 * au));
+        leo = earth + glm::dvec3(0.0, 6771000.0, 0.0);
+    }
+
+    BODY_MAP bodies;
+    glm::dvec3 earth;
+    glm::dvec3 leo;
+};
+
+}  // namespace
+
+TEST_F(PerturberSetTest, CislunarKeepsOnlyEarthMoonSun) {
+    PerturberSet set(1e-7);
+    set.refresh(leo, 0.0, bodies, nullptr, G);
+
+    ASSERT_EQ(set.nearBodies().size(), 3u);
+    EXPECT_TRUE(contains(set.farBodies(), "jupiter"));
+    EXPECT_TRUE(contains(set.farBodies(), "neptune"));
+    EXPECT_TRUE(contains(set.farBodies(), "venus"));
+}
+
+TEST_F(PerturberSetTest, AccelerationMatchesDirectSummation) {
+    PerturberSet set(1e-7);
+    set.refresh(leo, 0.0, bodies, nullptr, G);
+
+    glm::dvec3 exact = directSum(bodies, leo);
+    EXPECT_LT(glm::length(set.acceleration(leo) - exact), 1e-12 * glm::length(exact));
+
+    // Away from the anchor the tidal term keeps the far field accurate
+    glm::dvec3 moved = leo + glm::dvec3(2.0e7, -1.0e7, 3.0e7);
+    ASSERT_TRUE(set.covers(moved));
+    glm::dvec3 exactMoved = directSum(bodies, moved);
+    EXPECT_LT(glm::length(set.acceleration(moved) - exactMoved), 1e-12 * glm::length(exactMoved));
+}
+
+TEST_F(PerturberSetTest, ZeroToleranceKeepsEveryBody) {
+    PerturberSet set(0.0);
+    set.refresh(leo, 0.0, bodies, nullptr, G);
+    EXPECT_EQ(set.nearBodies().size(), bodies.size());
+    EXPECT_TRUE(set.farBodies().empty());
+}
+
+TEST_F(PerturberSetTest, SkipsSelf) {
+    PerturberSet set(0.0);
+    set.refresh(leo, 0.0, bodies, bodies["moon"].get(), G);
+    EXPECT_EQ(set.nearBodies().size(), bodies.size() - 1);
+}
+
+TEST_F(PerturberSetTest, RefreshTriggers) {
+    PerturberSet set(1e-7, 60.0, 0.01);
+    EXPECT_TRUE(set.needsRefresh(leo, 0.0, bodies));
+
+    set.refresh(leo, 0.0, bodies, nullptr, G);
+    EXPECT_FALSE(set.needsRefresh(leo, 30.0, bodies));
+    EXPECT_TRUE(set.needsRefresh(leo, 60.0, bodies));            // Interval elapsed
+
+    // Drift beyond 1% of the distance to the closest far body (Venus, ~0.28 AU)
+    glm::dvec3 farAway = leo + glm::dvec3(1.0e10, 0.0, 0.0);
+    EXPECT_FALSE(set.covers(farAway));
+    EXPECT_TRUE(set.needsRefresh(farAway, 30.0, bodies));
+
+    // A replaced near body invalidates the classification
+    addBody(bodies, "moon", 7.342e22, earth + glm::dvec3(3.844e8, 0.0, 0.0));
+    EXPECT_TRUE(set.needsRefresh(leo, 30.0, bodies));
+
+    BODY_MAP other;
+    EXPECT_TRUE(set.needsRefresh(leo, 30.0, other));
+    EXPECT_FALSE(set.boundTo(other));
+}
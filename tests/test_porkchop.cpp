@@ -0,0 +1,103 @@
+#include "core/porkchop.h"
+
+#include <gtest/gtest.h>
+#include <glm/glm.hpp>
+#include <chrono>
+#include <cmath>
+
+namespace {
+
+const double kMuSun = 1.32712440018e20;
+const double kPi = 3.14159265358979323846;
+const double kDay = 86400.0;
+const double kEarthOrbit = 1.496e11;
+const double kMarsOrbit = 2.279e11;
+
+// Circular coplanar orbit, phase angle theta at the epoch
+PhaseState circular(double radius, double theta) {
+    double v = std::sqrt(kMuSun / radius);
+    return PhaseState{radius * glm::dvec3(std::cos(theta), std::sin(theta), 0.0),
+                      v * glm::dvec3(-std::sin(theta), std::cos(theta), 0.0)};
+}
+
+}  // namespace
+
+// ============================================================
+// Porkchop Tests
+// ============================================================
+
+TEST(PorkchopTest, FindsTheHohmannWindow) {
+    // Mars placed where a Hohmann transfer leaving in 100 days meets it
+    double a = 0.5 * (kEarthOrbit + kMarsOrbit);
+    double transfer = kPi * std::sqrt(a * a * a / kMuSun);
+    double marsRate = std::sqrt(kMuSun / (kMarsOrbit * kMarsOrbit * kMarsOrbit));
+    double earthRate = std::sqrt(kMuSun / (kEarthOrbit * kEarthOrbit * kEarthOrbit));
+    double departure = 100.0 * kDay;
+    double marsAtEpoch = earthRate * departure + kPi - marsRate * (departure + transfer);
+
+    PorkchopRequest request;
+    request.departureStart = 0.0;
+    request.departureEnd = 200.0 * kDay;
+    request.arrivalStart = 200.0 * kDay;
+    request.arrivalEnd = 500.0 * kDay;
+    request.departureSteps = 101;
+    request.arrivalSteps = 151;
+    Porkchop grid = computePorkchop(circular(kEarthOrbit, 0.0), circular(kMarsOrbit, marsAtEpoch), kMuSun, request);
+
+    double hohmann = std::sqrt(kMuSun / kEarthOrbit) * (std::sqrt(2.0 * kMarsOrbit / (kEarthOrbit + kMarsOrbit)) - 1.0)
+                   + std::sqrt(kMuSun / kMarsOrbit) * (1.0 - std::sqrt(2.0 * kEarthOrbit / (kEarthOrbit + kMarsOrbit)));
+    size_t i = 0, j = 0;
+    ASSERT_TRUE(grid.best(i, j));
+    EXPECT_NEAR(grid.deltaV(i, j), hohmann, 0.02 * hohmann);
+    EXPECT_NEAR(grid.departureTime(i), departure, 10.0 * kDay);
+    EXPECT_NEAR(grid.arrivalTime(j) - grid.departureTime(i), transfer, 15.0 * kDay);
+}
+
+TEST(PorkchopTest, ArrivalBeforeDepartureIsEmpty) {
+    PorkchopRequest request;
+    request.departureStart = 0.0;
+    request.departureEnd = 100.0 * kDay;
+    request.arrivalStart = 0.0;
+    request.arrivalEnd = 100.0 * kDay;
+    request.departureSteps = request.arrivalSteps = 11;
+    Porkchop grid = computePorkchop(circular(kEarthOrbit, 0.0), circular(kMarsOrbit, 1.0), kMuSun, request);
+    EXPECT_TRUE(std::isnan(grid.deltaV(5, 5)));
+    EXPECT_TRUE(std::isnan(grid.deltaV(6, 2)));
+    EXPECT_FALSE(std::isnan(grid.deltaV(2, 6)));
+}
+
+TEST(PorkchopTest, ThreadCountDoesNotChangeTheGrid) {
+    PorkchopRequest request;
+    request.departureEnd = 300.0 * kDay;
+    request.arrivalStart = 150.0 * kDay;
+    request.arrivalEnd = 600.0 * kDay;
+    request.departureSteps = 40;
+    request.arrivalSteps = 37;
+    request.maxRevolutions = 1;
+    request.threads = 1;
+    Porkchop serial = computePorkchop(circular(kEarthOrbit, 0.0), circular(kMarsOrbit, 0.7), kMuSun, request);
+    request.threads = 5;
+    Porkchop parallel = computePorkchop(circular(kEarthOrbit, 0.0), circular(kMarsOrbit, 0.7), kMuSun, request);
+
+    ASSERT_EQ(serial.values().size(), parallel.values().size());
+    for (size_t k = 0; k < serial.values().size(); ++k) {
+        float a = serial.values()[k], b = parallel.values()[k];
+        EXPECT_TRUE((std::isnan(a) && std::isnan(b)) || a == b) << "cell " << k;
+    }
+}
+
+TEST(PorkchopTest, LargeGridIsFast) {
+    PorkchopRequest request;
+    request.departureEnd = 700.0 * kDay;
+    request.arrivalStart = 100.0 * kDay;
+    request.arrivalEnd = 1000.0 * kDay;
+    request.departureSteps = request.arrivalSteps = 500;
+
+    auto start = std::chrono::steady_clock::now();
+    Porkchop grid = computePorkchop(circular(kEarthOrbit, 0.0), circular(kMarsOrbit, 0.7), kMuSun, request);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    size_t i, j;
+    EXPECT_TRUE(grid.best(i, j));
+    EXPECT_LT(seconds, 1.0);
+}
@@ -0,0 +1,118 @@
+#include "core/propulsion.h"
+
+#include <gtest/gtest.h>
+#include <glm/glm.hpp>
+#include <cmath>
+
+namespace {
+
+RocketStageConfig boosterConfig() {
+    RocketStageConfig config;
+    config.name = "booster";
+    config.dry_mass = 20000.0;
+    config.propellant_mass = 300000.0;
+    config.thrust_curve = {{0.0, 6.0e6}, {100.0, 4.0e6}};
+    config.isp_curve = {{0.0, 310.0}, {101325.0, 280.0}};
+    return config;
+}
+
+}  // namespace
+
+// ============================================================
+// PerformanceCurve Tests
+// ============================================================
+
+TEST(PerformanceCurveTest, InterpolatesAndClamps) {
+    PerformanceCurve curve({{0.0, 10.0}, {10.0, 20.0}, {30.0, 0.0}});
+    EXPECT_DOUBLE_EQ(curve.at(-5.0), 10.0);
+    EXPECT_DOUBLE_EQ(curve.at(5.0), 15.0);
+    EXPECT_DOUBLE_EQ(curve.at(10.0), 20.0);
+    EXPECT_DOUBLE_EQ(curve.at(20.0), 10.0);
+    EXPECT_DOUBLE_EQ(curve.at(100.0), 0.0);
+
+    PerformanceCurve single({{0.0, 42.0}});
+    EXPECT_DOUBLE_EQ(single.at(-1.0), 42.0);
+    EXPECT_DOUBLE_EQ(single.at(1e9), 42.0);
+}
+
+TEST(PerformanceCurveTest, UnsortedSamplesThrow) {
+    EXPECT_THROW(PerformanceCurve({{1.0, 0.0}, {1.0, 1.0}}), ConfigError);
+    EXPECT_THROW(PerformanceCurve({{2.0, 0.0}, {1.0, 1.0}}), ConfigError);
+}
+
+// ============================================================
+// PropulsionStage Tests
+// ============================================================
+
+TEST(PropulsionStageTest, ThrustCurveLimitsTheCommand) {
+    PropulsionStage stage(boosterConfig());
+    EXPECT_EQ(stage.name(), "booster");
+    EXPECT_DOUBLE_EQ(stage.vacuumIsp(), 310.0);
+
+    EXPECT_DOUBLE_EQ(stage.vacuumThrust(50.0, 1.0e6), 1.0e6);
+    EXPECT_DOUBLE_EQ(stage.vacuumThrust(50.0, 1.0e7), 5.0e6);
+    EXPECT_DOUBLE_EQ(stage.vacuumThrust(500.0, 1.0e7), 4.0e6);
+    EXPECT_DOUBLE_EQ(stage.vacuumThrust(0.0, 0.0), 0.0);
+
+    // Without a curve the stage delivers the command at a constant exhaust velocity
+    PropulsionStage constant = PropulsionStage::constant(1000.0, 3000.0);
+    EXPECT_DOUBLE_EQ(constant.vacuumThrust(1e6, 2.0e7), 2.0e7);
+    EXPECT_NEAR(constant.isp(101325.0) * kStandardGravity, 3000.0, 1e-9);
+}
+
+TEST(PropulsionStageTest, InvalidStagesThrow) {
+    RocketStageConfig noIsp = boosterConfig();
+    noIsp.isp_curve.clear();
+    EXPECT_THROW(PropulsionStage{noIsp}, ConfigError);
+
+    RocketStageConfig negativeMass = boosterConfig();
+    negativeMass.dry_mass = -1.0;
+    EXPECT_THROW(PropulsionStage{negativeMass}, ConfigError);
+
+    RocketStageConfig zeroIsp = boosterConfig();
+    zeroIsp.isp_curve = {{0.0, 0.0}};
+    EXPECT_THROW(PropulsionStage{zeroIsp}, ConfigError);
+}
+
+TEST(StageEngineTest, BackPressureCostsThrustNotFlow) {
+    PropulsionStage stage(boosterConfig());
+    AtmosphereTable atmosphere = AtmosphereTable::us76();
+    const double radius = 6371000.0;
+    StageEngine engine{&stage, glm::dvec3(0.0, 1.0, 0.0), 1.0e7, 0.0, &atmosphere, glm::dvec3(0.0), radius};
+
+    EngineOutput seaLevel = engine(glm::dvec3(0.0, radius, 0.0), glm::dvec3(0.0), 0.0);
+    EngineOutput vacuum = engine(glm::dvec3(0.0, radius + 200000.0, 0.0), glm::dvec3(0.0), 0.0);
+
+    EXPECT_DOUBLE_EQ(seaLevel.massFlow, vacuum.massFlow);
+    EXPECT_NEAR(seaLevel.massFlow, 6.0e6 / (310.0 * kStandardGravity), 1e-9);
+    EXPECT_NEAR(vacuum.force.y, 6.0e6, 1e-6);
+    EXPECT_NEAR(seaLevel.force.y, 6.0e6 * 280.0 / 310.0, 1.0);
+
+    // Later in the burn the curve has throttled down
+    EngineOutput late = engine(glm::dvec3(0.0, radius + 200000.0, 0.0), glm::dvec3(0.0), 50.0);
+    EXPECT_NEAR(late.force.y, 5.0e6, 1e-6);
+}
+
+TEST(StageEngineTest, BurnFollowsTheCurveWithinOneStep) {
+    // The whole curve in two 50 s RK4 steps against a fine reference
+    PropulsionStage stage(boosterConfig());
+    StageEngine engine{&stage, glm::dvec3(1.0, 0.0, 0.0), 1.0e7, 0.0, nullptr, glm::dvec3(0.0), 0.0};
+    auto model = makeForceModel(forces::Thrust{glm::dvec3(0.0)});
+    BurnState start{glm::dvec3(0.0), glm::dvec3(0.0), 400000.0};
+
+    BurnState coarse = rk4BurnStep(model, engine, start, 50.0);
+    coarse = rk4BurnStep(model, StageEngine{engine.stage, engine.direction, engine.commanded, 50.0,
+                                            nullptr, glm::dvec3(0.0), 0.0}, coarse, 50.0);
+
+    BurnState fine = start;
+    for (int i = 0; i < 1000; ++i) {
+        StageEngine at = engine;
+        at.burnTime = 0.1 * i;
+        fine = rk4BurnStep(model, at, fine, 0.1);
+    }
+
+    // Propellant used: integral of F_vac / (g0 Isp) over 100 s
+    EXPECT_NEAR(fine.mass, 400000.0 - 5.0e8 / (310.0 * kStandardGravity), 1e-3);
+    EXPECT_NEAR(coarse.mass, fine.mass, 1e-6);
+    EXPECT_NEAR(coarse.velocity.x, fine.velocity.x, 1e-4 * fine.velocity.x);
+}
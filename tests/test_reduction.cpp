@@ -0,0 +1,47 @@
+#include "core/reduction.h"
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+// ============================================================
+// deterministicReduce Tests
+// ============================================================
+
+TEST(DeterministicReduceTest, SumIsBitIdenticalForAnyThreadCount) {
+    // Wildly mixed magnitudes and signs: any change of order shows up
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<double> exponent(-12.0, 12.0);
+    std::vector<double> values(100003);
+    for (double& v : values) {
+        v = std::pow(10.0, exponent(rng)) * ((rng() & 1) ? 1.0 : -1.0);
+    }
+    auto sum = [&](JobSystem* jobs) {
+        return deterministicReduce(jobs, values.size(), 256, 0.0,
+            [&](double& partial, size_t i) { partial += values[i]; },
+            [](double a, double b) { return a + b; });
+    };
+
+    const double reference = sum(nullptr);
+    for (unsigned threads : {1u, 2u, 3u, 5u, 8u}) {
+        JobSystem jobs(threads);
+        for (int run = 0; run < 5; ++run) {
+            EXPECT_EQ(sum(&jobs), reference) << threads << " threads";
+        }
+    }
+}
+
+TEST(DeterministicReduceTest, CombinesBlocksPairwise) {
+    // Blocks of 2 over 7 values: ((ab + cd) + (ef + g))
+    std::vector<std::string> items = {"a", "b", "c", "d", "e", "f", "g"};
+    JobSystem jobs(3);
+    std::string result = deterministicReduce(&jobs, items.size(), 2, std::string(),
+        [&](std::string& partial, size_t i) { partial += items[i]; },
+        [](const std::string& l, const std::string& r) { return "(" + l + "+" + r + ")"; });
+    EXPECT_EQ(result, "((ab+cd)+(ef+g))");
+
+    EXPECT_EQ(deterministicReduce(&jobs, 0, 2, std::string("empty"),
+        [&](std::string&, size_t) {}, [](const std::string& l, const std::string&) { return l; }), "empty");
+}
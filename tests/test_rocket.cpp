@@ -1,11 +1,12 @@
 #include "core/rocket.h"
-#include "rendering/render_object.h"
+#include "core/triple_buffer.h"
 #include "logging/logger.h"
 #include "test.h"
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 #include <nlohmann/json.hpp>
+#include <cmath>
 #include <thread>
 
 using ::testing::_;
@@ -17,23 +18,12 @@ protected:
     std::unique_ptr<Rocket> rocket;
     std::shared_ptr<MockLogger> logger;
 
-    std::unique_ptr<MockRenderObject> mockRenderObject;
-    std::unique_ptr<MockRenderObject> mockTrajectory;
-    std::unique_ptr<MockRenderObject> mockPrediction;
-
     void SetUp() override {
         config = Config();
         logger = std::make_shared<MockLogger>();
         EXPECT_CALL(*logger, log(_, _, _)).Times(AtLeast(0));
         EXPECT_CALL(*logger, set_level(_)).Times(AtLeast(0));
 
-
-        mockRenderObject = std::make_unique<MockRenderObject>();
-        mockTrajectory = std::make_unique<MockRenderObject>();
-        EXPECT_CALL(*mockTrajectory, updateBuffer(_, _, _)).Times(AtLeast(0));
-        mockPrediction = std::make_unique<MockRenderObject>();
-        EXPECT_CALL(*mockPrediction, updateBuffer(_, _, _)).Times(AtLeast(0));
-            
         rocket = std::make_unique<Rocket>(config, logger, FlightPlan(config.flight_plan_path));
     }
 };
@@ -43,24 +33,12 @@ TEST_F(RocketTest, Initialization) {
     EXPECT_DOUBLE_EQ(rocket->getThrustDirection().y, 0.0);
     EXPECT_DOUBLE_EQ(rocket->getThrustDirection().z, 0.0);
     
-    rocket->setRender(std::move(mockRenderObject));
-    rocket->setTrajectoryRender(std::move(mockTrajectory), std::move(mockPrediction));
     rocket->init();
     EXPECT_DOUBLE_EQ(rocket->getThrustDirection().x, 0.0);
     EXPECT_DOUBLE_EQ(rocket->getThrustDirection().y, 1.0);
     EXPECT_DOUBLE_EQ(rocket->getThrustDirection().z, 0.0);
 }
 
-TEST_F(RocketTest, InitInjectsMockRenderObject) {
-    auto mockRender = std::make_unique<MockRenderObject>();
-    auto mockTrajectory = std::make_unique<MockRenderObject>();
-    auto mockPrediction = std::make_unique<MockRenderObject>();
-
-    rocket->setRender(std::move(mockRenderObject));
-    rocket->setTrajectoryRender(std::move(mockTrajectory), std::move(mockPrediction));
-    EXPECT_NO_THROW(rocket->init());
-}
-
 TEST_F(RocketTest, OffsetPosition_Default) {
     config.rocket_initial_position = glm::dvec3(0.0, 6371000.0, 0.0);
     config.simulation_rendering_scale = 0.001f;
@@ -102,9 +80,6 @@ TEST_F(RocketTest, FlightPlanExecution) {
     FlightPlan plan(json);
     rocket = std::make_unique<Rocket>(config, logger, plan);
 
-    rocket->setRender(std::move(mockRenderObject));
-    rocket->setTrajectoryRender(std::move(mockTrajectory), std::move(mockPrediction));
-
     rocket->init();
     rocket->launched = true;
 
@@ -114,13 +89,401 @@ TEST_F(RocketTest, FlightPlanExecution) {
 }
 
 TEST_F(RocketTest, ConcurrentUpdate) {
-    rocket->setRender(std::move(mockRenderObject));
-    rocket->setTrajectoryRender(std::move(mockTrajectory), std::move(mockPrediction));
+    rocket->init();
+    rocket->launched = true;
+
+    // Physics steps and publishes; the reader only ever sees snapshots
+    TripleBuffer<RocketSnapshot> snapshots;
+    std::thread physics([&] {
+        for (int i = 0; i < 200; ++i) {
+            rocket->update(0.1f, {});
+            rocket->fillSnapshot(snapshots.back());
+            snapshots.publish();
+        }
+    });
+    std::thread reader([&] {
+        for (int i = 0; i < 200; ++i) {
+            const RocketSnapshot& state = snapshots.read();
+            EXPECT_TRUE(std::isfinite(state.position.y));
+            EXPECT_GE(state.mass, 0.0);
+        }
+    });
+    physics.join();
+    reader.join();
+
+    EXPECT_FLOAT_EQ(snapshots.read().time, rocket->time);
+}
+
+TEST_F(RocketTest, FuelDepletionSplitsStep) {
+    // 1000 kg at 2e7 N / 3000 m/s burns out after 0.15 s of a 1 s step
+    config.rocket_fuel_mass = 1000.0;
+    rocket = std::make_unique<Rocket>(config, logger, FlightPlan());
+    rocket->init();
+    rocket->launched = true;
+
+    rocket->update(1.0f, {});
+
+    EXPECT_DOUBLE_EQ(rocket->getFuelMass(), 0.0);
+    EXPECT_NEAR(rocket->getMass(), config.rocket_mass - 1000.0, 1e-3);
+    // Thrust acted for 0.15 s only (~6 m/s), not for the whole step (~40 m/s)
+    EXPECT_NEAR(rocket->getVelocity().y, 0.15 * config.rocket_thrust / config.rocket_mass, 0.1);
+}
+
+TEST_F(RocketTest, ImpactLandsOnSurface) {
+    config.rocket_fuel_mass = 0.0;
+    rocket = std::make_unique<Rocket>(config, logger, FlightPlan());
+    rocket->init();
+    rocket->setPosition(glm::dvec3(0.0, config.physics_earth_radius + 1000.0, 0.0));
+    rocket->setVelocity(glm::dvec3(0.0, -200.0, 0.0));
+    rocket->launched = true;
+
+    // One large step that would end 1 km underground without event detection
+    rocket->update(10.0f, {});
+
+    EXPECT_TRUE(rocket->isCrashed());
+    EXPECT_FALSE(rocket->isLaunched());
+    EXPECT_NEAR(glm::length(rocket->getPosition()), config.physics_earth_radius, 1e-6);
+}
+
+TEST_F(RocketTest, DragReachesIntoLongSteps) {
+    // One step from 2.5 ceilings up that dives to ~65 km: drag must apply
+    // even though the step starts far outside the atmosphere
+    config.rocket_fuel_mass = 0.0;
+    BODY_MAP bodies;
+    bodies["earth"] = std::make_unique<Body>();
+    bodies["earth"]->name = "earth";
+    bodies["earth"]->mass = config.physics_earth_mass;
+
+    Body start;
+    start.position = glm::dvec3(0.0, config.physics_earth_radius + 2.5 * config.physics_atmosphere_ceiling, 0.0);
+    start.velocity = glm::dvec3(0.0, -3000.0, 0.0);
+
+    auto fly = [&](double area) {
+        config.physics_cross_section_area = area;
+        rocket = std::make_unique<Rocket>(config, logger, FlightPlan());
+        rocket->init();
+        double mass = rocket->mass, fuel = 0.0, burnTime = 0.0;
+        return rocket->updateStateRK4(start, 60.0, mass, fuel, burnTime, 0, bodies);
+    };
+
+    Body vacuum = fly(0.0);
+    Body drag = fly(10.0);
+    ASSERT_LT(glm::length(vacuum.position) - config.physics_earth_radius, config.physics_atmosphere_ceiling);
+    EXPECT_LT(glm::length(drag.velocity), glm::length(vacuum.velocity));
+}
+
+TEST_F(RocketTest, EventRefiresLaterInTheFrame) {
+    // Up through 1000 m at ~0.5 s and back down at ~3.6 s, both in one frame
+    config.rocket_fuel_mass = 0.0;
+    BODY_MAP bodies;
+    bodies["earth"] = std::make_unique<Body>();
+    bodies["earth"]->name = "earth";
+    bodies["earth"]->mass = config.physics_earth_mass;
+    FlightPlan plan;
+    plan.addStage({{1000.0, 0.0, 0.0, 0.0}, {0.0, glm::dvec3(0.0, 1.0, 0.0)}});
+    rocket = std::make_unique<Rocket>(config, logger, plan);
+    rocket->init();
+    rocket->events_.setEnabled(rocket->apsisEvent_, false);   // The apex would split the frame anyway
+    rocket->setPosition(glm::dvec3(0.0, config.physics_earth_radius + 990.0, 0.0));
+    rocket->setVelocity(glm::dvec3(0.0, 20.0, 0.0));
+    rocket->launched = true;
+
+    EXPECT_CALL(*logger, log(LogLevel::DEBUG, "Rocket", ::testing::HasSubstr("Flight plan boundary"))).Times(2);
+    rocket->update(6.0f, bodies);
+
+    EXPECT_LT(rocket->altitudeAt(rocket->getPosition()), 1000.0);
+}
+
+TEST_F(RocketTest, EnckeCoastFollowsKeplerOrbit) {
+    config.rocket_fuel_mass = 0.0;
+    BODY_MAP bodies;
+    bodies["earth"] = std::make_unique<Body>();
+    bodies["earth"]->name = "earth";
+    bodies["earth"]->mass = config.physics_earth_mass;
+    bodies["earth"]->position = glm::dvec3(0.0);
+    bodies["earth"]->velocity = glm::dvec3(0.0);
+
+    const double mu = config.physics_gravity_constant * config.physics_earth_mass;
+    const double r = config.physics_earth_radius + 400000.0;
+    PhaseState start{glm::dvec3(r, 0.0, 0.0), glm::dvec3(0.0, 0.0, std::sqrt(mu / r) * 1.05)};
+
+    auto fly = [&](bool encke) {
+        config.simulation_encke = encke;
+        Rocket coast(config, logger, FlightPlan());
+        coast.init();
+        coast.setPosition(start.position);
+        coast.setVelocity(start.velocity);
+        coast.launched = true;
+        for (int frame = 0; frame < 60; ++frame) {
+            coast.update(10.0f, bodies);
+        }
+        return coast.getPosition();
+    };
+
+    glm::dvec3 exact = keplerPropagate(start, mu, 600.0).position;
+    // Earth is the only body, so Encke has no deviation to integrate
+    EXPECT_LT(glm::length(fly(true) - exact), 1e-2);
+    // Cowell integrates the same dynamics, with RK4 truncation error
+    EXPECT_LT(glm::length(fly(false) - exact), 100.0);
+}
+
+TEST_F(RocketTest, SwitchesToKsOnEccentricOrbits) {
+    config.rocket_fuel_mass = 0.0;
+    BODY_MAP bodies;
+    bodies["earth"] = std::make_unique<Body>();
+    bodies["earth"]->name = "earth";
+    bodies["earth"]->mass = config.physics_earth_mass;
+    bodies["earth"]->position = glm::dvec3(0.0);
+    bodies["earth"]->velocity = glm::dvec3(0.0);
+
+    const double mu = config.physics_gravity_constant * config.physics_earth_mass;
+    const double rp = 6.7e6, e = 0.95;
+    PhaseState periapsis{glm::dvec3(rp, 0.0, 0.0), glm::dvec3(0.0, 0.0, std::sqrt(mu * (1.0 + e) / rp))};
+    PhaseState start = keplerPropagate(periapsis, mu, -900.0);
+    PhaseState circular{glm::dvec3(7.0e6, 0.0, 0.0), glm::dvec3(0.0, 0.0, std::sqrt(mu / 7.0e6))};
+
+    auto fly = [&](bool ks, bool encke) {
+        config.simulation_ks = ks;
+        config.simulation_encke = encke;
+        Rocket coast(config, logger, FlightPlan());
+        coast.init();
+        coast.setPosition(start.position);
+        coast.setVelocity(start.velocity);
+        coast.launched = true;
+        coast.update(0.0f, bodies);
 
+        EXPECT_EQ(coast.usesKs(start, 1.0, 0.0), ks);
+        EXPECT_FALSE(coast.usesKs(circular, 1.0, 0.0));
+        // A step covering a large part of the distance counts as a close approach
+        EXPECT_EQ(coast.usesKs(circular, 120.0, 0.0), ks);
+
+        for (int frame = 0; frame < 30; ++frame) {
+            coast.update(60.0f, bodies);
+        }
+        return coast.getPosition();
+    };
+
+    glm::dvec3 exact = keplerPropagate(start, mu, 1800.0).position;
+    double ksError = glm::length(fly(true, false) - exact);
+    double cowellError = glm::length(fly(false, false) - exact);
+    EXPECT_LT(ksError, 1.0);
+    EXPECT_LT(ksError * 10.0, cowellError);
+}
+
+TEST_F(RocketTest, StagesSeparateAtBurnout) {
+    // 1000 kg at 2e7 N / 3000 m/s burns out after 0.15 s of a 1 s step,
+    // then the upper stage fires for the remaining 0.85 s
+    const double upperExhaust = 300.0 * kStandardGravity;
+    config.rocket_stages = {
+        {"booster", 1000.0, 1000.0, {}, {{0.0, 3000.0 / kStandardGravity}}},
+        {"upper", 500.0, 100000.0, {}, {{0.0, 300.0}}},
+    };
+    rocket = std::make_unique<Rocket>(config, logger, FlightPlan());
     rocket->init();
     rocket->launched = true;
-    std::thread t1([&] { rocket->update(0.1f, {}); });
-    std::thread t2([&] { rocket->update(0.1f, {}); });
-    t1.join();
-    t2.join();
-}
\ No newline at end of file
+    EXPECT_EQ(rocket->getStageName(), "booster");
+    EXPECT_DOUBLE_EQ(rocket->getFuelMass(), 1000.0);
+
+    rocket->update(1.0f, {});
+
+    EXPECT_EQ(rocket->getStageName(), "upper");
+    EXPECT_NEAR(rocket->stageBurnTime_, 0.85, 1e-5);
+    double upperBurned = 0.85 * config.rocket_thrust / upperExhaust;
+    EXPECT_NEAR(rocket->getFuelMass(), 100000.0 - upperBurned, 0.1);
+    EXPECT_NEAR(rocket->getMass(), config.rocket_mass - 2000.0 - upperBurned, 0.1);
+    EXPECT_NEAR(rocket->getExhaustVelocity(), upperExhaust, 1e-9);
+
+    // Rocket equation for each stage's burn
+    double deltaV = 3000.0 * std::log(config.rocket_mass / (config.rocket_mass - 1000.0))
+                  + upperExhaust * std::log((config.rocket_mass - 2000.0) / (config.rocket_mass - 2000.0 - upperBurned));
+    EXPECT_NEAR(rocket->getVelocity().y, deltaV, 0.01);
+
+    // A stack heavier than the liftoff mass is rejected
+    config.rocket_stages[1].propellant_mass = config.rocket_mass;
+    EXPECT_THROW(std::make_unique<Rocket>(config, logger, FlightPlan()), ConfigError);
+}
+
+TEST_F(RocketTest, GuidanceSteersInsideTheStep) {
+    // Horizontal pitch program from launch: the first step already flies it,
+    // although the frame started with the default vertical direction
+    nlohmann::json json = R"({
+        "guidance": [{"variable": "time", "points": [[0.0, 90.0, 20000000.0], [100.0, 90.0, 20000000.0]]}]
+    })"_json;
+    rocket = std::make_unique<Rocket>(config, logger, FlightPlan(json));
+    rocket->init();
+    rocket->launched = true;
+
+    rocket->update(1.0f, {});
+
+    double burned = config.rocket_thrust / config.rocket_exhaust_velocity;
+    double deltaV = config.rocket_exhaust_velocity * std::log(config.rocket_mass / (config.rocket_mass - burned));
+    // Drag at the surface is ~1e-5 m/s^2 at these speeds
+    EXPECT_NEAR(glm::length(rocket->getVelocity()), deltaV, 1e-3);
+    // Horizontal throughout; the local horizontal turns with the surface
+    // over the ~20 m flown, which takes ~4e-5 m/s off the vertical
+    EXPECT_NEAR(rocket->getVelocity().y, 0.0, 1e-4);
+    EXPECT_NEAR(rocket->getThrustDirection().x, 1.0, 1e-12);
+}
+
+TEST_F(RocketTest, GuidanceIgnitesFromCoast) {
+    // Launched with the engine off: the profile's first point starts the
+    // burn in the first step, not one frame later
+    config.rocket_thrust = 0.0;
+    nlohmann::json json = R"({
+        "guidance": [{"variable": "time", "points": [[0.0, 0.0, 20000000.0], [100.0, 0.0, 20000000.0]]}]
+    })"_json;
+    rocket = std::make_unique<Rocket>(config, logger, FlightPlan(json));
+    rocket->init();
+    rocket->launched = true;
+
+    rocket->update(1.0f, {});
+
+    double burned = 20000000.0 / config.rocket_exhaust_velocity;
+    double deltaV = config.rocket_exhaust_velocity * std::log(config.rocket_mass / (config.rocket_mass - burned));
+    EXPECT_NEAR(rocket->getVelocity().y, deltaV, 1e-3);
+    EXPECT_NEAR(rocket->getMass(), config.rocket_mass - burned, 1e-6);
+    EXPECT_DOUBLE_EQ(rocket->getThrust(), 20000000.0);
+}
+
+TEST_F(RocketTest, GuidanceSensitivityMatchesShiftedPitchPrograms) {
+    // A pitch-over from the pad through the atmosphere around a lone Earth:
+    // the derivatives of one dual propagation against central differences
+    // of real flights whose pitch program is shifted
+    config.simulation_prediction_duration = 0.0f;
+    BODY_MAP bodies;
+    bodies["earth"] = std::make_unique<Body>();
+    bodies["earth"]->name = "earth";
+    bodies["earth"]->mass = config.physics_earth_mass;
+    bodies["earth"]->position = glm::dvec3(0.0);
+    bodies["earth"]->velocity = glm::dvec3(0.0);
+
+    auto launch = [&](double pitchShift, double thrustShift) {
+        nlohmann::json points = nlohmann::json::array();
+        points.push_back({0.0, 2.0 + glm::degrees(pitchShift), 2.0e7 + thrustShift});
+        points.push_back({40.0, 20.0 + glm::degrees(pitchShift), 1.6e7 + thrustShift});
+        nlohmann::json json;
+        json["guidance"] = nlohmann::json::array({{{"variable", "time"}, {"points", points}}});
+        auto flight = std::make_unique<Rocket>(config, logger, FlightPlan(json));
+        flight->init();
+        flight->setPosition(glm::dvec3(0.0, config.physics_earth_radius, 0.0));
+        flight->setVelocity(glm::dvec3(0.0));
+        flight->toggleLaunch();
+        return flight;
+    };
+    const int frames = 40;
+    auto fly = [&](double pitchShift, double thrustShift) {
+        auto flight = launch(pitchShift, thrustShift);
+        for (int i = 0; i < frames; ++i) {
+            flight->update(0.5f, bodies);
+        }
+        return flight;
+    };
+
+    Rocket::GuidanceGradient dual = launch(0.0, 0.0)->guidanceSensitivity(0.5f, frames, bodies);
+    auto nominal = fly(0.0, 0.0);
+    EXPECT_GT(glm::length(nominal->getPosition()) - config.physics_earth_radius, 1000.0);
+    EXPECT_LT(glm::length(dual.position.value() - nominal->getPosition()), 1e-6);
+    EXPECT_LT(glm::length(dual.velocity.value() - nominal->getVelocity()), 1e-9);
+    EXPECT_NEAR(dual.mass.value, nominal->getMass(), 1e-6);
+
+    const double deltas[2] = {1e-4, 100.0};
+    for (int j : {Rocket::kGuidancePitch, Rocket::kGuidanceThrust}) {
+        auto plus = fly(j == Rocket::kGuidancePitch ? deltas[j] : 0.0, j == Rocket::kGuidanceThrust ? deltas[j] : 0.0);
+        auto minus = fly(j == Rocket::kGuidancePitch ? -deltas[j] : 0.0, j == Rocket::kGuidanceThrust ? -deltas[j] : 0.0);
+        glm::dvec3 position = (plus->getPosition() - minus->getPosition()) / (2.0 * deltas[j]);
+        glm::dvec3 velocity = (plus->getVelocity() - minus->getVelocity()) / (2.0 * deltas[j]);
+        double mass = (plus->getMass() - minus->getMass()) / (2.0 * deltas[j]);
+        EXPECT_LT(glm::length(dual.position.derivative(j) - position), 1e-4 * glm::length(position)) << "parameter " << j;
+        EXPECT_LT(glm::length(dual.velocity.derivative(j) - velocity), 1e-4 * glm::length(velocity)) << "parameter " << j;
+        EXPECT_NEAR(dual.mass.grad[j], mass, 1e-4 * std::abs(mass) + 1e-9) << "parameter " << j;
+    }
+}
+
+TEST_F(RocketTest, StateTransitionMatchesPerturbedSteps) {
+    // Cowell coast around a lone Earth: Phi from updateStateRK4 maps an
+    // initial offset onto the difference of two propagated states
+    config.rocket_fuel_mass = 0.0;
+    config.simulation_encke = false;
+    config.simulation_ks = false;
+    BODY_MAP bodies;
+    bodies["earth"] = std::make_unique<Body>();
+    bodies["earth"]->name = "earth";
+    bodies["earth"]->mass = config.physics_earth_mass;
+    bodies["earth"]->position = glm::dvec3(0.0);
+    bodies["earth"]->velocity = glm::dvec3(0.0);
+    rocket = std::make_unique<Rocket>(config, logger, FlightPlan());
+
+    const double mu = config.physics_gravity_constant * config.physics_earth_mass;
+    const double r = config.physics_earth_radius + 400000.0;
+    Body start;
+    start.position = glm::dvec3(r, 0.0, 0.0);
+    start.velocity = glm::dvec3(0.0, 0.0, std::sqrt(mu / r));
+
+    auto fly = [&](const Body& from, Matrix6* stm) {
+        Body state = from;
+        double mass = rocket->mass, fuel = 0.0, burnTime = 0.0;
+        for (int i = 0; i < 60; ++i) {
+            state = rocket->updateStateRK4(state, 10.0, mass, fuel, burnTime, 0, bodies, nullptr, 10.0 * i, 0.0, stm);
+        }
+        return state;
+    };
+
+    Matrix6 stm = identityMatrix6();
+    Body nominal = fly(start, &stm);
+    Body offset = start;
+    offset.position.y += 100.0;
+    offset.velocity.x += 0.1;
+    Body perturbed = fly(offset, nullptr);
+
+    for (int i = 0; i < 3; ++i) {
+        double linear = stm[i][1] * 100.0 + stm[i][3] * 0.1;
+        EXPECT_NEAR(linear, perturbed.position[i] - nominal.position[i], 0.1) << "component " << i;
+    }
+}
+
+TEST_F(RocketTest, StateTransitionFollowsKsSteps) {
+    // KS steps through periapsis of an eccentric orbit: the matrix has to
+    // follow the short steps there, not one Cowell step per call
+    config.rocket_fuel_mass = 0.0;
+    config.simulation_encke = false;
+    config.simulation_ks = true;
+    BODY_MAP bodies;
+    bodies["earth"] = std::make_unique<Body>();
+    bodies["earth"]->name = "earth";
+    bodies["earth"]->mass = config.physics_earth_mass;
+    bodies["earth"]->position = glm::dvec3(0.0);
+    bodies["earth"]->velocity = glm::dvec3(0.0);
+    rocket = std::make_unique<Rocket>(config, logger, FlightPlan());
+    rocket->init();
+    rocket->update(0.0f, bodies);
+
+    const double mu = config.physics_gravity_constant * config.physics_earth_mass;
+    const double rp = 6.7e6, e = 0.95;
+    PhaseState periapsis{glm::dvec3(rp, 0.0, 0.0), glm::dvec3(0.0, 0.0, std::sqrt(mu * (1.0 + e) / rp))};
+    PhaseState relative = keplerPropagate(periapsis, mu, -900.0);
+    Body start;
+    start.position = relative.position;
+    start.velocity = relative.velocity;
+    ASSERT_TRUE(rocket->usesKs(relative, 300.0, 0.0));
+
+    auto fly = [&](const Body& from, Matrix6* stm) {
+        Body state = from;
+        double mass = rocket->mass, fuel = 0.0, burnTime = 0.0;
+        for (int i = 0; i < 6; ++i) {
+            state = rocket->updateStateRK4(state, 300.0, mass, fuel, burnTime, 0, bodies, nullptr, 300.0 * i, 0.0, stm);
+        }
+        return state;
+    };
+
+    Matrix6 stm = identityMatrix6();
+    Body nominal = fly(start, &stm);
+    Body offset = start;
+    offset.position.y += 100.0;
+    offset.velocity.x += 0.1;
+    Body perturbed = fly(offset, nullptr);
+
+    for (int i = 0; i < 3; ++i) {
+        double linear = stm[i][1] * 100.0 + stm[i][3] * 0.1;
+        EXPECT_NEAR(linear, perturbed.position[i] - nominal.position[i], 1.0) << "component " << i;
+    }
+}
@@ -0,0 +1,97 @@
+#include "rendering/rocket_renderer.h"
+#include "logging/logger.h"
+#include "test.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+class RocketRendererTest : public ::testing::Test {
+protected:
+    Config config;
+    std::shared_ptr<MockLogger> logger;
+
+    void SetUp() override {
+        config = Config();
+        logger = std::make_shared<MockLogger>();
+        EXPECT_CALL(*logger, log(_, _, _)).Times(AtLeast(0));
+        EXPECT_CALL(*logger, set_level(_)).Times(AtLeast(0));
+    }
+};
+
+TEST_F(RocketRendererTest, InitInjectsMockRenderObject) {
+    RocketRenderer renderer(config, logger);
+    auto mockTrajectory = std::make_unique<MockRenderObject>();
+    auto mockPrediction = std::make_unique<MockRenderObject>();
+    EXPECT_CALL(*mockTrajectory, updateBuffer(_, _, _)).Times(AtLeast(0));
+    EXPECT_CALL(*mockPrediction, updateBuffer(_, _, _)).Times(AtLeast(0));
+
+    renderer.setRender(std::make_unique<MockRenderObject>());
+    renderer.setTrajectoryRender(std::move(mockTrajectory), std::move(mockPrediction));
+    EXPECT_NO_THROW(renderer.init());
+}
+
+TEST_F(RocketRendererTest, RedrawsThePredictionOncePerRevision) {
+    RocketRenderer renderer(config, logger);
+    auto mockTrajectory = std::make_unique<MockRenderObject>();
+    auto mockPrediction = std::make_unique<MockRenderObject>();
+    MockRenderObject* prediction = mockPrediction.get();
+    EXPECT_CALL(*mockTrajectory, updateBuffer(_, _, _)).Times(AtLeast(0));
+    renderer.setRender(std::make_unique<MockRenderObject>());
+    renderer.setTrajectoryRender(std::move(mockTrajectory), std::move(mockPrediction));
+
+    auto published = std::make_shared<PredictionSnapshot>();
+    published->revision = 1;
+    published->renderInterval = 1.0f;
+    published->points = {glm::vec3(7000.0f, 0.0f, 0.0f), glm::vec3(0.0f, 7000.0f, 0.0f)};
+    RocketSnapshot state;
+    state.time = 1.0f;
+    state.prediction = published;
+
+    // A new revision rebuilds the drawn prediction
+    EXPECT_CALL(*prediction, updateBuffer(_, _, _)).Times(AtLeast(1));
+    renderer.syncRender(state);
+    ::testing::Mock::VerifyAndClearExpectations(prediction);
+
+    // The same revision again leaves it alone
+    EXPECT_CALL(*prediction, updateBuffer(_, _, _)).Times(0);
+    state.time = 2.0f;
+    renderer.syncRender(state);
+}
+
+TEST_F(RocketRendererTest, TrailStartsOverWithoutAChord) {
+    RocketRenderer renderer(config, logger);
+    auto mockTrajectory = std::make_unique<MockRenderObject>();
+    auto mockPrediction = std::make_unique<MockRenderObject>();
+    EXPECT_CALL(*mockTrajectory, updateBuffer(_, _, _)).Times(AtLeast(0));
+    EXPECT_CALL(*mockPrediction, updateBuffer(_, _, _)).Times(AtLeast(0));
+    renderer.setRender(std::make_unique<MockRenderObject>());
+    renderer.setTrajectoryRender(std::move(mockTrajectory), std::move(mockPrediction));
+    renderer.init();
+
+    const float step = config.simulation_trajectory_sample_time;
+    RocketSnapshot state;
+    state.launched = true;
+    for (int i = 1; i <= 5; ++i) {
+        state.time = step * i;
+        state.position = glm::dvec3(1.0e6 * i, 0.0, 0.0);
+        renderer.syncRender(state);
+    }
+    TrailCheckpoint trail;
+    renderer.saveTrail(trail);
+    EXPECT_FALSE(trail.points.empty());
+
+    // A jump far ahead, as a replay seek: the old path goes, nothing joins the two
+    state.time = step * 100.0f;
+    state.position = glm::dvec3(9.0e8, 0.0, 0.0);
+    renderer.restoreTrail(nullptr, state.time);
+    renderer.saveTrail(trail);
+    EXPECT_TRUE(trail.points.empty());
+    renderer.syncRender(state);
+    state.time += step;
+    renderer.syncRender(state);
+    renderer.saveTrail(trail);
+    ASSERT_FALSE(trail.points.empty());
+    for (const glm::vec3& point : trail.points) {
+        EXPECT_GT(point.x, 1.0e5f);   // Render km: nothing from the old path
+    }
+}
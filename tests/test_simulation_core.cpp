@@ -0,0 +1,51 @@
+#include "core/simulation_core.h"
+#include "core/alloc_counter.h"
+#include "core/job_system.h"
+#include "logging/logger.h"
+#include "test.h"
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <memory>
+
+class SimulationCoreAllocationTest : public ::testing::Test {
+protected:
+    Config config;
+
+    void SetUp() override {
+        if (!AllocationCounter::enabled()) {
+            GTEST_SKIP() << "Built without ROCKETSIM_COUNT_ALLOCATIONS";
+        }
+        config = Config();
+    }
+
+    // Most heap allocations in any one of `frames` steps of a launched
+    // rocket on a job system, after a warm-up that lets every retained
+    // buffer reach size. The prediction refreshes every 2 s and a snapshot
+    // can still hold the previous one, so the warm-up spans two refreshes.
+    uint64_t worstSteadyFrame(int frames) {
+        JobSystem jobs(4);
+        SimulationCore core(config, std::make_shared<NullLogger>());
+        core.setJobSystem(&jobs);
+        core.init();
+        core.post({SimulationCommand::Type::ToggleLaunch});
+        for (int i = 0; i < 300; ++i) {
+            core.update(0.02f);
+        }
+        uint64_t worst = 0;
+        for (int i = 0; i < frames; ++i) {
+            core.update(0.02f);
+            worst = std::max(worst, core.getFrameAllocations());
+        }
+        return worst;
+    }
+};
+
+TEST_F(SimulationCoreAllocationTest, SteadyFrameDoesNotAllocate) {
+    EXPECT_EQ(worstSteadyFrame(300), 0u);
+}
+
+TEST_F(SimulationCoreAllocationTest, SteadyVerletFrameDoesNotAllocate) {
+    config.simulation_block_timesteps = false;
+    EXPECT_EQ(worstSteadyFrame(300), 0u);
+}
@@ -0,0 +1,54 @@
+#include "core/spsc_queue.h"
+
+#include <gtest/gtest.h>
+#include <thread>
+
+// ============================================================
+// SpscQueue Tests
+// ============================================================
+
+TEST(SpscQueueTest, FifoAndBounded) {
+    SpscQueue<int, 4> queue;   // Holds three
+    EXPECT_TRUE(queue.empty());
+    EXPECT_TRUE(queue.push(1));
+    EXPECT_TRUE(queue.push(2));
+    EXPECT_TRUE(queue.push(3));
+    EXPECT_FALSE(queue.push(4));
+
+    int v = 0;
+    ASSERT_TRUE(queue.pop(v));
+    EXPECT_EQ(v, 1);
+    EXPECT_TRUE(queue.push(4));
+    for (int expected : {2, 3, 4}) {
+        ASSERT_TRUE(queue.pop(v));
+        EXPECT_EQ(v, expected);
+    }
+    EXPECT_FALSE(queue.pop(v));
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST(SpscQueueTest, ConcurrentProducerAndConsumerKeepOrder) {
+    SpscQueue<long, 64> queue;
+    const long count = 200000;
+
+    std::thread producer([&] {
+        for (long i = 0; i < count; ++i) {
+            while (!queue.push(i)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    long expected = 0;
+    bool ordered = true;
+    while (expected < count) {
+        long v;
+        if (queue.pop(v)) {
+            ordered &= v == expected;
+            ++expected;
+        }
+    }
+    producer.join();
+    EXPECT_TRUE(ordered);
+    EXPECT_TRUE(queue.empty());
+}
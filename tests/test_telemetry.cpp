@@ -0,0 +1,237 @@
+#include "core/telemetry.h"
+#include "core/flight_recorder.h"
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::vector<TelemetryColumn> testSchema() {
+    return {{"time", TelemetryType::Float64},
+            {"moon.x", TelemetryType::Float64},
+            {"moon.vx", TelemetryType::Float64},
+            {"rocket.stage", TelemetryType::UInt32}};
+}
+
+// A smooth orbit-like trajectory, sampled at 10 Hz
+std::vector<double> testRow(size_t i) {
+    const double t = 0.1 * static_cast<double>(i);
+    return {t, 3.844e8 * std::cos(t * 2.66e-6), -1022.0 * std::sin(t * 2.66e-6), static_cast<double>(i / 700)};
+}
+
+std::string tempPath(const std::string& name) {
+    return ::testing::TempDir() + "rocketsim_" + name + ".rst";
+}
+
+long fileSize(const std::string& path) {
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    return static_cast<long>(in.tellg());
+}
+
+// Every row of every chunk, compared against testRow
+void expectRows(const TelemetryReader& reader, size_t rows) {
+    ASSERT_EQ(reader.rowCount(), rows);
+    std::vector<double> values;
+    size_t row = 0;
+    for (size_t c = 0; c < reader.chunks().size(); ++c) {
+        reader.readChunk(c, values);
+        const size_t n = reader.chunks()[c].rows;
+        for (size_t r = 0; r < n; ++r, ++row) {
+            const std::vector<double> expected = testRow(row);
+            for (size_t col = 0; col < expected.size(); ++col) {
+                ASSERT_EQ(values[col * n + r], expected[col]) << "row " << row << " column " << col;
+            }
+        }
+        EXPECT_EQ(reader.chunks()[c].firstTime, values[0]);
+        EXPECT_EQ(reader.chunks()[c].lastTime, values[n - 1]);
+    }
+}
+
+}  // namespace
+
+// ============================================================
+// Telemetry Tests
+// ============================================================
+
+TEST(TelemetryTest, CodecRoundTripsExactly) {
+    const std::vector<TelemetryColumn> columns = testSchema();
+    const size_t rows = 300;
+    std::vector<uint64_t> words(columns.size() * rows);
+    for (size_t r = 0; r < rows; ++r) {
+        const std::vector<double> row = testRow(r);
+        for (size_t c = 0; c < 3; ++c) {
+            std::memcpy(&words[c * rows + r], &row[c], sizeof(double));
+        }
+        words[3 * rows + r] = static_cast<uint64_t>(row[3]);
+    }
+
+    for (bool compress : {false, true}) {
+        std::vector<uint8_t> encoded;
+        std::vector<uint64_t> decoded;
+        telemetry::encodeChunk(columns, words.data(), rows, rows, compress, encoded);
+        telemetry::decodeChunk(columns, encoded.data(), encoded.size(), compress, rows, decoded);
+        EXPECT_EQ(decoded, words) << (compress ? "compressed" : "raw");
+    }
+}
+
+TEST(TelemetryTest, WriterAndReaderRoundTrip) {
+    for (bool compress : {false, true}) {
+        const std::string path = tempPath(compress ? "packed" : "raw");
+        const size_t rows = 2500;   // Two full chunks and a partial one
+        {
+            TelemetryWriter writer(path, testSchema(), {1000, compress});
+            for (size_t i = 0; i < rows; ++i) {
+                writer.append(testRow(i).data());
+            }
+            EXPECT_EQ(writer.rows(), rows);
+        }   // The destructor closes
+
+        TelemetryReader reader(path);
+        EXPECT_TRUE(reader.hasIndex());
+        ASSERT_EQ(reader.columns().size(), 4u);
+        EXPECT_EQ(reader.columns()[3].type, TelemetryType::UInt32);
+        EXPECT_EQ(reader.columnIndex("moon.vx"), 2);
+        EXPECT_EQ(reader.columnIndex("sun.x"), -1);
+        ASSERT_EQ(reader.chunks().size(), 3u);
+        expectRows(reader, rows);
+        std::remove(path.c_str());
+    }
+}
+
+TEST(TelemetryTest, CompressionShrinksSmoothData) {
+    const std::string raw = tempPath("size_raw");
+    const std::string packed = tempPath("size_packed");
+    for (const auto& [path, compress] : {std::make_pair(raw, false), std::make_pair(packed, true)}) {
+        TelemetryWriter writer(path, testSchema(), {1024, compress});
+        for (size_t i = 0; i < 10000; ++i) {
+            writer.append(testRow(i).data());
+        }
+    }
+    EXPECT_LT(fileSize(packed), fileSize(raw) * 3 / 4);
+    std::remove(raw.c_str());
+    std::remove(packed.c_str());
+}
+
+TEST(TelemetryTest, FileCutShortKeepsWholeChunks) {
+    const std::string path = tempPath("torn");
+    {
+        TelemetryWriter writer(path, testSchema(), {100, true});
+        for (size_t i = 0; i < 350; ++i) {
+            writer.append(testRow(i).data());
+        }
+    }
+    // Drop the index and half of the last chunk, as a crash mid-write would
+    std::vector<char> bytes;
+    {
+        std::ifstream in(path, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    const uint64_t lastChunk = TelemetryReader(path).chunks().back().offset;
+    bytes.resize(lastChunk + 20);
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    }
+
+    TelemetryReader reader(path);
+    EXPECT_FALSE(reader.hasIndex());
+    EXPECT_EQ(reader.chunks().size(), 3u);
+    expectRows(reader, 300);
+    std::remove(path.c_str());
+}
+
+TEST(TelemetryTest, RejectsBadSchemaAndForeignFiles) {
+    EXPECT_THROW(TelemetryWriter(tempPath("bad"), {{"x", TelemetryType::Float64}}, {}), TelemetryError);
+
+    const std::string path = tempPath("foreign");
+    {
+        std::ofstream out(path);
+        out << "time,x,y,z\n0,1,2,3\n";
+    }
+    EXPECT_THROW(TelemetryReader reader(path), TelemetryError);
+    EXPECT_THROW(TelemetryReader reader(tempPath("missing")), TelemetryError);
+    std::remove(path.c_str());
+}
+
+TEST(TelemetryTest, ExportsCsvAtFullPrecision) {
+    const std::string path = tempPath("csv");
+    {
+        TelemetryWriter writer(path, testSchema(), {100, true});
+        for (size_t i = 0; i < 250; ++i) {
+            writer.append(testRow(i).data());
+        }
+    }
+    std::ostringstream csv;
+    telemetry::exportCsv(TelemetryReader(path), csv);
+    std::remove(path.c_str());
+
+    std::istringstream in(csv.str());
+    std::string line;
+    ASSERT_TRUE(std::getline(in, line));
+    EXPECT_EQ(line, "time,moon.x,moon.vx,rocket.stage");
+    size_t row = 0;
+    for (; std::getline(in, line); ++row) {
+        std::istringstream fields(line);
+        std::string field;
+        const std::vector<double> expected = testRow(row);
+        for (size_t c = 0; c < expected.size(); ++c) {
+            ASSERT_TRUE(std::getline(fields, field, ','));
+            EXPECT_EQ(std::stod(field), expected[c]) << line;
+        }
+    }
+    EXPECT_EQ(row, 250u);
+}
+
+// ============================================================
+// FlightRecorder Tests
+// ============================================================
+
+TEST(FlightRecorderTest, RecordsBodiesAndRocketAtTheInterval) {
+    const std::string path = tempPath("flight");
+    SimulationSnapshot state;
+    state.bodies.resize(2);
+    state.bodies[0].name = "sun";
+    state.bodies[1].name = "earth";
+    {
+        FlightRecorder recorder(path, {"sun", "earth"}, 1.0, true);
+        for (int step = 0; step <= 40; ++step) {
+            state.time = 0.25 * step;
+            state.bodies[1].position = glm::dvec3(1.496e11 + step, 0.0, 0.0);
+            state.rocket.velocity = glm::dvec3(0.0, 0.5 * step, 0.0);
+            state.rocket.stage = step >= 20 ? 1 : 0;
+            state.rocket.launched = step >= 4;
+            recorder.record(state);
+        }
+        EXPECT_EQ(recorder.rows(), 11u);   // t = 0, 1, ..., 10
+    }
+
+    TelemetryReader reader(path);
+    ASSERT_EQ(reader.columns().size(), FlightRecorder::schema({"sun", "earth"}).size());
+    const int earthX = reader.columnIndex("earth.x");
+    const int rocketVy = reader.columnIndex("rocket.vy");
+    const int stage = reader.columnIndex("rocket.stage");
+    const int flags = reader.columnIndex("rocket.flags");
+    ASSERT_GE(earthX, 0);
+    ASSERT_GE(rocketVy, 0);
+    ASSERT_EQ(reader.columns()[stage].type, TelemetryType::UInt32);
+
+    std::vector<double> values;
+    reader.readChunk(0, values);
+    const size_t rows = reader.chunks()[0].rows;
+    ASSERT_EQ(rows, 11u);
+    for (size_t r = 0; r < rows; ++r) {
+        const int step = static_cast<int>(4 * r);
+        EXPECT_EQ(values[r], 0.25 * step);
+        EXPECT_EQ(values[earthX * rows + r], 1.496e11 + step);   // Full double precision
+        EXPECT_EQ(values[rocketVy * rows + r], 0.5 * step);
+        EXPECT_EQ(values[stage * rows + r], step >= 20 ? 1.0 : 0.0);
+        EXPECT_EQ(values[flags * rows + r], step >= 4 ? double(FlightRecorder::kLaunched) : 0.0);
+    }
+    std::remove(path.c_str());
+}
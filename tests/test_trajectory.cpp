@@ -67,4 +67,37 @@ TEST_F(TrajectoryTest, Reset) {
     traj->reset();
     EXPECT_EQ(traj->getPoints().size(), config.simulation_trajectory_max_points);
     EXPECT_EQ(traj->getSampleTimer(), 0.0f);
-}
\ No newline at end of file
+}
+
+TEST_F(TrajectoryTest, HistoryRestoresOldestFirst) {
+    Trajectory::Config trajConfig;
+    trajConfig.maxPoints = 4;
+    trajConfig.sampleInterval = 1.0f;
+    trajConfig.color = glm::vec4(1.0f);
+    trajConfig.scale = 1.0f;
+    trajConfig.earthRadius = 6371000.0f;
+
+    Trajectory traj(trajConfig, logger);
+    traj.setRenderObject(std::move(mockRenderObject));
+    traj.init();
+    for (int i = 1; i <= 6; ++i) {   // Wraps the ring
+        traj.update(glm::vec3(static_cast<float>(i), 0.0f, 0.0f), 1.0f);
+    }
+    std::vector<glm::vec3> history = traj.getHistory();
+    ASSERT_EQ(history.size(), 4u);
+    EXPECT_EQ(history.front(), glm::vec3(3.0f, 0.0f, 0.0f));
+    EXPECT_EQ(history.back(), glm::vec3(6.0f, 0.0f, 0.0f));
+
+    Trajectory restored(trajConfig, logger);
+    restored.setRenderObject(std::make_unique<MockRenderObject>());
+    restored.init();
+    restored.restoreHistory(history, 0.5f);
+    EXPECT_EQ(restored.getHistory(), history);
+    EXPECT_EQ(restored.getSampleTimer(), 0.5f);
+
+    // Sampling carries on after the newest point
+    restored.update(glm::vec3(7.0f, 0.0f, 0.0f), 0.5f);
+    history = restored.getHistory();
+    EXPECT_EQ(history.front(), glm::vec3(4.0f, 0.0f, 0.0f));
+    EXPECT_EQ(history.back(), glm::vec3(7.0f, 0.0f, 0.0f));
+}